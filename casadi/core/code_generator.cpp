@@ -55,6 +55,8 @@ namespace casadi {
     this->prefix = "";
     avoid_stack_ = false;
     indent_ = 2;
+    this->split = 0;
+    split_lock_ = 0;
 
     // Read options
     for (auto&& e : opts) {
@@ -95,6 +97,9 @@ namespace casadi {
         casadi_assert_dev(indent_>=0);
       } else if (e.first=="avoid_stack") {
         avoid_stack_ = e.second;
+      } else if (e.first=="split") {
+        this->split = e.second;
+        casadi_assert(this->split>=0, "Option 'split' must be nonnegative");
       } else if (e.first=="prefix") {
         this->prefix = e.second.to_string();
         prefix_set = true;
@@ -206,17 +211,23 @@ namespace casadi {
     // Generate declarations
     f->codegen_declarations(*this);
 
+    // The code of the function is kept in a single translation unit
+    split_point();
+    split_lock_++;
+
     // Print to file
     f->codegen(*this, fname);
 
     // Codegen reference count functions, if needed
     if (f->has_refcount_) {
       // Increase reference counter
+      prototype("void " + fname + "_incref(void)");
       *this << "void " << fname << "_incref(void) {\n";
       f->codegen_incref(*this);
       *this << "}\n\n";
 
       // Decrease reference counter
+      prototype("void " + fname + "_decref(void)");
       *this << "void " << fname << "_decref(void) {\n";
       f->codegen_decref(*this);
       *this << "}\n\n";
@@ -226,6 +237,10 @@ namespace casadi {
     needs_mem_ |= fun_needs_mem;
 
     if (fun_needs_mem) {
+      prototype("int " + fname + "_alloc_mem(void)");
+      prototype("int " + fname + "_init_mem(int mem)");
+      prototype("void " + fname + "_free_mem(int mem)");
+
       // Alloc memory
       *this << "int " << fname << "_alloc_mem(void) {\n";
       flush(this->body);
@@ -264,12 +279,14 @@ namespace casadi {
       std::string alloc_mem = shorthand(name + "_alloc_mem");
       std::string init_mem = shorthand(name + "_init_mem");
 
-      auxiliaries << "static int " << mem_counter  << " = 0;\n";
-      auxiliaries << "static int " << stack_counter  << " = -1;\n";
-      auxiliaries << "static int " << stack << "[CASADI_MAX_NUM_THREADS];\n";
-      auxiliaries << "static " << f->codegen_mem_type() <<
-               " *" << mem_array << "[CASADI_MAX_NUM_THREADS];\n\n";
+      file_scope_.push_back({"int " + mem_counter, "0"});
+      file_scope_.push_back({"int " + stack_counter, "-1"});
+      file_scope_.push_back({"int " + stack + "[CASADI_MAX_NUM_THREADS]", ""});
+      file_scope_.push_back({f->codegen_mem_type() + " *" + mem_array + "[CASADI_MAX_NUM_THREADS]",
+                             ""});
 
+      prototype("int " + shorthand(name + "_checkout") + "(void)");
+      prototype("void " + shorthand(name + "_release") + "(int mem)");
       *this << "int " << shorthand(name + "_checkout") << "(void) {\n";
       *this << "int mid;\n";
       *this << "if (" << stack_counter << ">=0) {\n";
@@ -290,6 +307,9 @@ namespace casadi {
       *this << "}\n\n";
     }
 
+    split_lock_--;
+    split_point();
+
     return fname;
   }
 
@@ -318,6 +338,33 @@ namespace casadi {
 
     // Add to list of exposed symbols
     this->exposed_fname.push_back(f.name());
+
+    // Allow the next function to go to another translation unit
+    split_point();
+  }
+
+  void CodeGenerator::split_point() {
+    if (this->split==0 || split_lock_>0) return;
+    flush(this->body);
+    split_points_.push_back(this->body.str().size());
+  }
+
+  void CodeGenerator::prototype(const std::string& s) {
+    if (this->split>0) prototypes_.push_back(s + ";");
+  }
+
+  std::string CodeGenerator::declare_internal(const std::string& s) {
+    // External linkage is needed for calls from other translation units
+    if (this->split>0) {
+      prototype(s);
+      return s;
+    }
+    return "static " + s;
+  }
+
+  std::string CodeGenerator::aux_linkage() const {
+    // Every translation unit carries its own copy of the auxiliary functions
+    return this->split>0 ? "CASADI_INTERNAL " : "";
   }
 
   string CodeGenerator::dump() {
@@ -410,10 +457,45 @@ namespace casadi {
     // Create c file
     ofstream s;
     string fullname = prefix + this->name + this->suffix;
+    units_ = {fullname};
     file_open(s, fullname);
 
     // Dump code to file
-    dump(s);
+    if (this->split>0) {
+      // Partition the body into translation units at split points
+      flush(this->body);
+      std::string b = this->body.str();
+      std::vector<size_t> cuts = split_points_;
+      cuts.push_back(b.size());
+      std::vector<std::string> parts(1);
+      casadi_int n_lines = 0;
+      size_t start = 0;
+      for (size_t c : cuts) {
+        if (c<=start) continue;
+        std::string section = b.substr(start, c-start);
+        casadi_int n = std::count(section.begin(), section.end(), '\n');
+        if (n_lines>0 && n_lines + n > this->split) {
+          parts.push_back(std::string());
+          n_lines = 0;
+        }
+        parts.back() += section;
+        n_lines += n;
+        start = c;
+      }
+
+      // The first unit defines the variables with file scope
+      dump(s, parts.front(), true);
+      for (casadi_int k=1; k<parts.size(); ++k) {
+        ofstream su;
+        string unitname = prefix + this->name + "_" + str(k) + this->suffix;
+        units_.push_back(unitname);
+        file_open(su, unitname);
+        dump(su, parts[k], false);
+        file_close(su);
+      }
+    } else {
+      dump(s);
+    }
 
     // Mex entry point
     if (this->mex) generate_mex(s);
@@ -549,9 +631,22 @@ namespace casadi {
   }
 
   void CodeGenerator::dump(std::ostream& s) {
+    flush(this->body);
+    dump(s, this->body.str(), true);
+  }
+
+  void CodeGenerator::dump(std::ostream& s, const std::string& body_part, bool define) {
     // Consistency check
     casadi_assert_dev(current_indent_ == 0);
 
+    // Check if inf/nan is needed
+    for (const auto& d : double_constants_) {
+      for (double e : d) {
+        if (isinf(e)) add_auxiliary(AUX_INF);
+        if (isnan(e)) add_auxiliary(AUX_NAN);
+      }
+    }
+
     // Prefix internal symbols to avoid symbol collisions
     s << "/* How to prefix internal symbols */\n"
       << "#ifdef CASADI_CODEGEN_PREFIX\n"
@@ -595,17 +690,34 @@ namespace casadi {
 
     if (this->with_export) generate_export_symbol(s);
 
-    // Check if inf/nan is needed
-    for (const auto& d : double_constants_) {
-      for (double e : d) {
-        if (isinf(e)) add_auxiliary(AUX_INF);
-        if (isnan(e)) add_auxiliary(AUX_NAN);
-      }
+    // Codegen auxiliary functions, a copy in each translation unit
+    if (this->split>0) {
+      s << "/* Internal linkage, not all auxiliary functions are used in every unit */\n"
+        << "#ifdef __GNUC__\n"
+        << "#define CASADI_INTERNAL static __attribute__((unused))\n"
+        << "#else\n"
+        << "#define CASADI_INTERNAL static\n"
+        << "#endif\n\n";
     }
-
-    // Codegen auxiliary functions
     s << this->auxiliaries.str();
 
+    // Variables with file scope, shared between translation units when splitting
+    if (!file_scope_.empty()) {
+      for (auto&& v : file_scope_) {
+        if (this->split==0) {
+          s << "static " << v.first;
+          if (!v.second.empty()) s << " = " << v.second;
+        } else if (define) {
+          s << v.first;
+          if (!v.second.empty()) s << " = " << v.second;
+        } else {
+          s << "extern " << v.first;
+        }
+        s << ";\n";
+      }
+      s << endl;
+    }
+
     // Print integer constants
     if (!integer_constants_.empty()) {
       for (casadi_int i=0; i<integer_constants_.size(); ++i) {
@@ -622,11 +734,14 @@ namespace casadi {
       s << endl;
     }
 
+    // Storage class of file scope work
+    std::string storage = this->split==0 ? "static " : define ? "" : "extern ";
+
     // Print file scope double work
     if (!file_scope_double_.empty()) {
       casadi_int i=0;
       for (const auto& it : file_scope_double_) {
-        s << "static casadi_real casadi_rd" + str(i++) + "[" + str(it.second) + "];\n";
+        s << storage << "casadi_real casadi_rd" + str(i++) + "[" + str(it.second) + "];\n";
       }
       s << endl;
     }
@@ -635,7 +750,7 @@ namespace casadi {
     if (!file_scope_integer_.empty()) {
       casadi_int i=0;
       for (const auto& it : file_scope_integer_) {
-        s << "static casadi_real casadi_ri" + str(i++) + "[" + str(it.second) + "];\n";
+        s << storage << "casadi_real casadi_ri" + str(i++) + "[" + str(it.second) + "];\n";
       }
       s << endl;
     }
@@ -649,8 +764,14 @@ namespace casadi {
       s << endl << endl;
     }
 
+    // Functions defined in other translation units
+    if (!prototypes_.empty()) {
+      for (auto&& p : prototypes_) s << p << endl;
+      s << endl;
+    }
+
     // Codegen body
-    s << this->body.str();
+    s << body_part;
 
     // End with new line
     s << endl;
@@ -690,12 +811,14 @@ namespace casadi {
 
   void CodeGenerator::print_vector(std::ostream &s, const string& name,
       const vector<casadi_int>& v) {
-    s << array("static const casadi_int", name, v.size(), initializer(v));
+    std::string storage = this->split==0 ? "static " : "CASADI_INTERNAL ";
+    s << array(storage + "const casadi_int", name, v.size(), initializer(v));
   }
 
   void CodeGenerator::print_vector(std::ostream &s, const string& name,
                                   const vector<double>& v) {
-    s << array("static const casadi_real", name, v.size(), initializer(v));
+    std::string storage = this->split==0 ? "static " : "CASADI_INTERNAL ";
+    s << array(storage + "const casadi_real", name, v.size(), initializer(v));
   }
 
   std::string CodeGenerator::print_op(casadi_int op, const std::string& a0) {
@@ -1059,6 +1182,29 @@ namespace casadi {
 
       this->auxiliaries << sanitize_source(casadi_qp_str, inst);
       break;
+    case AUX_IPQP:
+      add_auxiliary(AUX_COPY);
+      add_auxiliary(AUX_CLEAR);
+      add_auxiliary(AUX_AXPY);
+      add_auxiliary(AUX_DOT);
+      add_auxiliary(AUX_MV);
+      add_auxiliary(AUX_BILIN);
+      add_auxiliary(AUX_FMIN);
+      add_auxiliary(AUX_FMAX);
+      add_auxiliary(AUX_INF);
+      add_auxiliary(AUX_TRANS);
+      add_auxiliary(AUX_LDL);
+      add_include("stdio.h");
+      add_include("math.h");
+      this->auxiliaries << sanitize_source(casadi_ipqp_str, inst);
+      break;
+    case AUX_RICCATI:
+      add_auxiliary(AUX_COPY);
+      add_auxiliary(AUX_CLEAR);
+      add_auxiliary(AUX_MAX);
+      add_include("math.h");
+      this->auxiliaries << sanitize_source(casadi_riccati_str, inst);
+      break;
     case AUX_NLP:
       this->auxiliaries << sanitize_source(casadi_nlp_str, inst);
       break;
@@ -1070,6 +1216,9 @@ namespace casadi {
     case AUX_LDL:
       this->auxiliaries << sanitize_source(casadi_ldl_str, inst);
       break;
+    case AUX_ILU:
+      this->auxiliaries << sanitize_source(casadi_ilu_str, inst);
+      break;
     case AUX_NEWTON:
       add_auxiliary(AUX_COPY);
       add_auxiliary(AUX_AXPY);
@@ -1077,6 +1226,13 @@ namespace casadi {
       add_auxiliary(AUX_QR);
       this->auxiliaries << sanitize_source(casadi_newton_str, inst);
       break;
+    case AUX_DOPRI:
+      add_auxiliary(AUX_FMIN);
+      add_auxiliary(AUX_FMAX);
+      add_auxiliary(AUX_FABS);
+      add_include("math.h");
+      this->auxiliaries << sanitize_source(casadi_dopri_str, inst);
+      break;
     case AUX_MAX_VIOL:
       this->auxiliaries << sanitize_source(casadi_max_viol_str, inst);
       break;
@@ -1138,16 +1294,17 @@ namespace casadi {
       break;
     case AUX_SQ:
       shorthand("sq");
-      this->auxiliaries << "casadi_real casadi_sq(casadi_real x) { return x*x;}\n\n";
+      this->auxiliaries << aux_linkage()
+                        << "casadi_real casadi_sq(casadi_real x) { return x*x;}\n\n";
       break;
     case AUX_SIGN:
       shorthand("sign");
-      this->auxiliaries << "casadi_real casadi_sign(casadi_real x) "
+      this->auxiliaries << aux_linkage() << "casadi_real casadi_sign(casadi_real x) "
                         << "{ return x<0 ? -1 : x>0 ? 1 : x;}\n\n";
       break;
     case AUX_IF_ELSE:
       shorthand("if_else");
-      this->auxiliaries << "casadi_real casadi_if_else"
+      this->auxiliaries << aux_linkage() << "casadi_real casadi_if_else"
                         << "(casadi_real c, casadi_real x, casadi_real y) "
                         << "{ return c!=0 ? x : y;}\n\n";
       break;
@@ -1166,7 +1323,8 @@ namespace casadi {
       break;
     case AUX_FMIN:
       shorthand("fmin");
-      this->auxiliaries << "casadi_real casadi_fmin(casadi_real x, casadi_real y) {\n"
+      this->auxiliaries << aux_linkage()
+                        << "casadi_real casadi_fmin(casadi_real x, casadi_real y) {\n"
                         << "/* Pre-c99 compatibility */\n"
                         << "#if __STDC_VERSION__ < 199901L\n"
                         << "  return x<y ? x : y;\n"
@@ -1177,7 +1335,8 @@ namespace casadi {
       break;
     case AUX_FMAX:
       shorthand("fmax");
-      this->auxiliaries << "casadi_real casadi_fmax(casadi_real x, casadi_real y) {\n"
+      this->auxiliaries << aux_linkage()
+                        << "casadi_real casadi_fmax(casadi_real x, casadi_real y) {\n"
                         << "/* Pre-c99 compatibility */\n"
                         << "#if __STDC_VERSION__ < 199901L\n"
                         << "  return x>y ? x : y;\n"
@@ -1188,7 +1347,7 @@ namespace casadi {
       break;
     case AUX_FABS:
       shorthand("fabs");
-      this->auxiliaries << "casadi_real casadi_fabs(casadi_real x) {\n"
+      this->auxiliaries << aux_linkage() << "casadi_real casadi_fabs(casadi_real x) {\n"
                         << "/* Pre-c99 compatibility */\n"
                         << "#if __STDC_VERSION__ < 199901L\n"
                         << "  return x>0 ? x : -x;\n"
@@ -1199,7 +1358,7 @@ namespace casadi {
       break;
     case AUX_ISINF:
       shorthand("isinf");
-      this->auxiliaries << "casadi_real casadi_isinf(casadi_real x) {\n"
+      this->auxiliaries << aux_linkage() << "casadi_real casadi_isinf(casadi_real x) {\n"
                         << "/* Pre-c99 compatibility */\n"
                         << "#if __STDC_VERSION__ < 199901L\n"
                         << "  return x== INFINITY || x==-INFINITY;\n"
@@ -1209,12 +1368,12 @@ namespace casadi {
                         << "}\n\n";
       break;
     case AUX_MIN:
-      this->auxiliaries << "casadi_int casadi_min(casadi_int x, casadi_int y) {\n"
+      this->auxiliaries << aux_linkage() << "casadi_int casadi_min(casadi_int x, casadi_int y) {\n"
                         << "  return x>y ? y : x;\n"
                         << "}\n\n";
       break;
     case AUX_MAX:
-      this->auxiliaries << "casadi_int casadi_max(casadi_int x, casadi_int y) {\n"
+      this->auxiliaries << aux_linkage() << "casadi_int casadi_max(casadi_int x, casadi_int y) {\n"
                         << "  return x>y ? x : y;\n"
                         << "}\n\n";
       break;
@@ -1433,6 +1592,9 @@ namespace casadi {
       this->header << cpp_prefix << this->dll_import << s << ";\n";
     }
 
+    // Needed in other translation units when splitting
+    prototype(cpp_prefix + this->dll_export + s);
+
     // Return name with declarations
     return cpp_prefix + this->dll_export + s;
   }
@@ -1659,11 +1821,16 @@ namespace casadi {
     // Process C++ source
     string line;
     istringstream stream(src);
+    // Is a declaration expected on the next line of code
+    bool decl = false;
     while (std::getline(stream, line)) {
       size_t n1, n2;
 
       // C++ template declarations are ignored
-      if (line.find("template")==0) continue;
+      if (line.find("template")==0) {
+        decl = true;
+        continue;
+      }
 
       // Macro definitions are ignored
       if (line.find("#define")==0) continue;
@@ -1681,6 +1848,7 @@ namespace casadi {
         if (!suffix.empty()) {
           rep.push_back(make_pair(sym, sym + suffix));
         }
+        decl = true;
         continue;
       }
 
@@ -1725,6 +1893,14 @@ namespace casadi {
         }
       }
 
+      // Function definitions get the linkage of auxiliary functions
+      if (decl && (isalpha(line[0]) || line[0]=='_')) {
+        if (line.find("struct ")!=0 && line.find("typedef ")!=0) {
+          line = aux_linkage() + line;
+        }
+        decl = false;
+      }
+
       // Append to return
       ret << line << "\n";
     }
@@ -1814,6 +1990,24 @@ namespace casadi {
            + lt + ", " + d + ", " + p + ", " + w + ");";
   }
 
+  std::string CodeGenerator::
+  ilu(const std::string& sp_a, const std::string& a,
+      const std::string& sp_l, const std::string& l,
+      const std::string& sp_u, const std::string& u, const std::string& w) {
+    add_auxiliary(CodeGenerator::AUX_ILU);
+    return "casadi_ilu(" + sp_a + ", " + a + ", " + sp_l + ", " + l + ", "
+           + sp_u + ", " + u + ", " + w + ");";
+  }
+
+  std::string CodeGenerator::
+  ilu_solve(const std::string& x, casadi_int nrhs, bool tr,
+    const std::string& sp_l, const std::string& l,
+    const std::string& sp_u, const std::string& u) {
+    add_auxiliary(CodeGenerator::AUX_ILU);
+    return "casadi_ilu_solve(" + x + ", " + str(nrhs) + ", " + (tr ? "1" : "0") + ", "
+           + sp_l + ", " + l + ", " + sp_u + ", " + u + ");";
+  }
+
   std::string CodeGenerator::
   fmax(const std::string& x, const std::string& y) {
     add_auxiliary(CodeGenerator::AUX_FMAX);
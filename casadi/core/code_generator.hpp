@@ -49,6 +49,12 @@ namespace casadi {
 #ifndef SWIG
     /// Generate the code to a stream
     void dump(std::ostream& s);
+
+    /** \brief Generate a translation unit to a stream
+     * \param body_part Part of the body in the unit
+     * \param define Define the variables with file scope (otherwise extern)
+     */
+    void dump(std::ostream& s, const std::string& body_part, bool define);
 #endif // SWIG
 
     /// Generate a file, return code as string
@@ -254,6 +260,17 @@ namespace casadi {
                          const std::string& d, const std::string& p,
                          const std::string& w);
 
+    /** \brief Incomplete LU factorization */
+    std::string ilu(const std::string& sp_a, const std::string& a,
+                    const std::string& sp_l, const std::string& l,
+                    const std::string& sp_u, const std::string& u,
+                    const std::string& w);
+
+    /** \brief Incomplete LU solve */
+    std::string ilu_solve(const std::string& x, casadi_int nrhs, bool tr,
+                          const std::string& sp_l, const std::string& l,
+                          const std::string& sp_u, const std::string& u);
+
     /** \brief fmax */
     std::string fmax(const std::string& x, const std::string& y);
 
@@ -310,6 +327,17 @@ namespace casadi {
     /** \brief Declare a function */
     std::string declare(std::string s);
 
+    /** \brief Declare a function that is not exposed
+     * Static, unless the code is split into several translation units
+     */
+    std::string declare_internal(const std::string& s);
+
+    /** \brief Mark a location in the body where a new translation unit may start */
+    void split_point();
+
+    /** \brief Translation units of the last generated code, main file first */
+    const std::vector<std::string>& units() const { return units_;}
+
     /** \brief Write a comment line (ignored if not verbose) */
     void comment(const std::string& s);
 
@@ -351,10 +379,14 @@ namespace casadi {
       AUX_FINITE_DIFF,
       AUX_QR,
       AUX_QP,
+      AUX_IPQP,
+      AUX_RICCATI,
       AUX_NLP,
       AUX_SQPMETHOD,
       AUX_LDL,
+      AUX_ILU,
       AUX_NEWTON,
+      AUX_DOPRI,
       AUX_TO_DOUBLE,
       AUX_TO_INT,
       AUX_CAST,
@@ -500,6 +532,12 @@ namespace casadi {
     // Generate import symbol macros
     void generate_import_symbol(std::ostream &s) const;
 
+    // Add a function prototype, needed when splitting
+    void prototype(const std::string& s);
+
+    // Linkage specifier for auxiliary functions
+    std::string aux_linkage() const;
+
     //  private:
   public:
     /// \cond INTERNAL
@@ -540,6 +578,9 @@ namespace casadi {
     // Do we want to be lean on stack usage?
     bool avoid_stack_;
 
+    // Approximate number of lines per translation unit, 0 for a single file
+    casadi_int split;
+
     std::string infinity, nan, real_min;
 
     /** \brief Codegen scalar
@@ -589,6 +630,15 @@ namespace casadi {
     std::map<const void *, casadi_int> file_scope_double_;
     std::map<const void *, casadi_int> file_scope_integer_;
 
+    // Other variables with file scope: declaration and initializer
+    std::vector<std::pair<std::string, std::string> > file_scope_;
+
+    // Splitting into translation units
+    std::vector<size_t> split_points_;
+    casadi_int split_lock_;
+    std::vector<std::string> prototypes_;
+    std::vector<std::string> units_;
+
     // Added functions
     struct FunctionMeta {
       // The function object
@@ -0,0 +1,286 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "compile_cache.hpp"
+#include "casadi_misc.hpp"
+#include "exception.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <windows.h>
+#include <direct.h>
+#include <sys/utime.h>
+#else // _WIN32
+#include <dirent.h>
+#include <utime.h>
+#endif // _WIN32
+
+using namespace std;
+
+namespace casadi {
+
+  namespace {
+
+    // A file in the cache directory
+    struct CacheEntry {
+      std::string name;
+      casadi_int size;
+      time_t mtime;
+    };
+
+    // Get size and modification time, returns false if the file does not exist
+    bool file_stat(const std::string& path, casadi_int& size, time_t& mtime) {
+#ifdef _WIN32
+      struct _stat64 st;
+      if (_stat64(path.c_str(), &st)) return false;
+#else // _WIN32
+      struct stat st;
+      if (stat(path.c_str(), &st)) return false;
+#endif // _WIN32
+      size = st.st_size;
+      mtime = st.st_mtime;
+      return true;
+    }
+
+    // Create a directory, including missing parents
+    void make_dirs(const std::string& dir) {
+      for (size_t i=1; i<=dir.size(); ++i) {
+        if (i==dir.size() || dir[i]=='/' || dir[i]=='\\') {
+          std::string d = dir.substr(0, i);
+#ifdef _WIN32
+          _mkdir(d.c_str());
+#else // _WIN32
+          mkdir(d.c_str(), 0755);
+#endif // _WIN32
+        }
+      }
+    }
+
+    // List the regular files in a directory
+    std::vector<CacheEntry> list_dir(const std::string& dir) {
+      std::vector<CacheEntry> ret;
+      std::vector<std::string> names;
+#ifdef _WIN32
+      WIN32_FIND_DATAA fd;
+      HANDLE h = FindFirstFileA((dir + "\\*").c_str(), &fd);
+      if (h!=INVALID_HANDLE_VALUE) {
+        do {
+          if (!(fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) names.push_back(fd.cFileName);
+        } while (FindNextFileA(h, &fd));
+        FindClose(h);
+      }
+#else // _WIN32
+      DIR* d = opendir(dir.c_str());
+      if (d) {
+        while (struct dirent* e = readdir(d)) {
+          if (e->d_name[0]!='.') names.push_back(e->d_name);
+        }
+        closedir(d);
+      }
+#endif // _WIN32
+      for (const std::string& n : names) {
+        CacheEntry e;
+        e.name = n;
+        if (file_stat(dir + "/" + n, e.size, e.mtime)) ret.push_back(e);
+      }
+      return ret;
+    }
+
+    // Does a string end with a suffix
+    bool ends_with(const std::string& s, const std::string& suffix) {
+      return s.size()>=suffix.size() && s.compare(s.size()-suffix.size(), suffix.size(), suffix)==0;
+    }
+
+    // Suffix of files being written
+    const std::string TMP_SUFFIX = ".tmp";
+
+    // Age in seconds after which abandoned temporary files are removed
+    const double TMP_MAX_AGE = 24*3600;
+
+    // SHA-256 round constants
+    const uint32_t sha256_k[64] = {
+      0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4,
+      0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe,
+      0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f,
+      0x4a7484aa, 0x5cb0a9dc, 0x76f988da, 0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+      0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc,
+      0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+      0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116,
+      0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+      0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7,
+      0xc67178f2};
+
+    inline uint32_t rotr(uint32_t x, int n) { return (x >> n) | (x << (32 - n));}
+
+    // Process a 64-byte block
+    void sha256_block(uint32_t* h, const unsigned char* p) {
+      uint32_t w[64];
+      for (int i=0; i<16; ++i) {
+        w[i] = uint32_t(p[4*i]) << 24 | uint32_t(p[4*i+1]) << 16
+             | uint32_t(p[4*i+2]) << 8 | uint32_t(p[4*i+3]);
+      }
+      for (int i=16; i<64; ++i) {
+        uint32_t s0 = rotr(w[i-15], 7) ^ rotr(w[i-15], 18) ^ (w[i-15] >> 3);
+        uint32_t s1 = rotr(w[i-2], 17) ^ rotr(w[i-2], 19) ^ (w[i-2] >> 10);
+        w[i] = w[i-16] + s0 + w[i-7] + s1;
+      }
+      uint32_t a=h[0], b=h[1], c=h[2], d=h[3], e=h[4], f=h[5], g=h[6], hh=h[7];
+      for (int i=0; i<64; ++i) {
+        uint32_t t1 = hh + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g))
+                    + sha256_k[i] + w[i];
+        uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        hh = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+      }
+      h[0]+=a; h[1]+=b; h[2]+=c; h[3]+=d; h[4]+=e; h[5]+=f; h[6]+=g; h[7]+=hh;
+    }
+
+  } // namespace
+
+  CompileCache::CompileCache(const std::string& dir, casadi_int max_size) :
+    dir_(dir), max_size_(max_size) {
+    casadi_assert(!dir_.empty(), "Cache directory must be specified");
+    make_dirs(dir_);
+  }
+
+  std::string CompileCache::default_dir() {
+    const char* dir = getenv("CASADI_CACHE_DIR");
+    if (dir && *dir) return dir;
+    dir = getenv("XDG_CACHE_HOME");
+    if (dir && *dir) return std::string(dir) + "/casadi";
+#ifdef _WIN32
+    dir = getenv("LOCALAPPDATA");
+    if (dir && *dir) return std::string(dir) + "\\casadi\\cache";
+#else // _WIN32
+    dir = getenv("HOME");
+    if (dir && *dir) return std::string(dir) + "/.cache/casadi";
+#endif // _WIN32
+    return "casadi_cache";
+  }
+
+  std::string CompileCache::hash(const std::string& data) {
+    uint32_t h[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                     0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+    // Whole blocks
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data.data());
+    size_t n = data.size();
+    size_t n_full = n / 64;
+    for (size_t i=0; i<n_full; ++i) sha256_block(h, p + 64*i);
+    // Padding and message length in bits
+    unsigned char tail[128] = {0};
+    size_t rem = n - 64*n_full;
+    std::copy(p + 64*n_full, p + n, tail);
+    tail[rem] = 0x80;
+    size_t n_tail = rem + 9 <= 64 ? 64 : 128;
+    uint64_t n_bits = static_cast<uint64_t>(n) * 8;
+    for (int i=0; i<8; ++i) tail[n_tail-1-i] = (n_bits >> (8*i)) & 0xFF;
+    for (size_t i=0; i<n_tail; i+=64) sha256_block(h, tail + i);
+    // Hexadecimal digest
+    std::stringstream ss;
+    ss << std::hex << std::setfill('0');
+    for (int i=0; i<8; ++i) ss << std::setw(8) << h[i];
+    return ss.str();
+  }
+
+  std::string CompileCache::path(const std::string& key, const std::string& suffix) const {
+    return dir_ + "/" + key + suffix;
+  }
+
+  bool CompileCache::lookup(const std::string& key, const std::string& suffix) {
+    std::string p = path(key, suffix);
+    casadi_int size;
+    time_t mtime;
+    if (!file_stat(p, size, mtime)) return false;
+    // Mark as recently used
+#ifdef _WIN32
+    _utime(p.c_str(), nullptr);
+#else // _WIN32
+    utime(p.c_str(), nullptr);
+#endif // _WIN32
+    return true;
+  }
+
+  std::string CompileCache::publish(const std::string& key, const std::string& suffix,
+                                    const std::string& file) {
+    std::string p = path(key, suffix);
+    // Copy to a temporary file in the cache directory
+    std::string tmp = temporary_file(dir_ + "/" + key + ".", TMP_SUFFIX);
+    {
+      std::ifstream src(file, std::ios::binary);
+      casadi_assert(src.good(), "Cannot read " + file);
+      std::ofstream dst(tmp, std::ios::binary | std::ios::trunc);
+      dst << src.rdbuf();
+      casadi_assert(dst.good(), "Cannot write " + tmp);
+    }
+    // Atomic replace, concurrent writers publish identical contents
+#ifdef _WIN32
+    bool fail = !MoveFileExA(tmp.c_str(), p.c_str(), MOVEFILE_REPLACE_EXISTING);
+#else // _WIN32
+    bool fail = rename(tmp.c_str(), p.c_str())!=0;
+#endif // _WIN32
+    if (fail) {
+      remove(tmp.c_str());
+      casadi_error("Failed to publish " + p);
+    }
+    evict(key + suffix);
+    return p;
+  }
+
+  void CompileCache::evict(const std::string& keep) {
+    std::vector<CacheEntry> entries = list_dir(dir_);
+    time_t now = time(nullptr);
+    casadi_int total = 0;
+    std::vector<CacheEntry> cached;
+    for (const CacheEntry& e : entries) {
+      if (ends_with(e.name, TMP_SUFFIX)) {
+        // Remove temporary files abandoned by crashed processes
+        if (difftime(now, e.mtime) > TMP_MAX_AGE) remove((dir_ + "/" + e.name).c_str());
+      } else {
+        total += e.size;
+        cached.push_back(e);
+      }
+    }
+    if (max_size_<0 || total<=max_size_) return;
+    // Least recently used first
+    std::sort(cached.begin(), cached.end(),
+      [](const CacheEntry& a, const CacheEntry& b) { return a.mtime < b.mtime;});
+    for (const CacheEntry& e : cached) {
+      if (total<=max_size_) break;
+      if (e.name==keep) continue;
+      if (remove((dir_ + "/" + e.name).c_str())==0) total -= e.size;
+    }
+  }
+
+} // namespace casadi
@@ -0,0 +1,90 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_COMPILE_CACHE_HPP
+#define CASADI_COMPILE_CACHE_HPP
+
+#include "casadi_common.hpp"
+
+/// \cond INTERNAL
+
+namespace casadi {
+
+  /** \brief Persistent, content-addressed cache of compiled binaries
+
+      Entries are files named after a key, typically the hash of the source code
+      together with the compiler command, in a cache directory shared by all
+      processes. New entries are first written to a temporary file in the cache
+      directory and then renamed, so that concurrent processes never see a
+      partially written entry. Looking up an entry refreshes its modification
+      time, and when the total size of the directory exceeds a limit, the least
+      recently used entries are removed.
+  */
+  class CASADI_EXPORT CompileCache {
+  public:
+    /** \brief Constructor
+     *  \param dir Cache directory, created if it does not exist
+     *  \param max_size Maximum total size in bytes, no limit if negative
+     */
+    CompileCache(const std::string& dir, casadi_int max_size);
+
+    /** \brief Default cache directory
+     *  Environment variable CASADI_CACHE_DIR if set, otherwise
+     *  $XDG_CACHE_HOME/casadi or $HOME/.cache/casadi
+     */
+    static std::string default_dir();
+
+    /// SHA-256 digest of a string, in hexadecimal
+    static std::string hash(const std::string& data);
+
+    /// Location of an entry
+    std::string path(const std::string& key, const std::string& suffix) const;
+
+    /// Check if an entry exists and mark it as recently used
+    bool lookup(const std::string& key, const std::string& suffix);
+
+    /** \brief Move a file into the cache, atomically
+     *  \return Location of the entry
+     */
+    std::string publish(const std::string& key, const std::string& suffix,
+                        const std::string& file);
+
+    /** \brief Remove least recently used entries until the size limit is met
+     *  \param keep Name of a file in the cache directory that must not be removed
+     */
+    void evict(const std::string& keep=std::string());
+
+  private:
+    // Cache directory
+    std::string dir_;
+
+    // Maximum total size in bytes
+    casadi_int max_size_;
+  };
+
+} // namespace casadi
+/// \endcond
+
+#endif // CASADI_COMPILE_CACHE_HPP
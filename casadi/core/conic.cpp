@@ -673,6 +673,91 @@ namespace casadi {
     mem.AT = A_.transpose(mem.A_mapping);
   }
 
+  void Conic::detect_ocp_structure(casadi_int& N, std::vector<casadi_int>& nx,
+      std::vector<casadi_int>& nu, std::vector<casadi_int>& ng) const {
+    nx.clear();
+    nu.clear();
+    ng.clear();
+
+    /* General strategy: look for the xk+1 diagonal part in A
+    */
+
+    // Find the right-most column for each row in A -> A_skyline
+    // Find the second-to-right-most column -> A_skyline2
+    // Find the left-most column -> A_bottomline
+    Sparsity AT = A_.T();
+    std::vector<casadi_int> A_skyline;
+    std::vector<casadi_int> A_skyline2;
+    std::vector<casadi_int> A_bottomline;
+    for (casadi_int i=0;i<AT.size2();++i) {
+      casadi_int pivot = AT.colind()[i+1];
+      A_bottomline.push_back(AT.row()[AT.colind()[i]]);
+      if (pivot>AT.colind()[i]) {
+        A_skyline.push_back(AT.row()[pivot-1]);
+        if (pivot>AT.colind()[i]+1) {
+          A_skyline2.push_back(AT.row()[pivot-2]);
+        } else {
+          A_skyline2.push_back(-1);
+        }
+      } else {
+        A_skyline.push_back(-1);
+        A_skyline2.push_back(-1);
+      }
+    }
+
+    /*
+    Loop over the right-most columns of A:
+    they form the diagonal part due to xk+1 in gap constraints.
+    detect when the diagonal pattern is broken -> new stage
+    */
+    casadi_int pivot = 0; // Current right-most element
+    casadi_int start_pivot = pivot; // First right-most element that started the stage
+    casadi_int cg = 0; // Counter for non-gap-closing constraints
+    for (casadi_int i=0;i<na_;++i) { // Loop over all rows
+      bool commit = false; // Set true to jump to the stage
+      if (A_skyline[i]>pivot+1) { // Jump to a diagonal in the future
+        nu.push_back(A_skyline[i]-pivot-1); // Size of jump equals number of states
+        commit = true;
+      } else if (A_skyline[i]==pivot+1) { // Walking the diagonal
+        if (A_skyline2[i]<start_pivot) { // Free of below-diagonal entries?
+          pivot++;
+        } else {
+          nu.push_back(0); // We cannot but conclude that we arrived at a new stage
+          commit = true;
+        }
+      } else { // non-gap-closing constraint detected
+        cg++;
+      }
+
+      if (commit) {
+        nx.push_back(pivot-start_pivot+1);
+        ng.push_back(cg); cg=0;
+        start_pivot = A_skyline[i];
+        pivot = A_skyline[i];
+      }
+    }
+    nx.push_back(pivot-start_pivot+1);
+    casadi_assert(!nu.empty(), "Could not detect a stagewise structure in A.");
+
+    // Correction for k==0
+    nx[0] = A_skyline[0];
+    nu[0] = 0;
+    ng.erase(ng.begin());
+    casadi_int cN=0;
+    for (casadi_int i=na_-1;i>=0;--i) {
+      if (A_bottomline[i]<start_pivot) break;
+      cN++;
+    }
+    ng.push_back(cg-cN);
+    ng.push_back(cN);
+
+    N = nu.size();
+    if (verbose_) {
+      casadi_message("Detected structure: N " + str(N) + ", nx " + str(nx) + ", "
+        "nu " + str(nu) + ", ng " + str(ng) + ".");
+    }
+  }
+
   Dict Conic::get_stats(void* mem) const {
     Dict stats = FunctionInternal::get_stats(mem);
     auto m = static_cast<ConicMemory*>(mem);
@@ -175,6 +175,19 @@ namespace casadi {
     /// SDP to SOCP conversion initialization
     void sdp_to_socp_init(SDPToSOCPMem& mem) const;
 
+    /** \brief Detect the stagewise structure of an optimal control problem
+
+        The constraint matrix is expected to be laid out as
+          A B I
+          C D
+              A B I
+              C D
+        with nx of length N+1, nu of length N and ng of length N+1.
+        The controls of the first stage are lumped with its states.
+    */
+    void detect_ocp_structure(casadi_int& N, std::vector<casadi_int>& nx,
+      std::vector<casadi_int>& nu, std::vector<casadi_int>& ng) const;
+
     void serialize(SerializingStream &s, const SDPToSOCPMem& m) const;
     void deserialize(DeserializingStream &s, SDPToSOCPMem& m);
 
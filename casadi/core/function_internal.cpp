@@ -892,9 +892,10 @@ namespace casadi {
 
   /// \cond INTERNAL
 
-  void bvec_toggle(bvec_t* s, casadi_int begin, casadi_int end, casadi_int j) {
+  void bvec_toggle(bvec_t* s, casadi_int begin, casadi_int end, casadi_int j,
+                   casadi_int stride=1) {
     for (casadi_int i=begin; i<end; ++i) {
-      s[i] ^= (bvec_t(1) << j);
+      s[i*stride] ^= (bvec_t(1) << j);
     }
   }
 
@@ -905,9 +906,10 @@ namespace casadi {
   }
 
 
-  void bvec_or(const bvec_t* s, bvec_t & r, casadi_int begin, casadi_int end) {
+  void bvec_or(const bvec_t* s, bvec_t & r, casadi_int begin, casadi_int end,
+               casadi_int stride=1) {
     r = 0;
-    for (casadi_int i=begin; i<end; ++i) r |= s[i];
+    for (casadi_int i=begin; i<end; ++i) r |= s[i*stride];
   }
   /// \endcond
 
@@ -935,6 +937,27 @@ namespace casadi {
         if (!f->is_diff_out_[i] && res[i]) casadi_clear(res[i], f->nnz_out(i));
       }
     }
+    static inline void sp(const FunctionInternal *f,
+                          const bvec_t** arg, bvec_t** res,
+                          casadi_int* iw, bvec_t* w, void* mem, casadi_int nw) {
+      if (nw==1) return sp(f, arg, res, iw, w, mem);
+      std::vector<const bvec_t*> argm(f->sz_arg(), nullptr);
+      std::vector<bvec_t> wm(nw*f->nnz_in(), bvec_t(0));
+      bvec_t* wp = get_ptr(wm);
+
+      for (casadi_int i=0;i<f->n_in_;++i) {
+        if (f->is_diff_in_[i]) {
+          argm[i] = arg[i];
+        } else  {
+          argm[i] = arg[i] ? wp : nullptr;
+          wp += nw*f->nnz_in(i);
+        }
+      }
+      f->sp_forward_wide(get_ptr(argm), res, iw, w, mem, nw);
+      for (casadi_int i=0;i<f->n_out_;++i) {
+        if (!f->is_diff_out_[i] && res[i]) casadi_clear(res[i], nw*f->nnz_out(i));
+      }
+    }
   };
   template<> struct JacSparsityTraits<false> {
     typedef bvec_t* arg_t;
@@ -949,6 +972,18 @@ namespace casadi {
         if (!f->is_diff_in_[i] && arg[i]) casadi_clear(arg[i], f->nnz_in(i));
       }
     }
+    static inline void sp(const FunctionInternal *f,
+                          bvec_t** arg, bvec_t** res,
+                          casadi_int* iw, bvec_t* w, void* mem, casadi_int nw) {
+      if (nw==1) return sp(f, arg, res, iw, w, mem);
+      for (casadi_int i=0;i<f->n_out_;++i) {
+        if (!f->is_diff_out_[i] && res[i]) casadi_clear(res[i], nw*f->nnz_out(i));
+      }
+      f->sp_reverse_wide(arg, res, iw, w, mem, nw);
+      for (casadi_int i=0;i<f->n_in_;++i) {
+        if (!f->is_diff_in_[i] && arg[i]) casadi_clear(arg[i], nw*f->nnz_in(i));
+      }
+    }
   };
 
   template<bool fwd>
@@ -959,27 +994,35 @@ namespace casadi {
     casadi_int nz_in = nnz_in(iind);
     casadi_int nz_out = nnz_out(oind);
 
+    // Bit vectors per nonzero and directions per sweep
+    casadi_int nw = sp_width();
+    casadi_int ndir = nw*bvec_size;
+
     // Evaluation buffers
     vector<typename JacSparsityTraits<fwd>::arg_t> arg(sz_arg(), nullptr);
     vector<bvec_t*> res(sz_res(), nullptr);
     vector<casadi_int> iw(sz_iw());
-    vector<bvec_t> w(sz_w(), 0);
+    vector<bvec_t> w(nw*sz_w(), 0);
 
     // Seeds and sensitivities
-    vector<bvec_t> seed(nz_in, 0);
+    vector<bvec_t> seed(nw*nz_in, 0);
     arg[iind] = get_ptr(seed);
-    vector<bvec_t> sens(nz_out, 0);
+    vector<bvec_t> sens(nw*nz_out, 0);
     res[oind] = get_ptr(sens);
     if (!fwd) std::swap(seed, sens);
 
+    // Number of nonzeros in the seed and sensitivity directions
+    casadi_int nz_seed = fwd ? nz_in : nz_out;
+    casadi_int nz_sens = fwd ? nz_out : nz_in;
+
     // Number of forward sweeps we must make
-    casadi_int nsweep = seed.size() / bvec_size;
-    if (seed.size() % bvec_size) nsweep++;
+    casadi_int nsweep = nz_seed / ndir;
+    if (nz_seed % ndir) nsweep++;
 
     // Print
     if (verbose_) {
       casadi_message(str(nsweep) + string(fwd ? " forward" : " reverse") + " sweeps "
-                     "needed for " + str(seed.size()) + " directions");
+                     "needed for " + str(nz_seed) + " directions");
     }
 
     // Progress
@@ -988,7 +1031,7 @@ namespace casadi {
     // Temporary vectors
     std::vector<casadi_int> jcol, jrow;
 
-    // Loop over the variables, bvec_size variables at a time
+    // Loop over the variables, ndir variables at a time
     for (casadi_int s=0; s<nsweep; ++s) {
 
       // Print progress
@@ -1002,42 +1045,47 @@ namespace casadi {
       }
 
       // Nonzero offset
-      casadi_int offset = s*bvec_size;
+      casadi_int offset = s*ndir;
 
       // Number of local seed directions
-      casadi_int ndir_local = seed.size()-offset;
-      ndir_local = std::min(static_cast<casadi_int>(bvec_size), ndir_local);
+      casadi_int ndir_local = nz_seed-offset;
+      ndir_local = std::min(ndir, ndir_local);
 
+      // Direction i is bit i%bvec_size of bit vector i/bvec_size
       for (casadi_int i=0; i<ndir_local; ++i) {
-        seed[offset+i] |= bvec_t(1)<<i;
+        seed[(offset+i)*nw+i/bvec_size] |= bvec_t(1)<<(i%bvec_size);
       }
 
       // Propagate the dependencies
       JacSparsityTraits<fwd>::sp(this, get_ptr(arg), get_ptr(res),
-                                  get_ptr(iw), get_ptr(w), memory(0));
+                                  get_ptr(iw), get_ptr(w), memory(0), nw);
 
       // Loop over the nonzeros of the output
-      for (casadi_int el=0; el<sens.size(); ++el) {
+      for (casadi_int el=0; el<nz_sens; ++el) {
+        for (casadi_int j=0; j*bvec_size<ndir_local; ++j) {
 
-        // Get the sparsity sensitivity
-        bvec_t spsens = sens[el];
+          // Get the sparsity sensitivity
+          bvec_t spsens = sens[el*nw+j];
 
-        if (!fwd) {
-          // Clear the sensitivities for the next sweep
-          sens[el] = 0;
-        }
+          if (!fwd) {
+            // Clear the sensitivities for the next sweep
+            sens[el*nw+j] = 0;
+          }
 
-        // If there is a dependency in any of the directions
-        if (spsens!=0) {
+          // If there is a dependency in any of the directions
+          if (spsens!=0) {
 
-          // Loop over seed directions
-          for (casadi_int i=0; i<ndir_local; ++i) {
+            // Loop over seed directions
+            casadi_int ndir_j = std::min(static_cast<casadi_int>(bvec_size),
+                                         ndir_local-j*bvec_size);
+            for (casadi_int i=0; i<ndir_j; ++i) {
 
-            // If dependents on the variable
-            if ((bvec_t(1) << i) & spsens) {
-              // Add to pattern
-              jcol.push_back(el);
-              jrow.push_back(i+offset);
+              // If dependents on the variable
+              if ((bvec_t(1) << i) & spsens) {
+                // Add to pattern
+                jcol.push_back(el);
+                jrow.push_back(j*bvec_size+i+offset);
+              }
             }
           }
         }
@@ -1045,7 +1093,7 @@ namespace casadi {
 
       // Remove the seeds
       for (casadi_int i=0; i<ndir_local; ++i) {
-        seed[offset+i] = 0;
+        seed[(offset+i)*nw+i/bvec_size] = 0;
       }
     }
 
@@ -1067,18 +1115,21 @@ namespace casadi {
     casadi_int nz = nnz_in(iind);
     casadi_assert_dev(nz==nnz_out(oind));
 
+    // Maximum number of bit vectors per nonzero
+    casadi_int nw_max = sp_width();
+
     // Evaluation buffers
     vector<const bvec_t*> arg(sz_arg(), nullptr);
     vector<bvec_t*> res(sz_res(), nullptr);
     vector<casadi_int> iw(sz_iw());
-    vector<bvec_t> w(sz_w());
+    vector<bvec_t> w(nw_max*sz_w());
 
     // Seeds
-    vector<bvec_t> seed(nz, 0);
+    vector<bvec_t> seed(nw_max*nz, 0);
     arg[iind] = get_ptr(seed);
 
     // Sensitivities
-    vector<bvec_t> sens(nz, 0);
+    vector<bvec_t> sens(nw_max*nz, 0);
     res[oind] = get_ptr(sens);
 
     // Sparsity triplet accumulator
@@ -1152,12 +1203,17 @@ namespace casadi {
         n_fine_blocks_max = std::max(n_fine_blocks_max, del);
       }
 
+      // Bit vectors per nonzero and directions per sweep, no more than needed
+      casadi_int nw = D.size2()*n_fine_blocks_max;
+      nw = std::max(casadi_int(1), std::min(nw_max, (nw+bvec_size-1)/bvec_size));
+      casadi_int ndir = nw*bvec_size;
+
       // Loop over all coarse seed directions from the coloring
       for (casadi_int csd=0; csd<D.size2(); ++csd) {
 
 
         casadi_int fci_offset = 0;
-        casadi_int fci_cap = bvec_size-bvec_i;
+        casadi_int fci_cap = ndir-bvec_i;
 
         // Flag to indicate if all fine blocks have been handled
         bool f_finished = false;
@@ -1192,8 +1248,9 @@ namespace casadi {
               }
 
               // Toggle on seeds
-              bvec_toggle(get_ptr(seed), fine[fci+fci_start], fine[fci+fci_start+1],
-                          bvec_i+bvec_i_mod);
+              casadi_int dir = bvec_i+bvec_i_mod;
+              bvec_toggle(get_ptr(seed) + dir/bvec_size, fine[fci+fci_start],
+                          fine[fci+fci_start+1], dir%bvec_size, nw);
               bvec_i_mod++;
             }
           }
@@ -1202,28 +1259,28 @@ namespace casadi {
           bvec_i+= min(n_fine_blocks_max, fci_cap);
 
           // Check if bvec buffer is full
-          if (bvec_i==bvec_size || csd==D.size2()-1) {
-            // Calculate sparsity for bvec_size directions at once
+          if (bvec_i==ndir || csd==D.size2()-1) {
+            // Calculate sparsity for ndir directions at once
 
             // Statistics
             nsweeps+=1;
 
             // Construct lookup table
             IM lookup = IM::triplet(lookup_row, lookup_col, lookup_value,
-                                    bvec_size, coarse.size());
+                                    ndir, coarse.size());
 
             std::reverse(lookup_col.begin(), lookup_col.end());
             std::reverse(lookup_row.begin(), lookup_row.end());
             std::reverse(lookup_value.begin(), lookup_value.end());
             IM duplicates =
-              IM::triplet(lookup_row, lookup_col, lookup_value, bvec_size, coarse.size())
+              IM::triplet(lookup_row, lookup_col, lookup_value, ndir, coarse.size())
               - lookup;
             duplicates = sparsify(duplicates);
-            lookup(duplicates.sparsity()) = -bvec_size;
+            lookup(duplicates.sparsity()) = -ndir;
 
             // Propagate the dependencies
             JacSparsityTraits<true>::sp(this, get_ptr(arg), get_ptr(res),
-              get_ptr(iw), get_ptr(w), nullptr);
+              get_ptr(iw), get_ptr(w), nullptr, nw);
 
             // Temporary bit work vector
             bvec_t spsens;
@@ -1233,21 +1290,24 @@ namespace casadi {
 
               // Loop over the cols of fine blocks within the current coarse block
               for (casadi_int fri=fine_lookup[coarse[cri]];fri<fine_lookup[coarse[cri+1]];++fri) {
-                // Lump individual sensitivities together into fine block
-                bvec_or(get_ptr(sens), spsens, fine[fri], fine[fri+1]);
-
-                // Loop over all bvec_bits
-                for (casadi_int bvec_i=0;bvec_i<bvec_size;++bvec_i) {
-                  if (spsens & (bvec_t(1) << bvec_i)) {
-                    // if dependency is found, add it to the new sparsity pattern
-                    casadi_int ind = lookup.sparsity().get_nz(bvec_i, cri);
-                    if (ind==-1) continue;
-                    casadi_int lk = lookup->at(ind);
-                    if (lk>-bvec_size) {
-                      jrow.push_back(bvec_i+lk);
-                      jcol.push_back(fri);
-                      jrow.push_back(fri);
-                      jcol.push_back(bvec_i+lk);
+                for (casadi_int j=0; j<nw; ++j) {
+                  // Lump individual sensitivities together into fine block
+                  bvec_or(get_ptr(sens) + j, spsens, fine[fri], fine[fri+1], nw);
+
+                  // Loop over all bvec_bits
+                  for (casadi_int bvec_i=0;bvec_i<bvec_size;++bvec_i) {
+                    if (spsens & (bvec_t(1) << bvec_i)) {
+                      // if dependency is found, add it to the new sparsity pattern
+                      casadi_int dir = j*bvec_size+bvec_i;
+                      casadi_int ind = lookup.sparsity().get_nz(dir, cri);
+                      if (ind==-1) continue;
+                      casadi_int lk = lookup->at(ind);
+                      if (lk>-ndir) {
+                        jrow.push_back(dir+lk);
+                        jcol.push_back(fri);
+                        jrow.push_back(fri);
+                        jcol.push_back(dir+lk);
+                      }
                     }
                   }
                 }
@@ -1266,7 +1326,7 @@ namespace casadi {
           if (n_fine_blocks_max>fci_cap) {
             fci_offset += min(n_fine_blocks_max, fci_cap);
             bvec_i = 0;
-            fci_cap = bvec_size;
+            fci_cap = ndir;
           } else {
             f_finished = true;
           }
@@ -1302,9 +1362,12 @@ namespace casadi {
     // Number of nonzero outputs
     casadi_int nz_out = nnz_out(oind);
 
+    // Maximum number of bit vectors per nonzero
+    casadi_int nw_max = sp_width();
+
     // Seeds and sensitivities
-    vector<bvec_t> s_in(nz_in, 0);
-    vector<bvec_t> s_out(nz_out, 0);
+    vector<bvec_t> s_in(nw_max*nz_in, 0);
+    vector<bvec_t> s_out(nw_max*nz_out, 0);
 
     // Evaluation buffers
     vector<const bvec_t*> arg_fwd(sz_arg(), nullptr);
@@ -1313,7 +1376,7 @@ namespace casadi {
     vector<bvec_t*> res(sz_res(), nullptr);
     res[oind] = get_ptr(s_out);
     vector<casadi_int> iw(sz_iw());
-    vector<bvec_t> w(sz_w());
+    vector<bvec_t> w(nw_max*sz_w());
 
     // Sparsity triplet accumulator
     std::vector<casadi_int> jcol, jrow;
@@ -1401,7 +1464,7 @@ namespace casadi {
       casadi_int nz_sens = use_fwd ? nz_out : nz_in;
 
       // Clear the seeds
-      for (casadi_int i=0; i<nz_seed; ++i) seed_v[i]=0;
+      for (casadi_int i=0; i<nw_max*nz_seed; ++i) seed_v[i]=0;
 
       // Choose the active jacobian coloring scheme
       Sparsity D = use_fwd ? D1 : D2;
@@ -1455,11 +1518,16 @@ namespace casadi {
         n_fine_blocks_max = std::max(n_fine_blocks_max, del);
       }
 
+      // Bit vectors per nonzero and directions per sweep, no more than needed
+      casadi_int nw = D.size2()*n_fine_blocks_max;
+      nw = std::max(casadi_int(1), std::min(nw_max, (nw+bvec_size-1)/bvec_size));
+      casadi_int ndir = nw*bvec_size;
+
       // Loop over all coarse seed directions from the coloring
       for (casadi_int csd=0; csd<D.size2(); ++csd) {
 
         casadi_int fci_offset = 0;
-        casadi_int fci_cap = bvec_size-bvec_i;
+        casadi_int fci_cap = ndir-bvec_i;
 
         // Flag to indicate if all fine blocks have been handled
         bool f_finished = false;
@@ -1492,8 +1560,9 @@ namespace casadi {
               }
 
               // Toggle on seeds
-              bvec_toggle(seed_v, fine_row[fci+fci_start], fine_row[fci+fci_start+1],
-                          bvec_i+bvec_i_mod);
+              casadi_int dir = bvec_i+bvec_i_mod;
+              bvec_toggle(seed_v + dir/bvec_size, fine_row[fci+fci_start],
+                          fine_row[fci+fci_start+1], dir%bvec_size, nw);
               bvec_i_mod++;
             }
           }
@@ -1502,24 +1571,24 @@ namespace casadi {
           bvec_i+= min(n_fine_blocks_max, fci_cap);
 
           // Check if bvec buffer is full
-          if (bvec_i==bvec_size || csd==D.size2()-1) {
-            // Calculate sparsity for bvec_size directions at once
+          if (bvec_i==ndir || csd==D.size2()-1) {
+            // Calculate sparsity for ndir directions at once
 
             // Statistics
             nsweeps+=1;
 
             // Construct lookup table
-            IM lookup = IM::triplet(lookup_row, lookup_col, lookup_value, bvec_size,
+            IM lookup = IM::triplet(lookup_row, lookup_col, lookup_value, ndir,
                                     coarse_col.size());
 
             // Propagate the dependencies
             if (use_fwd) {
               JacSparsityTraits<true>::sp(this, get_ptr(arg_fwd), get_ptr(res),
-                get_ptr(iw), get_ptr(w), memory(0));
+                get_ptr(iw), get_ptr(w), memory(0), nw);
             } else {
               fill(w.begin(), w.end(), 0);
               JacSparsityTraits<false>::sp(this, get_ptr(arg_adj), get_ptr(res),
-                get_ptr(iw), get_ptr(w), memory(0));
+                get_ptr(iw), get_ptr(w), memory(0), nw);
             }
 
             // Temporary bit work vector
@@ -1531,20 +1600,23 @@ namespace casadi {
               // Loop over the cols of fine blocks within the current coarse block
               for (casadi_int fri=fine_col_lookup[coarse_col[cri]];
                    fri<fine_col_lookup[coarse_col[cri+1]];++fri) {
-                // Lump individual sensitivities together into fine block
-                bvec_or(sens_v, spsens, fine_col[fri], fine_col[fri+1]);
-
-                // Next iteration if no sparsity
-                if (!spsens) continue;
-
-                // Loop over all bvec_bits
-                for (casadi_int bvec_i=0;bvec_i<bvec_size;++bvec_i) {
-                  if (spsens & bvec_lookup[bvec_i]) {
-                    // if dependency is found, add it to the new sparsity pattern
-                    casadi_int ind = lookup.sparsity().get_nz(bvec_i, cri);
-                    if (ind==-1) continue;
-                    jrow.push_back(bvec_i+lookup->at(ind));
-                    jcol.push_back(fri);
+                for (casadi_int j=0; j<nw; ++j) {
+                  // Lump individual sensitivities together into fine block
+                  bvec_or(sens_v + j, spsens, fine_col[fri], fine_col[fri+1], nw);
+
+                  // Next iteration if no sparsity
+                  if (!spsens) continue;
+
+                  // Loop over all bvec_bits
+                  for (casadi_int bvec_i=0;bvec_i<bvec_size;++bvec_i) {
+                    if (spsens & bvec_lookup[bvec_i]) {
+                      // if dependency is found, add it to the new sparsity pattern
+                      casadi_int dir = j*bvec_size+bvec_i;
+                      casadi_int ind = lookup.sparsity().get_nz(dir, cri);
+                      if (ind==-1) continue;
+                      jrow.push_back(dir+lookup->at(ind));
+                      jcol.push_back(fri);
+                    }
                   }
                 }
               }
@@ -1565,7 +1637,7 @@ namespace casadi {
           if (n_fine_blocks_max>fci_cap) {
             fci_offset += min(n_fine_blocks_max, fci_cap);
             bvec_i = 0;
-            fci_cap = bvec_size;
+            fci_cap = ndir;
           } else {
             f_finished = true;
           }
@@ -2120,7 +2192,7 @@ namespace casadi {
   void FunctionInternal::codegen(CodeGenerator& g, const std::string& fname) const {
     // Define function
     g << "/* " << definition() << " */\n";
-    g << "static " << signature(fname) << " {\n";
+    g << g.declare_internal(signature(fname)) << " {\n";
 
     // Reset local variables, flush buffer
     g.flush(g.body);
@@ -2523,6 +2595,57 @@ namespace casadi {
     return 0;
   }
 
+  int FunctionInternal::sp_forward_wide(const bvec_t** arg, bvec_t** res, casadi_int* iw,
+                                        bvec_t* w, void* mem, casadi_int nw) const {
+    // One bit vector per nonzero, remaining pointers are work
+    std::vector<bvec_t> a1(nnz_in()), r1(nnz_out());
+    std::vector<const bvec_t*> arg1(arg, arg + sz_arg());
+    std::vector<bvec_t*> res1(res, res + sz_res());
+    for (casadi_int i=0, k=0; i<n_in_; k+=nnz_in(i++)) arg1[i] = arg[i] ? &a1[k] : nullptr;
+    for (casadi_int i=0, k=0; i<n_out_; k+=nnz_out(i++)) res1[i] = res[i] ? &r1[k] : nullptr;
+    for (casadi_int j=0; j<nw; ++j) {
+      for (casadi_int i=0, k=0; i<n_in_; k+=nnz_in(i++)) {
+        if (arg[i]) for (casadi_int el=0; el<nnz_in(i); ++el) a1[k+el] = arg[i][el*nw+j];
+      }
+      if (sp_forward(get_ptr(arg1), get_ptr(res1), iw, w, mem)) return 1;
+      for (casadi_int i=0, k=0; i<n_out_; k+=nnz_out(i++)) {
+        if (res[i]) for (casadi_int el=0; el<nnz_out(i); ++el) res[i][el*nw+j] = r1[k+el];
+      }
+    }
+    return 0;
+  }
+
+  int FunctionInternal::sp_reverse_wide(bvec_t** arg, bvec_t** res, casadi_int* iw,
+                                        bvec_t* w, void* mem, casadi_int nw) const {
+    // One bit vector per nonzero, remaining pointers are work
+    std::vector<bvec_t> a1(nnz_in()), r1(nnz_out());
+    std::vector<bvec_t*> arg1(arg, arg + sz_arg());
+    std::vector<bvec_t*> res1(res, res + sz_res());
+    for (casadi_int i=0, k=0; i<n_in_; k+=nnz_in(i++)) arg1[i] = arg[i] ? &a1[k] : nullptr;
+    for (casadi_int i=0, k=0; i<n_out_; k+=nnz_out(i++)) res1[i] = res[i] ? &r1[k] : nullptr;
+    for (casadi_int j=0; j<nw; ++j) {
+      for (casadi_int i=0, k=0; i<n_in_; k+=nnz_in(i++)) {
+        if (arg[i]) for (casadi_int el=0; el<nnz_in(i); ++el) a1[k+el] = arg[i][el*nw+j];
+      }
+      for (casadi_int i=0, k=0; i<n_out_; k+=nnz_out(i++)) {
+        if (res[i]) for (casadi_int el=0; el<nnz_out(i); ++el) r1[k+el] = res[i][el*nw+j];
+      }
+      if (sp_reverse(get_ptr(arg1), get_ptr(res1), iw, w, mem)) return 1;
+      for (casadi_int i=0, k=0; i<n_in_; k+=nnz_in(i++)) {
+        if (arg[i]) for (casadi_int el=0; el<nnz_in(i); ++el) arg[i][el*nw+j] = a1[k+el];
+      }
+      for (casadi_int i=0, k=0; i<n_out_; k+=nnz_out(i++)) {
+        if (res[i]) for (casadi_int el=0; el<nnz_out(i); ++el) res[i][el*nw+j] = r1[k+el];
+      }
+    }
+    return 0;
+  }
+
+  casadi_int FunctionInternal::sp_width() const {
+    if (!has_sp_wide()) return 1;
+    return std::max(GlobalOptions::sparsity_width, casadi_int(1));
+  }
+
   void FunctionInternal::sz_work(size_t& sz_arg, size_t& sz_res,
                                  size_t& sz_iw, size_t& sz_w) const {
     sz_arg = this->sz_arg();
@@ -128,6 +128,9 @@ namespace casadi {
     /// Memory objects
     void* memory(int ind) const;
 
+    /// Number of memory objects
+    casadi_int n_mem() const { return mem_.size();}
+
     /** \brief Create memory block */
     virtual void* alloc_mem() const { return new ProtoFunctionMemory(); }
 
@@ -800,6 +803,24 @@ namespace casadi {
     /** \brief  Propagate sparsity backwards */
     virtual int sp_reverse(bvec_t** arg, bvec_t** res, casadi_int* iw, bvec_t* w, void* mem) const;
 
+    ///@{
+    /** \brief Propagate sparsity in nw bit vectors per nonzero at once
+     * Bit vector j of nonzero k of an input or output is stored at k*nw+j.
+     * The work vector has length nw*sz_w(). The default implementation
+     * propagates the bit vectors one at a time.
+     */
+    virtual int sp_forward_wide(const bvec_t** arg, bvec_t** res, casadi_int* iw, bvec_t* w,
+                                void* mem, casadi_int nw) const;
+    virtual int sp_reverse_wide(bvec_t** arg, bvec_t** res, casadi_int* iw, bvec_t* w,
+                                void* mem, casadi_int nw) const;
+    ///@}
+
+    /** \brief Is wide sparsity propagation faster than one bit vector at a time? */
+    virtual bool has_sp_wide() const { return false;}
+
+    /** \brief Number of bit vectors per nonzero in a sparsity sweep */
+    casadi_int sp_width() const;
+
     /** \brief Get number of temporary variables needed */
     void sz_work(size_t& sz_arg, size_t& sz_res, size_t& sz_iw, size_t& sz_w) const;
 
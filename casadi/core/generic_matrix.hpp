@@ -745,6 +745,18 @@ namespace casadi {
       shared(ex_output, v, vdef, v_prefix, v_suffix);
     }
 
+    /** \brief Common subexpression elimination
+     *
+     * Structurally equal subexpressions (same operation, same dependencies)
+     * are merged into a single node.
+     */
+    inline friend std::vector<MatType> cse(const std::vector<MatType>& e) {
+      return MatType::cse(e);
+    }
+    inline friend MatType cse(const MatType& e) {
+      return MatType::cse(std::vector<MatType>{e}).at(0);
+    }
+
     /** \brief Given a repeated matrix, computes the sum of repeated parts
      */
     inline friend MatType repsum(const MatType &A, casadi_int n, casadi_int m=1) {
@@ -36,7 +36,15 @@ namespace casadi {
 
   casadi_int GlobalOptions::max_num_dir = 64;
 
+  // Propagate 512 directions per sparsity sweep
+  casadi_int GlobalOptions::sparsity_width = 8;
+
   // By default, use zero-based indexing
   casadi_int GlobalOptions::start_index = 0;
 
+  // By default, use all hardware threads
+  casadi_int GlobalOptions::max_num_threads = 0;
+
+  bool GlobalOptions::thread_affinity = false;
+
 } // namespace casadi
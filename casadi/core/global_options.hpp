@@ -66,8 +66,14 @@ namespace casadi {
 
       static casadi_int max_num_dir;
 
+      static casadi_int sparsity_width;
+
       static casadi_int start_index;
 
+      static casadi_int max_num_threads;
+
+      static bool thread_affinity;
+
 #endif //SWIG
       // Setter and getter for simplification_on_the_fly
       static void setSimplificationOnTheFly(bool flag) { simplification_on_the_fly = flag; }
@@ -86,6 +92,22 @@ namespace casadi {
       static void setMaxNumDir(casadi_int ndir) { max_num_dir=ndir; }
       static casadi_int getMaxNumDir() { return max_num_dir; }
 
+      /** \brief Number of bit vectors propagated per nonzero in one sparsity sweep
+      * Each holds 64 directions. Only used by functions supporting wide propagation.
+      */
+      static void setSparsityWidth(casadi_int n) { sparsity_width=n; }
+      static casadi_int getSparsityWidth() { return sparsity_width; }
+
+      /** \brief Number of threads used for parallel evaluation (e.g. "thread" maps)
+      * Includes the calling thread. Zero means the number of hardware threads.
+      */
+      static void setMaxNumThreads(casadi_int n) { max_num_threads=n; }
+      static casadi_int getMaxNumThreads() { return max_num_threads; }
+
+      /** \brief Pin worker threads to individual cores (Linux only) */
+      static void setThreadAffinity(bool flag) { thread_affinity=flag; }
+      static bool getThreadAffinity() { return thread_affinity; }
+
   };
 
 } // namespace casadi
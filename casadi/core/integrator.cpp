@@ -24,6 +24,7 @@
 
 
 #include "integrator_impl.hpp"
+#include "rootfinder_impl.hpp"
 #include "casadi_misc.hpp"
 
 using namespace std;
@@ -61,6 +62,25 @@ namespace casadi {
     return intg->create_advanced(opts);
   }
 
+  Function parareal(const string& name, const string& solver,
+                    const SXDict& dae, const Dict& opts) {
+    return parareal(name, solver, Integrator::map2oracle("dae", dae), opts);
+  }
+
+  Function parareal(const string& name, const string& solver,
+                    const MXDict& dae, const Dict& opts) {
+    return parareal(name, solver, Integrator::map2oracle("dae", dae), opts);
+  }
+
+  Function parareal(const string& name, const string& solver,
+                    const Function& dae, const Dict& opts) {
+    // Make sure that dae is sound
+    if (dae.has_free()) {
+      casadi_error("Cannot create '" + name + "' since " + str(dae.get_free()) + " are free.");
+    }
+    return Integrator::parareal(name, solver, dae, opts);
+  }
+
   vector<string> integrator_in() {
     vector<string> ret(integrator_n_in());
     for (size_t i=0; i<ret.size(); ++i) ret[i]=integrator_in(i);
@@ -116,6 +136,8 @@ namespace casadi {
     // Default options
     print_stats_ = false;
     output_t0_ = false;
+    ne_ = 0;
+    max_events_ = 1000;
   }
 
   Integrator::~Integrator() {
@@ -177,15 +199,27 @@ namespace casadi {
     setup(m, arg, res, iw, w);
 
     // Reset solver, take time to t0
+    reset_stats(m);
     reset(m, grid_.front(), x0, z0, p);
 
+    // Clear the events of any previous call
+    if (ne_>0) {
+      m->event_times.clear();
+      m->event_indices.clear();
+      casadi_clear(get_ptr(m->q_acc), nq_);
+    }
+
     // Integrate forward
     for (casadi_int k=0; k<grid_.size(); ++k) {
       // Skip t0?
       if (k==0 && !output_t0_) continue;
 
       // Integrate forward
-      advance(m, grid_[k], x, z, q);
+      if (ne_>0) {
+        advance_events(m, grid_[k], p, x, z, q);
+      } else {
+        advance(m, grid_[k], x, z, q);
+      }
       if (x) x += nx_;
       if (z) z += nz_;
       if (q) q += nq_;
@@ -205,6 +239,61 @@ namespace casadi {
     return 0;
   }
 
+  void Integrator::advance_events(IntegratorMemory* m, double t, const double* p,
+                                  double* x, double* z, double* q) const {
+    while (true) {
+      // Integrate until t or the first event before it
+      m->event_index = -1;
+      advance(m, t, get_ptr(m->xe), get_ptr(m->ze), get_ptr(m->qe));
+
+      // Add the quadratures from before the last restart
+      casadi_axpy(nq_, 1., get_ptr(m->q_acc), get_ptr(m->qe));
+      if (m->event_index<0) break;
+
+      // Record the event
+      casadi_assert(m->event_times.size()<max_events_,
+        "Maximum number of events (" + str(max_events_) + ") reached at t="
+        + str(m->t_event));
+      m->event_times.push_back(m->t_event);
+      m->event_indices.push_back(m->event_index);
+      casadi_copy(get_ptr(m->qe), nq_, get_ptr(m->q_acc));
+
+      // State after the event
+      if (event_transition_.is_null()) {
+        casadi_copy(get_ptr(m->xe), nx_, get_ptr(m->x_plus));
+      } else {
+        double ind = static_cast<double>(m->event_index);
+        m->arg[0] = &m->t_event;
+        m->arg[1] = get_ptr(m->xe);
+        m->arg[2] = get_ptr(m->ze);
+        m->arg[3] = p;
+        m->arg[4] = &ind;
+        m->res[0] = get_ptr(m->x_plus);
+        casadi_assert(!calc_function(m, "event_transition"),
+          "Evaluation of 'event_transition' failed at t=" + str(m->t_event));
+      }
+
+      // Restart the integration from the event
+      reset(m, m->t_event, get_ptr(m->x_plus), get_ptr(m->ze), p);
+    }
+
+    // Return to user
+    casadi_copy(get_ptr(m->xe), nx_, x);
+    casadi_copy(get_ptr(m->ze), nz_, z);
+    casadi_copy(get_ptr(m->qe), nq_, q);
+  }
+
+  Dict Integrator::get_stats(void* mem) const {
+    Dict stats = OracleFunction::get_stats(mem);
+    if (ne_>0) {
+      auto m = static_cast<IntegratorMemory*>(mem);
+      stats["nevents"] = static_cast<casadi_int>(m->event_times.size());
+      stats["event_times"] = m->event_times;
+      stats["event_indices"] = m->event_indices;
+    }
+    return stats;
+  }
+
   const Options Integrator::options_
   = {{&OracleFunction::options_},
      {{"expand",
@@ -227,7 +316,14 @@ namespace casadi {
         "Options to be passed down to the augmented integrator, if one is constructed."}},
       {"output_t0",
        {OT_BOOL,
-        "Output the state at the initial time"}}
+        "Output the state at the initial time"}},
+      {"event_transition",
+       {OT_FUNCTION,
+        "State after an event, a function (t, x, z, p, index) -> x+ where index is "
+        "the component of 'event' that crossed zero. Default: the state is kept"}},
+      {"max_events",
+       {OT_INT,
+        "Maximum number of events in one integration. Default: 1000"}}
      }
   };
 
@@ -252,6 +348,10 @@ namespace casadi {
         t0 = op.second;
       } else if (op.first=="tf") {
         tf = op.second;
+      } else if (op.first=="event_transition") {
+        event_transition_ = op.second;
+      } else if (op.first=="max_events") {
+        max_events_ = op.second;
       }
     }
 
@@ -269,6 +369,9 @@ namespace casadi {
     ngrid_ = grid_.size();
     ntout_ = output_t0_ ? ngrid_ : ngrid_-1;
 
+    // Number of event functions, needed to tell which derivatives are available
+    ne_ = oracle_.n_out()>DE_EVENT ? oracle_.nnz_out(DE_EVENT) : 0;
+
     // Call the base class method
     OracleFunction::init(opts);
 
@@ -306,6 +409,27 @@ namespace casadi {
     // Number of sensitivities
     ns_ = x().size2()-1;
 
+    // Event functions
+    if (ne_>0) {
+      casadi_assert(has_events(), "Events not supported by '" + class_name() + "'");
+      casadi_assert(nrx_==0, "Events cannot be combined with backward states");
+      casadi_assert(max_events_>=0, "'max_events' must be non-negative");
+      create_function("eventF", {"x", "z", "p", "t"}, {"event"});
+
+      // State transition at events
+      if (!event_transition_.is_null()) {
+        const Function& f = event_transition_;
+        casadi_assert(f.n_in()==5 && f.n_out()==1,
+          "'event_transition' must have inputs (t, x, z, p, index) and one output");
+        casadi_assert(f.nnz_in(0)==1 && f.nnz_in(1)==nx_ && f.nnz_in(2)==nz_
+          && f.nnz_in(3)==np_ && f.nnz_in(4)==1 && f.nnz_out(0)==nx_,
+          "Dimension mismatch for 'event_transition'");
+        set_function(event_transition_, "event_transition");
+      }
+    } else {
+      event_transition_ = Function();
+    }
+
     // Get the sparsities of the forward and reverse DAE
     sp_jac_dae_ = sp_jac_dae();
     casadi_assert(!sp_jac_dae_.is_singular(),
@@ -330,8 +454,18 @@ namespace casadi {
 
   int Integrator::init_mem(void* mem) const {
     if (OracleFunction::init_mem(mem)) return 1;
+    auto m = static_cast<IntegratorMemory*>(mem);
 
-    //auto m = static_cast<IntegratorMemory*>(mem);
+    // Events
+    m->event_index = -1;
+    m->t_event = nan;
+    if (ne_>0) {
+      m->xe.resize(nx_);
+      m->ze.resize(nz_);
+      m->qe.resize(nq_);
+      m->q_acc.resize(nq_);
+      m->x_plus.resize(nx_);
+    }
     return 0;
   }
 
@@ -1013,6 +1147,144 @@ namespace casadi {
 
   const std::string Integrator::infix_ = "integrator";
 
+  Function Integrator::parareal(const std::string& name, const std::string& solver,
+                                const Function& dae, const Dict& opts) {
+    casadi_assert(dae.n_in()==DE_NUM_IN && dae.n_out()==DE_NUM_OUT,
+                  "Parareal requires the DAE in the form returned by 'map2oracle'");
+    casadi_assert(dae.nnz_in(DE_RX)==0, "Parareal does not support backward states");
+    casadi_assert(dae.nnz_out(DE_EVENT)==0, "Parareal does not support events");
+
+    // Default options
+    casadi_int nw = 0, n_iter = 3;
+    std::string coarse = dae.nnz_in(DE_Z)>0 ? "collocation" : "rk", parallelization = "thread";
+    Dict coarse_opts = {{"number_of_finite_elements", 1}};
+    std::vector<double> grid;
+    double t0 = 0, tf = 1;
+    bool output_t0 = false;
+
+    // Read options, pass the rest to the fine integrator
+    Dict fine_opts;
+    for (auto&& op : opts) {
+      if (op.first=="parareal_windows") {
+        nw = op.second;
+      } else if (op.first=="parareal_iterations") {
+        n_iter = op.second;
+      } else if (op.first=="parareal_coarse") {
+        coarse = op.second.to_string();
+      } else if (op.first=="parareal_coarse_options") {
+        coarse_opts = op.second;
+      } else if (op.first=="parareal_parallelization") {
+        parallelization = op.second.to_string();
+      } else if (op.first=="grid") {
+        grid = op.second;
+      } else if (op.first=="t0") {
+        t0 = op.second;
+      } else if (op.first=="tf") {
+        tf = op.second;
+      } else if (op.first=="output_t0") {
+        output_t0 = op.second;
+      } else {
+        fine_opts[op.first] = op.second;
+      }
+    }
+    if (grid.empty()) grid = {t0, tf};
+    casadi_int nint = grid.size()-1;
+    casadi_assert(nw>0, "'parareal_windows' must be positive");
+    casadi_assert(nw%nint==0, "'parareal_windows' must be a multiple of the number "
+                  "of grid intervals, " + str(nint));
+    casadi_assert(n_iter>=1, "'parareal_iterations' must be positive");
+
+    // Windows, splitting each grid interval uniformly
+    casadi_int nsub = nw/nint;
+    std::vector<double> T(nw), dT(nw);
+    for (casadi_int w=0; w<nw; ++w) {
+      casadi_int i = w/nsub, j = w%nsub;
+      dT[w] = (grid[i+1]-grid[i])/static_cast<double>(nsub);
+      T[w] = grid[i] + static_cast<double>(j)*dT[w];
+    }
+
+    // DAE in the time normalized to the window, parameterized by its start and length
+    std::vector<MX> dae_in = dae.mx_in();
+    MX s = MX::sym("t"), Ts = MX::sym("T"), dTs = MX::sym("dT");
+    std::vector<MX> dae_arg = dae_in;
+    if (dae.nnz_in(DE_T)>0) dae_arg[DE_T] = Ts + dTs*s;
+    std::vector<MX> wdae_out = dae(dae_arg);
+    wdae_out[DE_ODE] *= dTs;
+    wdae_out[DE_QUAD] *= dTs;
+    std::vector<MX> wdae_in = dae_in;
+    wdae_in[DE_T] = s;
+    wdae_in[DE_P] = vertcat(dae_in[DE_P], Ts, dTs);
+    Function wdae(name + "_dae", wdae_in, wdae_out, DE_INPUTS, DE_OUTPUTS);
+
+    // Fine and coarse integrators over one window
+    fine_opts["output_t0"] = output_t0;
+    Function fine = integrator(name + "_fine", solver, wdae, fine_opts);
+    Function fine_map = fine.map(nw, parallelization);
+    Function coarse_intg = integrator(name + "_coarse", coarse, wdae, coarse_opts);
+
+    // Inputs
+    std::vector<MX> intg_in(INTEGRATOR_NUM_IN);
+    MX x0 = intg_in[INTEGRATOR_X0] = MX::sym("x0", dae.sparsity_in(DE_X));
+    MX p = intg_in[INTEGRATOR_P] = MX::sym("p", dae.sparsity_in(DE_P));
+    MX z0 = intg_in[INTEGRATOR_Z0] = MX::sym("z0", dae.sparsity_in(DE_Z));
+
+    // Parameters of all windows
+    std::vector<MX> P = horzsplit(vertcat(repmat(p, 1, nw), DM(T).T(), DM(dT).T()));
+    MX P_all = horzcat(P);
+
+    // Coarse propagation of the initial conditions
+    auto coarse_sweep = [&](const std::vector<MX>& U, std::vector<MX>& G) {
+      std::vector<MX> U_next = {x0};
+      for (casadi_int w=0; w<nw-1; ++w) {
+        MXDict r = coarse_intg(MXDict{{"x0", U_next.back()}, {"p", P[w]}, {"z0", z0}});
+        U_next.push_back(U.empty() ? r.at("xf") : r.at("xf") + U[w+1] - G[w]);
+        G[w] = r.at("xf");
+      }
+      return U_next;
+    };
+    std::vector<MX> G(nw-1);
+    std::vector<MX> U = coarse_sweep({}, G);
+
+    // Fine sweeps in parallel, each but the last followed by a coarse correction
+    MXDict F;
+    for (casadi_int k=0; k<n_iter; ++k) {
+      F = fine_map(MXDict{{"x0", horzcat(U)}, {"p", P_all}, {"z0", repmat(z0, 1, nw)}});
+      if (k==n_iter-1) break;
+      std::vector<MX> F_xf = horzsplit(F.at("xf"), output_t0 ? 2 : 1);
+      std::vector<MX> U_F(nw);
+      for (casadi_int w=0; w<nw-1; ++w) U_F[w+1] = output_t0 ? F_xf[w](Slice(), 1) : F_xf[w];
+      U = coarse_sweep(U_F, G);
+    }
+
+    // Solution at the end of each window
+    casadi_int ncol = output_t0 ? 2 : 1;
+    std::vector<MX> xf = horzsplit(F.at("xf"), ncol);
+    std::vector<MX> zf = horzsplit(F.at("zf"), ncol);
+    std::vector<MX> qf = horzsplit(F.at("qf"), ncol);
+
+    // Outputs on the grid, accumulating the quadratures
+    std::vector<MX> xf_grid, zf_grid, qf_grid;
+    if (output_t0) {
+      xf_grid.push_back(x0);
+      zf_grid.push_back(zf[0](Slice(), 0));
+      qf_grid.push_back(MX::zeros(dae.sparsity_out(DE_QUAD)));
+    }
+    MX q_sum = MX::zeros(dae.sparsity_out(DE_QUAD));
+    for (casadi_int w=0; w<nw; ++w) {
+      q_sum += output_t0 ? qf[w](Slice(), 1) : qf[w];
+      if ((w+1)%nsub==0) {
+        xf_grid.push_back(output_t0 ? xf[w](Slice(), 1) : xf[w]);
+        zf_grid.push_back(output_t0 ? zf[w](Slice(), 1) : zf[w]);
+        qf_grid.push_back(q_sum);
+      }
+    }
+    std::vector<MX> intg_out(INTEGRATOR_NUM_OUT);
+    intg_out[INTEGRATOR_XF] = horzcat(xf_grid);
+    intg_out[INTEGRATOR_ZF] = horzcat(zf_grid);
+    intg_out[INTEGRATOR_QF] = horzcat(qf_grid);
+    return Function(name, intg_in, intg_out, integrator_in(), integrator_out());
+  }
+
   void Integrator::setStopTime(IntegratorMemory* mem, double tf) const {
     casadi_error("setStopTime not defined for class " + class_name());
   }
@@ -1022,12 +1294,24 @@ namespace casadi {
 
     // Default options
     nk_ = 20;
+    checkpoints_ = 0;
+    event_tol_ = 1e-12;
   }
 
   FixedStepIntegrator::~FixedStepIntegrator() {
     clear_mem();
   }
 
+  bool Integrator::is_a(const std::string& type, bool recursive) const {
+    return type=="Integrator"
+      || (recursive && OracleFunction::is_a(type, recursive));
+  }
+
+  bool FixedStepIntegrator::is_a(const std::string& type, bool recursive) const {
+    return type=="FixedStepIntegrator"
+      || (recursive && Integrator::is_a(type, recursive));
+  }
+
   const Options FixedStepIntegrator::options_
   = {{&Integrator::options_},
      {{"number_of_finite_elements",
@@ -1038,7 +1322,16 @@ namespace casadi {
         "Implement as MX Function (codegeneratable/serializable) default: false"}},
       {"simplify_options",
         {OT_DICT,
-        "Any options to pass to simplified form Function constructor"}}
+        "Any options to pass to simplified form Function constructor"}},
+      {"number_of_checkpoints",
+        {OT_INT,
+        "Number of forward states kept for the backward problem. The steps in between "
+        "are recomputed, placing the checkpoints binomially. "
+        "Default: 0, store every step"}},
+      {"event_tol",
+        {OT_DOUBLE,
+        "Absolute tolerance on the event times, located on the dense output. "
+        "Default: 1e-12"}}
       }
   };
 
@@ -1051,7 +1344,7 @@ namespace casadi {
     auto it = opts.find("simplify");
     if (it!=opts.end()) simplify = it->second;
 
-    if (simplify && nrx_==0 && grid_.size()==2) {
+    if (simplify && nrx_==0 && ne_==0 && grid_.size()==2) {
       // Retrieve explicit simulation step (one finite element)
       Function F = getExplicit();
 
@@ -1109,11 +1402,20 @@ namespace casadi {
     for (auto&& op : opts) {
       if (op.first=="number_of_finite_elements") {
         nk_ = op.second;
+      } else if (op.first=="number_of_checkpoints") {
+        checkpoints_ = op.second;
+      } else if (op.first=="event_tol") {
+        event_tol_ = op.second;
       }
     }
+    casadi_assert(event_tol_>0, "'event_tol' must be positive");
 
     // Number of finite elements and time steps
     casadi_assert_dev(nk_>0);
+    casadi_assert(checkpoints_>=0, "'number_of_checkpoints' must be non-negative");
+
+    // Tape every step if there is room for it
+    if (checkpoints_>=nk_) checkpoints_ = 0;
     h_ = static_cast<double>(grid_.back() - grid_.front())/static_cast<double>(nk_);
 
     // Setup discrete time dynamics
@@ -1122,6 +1424,18 @@ namespace casadi {
     // Get discrete time dimensions
     nZ_ = F_.nnz_in(DAE_Z);
     nRZ_ =  G_.is_null() ? 0 : G_.nnz_in(RDAE_RZ);
+
+    // Continuous time dynamics for the dense output
+    if (ne_>0 && !has_function("f")) {
+      create_function("f", {"x", "z", "p", "t"}, {"ode", "alg", "quad"});
+    }
+
+    // Algebraic variables consistent with the state, which may jump at events
+    if (ne_>0 && nz_>0) {
+      Function algF = create_function("algF", {"x", "z", "p", "t"}, {"alg"});
+      set_function(rootfinder(name_ + "_algF", "newton", algF,
+                              {{"implicit_input", 1}, {"implicit_output", 0}}), "consistent_z");
+    }
   }
 
   int FixedStepIntegrator::init_mem(void* mem) const {
@@ -1132,11 +1446,26 @@ namespace casadi {
     m->Z.resize(F_.nnz_in(DAE_Z));
     if (!G_.is_null()) m->RZ.resize(G_.nnz_in(RDAE_RZ));
 
-    // Allocate tape if backward states are present
+    // Allocate tape or checkpoints if backward states are present
     if (nrx_>0) {
-      m->x_tape.resize(nk_+1, vector<double>(nx_));
-      m->Z_tape.resize(nk_, vector<double>(nZ_));
+      if (checkpoints_==0) {
+        m->x_tape.resize(nk_+1, vector<double>(nx_));
+        m->Z_tape.resize(nk_, vector<double>(nZ_));
+      } else {
+        m->chk_k.reserve(checkpoints_);
+        m->chk_x.resize(checkpoints_*nx_);
+        m->chk_Z.resize(checkpoints_*nZ_);
+        m->x_rec.resize(nx_);
+        m->Z_rec.resize(nZ_);
+        m->x_next.resize(nx_);
+        m->Z_next.resize(nZ_);
+      }
     }
+    m->nrecomp = m->nchk_max = 0;
+
+    // Keep the memory of the discrete time dynamics, e.g. a factorized Jacobian
+    m->mem_F = getExplicit().checkout();
+    m->mem_G = getExplicitB().is_null() ? -1 : getExplicitB().checkout();
 
     // Allocate state
     m->x.resize(nx_);
@@ -1153,13 +1482,41 @@ namespace casadi {
     m->rx_prev.resize(nrx_);
     m->RZ_prev.resize(nRZ_);
     m->rq_prev.resize(nrq_);
+
+    // Dense output and root localization
+    m->pending_index = -1;
+    if (ne_>0) {
+      m->z_prev.resize(nz_);
+      m->e_prev.resize(ne_);
+      m->e.resize(ne_);
+      m->f_prev.resize(nx_);
+      m->f.resize(nx_);
+      m->fq_prev.resize(nq_);
+      m->fq.resize(nq_);
+      m->x_int.resize(nx_);
+      m->z_int.resize(nz_);
+      m->q_int.resize(nq_);
+      m->e_lo.resize(ne_);
+      m->e_hi.resize(ne_);
+      m->e_mid.resize(ne_);
+    }
     return 0;
   }
 
+  void FixedStepIntegrator::free_mem(void *mem) const {
+    auto m = static_cast<FixedStepMemory*>(mem);
+    getExplicit().release(m->mem_F);
+    if (m->mem_G>=0) getExplicitB().release(m->mem_G);
+    delete m;
+  }
+
   void FixedStepIntegrator::advance(IntegratorMemory* mem, double t,
                                     double* x, double* z, double* q) const {
     auto m = static_cast<FixedStepMemory*>(mem);
 
+    // Steps are no longer aligned with the grid after an event
+    if (ne_>0) return advance_with_events(m, t, x, z, q);
+
     // Get discrete time sought
     casadi_int k_out = static_cast<casadi_int>(std::ceil((t - grid_.front())/h_));
     k_out = std::min(k_out, nk_); //  make sure that rounding errors does not result in k_out>nk_
@@ -1183,17 +1540,27 @@ namespace casadi {
 
     // Take time steps until end time has been reached
     while (m->k<k_out) {
+      // Checkpoint
+      if (nrx_>0 && m->k==m->next_chk) {
+        casadi_int i = m->chk_k.size();
+        m->chk_k.push_back(m->k);
+        m->nchk_max = std::max(m->nchk_max, i+1);
+        casadi_copy(get_ptr(m->x), nx_, get_ptr(m->chk_x) + i*nx_);
+        casadi_copy(get_ptr(m->Z), nZ_, get_ptr(m->chk_Z) + i*nZ_);
+        m->next_chk = next_checkpoint(m->k, nk_-1, i+1);
+      }
+
       // Update the previous step
       casadi_copy(get_ptr(m->x), nx_, get_ptr(m->x_prev));
       casadi_copy(get_ptr(m->Z), nZ_, get_ptr(m->Z_prev));
       casadi_copy(get_ptr(m->q), nq_, get_ptr(m->q_prev));
 
       // Take step
-      F(m->arg, m->res, m->iw, m->w);
+      F(m->arg, m->res, m->iw, m->w, m->mem_F);
       casadi_axpy(nq_, 1., get_ptr(m->q_prev), get_ptr(m->q));
 
       // Tape
-      if (nrx_>0) {
+      if (nrx_>0 && checkpoints_==0) {
         casadi_copy(get_ptr(m->x), nx_, get_ptr(m->x_tape.at(m->k+1)));
         casadi_copy(get_ptr(m->Z), m->Z.size(), get_ptr(m->Z_tape.at(m->k)));
       }
@@ -1209,6 +1576,158 @@ namespace casadi {
     casadi_copy(get_ptr(m->q), nq_, q);
   }
 
+  void FixedStepIntegrator::advance_with_events(FixedStepMemory* m, double t,
+                                                double* x, double* z, double* q) const {
+    // Tolerance for reaching t with a step
+    const double ttol = 1e-9*h_;
+
+    // Explicit discrete time dynamics
+    const Function& F = getExplicit();
+
+    // Zero crossing of an event function, a zero at the start of a step is no crossing
+    auto crossing = [](double e0, double e1) { return (e0<0 && e1>=0) || (e0>0 && e1<=0);};
+
+    while (true) {
+      // Event within the last step, before t
+      if (m->pending_index>=0 && m->t_pending<=t) {
+        interpolate(m, (m->t_pending - m->t_prev)/h_, x, z, q);
+        m->event_index = m->pending_index;
+        m->t_event = m->t_pending;
+        m->pending_index = -1;
+        return;
+      }
+
+      // t reached, possibly by overshooting it
+      if (m->t>=t-ttol) {
+        if (m->t==m->t_prev) {
+          casadi_copy(get_ptr(m->x), nx_, x);
+          casadi_copy(get_ptr(m->z), nz_, z);
+          casadi_copy(get_ptr(m->q), nq_, q);
+        } else {
+          interpolate(m, (t - m->t_prev)/h_, x, z, q);
+        }
+        return;
+      }
+
+      // Update the previous step
+      m->t_prev = m->t;
+      casadi_copy(get_ptr(m->x), nx_, get_ptr(m->x_prev));
+      casadi_copy(get_ptr(m->Z), nZ_, get_ptr(m->Z_prev));
+      casadi_copy(get_ptr(m->q), nq_, get_ptr(m->q_prev));
+      casadi_copy(get_ptr(m->z), nz_, get_ptr(m->z_prev));
+      casadi_copy(get_ptr(m->e), ne_, get_ptr(m->e_prev));
+      casadi_copy(get_ptr(m->f), nx_, get_ptr(m->f_prev));
+      casadi_copy(get_ptr(m->fq), nq_, get_ptr(m->fq_prev));
+
+      // Take step
+      fill_n(m->arg, F.n_in(), nullptr);
+      m->arg[DAE_T] = &m->t_prev;
+      m->arg[DAE_X] = get_ptr(m->x_prev);
+      m->arg[DAE_Z] = get_ptr(m->Z_prev);
+      m->arg[DAE_P] = get_ptr(m->p);
+      fill_n(m->res, F.n_out(), nullptr);
+      m->res[DAE_ODE] = get_ptr(m->x);
+      m->res[DAE_ALG] = get_ptr(m->Z);
+      m->res[DAE_QUAD] = get_ptr(m->q);
+      F(m->arg, m->res, m->iw, m->w, m->mem_F);
+      casadi_axpy(nq_, 1., get_ptr(m->q_prev), get_ptr(m->q));
+      m->k++;
+      m->t = m->t_start + static_cast<double>(m->k)*h_;
+      casadi_copy(get_ptr(m->Z)+nZ_-nz_, nz_, get_ptr(m->z));
+
+      // Dynamics and event functions at the end of the step
+      m->arg[0] = get_ptr(m->x);
+      m->arg[1] = get_ptr(m->z);
+      m->arg[2] = get_ptr(m->p);
+      m->arg[3] = &m->t;
+      m->res[0] = get_ptr(m->f);
+      m->res[1] = nullptr;
+      m->res[2] = get_ptr(m->fq);
+      casadi_assert(!calc_function(m, "f"), "Evaluation of 'f' failed at t=" + str(m->t));
+      eval_event(m, m->t, get_ptr(m->x), get_ptr(m->z), get_ptr(m->e));
+
+      // Any zero crossing?
+      casadi_int i;
+      for (i=0; i<ne_; ++i) if (crossing(m->e_prev[i], m->e[i])) break;
+      if (i==ne_) continue;
+
+      // Locate the first crossing on the dense output, cf. the rootfinding of CVODES
+      double lo = 0, hi = 1, theta_tol = event_tol_/h_, alpha = 1;
+      casadi_int side = 0, side_prev = -1;
+      casadi_copy(get_ptr(m->e_prev), ne_, get_ptr(m->e_lo));
+      casadi_copy(get_ptr(m->e), ne_, get_ptr(m->e_hi));
+      while (hi-lo>theta_tol) {
+        // Weighting to avoid slow one-sided convergence (Illinois)
+        if (side==side_prev) {
+          alpha = side==2 ? 2*alpha : 0.5*alpha;
+        } else {
+          alpha = 1;
+        }
+        side_prev = side;
+
+        // Earliest secant estimate among the crossing components
+        double theta = hi;
+        for (i=0; i<ne_; ++i) {
+          if (!crossing(m->e_lo[i], m->e_hi[i])) continue;
+          double d = m->e_hi[i] - alpha*m->e_lo[i];
+          if (d!=0) theta = std::min(theta, hi - (hi-lo)*m->e_hi[i]/d);
+        }
+
+        // Keep away from the ends of the bracket
+        double frac = (hi-lo)>5*theta_tol ? 0.1 : 0.5;
+        if (theta-lo<0.5*theta_tol) theta = lo + frac*(hi-lo);
+        if (hi-theta<0.5*theta_tol) theta = hi - frac*(hi-lo);
+
+        // Shrink the bracket
+        interpolate(m, theta, get_ptr(m->x_int), get_ptr(m->z_int), get_ptr(m->q_int));
+        eval_event(m, m->t_prev + theta*h_, get_ptr(m->x_int), get_ptr(m->z_int),
+                   get_ptr(m->e_mid));
+        for (i=0; i<ne_; ++i) if (crossing(m->e_lo[i], m->e_mid[i])) break;
+        if (i<ne_) {
+          hi = theta;
+          casadi_copy(get_ptr(m->e_mid), ne_, get_ptr(m->e_hi));
+          side = 1;
+        } else {
+          lo = theta;
+          casadi_copy(get_ptr(m->e_mid), ne_, get_ptr(m->e_lo));
+          side = 2;
+        }
+      }
+
+      // The event is at the end of the bracket, past the crossing
+      for (i=0; i<ne_; ++i) if (crossing(m->e_lo[i], m->e_hi[i])) break;
+      m->pending_index = i;
+      m->t_pending = m->t_prev + hi*h_;
+    }
+  }
+
+  void FixedStepIntegrator::interpolate(FixedStepMemory* m, double theta,
+                                        double* x, double* z, double* q) const {
+    // Cubic Hermite basis
+    double theta2 = theta*theta, theta3 = theta2*theta;
+    double h00 = 2*theta3 - 3*theta2 + 1, h10 = theta3 - 2*theta2 + theta;
+    double h01 = 3*theta2 - 2*theta3, h11 = theta3 - theta2;
+    for (casadi_int i=0; i<nx_; ++i) {
+      x[i] = h00*m->x_prev[i] + h10*h_*m->f_prev[i] + h01*m->x[i] + h11*h_*m->f[i];
+    }
+    for (casadi_int i=0; i<nq_; ++i) {
+      q[i] = h00*m->q_prev[i] + h10*h_*m->fq_prev[i] + h01*m->q[i] + h11*h_*m->fq[i];
+    }
+    for (casadi_int i=0; i<nz_; ++i) {
+      z[i] = (1-theta)*m->z_prev[i] + theta*m->z[i];
+    }
+  }
+
+  void FixedStepIntegrator::eval_event(FixedStepMemory* m, double t, const double* x,
+                                       const double* z, double* e) const {
+    m->arg[0] = x;
+    m->arg[1] = z;
+    m->arg[2] = get_ptr(m->p);
+    m->arg[3] = &t;
+    m->res[0] = e;
+    casadi_assert(!calc_function(m, "eventF"), "Evaluation of 'eventF' failed at t=" + str(t));
+  }
+
   void FixedStepIntegrator::retreat(IntegratorMemory* mem, double t,
                                     double* rx, double* rz, double* rq) const {
     auto m = static_cast<FixedStepMemory*>(mem);
@@ -1222,20 +1741,6 @@ namespace casadi {
     // Explicit discrete time dynamics
     const Function& G = getExplicitB();
 
-    // Discrete dynamics function inputs ...
-    fill_n(m->arg, G.n_in(), nullptr);
-    m->arg[RDAE_T] = &m->t;
-    m->arg[RDAE_P] = get_ptr(m->p);
-    m->arg[RDAE_RX] = get_ptr(m->rx_prev);
-    m->arg[RDAE_RZ] = get_ptr(m->RZ_prev);
-    m->arg[RDAE_RP] = get_ptr(m->rp);
-
-    // ... and outputs
-    fill_n(m->res, G.n_out(), nullptr);
-    m->res[RDAE_ODE] = get_ptr(m->rx);
-    m->res[RDAE_ALG] = get_ptr(m->RZ);
-    m->res[RDAE_QUAD] = get_ptr(m->rq);
-
     // Take time steps until end time has been reached
     while (m->k>k_out) {
       // Advance time
@@ -1247,10 +1752,32 @@ namespace casadi {
       casadi_copy(get_ptr(m->RZ), nRZ_, get_ptr(m->RZ_prev));
       casadi_copy(get_ptr(m->rq), nrq_, get_ptr(m->rq_prev));
 
+      // Forward solution at the step, recomputed if not taped
+      if (checkpoints_>0) recompute(m, m->k);
+
+      // Discrete dynamics function inputs ...
+      fill_n(m->arg, G.n_in(), nullptr);
+      m->arg[RDAE_T] = &m->t;
+      m->arg[RDAE_P] = get_ptr(m->p);
+      m->arg[RDAE_RX] = get_ptr(m->rx_prev);
+      m->arg[RDAE_RZ] = get_ptr(m->RZ_prev);
+      m->arg[RDAE_RP] = get_ptr(m->rp);
+      if (checkpoints_>0) {
+        m->arg[RDAE_X] = get_ptr(m->x_rec);
+        m->arg[RDAE_Z] = get_ptr(m->Z_next);
+      } else {
+        m->arg[RDAE_X] = get_ptr(m->x_tape.at(m->k));
+        m->arg[RDAE_Z] = get_ptr(m->Z_tape.at(m->k));
+      }
+
+      // ... and outputs
+      fill_n(m->res, G.n_out(), nullptr);
+      m->res[RDAE_ODE] = get_ptr(m->rx);
+      m->res[RDAE_ALG] = get_ptr(m->RZ);
+      m->res[RDAE_QUAD] = get_ptr(m->rq);
+
       // Take step
-      m->arg[RDAE_X] = get_ptr(m->x_tape.at(m->k));
-      m->arg[RDAE_Z] = get_ptr(m->Z_tape.at(m->k));
-      G(m->arg, m->res, m->iw, m->w);
+      G(m->arg, m->res, m->iw, m->w, m->mem_G);
       casadi_axpy(nrq_, 1., get_ptr(m->rq_prev), get_ptr(m->rq));
     }
 
@@ -1275,6 +1802,19 @@ namespace casadi {
     casadi_copy(x, nx_, get_ptr(m->x));
     casadi_copy(z, nz_, get_ptr(m->z));
 
+    // Events: solve for z, as x may have been changed by 'event_transition'
+    if (ne_>0 && nz_>0) {
+      casadi_copy(get_ptr(m->z), nz_, get_ptr(m->z_prev));
+      m->arg[0] = x;
+      m->arg[1] = get_ptr(m->z_prev);
+      m->arg[2] = get_ptr(m->p);
+      m->arg[3] = &m->t;
+      m->res[0] = get_ptr(m->z);
+      casadi_assert(!calc_function(m, "consistent_z"),
+        "Evaluation of 'consistent_z' failed at t=" + str(t));
+      z = get_ptr(m->z);
+    }
+
     // Reset summation states
     casadi_clear(get_ptr(m->q), nq_);
 
@@ -1282,12 +1822,135 @@ namespace casadi {
     m->k = 0;
 
     // Get consistent initial conditions
-    casadi_fill(get_ptr(m->Z), m->Z.size(), numeric_limits<double>::quiet_NaN());
+    guess_Z(x, z, get_ptr(m->Z));
 
     // Add the first element in the tape
-    if (nrx_>0) {
+    if (nrx_>0 && checkpoints_==0) {
       casadi_copy(x, nx_, get_ptr(m->x_tape.at(0)));
     }
+
+    // Clear the checkpoints, the first one is taken at the start of the integration
+    m->chk_k.clear();
+    m->next_chk = checkpoints_>0 ? 0 : -1;
+    m->nchk_max = 0;
+
+    // Events: restart the steps, dynamics and event functions at the start
+    if (ne_>0) {
+      m->t_start = m->t_prev = t;
+      m->pending_index = -1;
+      m->arg[0] = get_ptr(m->x);
+      m->arg[1] = get_ptr(m->z);
+      m->arg[2] = get_ptr(m->p);
+      m->arg[3] = &m->t;
+      m->res[0] = get_ptr(m->f);
+      m->res[1] = nullptr;
+      m->res[2] = get_ptr(m->fq);
+      casadi_assert(!calc_function(m, "f"), "Evaluation of 'f' failed at t=" + str(t));
+      eval_event(m, t, get_ptr(m->x), get_ptr(m->z), get_ptr(m->e));
+    }
+  }
+
+  void FixedStepIntegrator::guess_Z(const double* x, const double* z, double* Z) const {
+    casadi_fill(Z, nZ_, numeric_limits<double>::quiet_NaN());
+  }
+
+  Function FixedStepIntegrator::
+  batch_dynamics(casadi_int n, const std::string& parallelization) const {
+    Function F = getExplicit();
+    // Expand so that the instances are evaluated together, one instruction at a time
+    if (F.is_a("MXFunction") && oracle_.is_a("SXFunction")) F = F.expand();
+    return F.map(n, parallelization);
+  }
+
+  int FixedStepIntegrator::eval_batch(const Function& Fn, const double** arg, double** res,
+                                      casadi_int* iw, double* w, casadi_int n, void* mem) const {
+    auto m = static_cast<FixedStepMemory*>(mem);
+
+    // Reset statistics, as in an evaluation of a single instance
+    for (auto&& s : m->fstats) s.second.reset();
+    if (m->t_total) m->t_total->tic();
+    m->nrecomp = 0;
+    m->nchk_max = 0;
+
+    // Inputs and outputs, all instances
+    const double* x0 = arg[INTEGRATOR_X0];
+    const double* z0 = arg[INTEGRATOR_Z0];
+    const double* p = arg[INTEGRATOR_P];
+    double* xf = res[INTEGRATOR_XF];
+    double* zf = res[INTEGRATOR_ZF];
+    double* qf = res[INTEGRATOR_QF];
+    arg += INTEGRATOR_NUM_IN;
+    res += INTEGRATOR_NUM_OUT;
+
+    // Stacked states, current and previous step
+    double* x = w; w += n*nx_;
+    double* x_prev = w; w += n*nx_;
+    double* Z = w; w += n*nZ_;
+    double* Z_prev = w; w += n*nZ_;
+    double* q = w; w += n*nq_;
+    double* dq = w; w += n*nq_;
+    double* t = w; w += n;
+
+    // Initial conditions
+    casadi_copy(x0, n*nx_, x);
+    for (casadi_int i=0; i<n; ++i) {
+      guess_Z(x + i*nx_, z0 ? z0 + i*nz_ : nullptr, Z + i*nZ_);
+    }
+    casadi_clear(q, n*nq_);
+
+    // Discrete dynamics function inputs ...
+    fill_n(arg, Fn.n_in(), nullptr);
+    arg[DAE_T] = t;
+    arg[DAE_X] = x_prev;
+    arg[DAE_Z] = Z_prev;
+    arg[DAE_P] = p;
+
+    // ... and outputs
+    fill_n(res, Fn.n_out(), nullptr);
+    res[DAE_ODE] = x;
+    res[DAE_ALG] = Z;
+    res[DAE_QUAD] = dq;
+
+    // Integrate forward
+    scoped_checkout<Function> mem_Fn(Fn);
+    int flag = 0;
+    casadi_int k = 0, nnz_xf = nnz_out(INTEGRATOR_XF), nnz_zf = nnz_out(INTEGRATOR_ZF),
+      nnz_qf = nnz_out(INTEGRATOR_QF);
+    for (casadi_int j=0; j<grid_.size(); ++j) {
+      // Skip t0?
+      if (j==0 && !output_t0_) continue;
+
+      // Get discrete time sought
+      casadi_int k_out = static_cast<casadi_int>(std::ceil((grid_[j] - grid_.front())/h_));
+      k_out = std::min(k_out, nk_);
+
+      // Take time steps for all instances at once
+      while (k<k_out && !flag) {
+        casadi_copy(x, n*nx_, x_prev);
+        casadi_copy(Z, n*nZ_, Z_prev);
+        casadi_fill(t, n, static_cast<double>(grid_.front()) + static_cast<double>(k)*h_);
+        flag = Fn(arg, res, iw, w, mem_Fn);
+        casadi_axpy(n*nq_, 1., dq, q);
+        k++;
+      }
+      if (flag) break;
+
+      // Return to user
+      for (casadi_int i=0; i<n; ++i) {
+        if (xf) casadi_copy(x + i*nx_, nx_, xf + i*nnz_xf);
+        if (zf) casadi_copy(Z + (i+1)*nZ_ - nz_, nz_, zf + i*nnz_zf);
+        if (qf) casadi_copy(q + i*nq_, nq_, qf + i*nnz_qf);
+      }
+      if (xf) xf += nx_;
+      if (zf) zf += nz_;
+      if (qf) qf += nq_;
+    }
+
+    // Show statistics
+    if (m->t_total) m->t_total->toc();
+    print_time(m->fstats);
+    if (print_stats_) print_stats(m);
+    return flag;
   }
 
   void FixedStepIntegrator::resetB(IntegratorMemory* mem, double t, const double* rx,
@@ -1310,16 +1973,98 @@ namespace casadi {
     // Bring discrete time to the end
     m->k = nk_;
 
+    // Reset statistics
+    m->nrecomp = 0;
+
     // Get consistent initial conditions
     casadi_fill(get_ptr(m->RZ), m->RZ.size(), numeric_limits<double>::quiet_NaN());
   }
 
+  casadi_int FixedStepIntegrator::
+  next_checkpoint(casadi_int k, casadi_int k_last, casadi_int nchk) const {
+    // Steps to be reversed from the checkpoint at k, free checkpoints
+    casadi_int l = k_last - k + 1, c = checkpoints_ - nchk;
+    if (c<=0 || l<=2) return -1;
+
+    // Maximum number of steps that can be reversed with s checkpoints and r sweeps
+    auto beta = [](casadi_int s, casadi_int r) {
+      double b = 1;
+      for (casadi_int i=1; i<=s; ++i) b = b*static_cast<double>(r+i)/static_cast<double>(i);
+      return b;
+    };
+
+    // Smallest number of sweeps with the c+1 checkpoints starting at k
+    casadi_int r = 1;
+    while (beta(c+1, r)<l) r++;
+
+    // Steps to the next checkpoint that keep the number of sweeps, see Griewank (1992)
+    double lo = std::max(1., static_cast<double>(l) - beta(c, r));
+    double hi = std::min(static_cast<double>(l-2), beta(c+1, r-1));
+    return k + static_cast<casadi_int>(std::floor((lo+hi)/2));
+  }
+
+  void FixedStepIntegrator::recompute(FixedStepMemory* m, casadi_int k) const {
+    // Drop the checkpoints past k
+    while (m->chk_k.back()>k) m->chk_k.pop_back();
+
+    // Start from the last remaining checkpoint
+    casadi_int nchk = m->chk_k.size(), j = m->chk_k.back();
+    casadi_copy(get_ptr(m->chk_x) + (nchk-1)*nx_, nx_, get_ptr(m->x_rec));
+    casadi_copy(get_ptr(m->chk_Z) + (nchk-1)*nZ_, nZ_, get_ptr(m->Z_rec));
+    casadi_int next_chk = next_checkpoint(j, k, nchk);
+
+    // Explicit discrete time dynamics
+    const Function& F = getExplicit();
+    double t;
+
+    // Discrete dynamics function inputs ...
+    fill_n(m->arg, F.n_in(), nullptr);
+    m->arg[DAE_T] = &t;
+    m->arg[DAE_X] = get_ptr(m->x_rec);
+    m->arg[DAE_Z] = get_ptr(m->Z_rec);
+    m->arg[DAE_P] = get_ptr(m->p);
+
+    // ... and outputs
+    fill_n(m->res, F.n_out(), nullptr);
+    m->res[DAE_ODE] = get_ptr(m->x_next);
+    m->res[DAE_ALG] = get_ptr(m->Z_next);
+
+    // Take steps up to and including step k, checkpointing on the way
+    while (true) {
+      t = static_cast<double>(grid_.front()) + static_cast<double>(j)*h_;
+      F(m->arg, m->res, m->iw, m->w, m->mem_F);
+      m->nrecomp++;
+      if (j==k) break;
+      casadi_copy(get_ptr(m->x_next), nx_, get_ptr(m->x_rec));
+      casadi_copy(get_ptr(m->Z_next), nZ_, get_ptr(m->Z_rec));
+      if (++j==next_chk) {
+        m->chk_k.push_back(j);
+        casadi_copy(get_ptr(m->x_rec), nx_, get_ptr(m->chk_x) + nchk*nx_);
+        casadi_copy(get_ptr(m->Z_rec), nZ_, get_ptr(m->chk_Z) + nchk*nZ_);
+        nchk++;
+        m->nchk_max = std::max(m->nchk_max, nchk);
+        next_chk = next_checkpoint(j, k, nchk);
+      }
+    }
+  }
+
+  Dict FixedStepIntegrator::get_stats(void* mem) const {
+    Dict stats = Integrator::get_stats(mem);
+    auto m = static_cast<FixedStepMemory*>(mem);
+    if (checkpoints_>0) {
+      stats["nrecomp"] = m->nrecomp;
+      stats["ncheckpoints"] = m->nchk_max;
+    }
+    return stats;
+  }
+
   ImplicitFixedStepIntegrator::
   ImplicitFixedStepIntegrator(const std::string& name, const Function& dae)
     : FixedStepIntegrator(name, dae) {
   }
 
   ImplicitFixedStepIntegrator::~ImplicitFixedStepIntegrator() {
+    clear_mem();
   }
 
   const Options ImplicitFixedStepIntegrator::options_
@@ -1329,7 +2074,12 @@ namespace casadi {
         "An implicit function solver"}},
       {"rootfinder_options",
        {OT_DICT,
-        "Options to be passed to the NLP Solver"}}
+        "Options to be passed to the NLP Solver"}},
+      {"sensitivity_corrector",
+       {OT_STRING,
+        "Solution of the forward sensitivity equations in each step: "
+        "STAGGERED (after the state, all directions at once with one factorization "
+        "of the step Jacobian) | simultaneous (as one augmented nonlinear system)"}}
      }
   };
 
@@ -1340,6 +2090,7 @@ namespace casadi {
     // Default (temporary) options
     std::string implicit_function_name = "newton";
     Dict rootfinder_options;
+    std::string sensitivity_corrector = "staggered";
 
     // Read options
     for (auto&& op : opts) {
@@ -1347,17 +2098,41 @@ namespace casadi {
         implicit_function_name = op.second.to_string();
       } else if (op.first=="rootfinder_options") {
         rootfinder_options = op.second;
+      } else if (op.first=="sensitivity_corrector") {
+        sensitivity_corrector = op.second.to_string();
       }
     }
+    casadi_assert(sensitivity_corrector=="staggered" || sensitivity_corrector=="simultaneous",
+      "Unknown sensitivity corrector: " + sensitivity_corrector);
 
     // Complete rootfinder dictionary
     rootfinder_options["implicit_input"] = DAE_Z;
     rootfinder_options["implicit_output"] = DAE_ALG;
 
+    // The stage_newton rootfinder needs the stage structure of the discrete time dynamics
+    bool stage_newton = implicit_function_name=="stage_newton";
+
+    // Forward sensitivities through the step of the nondifferentiated problem
+    if (ns_>0 && sensitivity_corrector=="staggered" && !derivative_of_.is_null()) {
+      auto d = dynamic_cast<const ImplicitFixedStepIntegrator*>(derivative_of_.get());
+      if (d!=nullptr) sens_step_ = staggered_step(*d);
+    }
+
     // Allocate a solver
-    rootfinder_ = rootfinder(name_ + "_rootfinder", implicit_function_name,
-                                  F_, rootfinder_options);
-    alloc(rootfinder_);
+    if (sens_step_.is_null()) {
+      Dict forward_rootfinder_options = rootfinder_options;
+      if (stage_newton) {
+        Dict ss = stage_structure(false);
+        casadi_assert(!ss.empty(),
+          "Rootfinder 'stage_newton' is not supported by '" + class_name() + "'");
+        update_dict(forward_rootfinder_options, ss);
+      }
+      rootfinder_ = rootfinder(name_ + "_rootfinder", implicit_function_name,
+                                    F_, forward_rootfinder_options);
+      alloc(rootfinder_);
+    } else {
+      alloc(sens_step_);
+    }
 
     // Allocate a root-finding solver for the backward problem
     if (nRZ_>0) {
@@ -1365,6 +2140,12 @@ namespace casadi {
       Dict backward_rootfinder_options = rootfinder_options;
       backward_rootfinder_options["implicit_input"] = RDAE_RZ;
       backward_rootfinder_options["implicit_output"] = RDAE_ALG;
+      if (stage_newton) {
+        Dict ss = stage_structure(true);
+        casadi_assert(!ss.empty(),
+          "Rootfinder 'stage_newton' is not supported by '" + class_name() + "'");
+        update_dict(backward_rootfinder_options, ss);
+      }
       string backward_implicit_function_name = implicit_function_name;
 
       // Allocate a Newton solver
@@ -1376,6 +2157,132 @@ namespace casadi {
     }
   }
 
+  void ImplicitFixedStepIntegrator::reset_stats(IntegratorMemory* mem) const {
+    auto m = static_cast<FixedStepMemory*>(mem);
+
+    // Count the rootfinder work of this integration only, including the restarts at events
+    if (sens_step_.is_null()) {
+      auto rm = static_cast<RootfinderMemory*>(rootfinder_->memory(m->mem_F));
+      rm->njevals = rm->nfact = rm->nreject = 0;
+    }
+  }
+
+  int ImplicitFixedStepIntegrator::
+  eval_batch(const Function& Fn, const double** arg, double** res,
+             casadi_int* iw, double* w, casadi_int n, void* mem) const {
+    auto m = static_cast<FixedStepMemory*>(mem);
+    if (!sens_step_.is_null()) return FixedStepIntegrator::eval_batch(Fn, arg, res, iw, w, n, mem);
+
+    // The mapped rootfinder solves the instances with its other memory objects,
+    // which keep their counters over all calls: add up their changes
+    reset_stats(m);
+    auto rm = static_cast<RootfinderMemory*>(rootfinder_->memory(m->mem_F));
+    auto add_counters = [&](casadi_int sign) {
+      for (casadi_int i=0; i<rootfinder_->n_mem(); ++i) {
+        if (i==m->mem_F) continue;
+        auto ri = static_cast<RootfinderMemory*>(rootfinder_->memory(i));
+        rm->njevals += sign*ri->njevals;
+        rm->nfact += sign*ri->nfact;
+        rm->nreject += sign*ri->nreject;
+      }
+    };
+    add_counters(-1);
+    int flag = FixedStepIntegrator::eval_batch(Fn, arg, res, iw, w, n, mem);
+    add_counters(1);
+    return flag;
+  }
+
+  void ImplicitFixedStepIntegrator::
+  resetB(IntegratorMemory* mem, double t,
+         const double* rx, const double* rz, const double* rp) const {
+    auto m = static_cast<FixedStepMemory*>(mem);
+    FixedStepIntegrator::resetB(mem, t, rx, rz, rp);
+    if (m->mem_G>=0) {
+      auto rm = static_cast<RootfinderMemory*>(backward_rootfinder_->memory(m->mem_G));
+      rm->njevals = rm->nfact = rm->nreject = 0;
+    }
+  }
+
+  Dict ImplicitFixedStepIntegrator::get_stats(void* mem) const {
+    Dict stats = FixedStepIntegrator::get_stats(mem);
+    auto m = static_cast<FixedStepMemory*>(mem);
+    if (sens_step_.is_null()) {
+      auto rm = static_cast<RootfinderMemory*>(rootfinder_->memory(m->mem_F));
+      stats["njevals"] = rm->njevals;
+      stats["nfact"] = rm->nfact;
+      stats["nreject"] = rm->nreject;
+    }
+    if (m->mem_G>=0) {
+      auto rm = static_cast<RootfinderMemory*>(backward_rootfinder_->memory(m->mem_G));
+      stats["njevalsB"] = rm->njevals;
+      stats["nfactB"] = rm->nfact;
+      stats["nrejectB"] = rm->nreject;
+    }
+    return stats;
+  }
+
+  Function ImplicitFixedStepIntegrator::
+  staggered_step(const ImplicitFixedStepIntegrator& d) const {
+    // The augmented problem must stack the directions of the nondifferentiated one
+    casadi_int nd = 1 + ns_;
+    if (nx_!=nd*d.nx_ || nz_!=nd*d.nz_ || np_!=nd*d.np_ || nq_!=nd*d.nq_
+        || nZ_!=nd*d.nZ_) return Function();
+
+    // Layout of the discrete time algebraic variables, stages of (differential, algebraic)
+    Dict ss = d.stage_structure(false);
+    if (ss.empty() || d.rootfinder_.is_null()) return Function();
+    std::vector<double> stage_matrix = ss.at("stage_matrix");
+    casadi_int nstage = static_cast<casadi_int>(round(sqrt(static_cast<double>(stage_matrix.size()))));
+    casadi_int ndiff = ss.at("stage_differential");
+    if (nstage<1 || d.nZ_ % nstage) return Function();
+    casadi_int nv = d.nZ_/nstage;
+
+    // Augmented Z, per stage all differential then all algebraic directions
+    std::vector<casadi_int> perm(nZ_);
+    for (casadi_int k=0; k<nd; ++k) {
+      for (casadi_int j=0; j<nstage; ++j) {
+        for (casadi_int i=0; i<nv; ++i) {
+          casadi_int ind = j*nd*nv + (i<ndiff ? k*ndiff + i : nd*ndiff + k*(nv-ndiff) + i-ndiff);
+          perm[k*d.nZ_ + j*nv + i] = ind;
+        }
+      }
+    }
+    std::vector<casadi_int> iperm = lookupvector(perm);
+
+    // Split up the augmented inputs
+    std::vector<MX> arg = F_.mx_in();
+    std::vector<MX> x = horzsplit(reshape(arg[DAE_X], d.nx_, nd));
+    std::vector<MX> p = horzsplit(reshape(arg[DAE_P], d.np_, nd));
+    MX Z = arg[DAE_Z](perm);
+
+    // Nondifferentiated step
+    const Function& R = d.rootfinder_;
+    std::vector<MX> r_arg(DAE_NUM_IN);
+    r_arg[DAE_T] = arg[DAE_T];
+    r_arg[DAE_X] = x[0];
+    r_arg[DAE_Z] = Z(Slice(0, d.nZ_));
+    r_arg[DAE_P] = p[0];
+    std::vector<MX> r_res = R(r_arg);
+
+    // All forward directions at once, seeds for the guess are ignored
+    std::vector<MX> fseed(DAE_NUM_IN);
+    fseed[DAE_T] = MX(R.size1_in(DAE_T), ns_);
+    fseed[DAE_X] = horzcat(std::vector<MX>(x.begin()+1, x.end()));
+    fseed[DAE_Z] = MX(d.nZ_, ns_);
+    fseed[DAE_P] = horzcat(std::vector<MX>(p.begin()+1, p.end()));
+    std::vector<MX> fwd_arg = r_arg;
+    fwd_arg.insert(fwd_arg.end(), r_res.begin(), r_res.end());
+    fwd_arg.insert(fwd_arg.end(), fseed.begin(), fseed.end());
+    std::vector<MX> fwd_res = R.forward(ns_)(fwd_arg);
+
+    // Assemble the augmented outputs
+    std::vector<MX> res(DAE_NUM_OUT);
+    res[DAE_ODE] = vec(horzcat(r_res[DAE_ODE], fwd_res[DAE_ODE]));
+    res[DAE_ALG] = vec(horzcat(r_res[DAE_ALG], fwd_res[DAE_ALG]))(iperm);
+    res[DAE_QUAD] = vec(horzcat(r_res[DAE_QUAD], fwd_res[DAE_QUAD]));
+    return Function(name_ + "_sens_step", arg, res, F_.name_in(), F_.name_out());
+  }
+
   template<typename XType>
   Function Integrator::map2oracle(const std::string& name,
     const std::map<std::string, XType>& d, const Dict& opts) {
@@ -1408,6 +2315,8 @@ namespace casadi {
         de_out[DE_RALG]=i.second;
       } else if (i.first=="rquad") {
         de_out[DE_RQUAD]=i.second;
+      } else if (i.first=="event") {
+        de_out[DE_EVENT]=i.second;
       } else {
         casadi_error("No such field: " + i.first);
       }
@@ -1422,8 +2331,8 @@ namespace casadi {
     // Make sure consistent number of right-hand-sides
     for (bool b : {true, false}) {
       for (auto&& e : b ? de_in : de_out) {
-        // Skip time
-        if (&e == &de_in[DE_T]) continue;
+        // Skip time and event functions
+        if (&e == &de_in[DE_T] || &e == &de_out[DE_EVENT]) continue;
         // Number of rows
         casadi_int nr = e.size1();
         // Make sure no change in number of elements
@@ -1452,6 +2361,9 @@ namespace casadi {
       "Dimension mismatch for 'ralg'");
     de_out[DE_RALG] = project(de_out[DE_RALG], de_in[DE_RZ].sparsity());
 
+    // Event functions, a vector
+    de_out[DE_EVENT] = vec(de_out[DE_EVENT]);
+
     // Construct
     return Function(name, de_in, de_out, DE_INPUTS, DE_OUTPUTS, opts);
   }
@@ -1459,7 +2371,7 @@ namespace casadi {
   void Integrator::serialize_body(SerializingStream &s) const {
     OracleFunction::serialize_body(s);
 
-    s.version("Integrator", 1);
+    s.version("Integrator", 2);
     s.pack("Integrator::sp_jac_dae", sp_jac_dae_);
     s.pack("Integrator::sp_jac_rdae", sp_jac_rdae_);
     s.pack("Integrator::nx", nx_);
@@ -1487,6 +2399,9 @@ namespace casadi {
     s.pack("Integrator::print_stats", print_stats_);
     s.pack("Integrator::output_t0", output_t0_);
     s.pack("Integrator::ntout", ntout_);
+    s.pack("Integrator::ne", ne_);
+    s.pack("Integrator::event_transition", event_transition_);
+    s.pack("Integrator::max_events", max_events_);
   }
 
   void Integrator::serialize_type(SerializingStream &s) const {
@@ -1499,7 +2414,7 @@ namespace casadi {
   }
 
   Integrator::Integrator(DeserializingStream & s) : OracleFunction(s) {
-    s.version("Integrator", 1);
+    int version = s.version("Integrator", 1, 2);
     s.unpack("Integrator::sp_jac_dae", sp_jac_dae_);
     s.unpack("Integrator::sp_jac_rdae", sp_jac_rdae_);
     s.unpack("Integrator::nx", nx_);
@@ -1527,44 +2442,66 @@ namespace casadi {
     s.unpack("Integrator::print_stats", print_stats_);
     s.unpack("Integrator::output_t0", output_t0_);
     s.unpack("Integrator::ntout", ntout_);
+    if (version>=2) {
+      s.unpack("Integrator::ne", ne_);
+      s.unpack("Integrator::event_transition", event_transition_);
+      s.unpack("Integrator::max_events", max_events_);
+    } else {
+      ne_ = 0;
+      max_events_ = 1000;
+    }
   }
 
 
   void FixedStepIntegrator::serialize_body(SerializingStream &s) const {
     Integrator::serialize_body(s);
 
-    s.version("FixedStepIntegrator", 1);
+    s.version("FixedStepIntegrator", 3);
     s.pack("FixedStepIntegrator::F", F_);
     s.pack("FixedStepIntegrator::G", G_);
     s.pack("FixedStepIntegrator::nk", nk_);
     s.pack("FixedStepIntegrator::h", h_);
     s.pack("FixedStepIntegrator::nZ", nZ_);
     s.pack("FixedStepIntegrator::nRZ", nRZ_);
+    s.pack("FixedStepIntegrator::checkpoints", checkpoints_);
+    s.pack("FixedStepIntegrator::event_tol", event_tol_);
   }
 
   FixedStepIntegrator::FixedStepIntegrator(DeserializingStream & s) : Integrator(s) {
-    s.version("FixedStepIntegrator", 1);
+    int version = s.version("FixedStepIntegrator", 1, 3);
     s.unpack("FixedStepIntegrator::F", F_);
     s.unpack("FixedStepIntegrator::G", G_);
     s.unpack("FixedStepIntegrator::nk", nk_);
     s.unpack("FixedStepIntegrator::h", h_);
     s.unpack("FixedStepIntegrator::nZ", nZ_);
     s.unpack("FixedStepIntegrator::nRZ", nRZ_);
+    if (version>=2) {
+      s.unpack("FixedStepIntegrator::checkpoints", checkpoints_);
+    } else {
+      checkpoints_ = 0;
+    }
+    if (version>=3) {
+      s.unpack("FixedStepIntegrator::event_tol", event_tol_);
+    } else {
+      event_tol_ = 1e-12;
+    }
   }
 
   void ImplicitFixedStepIntegrator::serialize_body(SerializingStream &s) const {
     FixedStepIntegrator::serialize_body(s);
 
-    s.version("ImplicitFixedStepIntegrator", 1);
+    s.version("ImplicitFixedStepIntegrator", 2);
     s.pack("ImplicitFixedStepIntegrator::rootfinder", rootfinder_);
     s.pack("ImplicitFixedStepIntegrator::backward_rootfinder", backward_rootfinder_);
+    s.pack("ImplicitFixedStepIntegrator::sens_step", sens_step_);
   }
 
   ImplicitFixedStepIntegrator::ImplicitFixedStepIntegrator(DeserializingStream & s) :
       FixedStepIntegrator(s) {
-    s.version("ImplicitFixedStepIntegrator", 1);
+    int version = s.version("ImplicitFixedStepIntegrator", 1, 2);
     s.unpack("ImplicitFixedStepIntegrator::rootfinder", rootfinder_);
     s.unpack("ImplicitFixedStepIntegrator::backward_rootfinder", backward_rootfinder_);
+    if (version>=2) s.unpack("ImplicitFixedStepIntegrator::sens_step", sens_step_);
   }
 
 } // namespace casadi
@@ -61,6 +61,13 @@ namespace casadi {
       (i.e. dfz/dz, dgz/drz are invertible) and furthermore that
       gx, gz and gq have a linear dependency on rx, rz and rp.
 
+      State events (forward problem only)
+      e(x, z, p, t)                                 Event functions
+
+      The integration stops when a component of e changes sign, the state is
+      mapped by the 'event_transition' function, if any, and the integration
+      restarts from the event time.
+
       \endverbatim
 
       \generalsection{Integrator}
@@ -89,6 +96,36 @@ namespace casadi {
 #endif // SWIG
   ///@}
 
+  /** \brief Parallel-in-time integration with Parareal
+
+      The horizon is split into windows, integrated in parallel with the
+      integrator plugin \a solver and corrected sequentially with a coarse
+      integrator. Options are those of #integrator, which are passed on to the
+      integrator of the windows, and in addition:
+      - parareal_windows: number of windows, a multiple of the number of grid intervals
+      - parareal_iterations: number of parallel sweeps [3], equal to the number of
+        windows gives the fine solution exactly
+      - parareal_coarse: coarse integrator plugin [rk, or collocation for DAEs]
+      - parareal_coarse_options: options of the coarse integrator [a single step]
+      - parareal_parallelization: parallelization over the windows [thread]
+
+      The result has the inputs and outputs of an integrator, but it is an MX
+      Function composed of integrators, not an Integrator. Integrator statistics
+      are not available and derivatives are obtained by algorithmic
+      differentiation of the composition. Backward states and events are not
+      supported.
+  */
+  ///@{
+  CASADI_EXPORT Function parareal(const std::string& name, const std::string& solver,
+                                  const SXDict& dae, const Dict& opts);
+  CASADI_EXPORT Function parareal(const std::string& name, const std::string& solver,
+                                  const MXDict& dae, const Dict& opts);
+#ifndef SWIG
+  CASADI_EXPORT Function parareal(const std::string& name, const std::string& solver,
+                                  const Function& dae, const Dict& opts);
+#endif // SWIG
+  ///@}
+
   /// Check if a particular plugin is available
   CASADI_EXPORT bool has_integrator(const std::string& name);
 
@@ -140,10 +177,12 @@ enum DeOut {
   DE_RODE,
   DE_RALG,
   DE_RQUAD,
+  DE_EVENT,
   DE_NUM_OUT};
 
 /// Shortnames for DAE symbolic representation outputs
-const std::vector<std::string> DE_OUTPUTS = {"ode", "alg", "quad", "rode", "ralg", "rquad"};
+const std::vector<std::string> DE_OUTPUTS = {"ode", "alg", "quad", "rode", "ralg", "rquad",
+                                             "event"};
 
 /// Input arguments of an ODE/DAE function
 enum DAEInput {
@@ -36,6 +36,16 @@ namespace casadi {
 
   /** \brief Integrator memory */
   struct CASADI_EXPORT IntegratorMemory : public OracleMemory {
+    // Event that stopped the last call to advance, -1 if none, and its time
+    casadi_int event_index;
+    double t_event;
+
+    // State at the event, quadratures accumulated before it and state after the transition
+    std::vector<double> xe, ze, qe, q_acc, x_plus;
+
+    // Statistics: all events of the integration
+    std::vector<double> event_times;
+    std::vector<casadi_int> event_indices;
   };
 
   /** \brief Internal storage for integrator related data
@@ -53,6 +63,9 @@ namespace casadi {
     /** \brief  Destructor */
     ~Integrator() override=0;
 
+    /** \brief Check if the function is of a particular type */
+    bool is_a(const std::string& type, bool recursive) const override;
+
     ///@{
     /** \brief Number of function inputs and outputs */
     size_t get_n_in() override { return INTEGRATOR_NUM_IN;}
@@ -86,6 +99,13 @@ namespace casadi {
     /** Helper for a more powerful 'integrator' factory */
     virtual Function create_advanced(const Dict& opts);
 
+    /** \brief Parallel-in-time integration with Parareal
+
+        The horizon is split into windows, integrated in parallel with the
+        fine integrator 'solver' and corrected sequentially with a coarse one. */
+    static Function parareal(const std::string& name, const std::string& solver,
+                             const Function& dae, const Dict& opts);
+
     virtual MX algebraic_state_init(const MX& x0, const MX& z0) const { return z0; }
     virtual MX algebraic_state_output(const MX& Z) const { return Z; }
 
@@ -93,10 +113,23 @@ namespace casadi {
     virtual void reset(IntegratorMemory* mem, double t,
                        const double* x, const double* z, const double* p) const = 0;
 
-    /** \brief  Advance solution in time */
+    /** \brief Reset the statistics, once per evaluation rather than at every event */
+    virtual void reset_stats(IntegratorMemory* mem) const {}
+
+    /** \brief  Advance solution in time
+
+        With event functions, stop at the first zero crossing before t, setting
+        event_index and t_event in the memory object. */
     virtual void advance(IntegratorMemory* mem, double t,
                          double* x, double* z, double* q) const = 0;
 
+    /** \brief Advance solution in time, handling any events on the way */
+    void advance_events(IntegratorMemory* mem, double t, const double* p,
+                        double* x, double* z, double* q) const;
+
+    /** \brief Can the plugin locate zero crossings of the event functions? */
+    virtual bool has_events() const { return false;}
+
     /** \brief Reset the backward problem */
     virtual void resetB(IntegratorMemory* mem, double t,
                         const double* rx, const double* rz, const double* rp) const = 0;
@@ -111,6 +144,9 @@ namespace casadi {
     /** \brief  Print solver statistics */
     virtual void print_stats(IntegratorMemory* mem) const {}
 
+    /// Get all statistics
+    Dict get_stats(void* mem) const override;
+
     /** \brief  Propagate sparsity forward */
     int sp_forward(const bvec_t** arg, bvec_t** res,
       casadi_int* iw, bvec_t* w, void* mem) const override;
@@ -120,8 +156,8 @@ namespace casadi {
 
     ///@{
     /// Is the class able to propagate seeds through the algorithm?
-    bool has_spfwd() const override { return true;}
-    bool has_sprev() const override { return true;}
+    bool has_spfwd() const override { return ne_==0;}
+    bool has_sprev() const override { return ne_==0;}
     ///@}
 
     ///@{
@@ -130,7 +166,7 @@ namespace casadi {
                          const std::vector<std::string>& inames,
                          const std::vector<std::string>& onames,
                          const Dict& opts) const override;
-    bool has_forward(casadi_int nfwd) const override { return true;}
+    bool has_forward(casadi_int nfwd) const override { return ne_==0;}
     ///@}
 
     ///@{
@@ -139,7 +175,7 @@ namespace casadi {
                          const std::vector<std::string>& inames,
                          const std::vector<std::string>& onames,
                          const Dict& opts) const override;
-    bool has_reverse(casadi_int nadj) const override { return true;}
+    bool has_reverse(casadi_int nadj) const override { return ne_==0;}
     ///@}
 
     /** \brief  Set stop time for the integration */
@@ -188,6 +224,15 @@ namespace casadi {
     /// Number of sensitivities
     casadi_int ns_;
 
+    /// Number of event functions
+    casadi_int ne_;
+
+    /// State reset at events, (t, x, z, p, index) -> x+, identity if null
+    Function event_transition_;
+
+    /// Maximum number of events in one integration
+    casadi_int max_events_;
+
     // Time grid
     std::vector<double> grid_;
     casadi_int ngrid_;
@@ -260,6 +305,42 @@ namespace casadi {
 
     // Tape
     std::vector<std::vector<double> > x_tape, Z_tape;
+
+    // Checkpoints: discrete times, states and algebraic variable guesses
+    std::vector<casadi_int> chk_k;
+    std::vector<double> chk_x, chk_Z;
+
+    // Discrete time of the next checkpoint in the forward integration
+    casadi_int next_chk;
+
+    // Forward solution recomputed from a checkpoint
+    std::vector<double> x_rec, Z_rec, x_next, Z_next;
+
+    // Statistics
+    casadi_int nrecomp, nchk_max;
+
+    // Memory of the discrete time dynamics, kept between steps
+    int mem_F, mem_G;
+
+    // Events: start time of the integration, restarted after each event
+    double t_start;
+
+    // Events: start time of the last step, and event functions at its ends
+    double t_prev;
+    std::vector<double> e_prev, e;
+
+    // Events: algebraic state at the ends of the last step
+    std::vector<double> z_prev;
+
+    // Events: state derivatives and quadrature integrands at the ends of the last step
+    std::vector<double> f_prev, f, fq_prev, fq;
+
+    // Events: pending zero crossing within the last step, -1 if none
+    casadi_int pending_index;
+    double t_pending;
+
+    // Events: work vectors for the dense output and the root localization
+    std::vector<double> x_int, z_int, q_int, e_lo, e_hi, e_mid;
   };
 
   class CASADI_EXPORT FixedStepIntegrator : public Integrator {
@@ -271,6 +352,9 @@ namespace casadi {
     /// Destructor
     ~FixedStepIntegrator() override;
 
+    /** \brief Check if the function is of a particular type */
+    bool is_a(const std::string& type, bool recursive) const override;
+
     ///@{
     /** \brief Options */
     static const Options options_;
@@ -290,7 +374,7 @@ namespace casadi {
     int init_mem(void* mem) const override;
 
     /** \brief Free memory block */
-    void free_mem(void *mem) const override { delete static_cast<FixedStepMemory*>(mem);}
+    void free_mem(void *mem) const override;
 
     /// Setup F and G
     virtual void setupFG() = 0;
@@ -299,10 +383,53 @@ namespace casadi {
     void reset(IntegratorMemory* mem, double t,
                        const double* x, const double* z, const double* p) const override;
 
+    /// Initial guess for the discrete time algebraic variables
+    virtual void guess_Z(const double* x, const double* z, double* Z) const;
+
     /** \brief  Advance solution in time */
     void advance(IntegratorMemory* mem, double t,
                          double* x, double* z, double* q) const override;
 
+    /** \brief  Advance solution in time, locating events with the dense output
+
+        After an event, the steps restart at the event time and no longer end on
+        the output grid. The discrete time dynamics have a fixed step length h, so
+        the last step is not shortened. It may end up to h past t, and the
+        solution at t is taken from the dense output. The DAE is therefore
+        evaluated up to h past the end of the horizon, as it is without events
+        when h does not divide the output grid. */
+    void advance_with_events(FixedStepMemory* m, double t,
+                             double* x, double* z, double* q) const;
+
+    /** \brief Dense output of the last step at t_prev + theta*h
+
+        Cubic Hermite interpolation for the differential states and quadratures,
+        linear interpolation for the algebraic states. */
+    void interpolate(FixedStepMemory* m, double theta,
+                     double* x, double* z, double* q) const;
+
+    /** \brief Event functions at the current state */
+    void eval_event(FixedStepMemory* m, double t, const double* x,
+                    const double* z, double* e) const;
+
+    /** \brief Supports events */
+    bool has_events() const override { return true;}
+
+    /** \brief Discrete time dynamics of n instances, for eval_batch */
+    Function batch_dynamics(casadi_int n, const std::string& parallelization) const;
+
+    /** \brief Size of the work vector for eval_batch */
+    casadi_int sz_w_batch(casadi_int n) const { return n*(2*nx_ + 2*nZ_ + 2*nq_ + 1);}
+
+    /** \brief Integrate n instances in lockstep
+
+        Inputs and outputs are stacked as in Map. Fn is the discrete time
+        dynamics mapped over the n instances, called once per step.
+        Only the forward problem is supported. The statistics of all
+        instances together are recorded in the memory object mem. */
+    virtual int eval_batch(const Function& Fn, const double** arg, double** res,
+                           casadi_int* iw, double* w, casadi_int n, void* mem) const;
+
     /// Reset the backward problem and take time to tf
     void resetB(IntegratorMemory* mem, double t,
                         const double* rx, const double* rz, const double* rp) const override;
@@ -311,6 +438,9 @@ namespace casadi {
     void retreat(IntegratorMemory* mem, double t,
                          double* rx, double* rz, double* rq) const override;
 
+    /// Get all statistics
+    Dict get_stats(void* mem) const override;
+
     /// Get explicit dynamics
     virtual const Function& getExplicit() const { return F_;}
 
@@ -329,12 +459,24 @@ namespace casadi {
     /// Number of algebraic variables for the discrete time integration
     casadi_int nZ_, nRZ_;
 
+    /// Number of checkpoints for the backward problem, zero if every step is taped
+    casadi_int checkpoints_;
+
+    /// Absolute tolerance on the event times
+    double event_tol_;
+
     /** \brief Serialize an object without type information */
     void serialize_body(SerializingStream &s) const override;
 
   protected:
     /** \brief Deserializing constructor */
     explicit FixedStepIntegrator(DeserializingStream& s);
+
+    /// Discrete time of the checkpoint following the one at k, -1 if none
+    casadi_int next_checkpoint(casadi_int k, casadi_int k_last, casadi_int nchk) const;
+
+    /// Recompute the forward solution at step k from the last checkpoint before it
+    void recompute(FixedStepMemory* m, casadi_int k) const;
   };
 
   class CASADI_EXPORT ImplicitFixedStepIntegrator : public FixedStepIntegrator {
@@ -356,14 +498,45 @@ namespace casadi {
     void init(const Dict& opts) override;
 
     /// Get explicit dynamics
-    const Function& getExplicit() const override { return rootfinder_;}
+    const Function& getExplicit() const override {
+      return sens_step_.is_null() ? rootfinder_ : sens_step_;
+    }
 
     /// Get explicit dynamics (backward problem)
     const Function& getExplicitB() const override { return backward_rootfinder_;}
 
+    /** \brief Reset the statistics */
+    void reset_stats(IntegratorMemory* mem) const override;
+
+    /** \brief Integrate n instances in lockstep, counting the work of all rootfinder calls */
+    int eval_batch(const Function& Fn, const double** arg, double** res,
+                   casadi_int* iw, double* w, casadi_int n, void* mem) const override;
+
+    /// Reset the backward problem and take time to tf
+    void resetB(IntegratorMemory* mem, double t,
+                const double* rx, const double* rz, const double* rp) const override;
+
+    /// Get all statistics
+    Dict get_stats(void* mem) const override;
+
+    /** \brief Stage structure of F or G, options for the stage_newton rootfinder
+
+        The implicitly defined variables must consist of stages of equal size,
+        differential components first. Empty if there is no such structure. */
+    virtual Dict stage_structure(bool backward) const { return Dict();}
+
+    /** \brief Step with staggered forward sensitivities
+
+        Solves the step of the nondifferentiated problem, then all sensitivity
+        directions with one multi-RHS solve. Null if not applicable. */
+    Function staggered_step(const ImplicitFixedStepIntegrator& d) const;
+
     // Implicit function solver
     Function rootfinder_, backward_rootfinder_;
 
+    // Forward step with staggered sensitivities, null if not used
+    Function sens_step_;
+
     /** \brief Serialize an object without type information */
     void serialize_body(SerializingStream &s) const override;
 
@@ -0,0 +1,505 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "machine_code.hpp"
+#include "sx_function.hpp"
+#include "calculus.hpp"
+#include "exception.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#if defined(__x86_64__) && (defined(__linux__) || defined(__APPLE__))
+#include <sys/mman.h>
+#define CASADI_MACHINE_CODE_X86_64
+#endif
+
+using namespace std;
+
+namespace casadi {
+
+#ifdef CASADI_MACHINE_CODE_X86_64
+
+  namespace {
+
+    // Operation called from the generated code
+    typedef double (*scalar_fcn_t)(double x, double y);
+
+    // Scalar operation with C linkage compatible signature
+    template<casadi_int I>
+    double scalar_fcn(double x, double y) {
+      double f;
+      BinaryOperation<I>::fcn(x, y, f);
+      return f;
+    }
+
+    // Helper class for looking up scalar_fcn<I> with CASADI_MATH_FUN_BUILTIN_GEN
+    template<casadi_int I>
+    struct ScalarFcnLookup {
+      static void fcn(int, int, scalar_fcn_t& f, int) { f = scalar_fcn<I>;}
+    };
+
+    // Get a function pointer for an operation
+    scalar_fcn_t get_scalar_fcn(int op) {
+      scalar_fcn_t f = nullptr;
+      switch (op) {
+        CASADI_MATH_FUN_BUILTIN_GEN(ScalarFcnLookup, 0, 0, f, 0)
+      }
+      return f;
+    }
+
+    // Bit pattern of a double
+    uint64_t bits(double d) {
+      uint64_t b;
+      memcpy(&b, &d, sizeof(b));
+      return b;
+    }
+
+    // General purpose registers used
+    enum {RAX=0, RCX=1, RBX=3, RBP=5, RSI=6, RDI=7, R15=15};
+
+    // Predicates for cmpsd
+    enum {CMP_EQ=0, CMP_LT=1, CMP_LE=2, CMP_NE=4};
+
+    // First xmm register used for caching work vector entries,
+    // xmm0 and xmm1 are scratch and argument registers
+    const int XMM_FIRST = 2;
+
+    /* Emitter for x86-64 machine code
+     *
+     * Register usage (System V calling convention):
+     * rbx: arg, rbp: res, r15: w, rax: scratch. All xmm registers are
+     * caller-saved and thus invalidated by calls into the math library.
+     */
+    class X86Emitter {
+    public:
+      X86Emitter(casadi_int sz_w) : reg_of_slot_(sz_w, -1), next_(XMM_FIRST) {
+        for (int& s : slot_of_reg_) s = -1;
+      }
+
+      // Generated code
+      std::vector<unsigned char> code;
+
+      // Function entry
+      void prologue() {
+        byte(0x53);                                  // push rbx
+        byte(0x55);                                  // push rbp
+        byte(0x41); byte(0x57);                      // push r15
+        byte(0x48); byte(0x89); byte(0xFB);          // mov rbx, rdi
+        byte(0x48); byte(0x89); byte(0xF5);          // mov rbp, rsi
+        byte(0x49); byte(0x89); byte(0xCF);          // mov r15, rcx
+        // Three pushes and the return address: stack is 16-byte aligned for calls
+      }
+
+      // Function exit, returns 0
+      void epilogue() {
+        byte(0x31); byte(0xC0);                      // xor eax, eax
+        byte(0x41); byte(0x5F);                      // pop r15
+        byte(0x5D);                                  // pop rbp
+        byte(0x5B);                                  // pop rbx
+        byte(0xC3);                                  // ret
+      }
+
+      // Translate an instruction
+      void instruction(const ScalarAtomic& e) {
+        switch (e.op) {
+        case OP_CONST:
+          {
+            int rd = alloc();
+            mov_rax_imm(bits(e.d));
+            movq_x_rax(rd);
+            def(e.i0, rd);
+          }
+          break;
+        case OP_INPUT:
+          {
+            int rd = alloc();
+            mov_rax_mem(RBX, 8*e.i1);                // rax = arg[i1]
+            test_rax();
+            size_t jz = jump(0x74);                  // jz null
+            sse_rm(0xF2, 0x10, rd, RAX, 8*e.i2);     // movsd rd, [rax+8*i2]
+            size_t jmp = jump(0xEB);                 // jmp done
+            patch(jz);
+            sse_rr(0x66, 0x57, rd, rd);              // null: xorpd rd, rd
+            patch(jmp);
+            def(e.i0, rd);
+          }
+          break;
+        case OP_OUTPUT:
+          {
+            int rx = get(e.i1);
+            mov_rax_mem(RBP, 8*e.i0);                // rax = res[i0]
+            test_rax();
+            size_t jz = jump(0x74);                  // jz done
+            sse_rm(0xF2, 0x11, rx, RAX, 8*e.i2);     // movsd [rax+8*i2], rx
+            patch(jz);
+          }
+          break;
+        case OP_ADD: binary(e, 0x58); break;
+        case OP_SUB: binary(e, 0x5C); break;
+        case OP_MUL: binary(e, 0x59); break;
+        case OP_DIV: binary(e, 0x5E); break;
+        case OP_SQRT:
+          {
+            int rx = get(e.i1);
+            int rd = alloc(rx);
+            sse_rr(0xF2, 0x51, rd, rx);              // sqrtsd rd, rx
+            def(e.i0, rd);
+          }
+          break;
+        case OP_ASSIGN:
+          {
+            int rx = get(e.i1);
+            int rd = alloc(rx);
+            movapd(rd, rx);
+            def(e.i0, rd);
+          }
+          break;
+        case OP_SQ: unary_self(e, 0x59); break;
+        case OP_TWICE: unary_self(e, 0x58); break;
+        case OP_NEG: sign_bit(e, 0xF8); break;
+        case OP_FABS: sign_bit(e, 0xF0); break;
+        case OP_INV:
+          {
+            int rx = get(e.i1);
+            int rd = alloc(rx);
+            mov_rax_imm(bits(1));
+            movq_x_rax(rd);
+            sse_rr(0xF2, 0x5E, rd, rx);              // divsd rd, rx
+            def(e.i0, rd);
+          }
+          break;
+        case OP_LT: compare(e, CMP_LT); break;
+        case OP_LE: compare(e, CMP_LE); break;
+        case OP_EQ: compare(e, CMP_EQ); break;
+        case OP_NE: compare(e, CMP_NE); break;
+        case OP_NOT:
+          {
+            int rx = get(e.i1);
+            int rd = alloc(rx);
+            sse_rr(0x66, 0x57, 1, 1);                // xorpd xmm1, xmm1
+            movapd(rd, rx);
+            cmpsd(rd, 1, CMP_EQ);
+            and_one(rd);
+            def(e.i0, rd);
+          }
+          break;
+        case OP_AND: logical(e, 0x54); break;
+        case OP_OR: logical(e, 0x56); break;
+        case OP_IF_ELSE_ZERO:
+          {
+            int rx = get(e.i1);
+            int ry = get(e.i2, rx);
+            int rd = alloc(rx, ry);
+            sse_rr(0x66, 0x57, 1, 1);                // xorpd xmm1, xmm1
+            movapd(rd, rx);
+            cmpsd(rd, 1, CMP_NE);                    // x!=0, also true for NaN
+            sse_rr(0x66, 0x54, rd, ry);              // andpd rd, ry
+            def(e.i0, rd);
+          }
+          break;
+        default:
+          {
+            scalar_fcn_t f = get_scalar_fcn(e.op);
+            casadi_assert(f!=nullptr, "Unknown operation " + str(e.op));
+            call(e, f);
+          }
+        }
+      }
+
+    private:
+      void byte(unsigned char b) { code.push_back(b);}
+
+      void dword(casadi_int v) {
+        casadi_assert(v>=0 && v<=std::numeric_limits<int32_t>::max(),
+                      "Displacement too large for native code");
+        uint32_t u = static_cast<uint32_t>(v);
+        for (int k=0; k<4; ++k) byte((u >> (8*k)) & 0xFF);
+      }
+
+      void qword(uint64_t v) {
+        for (int k=0; k<8; ++k) byte((v >> (8*k)) & 0xFF);
+      }
+
+      // SSE instruction, register operands: op r, m
+      void sse_rr(unsigned char prefix, unsigned char op, int r, int m) {
+        byte(prefix);
+        unsigned char rex = (r>=8 ? 4 : 0) | (m>=8 ? 1 : 0);
+        if (rex) byte(0x40 | rex);
+        byte(0x0F);
+        byte(op);
+        byte(0xC0 | (r & 7) << 3 | (m & 7));
+      }
+
+      // SSE instruction, memory operand [base+disp32]: op r, m64
+      void sse_rm(unsigned char prefix, unsigned char op, int r, int base, casadi_int disp) {
+        byte(prefix);
+        unsigned char rex = (r>=8 ? 4 : 0) | (base>=8 ? 1 : 0);
+        if (rex) byte(0x40 | rex);
+        byte(0x0F);
+        byte(op);
+        byte(0x80 | (r & 7) << 3 | (base & 7));
+        dword(disp);
+      }
+
+      void movapd(int r, int m) { if (r!=m) sse_rr(0x66, 0x28, r, m);}
+
+      void cmpsd(int r, int m, unsigned char pred) {
+        sse_rr(0xF2, 0xC2, r, m);
+        byte(pred);
+      }
+
+      // mov rax, imm64
+      void mov_rax_imm(uint64_t v) {
+        byte(0x48); byte(0xB8);
+        qword(v);
+      }
+
+      // mov rax, [base+disp32]
+      void mov_rax_mem(int base, casadi_int disp) {
+        byte(0x48 | (base>=8 ? 1 : 0));
+        byte(0x8B);
+        byte(0x80 | (base & 7));
+        dword(disp);
+      }
+
+      // movq r, rax
+      void movq_x_rax(int r) {
+        byte(0x66); byte(0x48 | (r>=8 ? 4 : 0)); byte(0x0F); byte(0x6E);
+        byte(0xC0 | (r & 7) << 3);
+      }
+
+      // movq rax, r
+      void movq_rax_x(int r) {
+        byte(0x66); byte(0x48 | (r>=8 ? 4 : 0)); byte(0x0F); byte(0x7E);
+        byte(0xC0 | (r & 7) << 3);
+      }
+
+      // test rax, rax
+      void test_rax() { byte(0x48); byte(0x85); byte(0xC0);}
+
+      // Short jump with an offset to be patched, returns its location
+      size_t jump(unsigned char op) {
+        byte(op);
+        byte(0);
+        return code.size() - 2;
+      }
+
+      // Let a short jump point to the current location
+      void patch(size_t loc) {
+        size_t offset = code.size() - (loc + 2);
+        casadi_assert_dev(offset<128);
+        code[loc + 1] = static_cast<unsigned char>(offset);
+      }
+
+      // rd = x op y
+      void binary(const ScalarAtomic& e, unsigned char op) {
+        int rx = get(e.i1);
+        int ry = get(e.i2, rx);
+        int rd = alloc(rx, ry);
+        movapd(rd, rx);
+        sse_rr(0xF2, op, rd, ry);
+        def(e.i0, rd);
+      }
+
+      // rd = x op x
+      void unary_self(const ScalarAtomic& e, unsigned char op) {
+        int rx = get(e.i1);
+        int rd = alloc(rx);
+        movapd(rd, rx);
+        sse_rr(0xF2, op, rd, rx);
+        def(e.i0, rd);
+      }
+
+      // Complement (btc) or reset (btr) the sign bit
+      void sign_bit(const ScalarAtomic& e, unsigned char modrm) {
+        int rx = get(e.i1);
+        int rd = alloc(rx);
+        movq_rax_x(rx);
+        byte(0x48); byte(0x0F); byte(0xBA); byte(modrm); byte(63);
+        movq_x_rax(rd);
+        def(e.i0, rd);
+      }
+
+      // Mask to 1.0 (all ones) or 0.0 (all zeros)
+      void and_one(int rd) {
+        mov_rax_imm(bits(1));
+        movq_x_rax(0);
+        sse_rr(0x66, 0x54, rd, 0);                   // andpd rd, xmm0
+      }
+
+      // rd = x pred y
+      void compare(const ScalarAtomic& e, unsigned char pred) {
+        int rx = get(e.i1);
+        int ry = get(e.i2, rx);
+        int rd = alloc(rx, ry);
+        movapd(rd, rx);
+        cmpsd(rd, ry, pred);
+        and_one(rd);
+        def(e.i0, rd);
+      }
+
+      // rd = (x!=0) op (y!=0)
+      void logical(const ScalarAtomic& e, unsigned char op) {
+        int rx = get(e.i1);
+        int ry = get(e.i2, rx);
+        int rd = alloc(rx, ry);
+        sse_rr(0x66, 0x57, 1, 1);                    // xorpd xmm1, xmm1
+        movapd(rd, rx);
+        cmpsd(rd, 1, CMP_NE);
+        movapd(0, ry);
+        cmpsd(0, 1, CMP_NE);
+        sse_rr(0x66, op, rd, 0);
+        and_one(rd);
+        def(e.i0, rd);
+      }
+
+      // Call into the math library
+      void call(const ScalarAtomic& e, scalar_fcn_t f) {
+        load_arg(0, e.i1);
+        load_arg(1, e.i2);
+        mov_rax_imm(reinterpret_cast<uint64_t>(f));
+        byte(0xFF); byte(0xD0);                      // call rax
+        // All xmm registers are caller-saved
+        for (int r=0; r<16; ++r) {
+          if (slot_of_reg_[r]>=0) reg_of_slot_[slot_of_reg_[r]] = -1;
+          slot_of_reg_[r] = -1;
+        }
+        int rd = alloc();
+        movapd(rd, 0);
+        def(e.i0, rd);
+      }
+
+      // Load a work vector entry into xmm0 or xmm1
+      void load_arg(int r, int slot) {
+        if (reg_of_slot_[slot]>=0) {
+          movapd(r, reg_of_slot_[slot]);
+        } else {
+          sse_rm(0xF2, 0x10, r, R15, 8*slot);
+        }
+      }
+
+      // Allocate a register, round-robin, not equal to pin1 or pin2
+      int alloc(int pin1=-1, int pin2=-1) {
+        int r;
+        do {
+          r = next_;
+          next_ = next_==15 ? XMM_FIRST : next_ + 1;
+        } while (r==pin1 || r==pin2);
+        if (slot_of_reg_[r]>=0) reg_of_slot_[slot_of_reg_[r]] = -1;
+        slot_of_reg_[r] = -1;
+        return r;
+      }
+
+      // Get the register holding a work vector entry, loading if needed
+      int get(int slot, int pin=-1) {
+        if (reg_of_slot_[slot]>=0) return reg_of_slot_[slot];
+        int r = alloc(pin);
+        sse_rm(0xF2, 0x10, r, R15, 8*slot);          // movsd r, [r15+8*slot]
+        bind(r, slot);
+        return r;
+      }
+
+      // Write back a result and cache it
+      void def(int slot, int r) {
+        sse_rm(0xF2, 0x11, r, R15, 8*slot);          // movsd [r15+8*slot], r
+        bind(r, slot);
+      }
+
+      // Register r now holds work vector entry slot
+      void bind(int r, int slot) {
+        if (reg_of_slot_[slot]>=0) slot_of_reg_[reg_of_slot_[slot]] = -1;
+        if (slot_of_reg_[r]>=0) reg_of_slot_[slot_of_reg_[r]] = -1;
+        reg_of_slot_[slot] = r;
+        slot_of_reg_[r] = slot;
+      }
+
+      // Register caching each work vector entry, if any
+      std::vector<int> reg_of_slot_;
+
+      // Work vector entry cached in each register, if any
+      int slot_of_reg_[16];
+
+      // Next register to allocate
+      int next_;
+    };
+
+  } // namespace
+
+#endif // CASADI_MACHINE_CODE_X86_64
+
+  MachineCode::MachineCode() : mem_(nullptr), size_(0), fcn_(nullptr) {
+  }
+
+  MachineCode::~MachineCode() {
+    clear();
+  }
+
+  bool MachineCode::is_supported() {
+#ifdef CASADI_MACHINE_CODE_X86_64
+    return true;
+#else // CASADI_MACHINE_CODE_X86_64
+    return false;
+#endif // CASADI_MACHINE_CODE_X86_64
+  }
+
+  void MachineCode::clear() {
+#ifdef CASADI_MACHINE_CODE_X86_64
+    if (mem_) munmap(mem_, size_);
+#endif // CASADI_MACHINE_CODE_X86_64
+    mem_ = nullptr;
+    size_ = 0;
+    fcn_ = nullptr;
+  }
+
+  void MachineCode::compile(const ScalarAtomic* alg, casadi_int n_alg, casadi_int sz_w) {
+    clear();
+#ifdef CASADI_MACHINE_CODE_X86_64
+    // Translate the algorithm
+    X86Emitter em(sz_w);
+    em.prologue();
+    for (casadi_int k=0; k<n_alg; ++k) em.instruction(alg[k]);
+    em.epilogue();
+
+    // Copy to executable memory
+    void* mem = mmap(nullptr, em.code.size(), PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANON, -1, 0);
+    casadi_assert(mem!=MAP_FAILED, "Failed to allocate memory for native code");
+    memcpy(mem, em.code.data(), em.code.size());
+    if (mprotect(mem, em.code.size(), PROT_READ | PROT_EXEC)) {
+      munmap(mem, em.code.size());
+      casadi_error("Failed to make native code executable");
+    }
+    mem_ = mem;
+    size_ = em.code.size();
+    fcn_ = reinterpret_cast<eval_t>(mem);
+#else // CASADI_MACHINE_CODE_X86_64
+    casadi_error("Native code generation is only available for x86-64 on Linux and macOS");
+#endif // CASADI_MACHINE_CODE_X86_64
+  }
+
+} // namespace casadi
@@ -0,0 +1,95 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_MACHINE_CODE_HPP
+#define CASADI_MACHINE_CODE_HPP
+
+#include "casadi_common.hpp"
+
+/// \cond INTERNAL
+
+namespace casadi {
+
+  // Forward declaration
+  struct ScalarAtomic;
+
+  /** \brief Native machine code for an SXFunction algorithm, generated in memory
+
+      The algorithm is translated instruction by instruction to x86-64 machine code
+      with scalar SSE2 arithmetic, written to an executable memory page and called
+      directly with the signature of generated C code (eval_t).
+      No files are written and no external compiler is invoked.
+
+      Recently computed work vector entries are cached in the xmm registers;
+      every result is also written back to the work vector. Operations without
+      a short SSE2 equivalent, e.g. transcendental functions, are calls into
+      the C math library.
+  */
+  class CASADI_EXPORT MachineCode {
+  public:
+    /// Default constructor, no code
+    MachineCode();
+
+    /// Destructor, releases the executable memory
+    ~MachineCode();
+
+    /// Is native code generation available on this platform?
+    static bool is_supported();
+
+    /** \brief Generate code for an algorithm
+     *  \param alg Algorithm, as in SXFunction
+     *  \param n_alg Number of instructions
+     *  \param sz_w Length of the work vector
+     */
+    void compile(const ScalarAtomic* alg, casadi_int n_alg, casadi_int sz_w);
+
+    /// Release the generated code
+    void clear();
+
+    /// Entry point, null if no code has been generated
+    eval_t fcn() const { return fcn_;}
+
+    /// Size of the generated code in bytes
+    size_t size() const { return size_;}
+
+  private:
+    /// No copying
+    MachineCode(const MachineCode&) = delete;
+    MachineCode& operator=(const MachineCode&) = delete;
+
+    // Executable memory
+    void* mem_;
+
+    // Size of the executable memory
+    size_t size_;
+
+    // Entry point
+    eval_t fcn_;
+  };
+
+} // namespace casadi
+/// \endcond
+
+#endif // CASADI_MACHINE_CODE_HPP
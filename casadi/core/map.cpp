@@ -25,14 +25,9 @@
 
 #include "map.hpp"
 #include "serializing_stream.hpp"
-
-#ifdef CASADI_WITH_THREAD
-#ifdef CASADI_WITH_THREAD_MINGW
-#include <mingw.thread.h>
-#else // CASADI_WITH_THREAD_MINGW
-#include <thread>
-#endif // CASADI_WITH_THREAD_MINGW
-#endif // CASADI_WITH_THREAD
+#include "thread_pool.hpp"
+#include "sx_function.hpp"
+#include "integrator_impl.hpp"
 
 using namespace std;
 
@@ -53,7 +48,7 @@ namespace casadi {
   }
 
   Map::Map(const std::string& name, const Function& f, casadi_int n)
-    : FunctionInternal(name), f_(f), n_(n) {
+    : FunctionInternal(name), f_(f), n_(n), sx_batch_(0) {
   }
 
   bool Map::is_a(const std::string& type, bool recursive) const {
@@ -100,6 +95,16 @@ namespace casadi {
   Map::Map(DeserializingStream& s) : FunctionInternal(s) {
     s.unpack("Map::f", f_);
     s.unpack("Map::n", n_);
+    sx_batch_ = sx_batch();
+  }
+
+  casadi_int Map::sx_batch() const {
+    // Only for the default evaluation of SXFunction instances
+    casadi_int sz_w = f_.sz_w();
+    if (!f_.is_a("SXFunction") || sz_w==0) return 0;
+    if (!f_.get<SXFunction>()->has_eval_batch()) return 0;
+    casadi_int batch = std::min(n_, std::max(batch_work_size / sz_w, casadi_int(1)));
+    return batch>1 ? batch : 0;
   }
 
   ProtoFunction* Map::deserialize(DeserializingStream& s) {
@@ -131,6 +136,45 @@ namespace casadi {
     alloc_res(f_.sz_res());
     alloc_w(f_.sz_w());
     alloc_iw(f_.sz_iw());
+
+    // Work vector for batched evaluation of SXFunction instances
+    sx_batch_ = sx_batch();
+    if (sx_batch_>0) alloc_w(f_.sz_w() * sx_batch_);
+
+    // Lockstep integration of FixedStepIntegrator instances, forward problem without events only
+    if (f_.is_a("FixedStepIntegrator", true)) {
+      const FixedStepIntegrator* intg = f_.get<FixedStepIntegrator>();
+      if (intg->nrx_==0 && intg->ne_==0) {
+        batch_ = intg->batch_dynamics(n_, parallelization());
+        alloc(batch_);
+        alloc_w(intg->sz_w_batch(n_), true);
+      }
+    }
+  }
+
+  int Map::init_mem(void* mem) const {
+    if (FunctionInternal::init_mem(mem)) return 1;
+    auto m = static_cast<MapMemory*>(mem);
+    // The integrator memory collects the statistics of all instances
+    m->mem_f = batch_.is_null() ? -1 : f_.checkout();
+    return 0;
+  }
+
+  void Map::free_mem(void *mem) const {
+    auto m = static_cast<MapMemory*>(mem);
+    if (m->mem_f>=0) f_.release(m->mem_f);
+    delete m;
+  }
+
+  Dict Map::get_stats(void* mem) const {
+    Dict stats = FunctionInternal::get_stats(mem);
+    auto m = static_cast<MapMemory*>(mem);
+    if (m->mem_f>=0) {
+      Dict f_stats = f_.stats(m->mem_f);
+      update_dict(f_stats, stats);
+      stats = f_stats;
+    }
+    return stats;
   }
 
   template<typename T>
@@ -311,6 +355,33 @@ namespace casadi {
   }
 
   int Map::eval(const double** arg, double** res, casadi_int* iw, double* w, void* mem) const {
+    // Integrate FixedStepIntegrator instances in lockstep
+    if (!batch_.is_null()) {
+      auto m = static_cast<MapMemory*>(mem);
+      return f_.get<FixedStepIntegrator>()->eval_batch(batch_, arg, res, iw, w, n_,
+                                                       f_.memory(m->mem_f));
+    }
+
+    // Evaluate batches of SXFunction instances at once
+    if (sx_batch_>0) {
+      const SXFunction* ff = f_.get<SXFunction>();
+      const double** arg1 = arg+n_in_;
+      copy_n(arg, n_in_, arg1);
+      double** res1 = res+n_out_;
+      copy_n(res, n_out_, res1);
+      for (casadi_int i=0; i<n_; i+=sx_batch_) {
+        casadi_int nb = std::min(sx_batch_, n_-i);
+        if (ff->eval_batch(arg1, res1, w, nb)) return 1;
+        for (casadi_int j=0; j<n_in_; ++j) {
+          if (arg1[j]) arg1[j] += nb*f_.nnz_in(j);
+        }
+        for (casadi_int j=0; j<n_out_; ++j) {
+          if (res1[j]) res1[j] += nb*f_.nnz_out(j);
+        }
+      }
+      return 0;
+    }
+
     // This checkout/release dance is an optimization.
     // Could also use the thread-safe variant f_(arg1, res1, iw, w)
     // in Map::eval_gen
@@ -326,6 +397,9 @@ namespace casadi {
 #ifndef WITH_OPENMP
     return Map::eval(arg, res, iw, w, mem);
 #else // WITH_OPENMP
+    // Parallelized in the discrete time dynamics
+    if (!batch_.is_null()) return Map::eval(arg, res, iw, w, mem);
+
     size_t sz_arg, sz_res, sz_iw, sz_w;
     f_.sz_work(sz_arg, sz_res, sz_iw, sz_w);
 
@@ -459,6 +533,9 @@ namespace casadi {
 #ifndef CASADI_WITH_THREAD
     return Map::eval(arg, res, iw, w, mem);
 #else // CASADI_WITH_THREAD
+    // Parallelized in the discrete time dynamics
+    if (!batch_.is_null()) return Map::eval(arg, res, iw, w, mem);
+
     // Checkout memory objects
     std::vector< scoped_checkout<Function> > ind; ind.reserve(n_);
     for (casadi_int i=0; i<n_; ++i) ind.emplace_back(f_);
@@ -466,22 +543,10 @@ namespace casadi {
     // Allocate space for return values
     std::vector<int> ret_values(n_);
 
-    // Spawn threads
-    std::vector<std::thread> threads;
-    for (casadi_int i=0; i<n_; ++i) {
-      // Why the lambda function?
-      // Because it was the first iteration to pass tests on MingGW
-      // using mingw-std-threads.
-      threads.emplace_back(
-        [i](const Function& f, const double** arg, double** res,
-            casadi_int* iw, double* w, casadi_int ind, int& ret) {
-              ThreadsWork(f, i, arg, res, iw, w, ind, ret);
-            },
-        std::ref(f_), arg, res, iw, w, casadi_int(ind[i]), std::ref(ret_values[i]));
-    }
-
-    // Join threads
-    for (auto && th : threads) th.join();
+    // Evaluate on the persistent worker pool
+    ThreadPool::instance().run(n_, [&](casadi_int i) {
+      ThreadsWork(f_, i, arg, res, iw, w, ind[i], ret_values[i]);
+    });
 
     // Anticipate success
     int ret = 0;
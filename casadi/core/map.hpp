@@ -32,6 +32,12 @@
 
 namespace casadi {
 
+  /** \brief Memory of a Map */
+  struct CASADI_EXPORT MapMemory : public FunctionMemory {
+    // Memory of the FixedStepIntegrator integrated in lockstep, -1 if none
+    int mem_f;
+  };
+
   /** Evaluate in parallel
       \author Joel Andersson
       \date 2015
@@ -124,6 +130,18 @@ namespace casadi {
     /** \brief  Initialize */
     void init(const Dict& opts) override;
 
+    /** \brief Create memory block */
+    void* alloc_mem() const override { return new MapMemory();}
+
+    /** \brief Initalize memory block */
+    int init_mem(void* mem) const override;
+
+    /** \brief Free memory block */
+    void free_mem(void *mem) const override;
+
+    /// Get all statistics, including those of an integrator integrated in lockstep
+    Dict get_stats(void* mem) const override;
+
     ///@{
     /** \brief Generate a function that calculates \a nfwd forward derivatives */
     bool has_forward(casadi_int nfwd) const override { return true;}
@@ -168,6 +186,18 @@ namespace casadi {
 
     // Number of times to evaluate this function
     casadi_int n_;
+
+    // Discrete time dynamics of all instances, for integrating FixedStepIntegrator in lockstep
+    Function batch_;
+
+    // Work vector budget (in doubles) for batched evaluation of SXFunction instances
+    static const casadi_int batch_work_size = 1 << 16;
+
+    // Number of SXFunction instances evaluated at once, 0 if not batched
+    casadi_int sx_batch_;
+
+    // Determine sx_batch_ from f_ and n_
+    casadi_int sx_batch() const;
   };
 
   /** A map Evaluate in parallel using OpenMP
@@ -213,6 +243,9 @@ namespace casadi {
       Note: Do not use this class with much more than the intended number of
       threads for the parallel evaluation as it will cause excessive memory use.
 
+      Evaluations are dispatched to the persistent ThreadPool,
+      no threads are created or joined per call.
+
       \author Joris Gillis
       \date 2018
   */
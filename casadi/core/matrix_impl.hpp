@@ -2580,6 +2580,12 @@ namespace casadi {
     casadi_error("'shared' not defined for " + type_name());
   }
 
+  template<typename Scalar>
+  std::vector<Matrix<Scalar> > Matrix<Scalar>::cse(const std::vector<Matrix<Scalar> >& e) {
+    // Numerical matrices have no subexpressions
+    return e;
+  }
+
   template<typename Scalar>
   Matrix<Scalar> Matrix<Scalar>::poly_coeff(const Matrix<Scalar>& f,
                                                 const Matrix<Scalar>&x) {
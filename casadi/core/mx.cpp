@@ -37,6 +37,9 @@
 #include "im.hpp"
 #include "bspline.hpp"
 
+#include <cstring>
+#include <unordered_map>
+
 // Throw informative error message
 #define CASADI_THROW_ERROR(FNAME, WHAT) \
 throw CasadiException("Error in MX::" FNAME " at " + CASADI_WHERE + ":\n"\
@@ -1653,6 +1656,111 @@ namespace casadi {
     }
   }
 
+  std::vector<MX> MX::cse(const std::vector<MX>& ex) {
+    try {
+      // Sort the expression
+      Function f("tmp_cse", vector<MX>{}, ex);
+      auto *ff = f.get<MXFunction>();
+
+      // Get references to the internal data structures
+      const vector<MXAlgEl>& algorithm = ff->algorithm_;
+      vector<MX> work(ff->workloc_.size()-1);
+
+      // Allocate storage for split outputs
+      vector<vector<MX> > res_split(ex.size());
+      for (casadi_int i=0; i<ex.size(); ++i) res_split[i].resize(ex[i].n_primitives());
+
+      // Unique nodes, bucketed by a hash of the operation and its dependencies
+      std::unordered_map<size_t, vector<MX> > unique;
+
+      // Arguments for calling the atomic operations
+      vector<MX> oarg, ores;
+
+      // Evaluate the algorithm
+      for (auto it=algorithm.begin(); it<algorithm.end(); ++it) {
+        switch (it->op) {
+        case OP_OUTPUT:
+          res_split.at(it->data->ind()).at(it->data->segment()) = work[it->arg.front()];
+          break;
+        case OP_PARAMETER:
+          work[it->res.front()] = it->data;
+          break;
+        default:
+          {
+            // Arguments of the operation
+            bool changed = false;
+            oarg.resize(it->arg.size());
+            for (casadi_int i=0; i<oarg.size(); ++i) {
+              casadi_int el = it->arg[i];
+              oarg[i] = el<0 ? MX(it->data->dep(i).size()) : work.at(el);
+              if (!MX::is_equal(oarg[i], it->data->dep(i))) changed = true;
+            }
+
+            // Perform the operation, reusing the original node if possible
+            ores.resize(it->res.size());
+            if (changed) {
+              it->data->eval_mx(oarg, ores);
+            } else {
+              for (casadi_int i=0; i<ores.size(); ++i) ores[i] = it->data.get_output(i);
+            }
+
+            // Merge with an equivalent node, if any (single-output nodes only)
+            if (ores.size()==1 && !ores[0].is_symbolic()) {
+              MXNode* n = ores[0].get();
+              size_t key = n->op();
+              hash_combine(key, n->n_dep());
+              if (n->op()==OP_CONST) {
+                // Constants by value
+                hash_combine(key, n->sparsity().hash());
+                for (double v : n->get_DM().nonzeros()) {
+                  int64_t bits;
+                  std::memcpy(&bits, &v, sizeof(bits));
+                  hash_combine(key, bits);
+                }
+              } else if (n->is_binary() && operation_checker<CommChecker>(n->op())) {
+                // Order of arguments irrelevant for commutative operations
+                size_t hx = reinterpret_cast<size_t>(n->dep(0).get());
+                size_t hy = reinterpret_cast<size_t>(n->dep(1).get());
+                if (hy<hx) std::swap(hx, hy);
+                hash_combine(key, hx);
+                hash_combine(key, hy);
+              } else {
+                for (casadi_int i=0; i<n->n_dep(); ++i) {
+                  hash_combine(key, reinterpret_cast<size_t>(n->dep(i).get()));
+                }
+              }
+              vector<MX>& bucket = unique[key];
+              bool found = false;
+              for (auto&& c : bucket) {
+                if (c.sparsity()==ores[0].sparsity() && MX::is_equal(c, ores[0], 1)) {
+                  ores[0] = c;
+                  found = true;
+                  break;
+                }
+              }
+              if (!found) bucket.push_back(ores[0]);
+            }
+
+            // Get the result
+            for (casadi_int i=0; i<ores.size(); ++i) {
+              casadi_int el = it->res[i];
+              if (el>=0) work.at(el) = ores[i];
+            }
+          }
+        }
+      }
+
+      // Join split outputs
+      vector<MX> ret(ex.size());
+      for (casadi_int i=0; i<ret.size(); ++i) {
+        ret[i] = ex[i].join_primitives(res_split[i]);
+      }
+      return ret;
+    } catch (std::exception& e) {
+      CASADI_THROW_ERROR("cse", e.what());
+    }
+  }
+
   MX MX::jacobian(const MX &f, const MX &x, const Dict& opts) {
     try {
       Dict h_opts;
@@ -264,6 +264,9 @@ namespace casadi {
     m->success = false;
     m->unified_return_status = SOLVER_RET_UNKNOWN;
 
+    // Reset the counters
+    m->njevals = m->nfact = m->nreject = 0;
+
     return 0;
   }
 
@@ -545,6 +548,9 @@ namespace casadi {
     auto m = static_cast<RootfinderMemory*>(mem);
     stats["success"] = m->success;
     stats["unified_return_status"] = string_from_UnifiedReturnStatus(m->unified_return_status);
+    stats["njevals"] = m->njevals;
+    stats["nfact"] = m->nfact;
+    stats["nreject"] = m->nreject;
     return stats;
   }
 
@@ -46,6 +46,9 @@ namespace casadi {
 
     // Return status
     FunctionInternal::UnifiedReturnStatus unified_return_status;
+
+    // Jacobian evaluations, factorizations and rejected outdated Jacobians, over all calls
+    casadi_int njevals, nfact, nreject;
   };
 
   /// Internal class
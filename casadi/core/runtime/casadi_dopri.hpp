@@ -0,0 +1,104 @@
+// NOLINT(legal/copyright)
+
+// C-REPLACE "fmin" "casadi_fmin"
+// C-REPLACE "fmax" "casadi_fmax"
+// C-REPLACE "fabs" "casadi_fabs"
+
+// SYMBOL "dopri_stage"
+// Dormand-Prince 5(4) stage value y = x + h*sum_{j<s} a_sj*k_j, k_j stored at k+j*n
+// Stage s=6 is the fifth order solution
+template<typename T1>
+void casadi_dopri_stage(casadi_int n, casadi_int s, T1 h, const T1* x, const T1* k, T1* y) {
+  static const T1 a[] = {
+    1./5,
+    3./40, 9./40,
+    44./45, -56./15, 32./9,
+    19372./6561, -25360./2187, 64448./6561, -212./729,
+    9017./3168, -355./33, 46732./5247, 49./176, -5103./18656,
+    35./384, 0., 500./1113, 125./192, -2187./6784, 11./84};
+  casadi_int i, j;
+  const T1* a_s;
+  a_s = a + (s*(s-1))/2;
+  for (i=0; i<n; ++i) y[i] = x[i];
+  for (j=0; j<s; ++j) {
+    if (a_s[j]==0) continue;
+    for (i=0; i<n; ++i) y[i] += h*a_s[j]*k[i+j*n];
+  }
+}
+
+// SYMBOL "dopri_err"
+// Sum of squares of the scaled local error estimates of a Dormand-Prince 5(4) step
+template<typename T1>
+T1 casadi_dopri_err(casadi_int n, T1 h, const T1* x0, const T1* x1, const T1* k,
+                    T1 abstol, T1 reltol) {
+  static const T1 e[] = {71./57600, 0., -71./16695, 71./1920, -17253./339200, 22./525, -1./40};
+  casadi_int i, j;
+  T1 r, err, sk;
+  r = 0;
+  for (i=0; i<n; ++i) {
+    err = 0;
+    for (j=0; j<7; ++j) err += e[j]*k[i+j*n];
+    sk = abstol + reltol*fmax(fabs(x0[i]), fabs(x1[i]));
+    err *= h/sk;
+    r += err*err;
+  }
+  return r;
+}
+
+// SYMBOL "dopri_cont"
+// Coefficients of the continuous extension of an accepted Dormand-Prince 5(4) step
+// len[c] = 5*n
+template<typename T1>
+void casadi_dopri_cont(casadi_int n, T1 h, const T1* x0, const T1* x1, const T1* k, T1* c) {
+  static const T1 d[] = {-12715105075./11282082432, 0., 87487479700./32700410799,
+    -10690763975./1880347072, 701980252875./199316789632, -1453857185./822651844,
+    69997945./29380423};
+  casadi_int i, j;
+  for (i=0; i<n; ++i) {
+    c[i] = x0[i];
+    c[i+n] = x1[i] - x0[i];
+    c[i+2*n] = h*k[i] - c[i+n];
+    c[i+3*n] = c[i+n] - h*k[i+6*n] - c[i+2*n];
+    c[i+4*n] = 0;
+    for (j=0; j<7; ++j) c[i+4*n] += d[j]*k[i+j*n];
+    c[i+4*n] *= h;
+  }
+}
+
+// SYMBOL "dopri_interp"
+// Evaluate the continuous extension at theta in [0, 1]
+template<typename T1>
+void casadi_dopri_interp(casadi_int n, T1 theta, const T1* c, T1* y) {
+  casadi_int i;
+  T1 theta1;
+  theta1 = 1 - theta;
+  for (i=0; i<n; ++i) {
+    y[i] = c[i] + theta*(c[i+n] + theta1*(c[i+2*n] + theta*(c[i+3*n] + theta1*c[i+4*n])));
+  }
+}
+
+// SYMBOL "dopri_fac"
+// Step size factor from the error norm, not increasing the step after a rejection
+template<typename T1>
+T1 casadi_dopri_fac(T1 err, casadi_int reject) {
+  T1 fac;
+  fac = err>0 ? 0.9*pow(err, -0.2) : 5.;
+  fac = fmin(reject ? 1. : 5., fmax(0.2, fac));
+  return fac;
+}
+
+// SYMBOL "dopri_h0"
+// Initial step size estimate from the state and its time derivative
+template<typename T1>
+T1 casadi_dopri_h0(casadi_int n, const T1* x, const T1* k, T1 abstol, T1 reltol) {
+  casadi_int i;
+  T1 d0, d1, sk;
+  d0 = d1 = 0;
+  for (i=0; i<n; ++i) {
+    sk = abstol + reltol*fabs(x[i]);
+    d0 += (x[i]/sk)*(x[i]/sk);
+    d1 += (k[i]/sk)*(k[i]/sk);
+  }
+  if (d0<1e-10*n || d1<1e-10*n) return 1e-6;
+  return 0.01*sqrt(d0/d1);
+}
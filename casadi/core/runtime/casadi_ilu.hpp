@@ -0,0 +1,80 @@
+// NOLINT(legal/copyright)
+// SYMBOL "ilu"
+// Incomplete LU factorization, restricted to the sparsity patterns of L and U
+// L is unit lower triangular with the strictly lower entries stored, U is upper
+// triangular with the diagonal entry last in each column. The pattern of A must be
+// contained in the union of the two patterns.
+// len[w] >= n
+template<typename T1>
+void casadi_ilu(const casadi_int* sp_a, const T1* a, const casadi_int* sp_l, T1* l,
+                const casadi_int* sp_u, T1* u, T1* w) {
+  const casadi_int *a_colind, *a_row, *l_colind, *l_row, *u_colind, *u_row;
+  casadi_int n, r, c, k, k2;
+  T1 d;
+  // Extract sparsities
+  n=sp_a[1];
+  a_colind=sp_a+2; a_row=sp_a+2+n+1;
+  l_colind=sp_l+2; l_row=sp_l+2+n+1;
+  u_colind=sp_u+2; u_row=sp_u+2+n+1;
+  // Clear w
+  for (r=0; r<n; ++r) w[r] = 0;
+  // Loop over columns
+  for (c=0; c<n; ++c) {
+    // Scatter column c of A
+    for (k=a_colind[c]; k<a_colind[c+1]; ++k) w[a_row[k]] = a[k];
+    // Eliminate with the previous columns, u(r,c) is final when reached
+    for (k=u_colind[c]; k<u_colind[c+1]-1; ++k) {
+      r = u_row[k];
+      for (k2=l_colind[r]; k2<l_colind[r+1]; ++k2) w[l_row[k2]] -= l[k2]*w[r];
+    }
+    // Gather column c of U and L, dropping any fill outside of the patterns
+    for (k=u_colind[c]; k<u_colind[c+1]; ++k) u[k] = w[u_row[k]];
+    d = u[u_colind[c+1]-1];
+    for (k=l_colind[c]; k<l_colind[c+1]; ++k) l[k] = w[l_row[k]]/d;
+    // Clear w
+    for (k=u_colind[c]; k<u_colind[c+1]-1; ++k) {
+      r = u_row[k];
+      for (k2=l_colind[r]; k2<l_colind[r+1]; ++k2) w[l_row[k2]] = 0;
+    }
+    for (k=a_colind[c]; k<a_colind[c+1]; ++k) w[a_row[k]] = 0;
+    for (k=u_colind[c]; k<u_colind[c+1]; ++k) w[u_row[k]] = 0;
+    for (k=l_colind[c]; k<l_colind[c+1]; ++k) w[l_row[k]] = 0;
+  }
+}
+
+// SYMBOL "ilu_solve"
+// Linear solve using an incomplete LU factorization, optionally transposed
+template<typename T1>
+void casadi_ilu_solve(T1* x, casadi_int nrhs, casadi_int tr, const casadi_int* sp_l, const T1* l,
+                      const casadi_int* sp_u, const T1* u) {
+  const casadi_int *l_colind, *l_row, *u_colind, *u_row;
+  casadi_int n, c, k, j;
+  // Extract sparsities
+  n=sp_l[1];
+  l_colind=sp_l+2; l_row=sp_l+2+n+1;
+  u_colind=sp_u+2; u_row=sp_u+2+n+1;
+  for (j=0; j<nrhs; ++j) {
+    if (tr) {
+      // Solve U' y = b
+      for (c=0; c<n; ++c) {
+        for (k=u_colind[c]; k<u_colind[c+1]-1; ++k) x[c] -= u[k]*x[u_row[k]];
+        x[c] /= u[u_colind[c+1]-1];
+      }
+      // Solve L' x = y
+      for (c=n-1; c>=0; --c) {
+        for (k=l_colind[c]; k<l_colind[c+1]; ++k) x[c] -= l[k]*x[l_row[k]];
+      }
+    } else {
+      // Solve L y = b
+      for (c=0; c<n; ++c) {
+        for (k=l_colind[c]; k<l_colind[c+1]; ++k) x[l_row[k]] -= l[k]*x[c];
+      }
+      // Solve U x = y
+      for (c=n-1; c>=0; --c) {
+        x[c] /= u[u_colind[c+1]-1];
+        for (k=u_colind[c]; k<u_colind[c+1]-1; ++k) x[u_row[k]] -= u[k]*x[c];
+      }
+    }
+    x += n;
+  }
+}
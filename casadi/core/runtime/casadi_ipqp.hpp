@@ -0,0 +1,542 @@
+// NOLINT(legal/copyright)
+
+// C-REPLACE "fmin" "casadi_fmin"
+// C-REPLACE "fmax" "casadi_fmax"
+// C-REPLACE "std::numeric_limits<T1>::infinity()" "casadi_inf"
+// C-REPLACE "static_cast<int>" "(int) "
+// SYMBOL "ipqp_prob"
+template<typename T1>
+struct casadi_ipqp_prob {
+  // Sparsity patterns
+  const casadi_int *sp_a, *sp_h;
+  // Dimensions
+  casadi_int nx, na, nz;
+  // Linear constraints never treated as equalities, even if lba==uba (null: none)
+  const casadi_int *ineq;
+  // Infinity
+  T1 inf;
+  // Maximum number of iterations
+  casadi_int max_iter;
+  // Primal, dual and complementarity error tolerance
+  T1 constr_viol_tol, dual_inf_tol, comp_tol;
+  // Fraction of the distance to the boundary that a step may take
+  T1 frac_bound;
+  // Sparse LDL of the KKT system (null: the caller solves the linear systems)
+  const casadi_int *sp_at, *sp_kkt, *sp_lt, *perm;
+  // Regularization of the KKT system
+  T1 reg;
+};
+// C-REPLACE "casadi_ipqp_prob<T1>" "struct casadi_ipqp_prob"
+
+// SYMBOL "ipqp_setup"
+template<typename T1>
+void casadi_ipqp_setup(casadi_ipqp_prob<T1>* p) {
+  p->na = p->sp_a[0];
+  p->nx = p->sp_a[1];
+  p->nz = p->nx + p->na;
+  p->ineq = 0;
+  p->inf = std::numeric_limits<T1>::infinity();
+  p->max_iter = 100;
+  p->constr_viol_tol = 1e-8;
+  p->dual_inf_tol = 1e-8;
+  p->comp_tol = 1e-8;
+  p->frac_bound = 0.995;
+  p->sp_at = p->sp_kkt = p->sp_lt = p->perm = 0;
+  p->reg = 1e-10;
+}
+
+// SYMBOL "ipqp_work"
+template<typename T1>
+void casadi_ipqp_work(const casadi_ipqp_prob<T1>* p, casadi_int* sz_iw, casadi_int* sz_w) {
+  // Reset sz_w, sz_iw
+  *sz_w = *sz_iw = 0;
+  // Persistent work vectors
+  *sz_w += p->nz; // z=[xk,gk]
+  *sz_w += p->nz; // lbz
+  *sz_w += p->nz; // ubz
+  *sz_w += p->nz; // lam
+  *sz_w += p->nz; // lam_l
+  *sz_w += p->nz; // lam_u
+  *sz_w += p->nz; // s_l
+  *sz_w += p->nz; // s_u
+  *sz_w += p->nx; // rd
+  *sz_w += p->nz; // r_l
+  *sz_w += p->nz; // r_u
+  *sz_w += p->nz; // rc_l
+  *sz_w += p->nz; // rc_u
+  *sz_w += p->nz; // sigma
+  *sz_w += p->nz; // rhs
+  *sz_w += p->nz; // dz
+  *sz_w += p->nz; // dlam
+  *sz_w += p->nz; // ds_l
+  *sz_w += p->nz; // ds_u
+  *sz_w += p->nz; // dlam_l
+  *sz_w += p->nz; // dlam_u
+  *sz_iw += p->nz; // lower
+  *sz_iw += p->nz; // upper
+  *sz_iw += p->nz; // equality
+  // Sparse LDL of the KKT system
+  if (p->sp_kkt) {
+    *sz_w += p->sp_a[2+p->nx]; // nz_at
+    *sz_w += p->sp_kkt[2+p->nz]; // nz_kkt
+    *sz_w += p->sp_lt[2+p->nz]; // nz_lt
+    *sz_w += p->nz; // nz_d
+    *sz_w += p->nz; // w
+    *sz_iw += p->na; // casadi_trans
+  }
+}
+
+// SYMBOL "ipqp_flag_t"
+typedef enum {
+  IPQP_SUCCESS,
+  IPQP_MAX_ITER,
+  IPQP_NO_SEARCH_DIR,
+  IPQP_PRINTING_ERROR
+} casadi_ipqp_flag_t;
+
+// SYMBOL "ipqp_data"
+template<typename T1>
+struct casadi_ipqp_data {
+  // Problem structure
+  const casadi_ipqp_prob<T1>* prob;
+  // Solver status
+  casadi_ipqp_flag_t status;
+  // Cost
+  T1 f;
+  // QP data
+  const T1 *nz_a, *nz_h, *g;
+  // Primal and dual variables, slacks and multipliers of the lower and upper bounds
+  T1 *z, *lbz, *ubz, *lam, *lam_l, *lam_u, *s_l, *s_u;
+  // Dual residual, primal residuals, complementarity targets
+  T1 *rd, *r_l, *r_u, *rc_l, *rc_u;
+  // Linear system: diagonal and right-hand side
+  T1 *sigma, *rhs;
+  // Search direction
+  T1 *dz, *dlam, *ds_l, *ds_u, *dlam_l, *dlam_u;
+  // Finite lower bound, finite upper bound, equality
+  casadi_int *lower, *upper, *equality;
+  // Transpose of A, KKT system and its LDL factorization
+  T1 *nz_at, *nz_kkt, *nz_lt, *nz_d, *w;
+  casadi_int *iw;
+  // Message buffer
+  const char *msg;
+  // Primal and dual error, corresponding index
+  T1 pr, du;
+  casadi_int ipr, idu;
+  // Complementarity measure, centering parameter, stepsize
+  T1 mu, sig, tau;
+  // Iteration
+  casadi_int iter;
+};
+// C-REPLACE "casadi_ipqp_data<T1>" "struct casadi_ipqp_data"
+
+// SYMBOL "ipqp_init"
+template<typename T1>
+void casadi_ipqp_init(casadi_ipqp_data<T1>* d, casadi_int** iw, T1** w) {
+  const casadi_ipqp_prob<T1>* p = d->prob;
+  d->z = *w; *w += p->nz;
+  d->lbz = *w; *w += p->nz;
+  d->ubz = *w; *w += p->nz;
+  d->lam = *w; *w += p->nz;
+  d->lam_l = *w; *w += p->nz;
+  d->lam_u = *w; *w += p->nz;
+  d->s_l = *w; *w += p->nz;
+  d->s_u = *w; *w += p->nz;
+  d->rd = *w; *w += p->nx;
+  d->r_l = *w; *w += p->nz;
+  d->r_u = *w; *w += p->nz;
+  d->rc_l = *w; *w += p->nz;
+  d->rc_u = *w; *w += p->nz;
+  d->sigma = *w; *w += p->nz;
+  d->rhs = *w; *w += p->nz;
+  d->dz = *w; *w += p->nz;
+  d->dlam = *w; *w += p->nz;
+  d->ds_l = *w; *w += p->nz;
+  d->ds_u = *w; *w += p->nz;
+  d->dlam_l = *w; *w += p->nz;
+  d->dlam_u = *w; *w += p->nz;
+  d->lower = *iw; *iw += p->nz;
+  d->upper = *iw; *iw += p->nz;
+  d->equality = *iw; *iw += p->nz;
+  if (p->sp_kkt) {
+    d->nz_at = *w; *w += p->sp_a[2+p->nx];
+    d->nz_kkt = *w; *w += p->sp_kkt[2+p->nz];
+    d->nz_lt = *w; *w += p->sp_lt[2+p->nz];
+    d->nz_d = *w; *w += p->nz;
+    d->w = *w; *w += p->nz;
+    d->iw = *iw; *iw += p->na;
+  }
+}
+
+// SYMBOL "ipqp_reset"
+template<typename T1>
+int casadi_ipqp_reset(casadi_ipqp_data<T1>* d) {
+  // Local variables
+  casadi_int i;
+  const casadi_ipqp_prob<T1>* p = d->prob;
+  // Reset variables corresponding to previous iteration
+  d->msg = 0;
+  d->tau = 0.;
+  d->sig = 0.;
+  d->iter = 0;
+  // Constraint values
+  casadi_clear(d->z + p->nx, p->na);
+  casadi_mv(d->nz_a, p->sp_a, d->z, d->z + p->nx, 0);
+  // Transpose of A
+  if (p->sp_kkt) casadi_trans(d->nz_a, p->sp_a, d->nz_at, p->sp_at, d->iw);
+  // Classify the bounds, initial slacks and multipliers
+  for (i=0; i<p->nz; ++i) {
+    if (d->lbz[i] > d->ubz[i]) return 1;
+    // Linear equalities keep their multiplier guess, bounds on x are never equalities
+    d->equality[i] = i>=p->nx && d->lbz[i]==d->ubz[i] && !(p->ineq && p->ineq[i-p->nx]);
+    if (d->equality[i] && (d->lbz[i]==p->inf || d->lbz[i]==-p->inf)) return 1;
+    d->lower[i] = !d->equality[i] && d->lbz[i] > -p->inf;
+    d->upper[i] = !d->equality[i] && d->ubz[i] < p->inf;
+    if (!d->equality[i]) d->lam[i] = 0.;
+    // Strictly positive slacks and multipliers, the residuals absorb any infeasibility
+    d->s_l[i] = d->lower[i] ? fmax(d->z[i] - d->lbz[i], 1.) : 0.;
+    d->s_u[i] = d->upper[i] ? fmax(d->ubz[i] - d->z[i], 1.) : 0.;
+    d->lam_l[i] = d->lower[i] ? 1. : 0.;
+    d->lam_u[i] = d->upper[i] ? 1. : 0.;
+  }
+  return 0;
+}
+
+// SYMBOL "ipqp_residual"
+template<typename T1>
+void casadi_ipqp_residual(casadi_ipqp_data<T1>* d) {
+  // Local variables
+  casadi_int i, m;
+  T1 r;
+  const casadi_ipqp_prob<T1>* p = d->prob;
+  // Constraint values
+  casadi_clear(d->z + p->nx, p->na);
+  casadi_mv(d->nz_a, p->sp_a, d->z, d->z + p->nx, 0);
+  // Combined multipliers, positive for an active upper bound
+  for (i=0; i<p->nz; ++i) {
+    if (!d->equality[i]) d->lam[i] = d->lam_u[i] - d->lam_l[i];
+  }
+  // Cost
+  d->f = casadi_bilin(d->nz_h, p->sp_h, d->z, d->z)/2. + casadi_dot(p->nx, d->z, d->g);
+  // Dual residual: H*x + g + lam_x + A'*lam_a
+  casadi_copy(d->g, p->nx, d->rd);
+  casadi_mv(d->nz_h, p->sp_h, d->z, d->rd, 0);
+  casadi_axpy(p->nx, 1., d->lam, d->rd);
+  casadi_mv(d->nz_a, p->sp_a, d->lam + p->nx, d->rd, 1);
+  d->du = 0.;
+  d->idu = -1;
+  for (i=0; i<p->nx; ++i) {
+    if (fabs(d->rd[i]) > d->du) {
+      d->du = fabs(d->rd[i]);
+      d->idu = i;
+    }
+  }
+  // Primal residuals and complementarity
+  d->pr = 0.;
+  d->ipr = -1;
+  d->mu = 0.;
+  m = 0;
+  for (i=0; i<p->nz; ++i) {
+    d->r_l[i] = d->r_u[i] = 0.;
+    if (d->equality[i]) {
+      d->r_l[i] = d->z[i] - d->lbz[i];
+    } else {
+      if (d->lower[i]) {
+        d->r_l[i] = d->z[i] - d->lbz[i] - d->s_l[i];
+        d->mu += d->s_l[i] * d->lam_l[i];
+        m++;
+      }
+      if (d->upper[i]) {
+        d->r_u[i] = d->ubz[i] - d->z[i] - d->s_u[i];
+        d->mu += d->s_u[i] * d->lam_u[i];
+        m++;
+      }
+    }
+    r = fmax(fabs(d->r_l[i]), fabs(d->r_u[i]));
+    if (r > d->pr) {
+      d->pr = r;
+      d->ipr = i;
+    }
+  }
+  if (m > 0) d->mu /= m;
+}
+
+// SYMBOL "ipqp_rhs"
+template<typename T1>
+void casadi_ipqp_rhs(casadi_ipqp_data<T1>* d, T1 smu, int corr) {
+  // Local variables
+  casadi_int i;
+  T1 e;
+  const casadi_ipqp_prob<T1>* p = d->prob;
+  for (i=0; i<p->nz; ++i) {
+    // Complementarity targets, with second order correction from the affine step
+    d->rc_l[i] = d->rc_u[i] = 0.;
+    e = 0.;
+    if (d->lower[i]) {
+      d->rc_l[i] = smu - d->s_l[i] * d->lam_l[i];
+      if (corr) d->rc_l[i] -= d->ds_l[i] * d->dlam_l[i];
+      e -= (d->rc_l[i] - d->lam_l[i] * d->r_l[i]) / d->s_l[i];
+    }
+    if (d->upper[i]) {
+      d->rc_u[i] = smu - d->s_u[i] * d->lam_u[i];
+      if (corr) d->rc_u[i] -= d->ds_u[i] * d->dlam_u[i];
+      e += (d->rc_u[i] - d->lam_u[i] * d->r_u[i]) / d->s_u[i];
+    }
+    // The eliminated multiplier step is dlam = sigma*dz + e
+    if (i<p->nx) {
+      d->rhs[i] = -d->rd[i] - e;
+    } else if (d->equality[i]) {
+      d->rhs[i] = -d->r_l[i];
+    } else if (d->sigma[i] > 0.) {
+      d->rhs[i] = -e / d->sigma[i];
+    } else {
+      d->rhs[i] = 0.;
+    }
+  }
+}
+
+// SYMBOL "ipqp_expand"
+template<typename T1>
+void casadi_ipqp_expand(casadi_ipqp_data<T1>* d) {
+  // Local variables
+  casadi_int i;
+  const casadi_ipqp_prob<T1>* p = d->prob;
+  // Step in the constraint values
+  casadi_clear(d->dz + p->nx, p->na);
+  casadi_mv(d->nz_a, p->sp_a, d->dz, d->dz + p->nx, 0);
+  // Steps in the slacks and the multipliers of the inequalities
+  for (i=0; i<p->nz; ++i) {
+    if (d->equality[i]) continue;
+    d->ds_l[i] = d->ds_u[i] = d->dlam_l[i] = d->dlam_u[i] = 0.;
+    if (d->lower[i]) {
+      d->ds_l[i] = d->dz[i] + d->r_l[i];
+      d->dlam_l[i] = (d->rc_l[i] - d->lam_l[i] * d->ds_l[i]) / d->s_l[i];
+    }
+    if (d->upper[i]) {
+      d->ds_u[i] = d->r_u[i] - d->dz[i];
+      d->dlam_u[i] = (d->rc_u[i] - d->lam_u[i] * d->ds_u[i]) / d->s_u[i];
+    }
+    d->dlam[i] = d->dlam_u[i] - d->dlam_l[i];
+  }
+}
+
+// SYMBOL "ipqp_max_step"
+template<typename T1>
+T1 casadi_ipqp_max_step(casadi_ipqp_data<T1>* d) {
+  // Local variables
+  casadi_int i;
+  T1 t;
+  const casadi_ipqp_prob<T1>* p = d->prob;
+  t = p->inf;
+  for (i=0; i<p->nz; ++i) {
+    if (d->lower[i]) {
+      if (d->ds_l[i] < 0.) t = fmin(t, -d->s_l[i] / d->ds_l[i]);
+      if (d->dlam_l[i] < 0.) t = fmin(t, -d->lam_l[i] / d->dlam_l[i]);
+    }
+    if (d->upper[i]) {
+      if (d->ds_u[i] < 0.) t = fmin(t, -d->s_u[i] / d->ds_u[i]);
+      if (d->dlam_u[i] < 0.) t = fmin(t, -d->lam_u[i] / d->dlam_u[i]);
+    }
+  }
+  return t;
+}
+
+// SYMBOL "ipqp_prepare"
+template<typename T1>
+int casadi_ipqp_prepare(casadi_ipqp_data<T1>* d) {
+  // Local variables
+  casadi_int i;
+  const casadi_ipqp_prob<T1>* p = d->prob;
+  // Residuals and complementarity
+  casadi_ipqp_residual(d);
+  // Termination
+  if (d->pr <= p->constr_viol_tol && d->du <= p->dual_inf_tol && d->mu <= p->comp_tol) {
+    d->status = IPQP_SUCCESS;
+    d->msg = "Converged";
+    return 1;
+  } else if (d->iter >= p->max_iter) {
+    d->status = IPQP_MAX_ITER;
+    d->msg = "Max iter";
+    return 1;
+  }
+  // Diagonal of the linear system, zero for equalities and unbounded constraints
+  for (i=0; i<p->nz; ++i) {
+    d->sigma[i] = 0.;
+    if (d->lower[i]) d->sigma[i] += d->lam_l[i] / d->s_l[i];
+    if (d->upper[i]) d->sigma[i] += d->lam_u[i] / d->s_u[i];
+  }
+  // Affine scaling (predictor) direction
+  casadi_ipqp_rhs(d, 0., 0);
+  return 0;
+}
+
+// SYMBOL "ipqp_predictor"
+template<typename T1>
+void casadi_ipqp_predictor(casadi_ipqp_data<T1>* d) {
+  // Local variables
+  casadi_int i, m;
+  T1 t, mu_aff;
+  const casadi_ipqp_prob<T1>* p = d->prob;
+  // Complete the affine scaling direction
+  casadi_ipqp_expand(d);
+  // Complementarity after a full affine step to the boundary
+  t = fmin(casadi_ipqp_max_step(d), 1.);
+  mu_aff = 0.;
+  m = 0;
+  for (i=0; i<p->nz; ++i) {
+    if (d->lower[i]) {
+      mu_aff += (d->s_l[i] + t*d->ds_l[i]) * (d->lam_l[i] + t*d->dlam_l[i]);
+      m++;
+    }
+    if (d->upper[i]) {
+      mu_aff += (d->s_u[i] + t*d->ds_u[i]) * (d->lam_u[i] + t*d->dlam_u[i]);
+      m++;
+    }
+  }
+  // Centering parameter (Mehrotra's heuristic)
+  if (m > 0 && d->mu > 0.) {
+    mu_aff /= m;
+    d->sig = mu_aff / d->mu;
+    d->sig = fmin(d->sig*d->sig*d->sig, 1.);
+  } else {
+    d->sig = 0.;
+  }
+  // Centering-corrector direction
+  casadi_ipqp_rhs(d, d->sig * d->mu, 1);
+}
+
+// SYMBOL "ipqp_corrector"
+template<typename T1>
+void casadi_ipqp_corrector(casadi_ipqp_data<T1>* d) {
+  // Local variables
+  casadi_int i;
+  const casadi_ipqp_prob<T1>* p = d->prob;
+  // Complete the combined direction
+  casadi_ipqp_expand(d);
+  // Stay strictly inside the positive orthant
+  d->tau = fmin(p->frac_bound * casadi_ipqp_max_step(d), 1.);
+  // Take step
+  casadi_axpy(p->nx, d->tau, d->dz, d->z);
+  for (i=0; i<p->nz; ++i) {
+    if (d->equality[i]) {
+      d->lam[i] += d->tau * d->dlam[i];
+    } else {
+      d->s_l[i] += d->tau * d->ds_l[i];
+      d->s_u[i] += d->tau * d->ds_u[i];
+      d->lam_l[i] += d->tau * d->dlam_l[i];
+      d->lam_u[i] += d->tau * d->dlam_u[i];
+    }
+  }
+  d->iter++;
+}
+
+// SYMBOL "ipqp_factorize"
+template<typename T1>
+int casadi_ipqp_factorize(casadi_ipqp_data<T1>* d) {
+  // Local variables
+  casadi_int i, k;
+  const casadi_int *h_colind, *h_row, *a_colind, *a_row, *at_colind, *at_row,
+                   *kkt_colind, *kkt_row;
+  const casadi_ipqp_prob<T1>* p = d->prob;
+  // Extract sparsities
+  a_row = (a_colind = p->sp_a+2) + p->nx + 1;
+  at_row = (at_colind = p->sp_at+2) + p->na + 1;
+  h_row = (h_colind = p->sp_h+2) + p->nx + 1;
+  kkt_row = (kkt_colind = p->sp_kkt+2) + p->nz + 1;
+  // Reset w to zero
+  casadi_clear(d->w, p->nz);
+  // Quasi-definite KKT matrix [H+diag(sigma_x), A'; A, -diag(1/sigma_a)]
+  for (i=0; i<p->nz; ++i) {
+    // Copy column of KKT to w
+    if (i<p->nx) {
+      for (k=h_colind[i]; k<h_colind[i+1]; ++k) d->w[h_row[k]] = d->nz_h[k];
+      d->w[i] += d->sigma[i] + p->reg;
+      for (k=a_colind[i]; k<a_colind[i+1]; ++k) {
+        // Constraints without finite bounds are decoupled
+        if (d->equality[p->nx+a_row[k]] || d->sigma[p->nx+a_row[k]] > 0.) {
+          d->w[p->nx+a_row[k]] = d->nz_a[k];
+        }
+      }
+    } else if (d->equality[i] || d->sigma[i] > 0.) {
+      for (k=at_colind[i-p->nx]; k<at_colind[i-p->nx+1]; ++k) {
+        d->w[at_row[k]] = d->nz_at[k];
+      }
+      d->w[i] = d->equality[i] ? -p->reg : -1./d->sigma[i];
+    } else {
+      d->w[i] = -1.;
+    }
+    // Copy column to KKT, zero out w
+    for (k=kkt_colind[i]; k<kkt_colind[i+1]; ++k) {
+      d->nz_kkt[k] = d->w[kkt_row[k]];
+      d->w[kkt_row[k]] = 0;
+    }
+  }
+  // Factorize, without pivoting
+  casadi_ldl(p->sp_kkt, d->nz_kkt, p->sp_lt, d->nz_lt, d->nz_d, p->perm, d->w);
+  for (i=0; i<p->nz; ++i) {
+    if (!(fabs(d->nz_d[i]) > 0.)) return 1;
+  }
+  return 0;
+}
+
+// SYMBOL "ipqp_solve"
+template<typename T1>
+void casadi_ipqp_solve(casadi_ipqp_data<T1>* d) {
+  // Local variables
+  const casadi_ipqp_prob<T1>* p = d->prob;
+  // Solve the KKT system for [dx; dlam_a]
+  casadi_copy(d->rhs, p->nz, d->dz);
+  casadi_ldl_solve(d->dz, 1, p->sp_lt, d->nz_lt, d->nz_d, p->perm, d->w);
+  casadi_copy(d->dz + p->nx, p->na, d->dlam + p->nx);
+}
+
+// The following routines require stdio
+#ifndef CASADI_PRINTF
+
+// SYMBOL "ipqp_print_header"
+template<typename T1>
+int casadi_ipqp_print_header(casadi_ipqp_data<T1>* d, char* buf, size_t buf_sz) {
+  int flag;
+  // Print to string
+  flag = snprintf(buf, buf_sz, "%5s %9s %9s %5s %9s %5s %9s %9s %9s  %4s",
+          "Iter", "fk", "|pr|", "con", "|du|", "var", "mu", "sigma", "tau", "Note");
+  // Check if error
+  if (flag < 0) {
+    d->status = IPQP_PRINTING_ERROR;
+    return 1;
+  }
+  // Successful return
+  return 0;
+}
+
+// SYMBOL "ipqp_print_iteration"
+template<typename T1>
+int casadi_ipqp_print_iteration(casadi_ipqp_data<T1>* d, char* buf, int buf_sz) {
+  int flag;
+  // Print iteration data without note to string
+  flag = snprintf(buf, buf_sz,
+    "%5d %9.2g %9.2g %5d %9.2g %5d %9.2g %9.2g %9.2g  ",
+    static_cast<int>(d->iter), d->f, d->pr, static_cast<int>(d->ipr),
+    d->du, static_cast<int>(d->idu), d->mu, d->sig, d->tau);
+  // Check if error
+  if (flag < 0) {
+    d->status = IPQP_PRINTING_ERROR;
+    return 1;
+  }
+  // Rest of buffer reserved for iteration note
+  buf += flag;
+  buf_sz -= flag;
+  // Print iteration note, if any
+  if (d->msg) {
+    flag = snprintf(buf, buf_sz, "%s", d->msg);
+    // Check if error
+    if (flag < 0) {
+      d->status = IPQP_PRINTING_ERROR;
+      return 1;
+    }
+  }
+  // Successful return
+  return 0;
+}
+
+#endif  // CASADI_PRINTF
@@ -22,6 +22,8 @@ struct casadi_qp_prob {
   T1 min_lam;
   // Maximum number of iterations
   casadi_int max_iter;
+  // Maximum number of active-set changes handled by updating the factorization
+  casadi_int max_update;
   // Primal and dual error tolerance
   T1 constr_viol_tol, dual_inf_tol;
 };
@@ -37,6 +39,7 @@ void casadi_qp_setup(casadi_qp_prob<T1>* p) {
   p->inf = std::numeric_limits<T1>::infinity();
   p->min_lam = 0;
   p->max_iter = 1000;
+  p->max_update = 0;
   p->constr_viol_tol = 1e-8;
   p->dual_inf_tol = 1e-8;
 }
@@ -75,6 +78,14 @@ void casadi_qp_work(const casadi_qp_prob<T1>* p, casadi_int* sz_iw, casadi_int*
   *sz_iw += p->nz; // lincomb
   *sz_w += casadi_max(nnz_v+nnz_r, nnz_kkt); // [v,r] or trans(kkt)
   *sz_w += p->nz; // beta
+  *sz_iw += p->nz; // act_base
+  *sz_iw += p->max_update; // upd
+  *sz_iw += p->max_update; // upd_piv
+  *sz_w += p->nz*p->max_update; // upd_zp
+  *sz_w += p->nz*p->max_update; // upd_zt
+  *sz_w += p->max_update*p->max_update; // upd_s
+  *sz_w += p->max_update; // upd_u
+  *sz_w += p->nz; // upd_r
 }
 
 // SYMBOL "qp_flag_t"
@@ -101,6 +112,14 @@ struct casadi_qp_data {
   casadi_int *iw, *neverzero, *neverlower, *neverupper, *lincomb;
   // Numeric QR factorization
   T1 *nz_at, *nz_kkt, *beta, *nz_v, *nz_r;
+  // Number of columns updated since the last factorization, -1 if none to update
+  casadi_int n_upd;
+  // Number of factorizations, number of active-set changes handled by an update
+  casadi_int n_fact, n_update;
+  // Updated columns, pivoting in the Schur complement, active set of the factorization
+  casadi_int *upd, *upd_piv, *act_base;
+  // Solves with the factorization, LU factorized Schur complement, work vectors
+  T1 *upd_zp, *upd_zt, *upd_s, *upd_u, *upd_r;
   // Message buffer
   const char *msg;
   // Message index
@@ -155,6 +174,14 @@ void casadi_qp_init(casadi_qp_data<T1>* d, casadi_int** iw, T1** w) {
   d->neverupper = *iw; *iw += p->nz;
   d->neverlower = *iw; *iw += p->nz;
   d->lincomb = *iw; *iw += p->nz;
+  d->act_base = *iw; *iw += p->nz;
+  d->upd = *iw; *iw += p->max_update;
+  d->upd_piv = *iw; *iw += p->max_update;
+  d->upd_zp = *w; *w += p->nz*p->max_update;
+  d->upd_zt = *w; *w += p->nz*p->max_update;
+  d->upd_s = *w; *w += p->max_update*p->max_update;
+  d->upd_u = *w; *w += p->max_update;
+  d->upd_r = *w; *w += p->nz;
   d->w = *w;
   d->iw = *iw;
 }
@@ -198,6 +225,9 @@ int casadi_qp_reset(casadi_qp_data<T1>* d) {
   d->r_sign = 0;
   // Reset iteration counter
   d->iter = 0;
+  // No factorization to update
+  d->n_upd = -1;
+  d->n_fact = d->n_update = 0;
   return 0;
 }
 
@@ -649,6 +679,127 @@ void casadi_qp_take_step(casadi_qp_data<T1>* d) {
   }
 }
 
+// SYMBOL "qp_kkt_mv"
+template<typename T1>
+void casadi_qp_kkt_mv(casadi_qp_data<T1>* d, const T1* x, T1* r, casadi_int tr) {
+  // Local variables
+  casadi_int i, k;
+  const casadi_int *h_colind, *h_row, *a_colind, *a_row, *at_colind, *at_row;
+  const casadi_qp_prob<T1>* p = d->prob;
+  // Extract sparsities
+  a_row = (a_colind = p->sp_a+2) + p->nx + 1;
+  at_row = (at_colind = p->sp_at+2) + p->na + 1;
+  h_row = (h_colind = p->sp_h+2) + p->nx + 1;
+  // r -= K*x or r -= K'*x, column i of K is row i of the KKT system
+  for (i=0; i<p->nz; ++i) {
+    if (i<p->nx) {
+      if (d->lam[i]==0) {
+        for (k=h_colind[i]; k<h_colind[i+1]; ++k) {
+          if (tr) {
+            r[i] -= d->nz_h[k]*x[h_row[k]];
+          } else {
+            r[h_row[k]] -= d->nz_h[k]*x[i];
+          }
+        }
+        for (k=a_colind[i]; k<a_colind[i+1]; ++k) {
+          if (tr) {
+            r[i] -= d->nz_a[k]*x[p->nx+a_row[k]];
+          } else {
+            r[p->nx+a_row[k]] -= d->nz_a[k]*x[i];
+          }
+        }
+      } else {
+        r[i] -= x[i];
+      }
+    } else {
+      if (d->lam[i]==0) {
+        r[i] += x[i];
+      } else {
+        for (k=at_colind[i-p->nx]; k<at_colind[i-p->nx+1]; ++k) {
+          if (tr) {
+            r[i] -= d->nz_at[k]*x[at_row[k]];
+          } else {
+            r[at_row[k]] -= d->nz_at[k]*x[i];
+          }
+        }
+      }
+    }
+  }
+}
+
+// SYMBOL "qp_solve_update"
+template<typename T1>
+void casadi_qp_solve_update(casadi_qp_data<T1>* d, T1* x, casadi_int tr) {
+  // Local variables
+  casadi_int a, b, i, n;
+  T1 *s, *u, t;
+  const casadi_qp_prob<T1>* p = d->prob;
+  // Solve with the factorized KKT matrix K0 (transposed if tr)
+  casadi_qr_solve(x, 1, tr, p->sp_v, d->nz_v, p->sp_r, d->nz_r, d->beta,
+    p->prinv, p->pc, d->w);
+  // Correct for the updated columns, K = K0 + D*E' (Sherman-Morrison-Woodbury)
+  n = d->n_upd;
+  s = d->upd_s;
+  u = d->upd_u;
+  if (tr) {
+    // Solve S'*u = D'*x, with P*S = L*U
+    for (a=0; a<n; ++a) {
+      i = d->upd[a];
+      u[a] = casadi_qp_kkt_dot(d, x, i);
+      if (d->act_base[i]) u[a] = -u[a];
+    }
+    for (a=0; a<n; ++a) {
+      for (b=0; b<a; ++b) u[a] -= s[b+a*n]*u[b];
+      u[a] /= s[a+a*n];
+    }
+    for (a=n-1; a>=0; --a) {
+      for (b=a+1; b<n; ++b) u[a] -= s[b+a*n]*u[b];
+    }
+    for (a=n-1; a>=0; --a) {
+      t = u[a];
+      u[a] = u[d->upd_piv[a]];
+      u[d->upd_piv[a]] = t;
+    }
+    // x -= K0'\E*u
+    for (a=0; a<n; ++a) casadi_axpy(p->nz, -u[a], d->upd_zt + a*p->nz, x);
+  } else {
+    // Solve S*u = E'*x, with P*S = L*U
+    for (a=0; a<n; ++a) u[a] = x[d->upd[a]];
+    for (a=0; a<n; ++a) {
+      t = u[a];
+      u[a] = u[d->upd_piv[a]];
+      u[d->upd_piv[a]] = t;
+    }
+    for (a=0; a<n; ++a) {
+      for (b=0; b<a; ++b) u[a] -= s[a+b*n]*u[b];
+    }
+    for (a=n-1; a>=0; --a) {
+      for (b=a+1; b<n; ++b) u[a] -= s[a+b*n]*u[b];
+      u[a] /= s[a+a*n];
+    }
+    // x -= K0\D*u
+    for (a=0; a<n; ++a) casadi_axpy(p->nz, -u[a], d->upd_zp + a*p->nz, x);
+  }
+}
+
+// SYMBOL "qp_solve"
+template<typename T1>
+void casadi_qp_solve(casadi_qp_data<T1>* d, T1* x, casadi_int tr) {
+  const casadi_qp_prob<T1>* p = d->prob;
+  if (d->n_upd <= 0) {
+    // Solve with the factorization
+    casadi_qr_solve(x, 1, tr, p->sp_v, d->nz_v, p->sp_r, d->nz_r, d->beta,
+      p->prinv, p->pc, d->w);
+  } else {
+    // Solve with the updated factorization and one step of iterative refinement
+    casadi_copy(x, p->nz, d->upd_r);
+    casadi_qp_solve_update(d, x, tr);
+    casadi_qp_kkt_mv(d, x, d->upd_r, tr);
+    casadi_qp_solve_update(d, d->upd_r, tr);
+    casadi_axpy(p->nz, 1., d->upd_r, x);
+  }
+}
+
 // SYMBOL "qp_flip_check"
 template<typename T1>
 int casadi_qp_flip_check(casadi_qp_data<T1>* d) {
@@ -658,15 +809,13 @@ int casadi_qp_flip_check(casadi_qp_data<T1>* d) {
   // Calculate the difference between old and new column index
   if (d->sign == 0) casadi_scal(p->nz, -1., d->dlam);
   // Try to find a linear combination of the new columns
-  casadi_qr_solve(d->dlam, 1, 0, p->sp_v, d->nz_v, p->sp_r, d->nz_r, d->beta,
-    p->prinv, p->pc, d->w);
+  casadi_qp_solve(d, d->dlam, 0);
   // If dlam[index]!=1, new columns must be linearly independent
   if (fabs(d->dlam[d->index]-1.) >= 1e-12) return 0;
   // Next, find a linear combination of the new rows
   casadi_clear(d->dz, p->nz);
   d->dz[d->index] = 1;
-  casadi_qr_solve(d->dz, 1, 1, p->sp_v, d->nz_v, p->sp_r, d->nz_r, d->beta,
-    p->prinv, p->pc, d->w);
+  casadi_qp_solve(d, d->dz, 1);
   // Normalize dlam, dz
   casadi_scal(p->nz, 1./sqrt(casadi_dot(p->nz, d->dlam, d->dlam)), d->dlam);
   casadi_scal(p->nz, 1./sqrt(casadi_dot(p->nz, d->dz, d->dz)), d->dz);
@@ -674,22 +823,104 @@ int casadi_qp_flip_check(casadi_qp_data<T1>* d) {
   return 1;
 }
 
+// SYMBOL "qp_update"
+template<typename T1>
+int casadi_qp_update(casadi_qp_data<T1>* d) {
+  // Local variables
+  casadi_int a, b, i, k, n;
+  T1 *s, t;
+  const casadi_qp_prob<T1>* p = d->prob;
+  // Need a regular factorization to update
+  if (d->n_upd < 0) return 1;
+  // Remove columns that are back in the factorized active set
+  for (a=0; a<d->n_upd; ) {
+    i = d->upd[a];
+    if ((d->lam[i]!=0.) == d->act_base[i]) {
+      d->n_upd--;
+      d->upd[a] = d->upd[d->n_upd];
+      casadi_copy(d->upd_zp + d->n_upd*p->nz, p->nz, d->upd_zp + a*p->nz);
+      casadi_copy(d->upd_zt + d->n_upd*p->nz, p->nz, d->upd_zt + a*p->nz);
+    } else {
+      a++;
+    }
+  }
+  // Add columns that left the factorized active set
+  for (i=0; i<p->nz; ++i) {
+    if ((d->lam[i]!=0.) == d->act_base[i]) continue;
+    for (a=0; a<d->n_upd; ++a) if (d->upd[a]==i) break;
+    if (a<d->n_upd) continue;
+    // Refactorize periodically
+    if (d->n_upd==p->max_update) return 1;
+    // Change in the column, d = K[:,i] - K0[:,i], and K0\d
+    casadi_qp_kkt_vector(d, d->upd_zp + a*p->nz, i);
+    if (!d->act_base[i]) casadi_scal(p->nz, -1., d->upd_zp + a*p->nz);
+    casadi_qr_solve(d->upd_zp + a*p->nz, 1, 0, p->sp_v, d->nz_v, p->sp_r, d->nz_r, d->beta,
+      p->prinv, p->pc, d->w);
+    // K0'\e_i
+    casadi_clear(d->upd_zt + a*p->nz, p->nz);
+    d->upd_zt[i + a*p->nz] = 1.;
+    casadi_qr_solve(d->upd_zt + a*p->nz, 1, 1, p->sp_v, d->nz_v, p->sp_r, d->nz_r, d->beta,
+      p->prinv, p->pc, d->w);
+    d->upd[d->n_upd++] = i;
+  }
+  // Schur complement S = I + E'*(K0\D)
+  n = d->n_upd;
+  s = d->upd_s;
+  for (b=0; b<n; ++b) {
+    for (a=0; a<n; ++a) s[a+b*n] = d->upd_zp[d->upd[a] + b*p->nz];
+    s[b+b*n] += 1.;
+  }
+  // LU factorization with partial pivoting
+  for (k=0; k<n; ++k) {
+    i = k;
+    for (a=k+1; a<n; ++a) if (fabs(s[a+k*n]) > fabs(s[i+k*n])) i = a;
+    d->upd_piv[k] = i;
+    // Refactorize if (nearly) singular
+    if (fabs(s[i+k*n]) < 1e-8) return 1;
+    if (i!=k) {
+      for (b=0; b<n; ++b) {
+        t = s[k+b*n];
+        s[k+b*n] = s[i+b*n];
+        s[i+b*n] = t;
+      }
+    }
+    for (a=k+1; a<n; ++a) {
+      s[a+k*n] /= s[k+k*n];
+      for (b=k+1; b<n; ++b) s[a+b*n] -= s[a+k*n]*s[k+b*n];
+    }
+  }
+  // Regular
+  d->sing = 0;
+  return 0;
+}
+
 // SYMBOL "qp_factorize"
 template<typename T1>
 void casadi_qp_factorize(casadi_qp_data<T1>* d) {
+  // Local variables
+  casadi_int i;
   const casadi_qp_prob<T1>* p = d->prob;
   // Do we already have a search direction due to lost singularity?
   if (d->has_search_dir) {
     d->sing = 1;
     return;
   }
+  // Update the previous factorization, if possible
+  if (!casadi_qp_update(d)) {
+    d->n_update++;
+    return;
+  }
   // Construct the KKT matrix
   casadi_qp_kkt(d);
   // QR factorization
   casadi_qr(p->sp_kkt, d->nz_kkt, d->w, p->sp_v, d->nz_v, p->sp_r,
             d->nz_r, d->beta, p->prinv, p->pc);
+  d->n_fact++;
   // Check singularity
   d->sing = casadi_qr_singular(&d->mina, &d->imina, d->nz_r, p->sp_r, p->pc, 1e-12);
+  // Only a regular factorization can be updated
+  d->n_upd = d->sing || p->max_update==0 ? -1 : 0;
+  for (i=0; i<p->nz; ++i) d->act_base[i] = d->lam[i]!=0.;
 }
 
 // SYMBOL "qp_expand_step"
@@ -801,7 +1032,8 @@ int casadi_qp_singular_step(casadi_qp_data<T1>* d) {
     // One, given search direction
     nk = 1;
   } else {
-    // QR factorization of the transpose
+    // QR factorization of the transpose, replacing the factorization
+    d->n_upd = -1;
     casadi_trans(d->nz_kkt, p->sp_kkt, d->nz_v, p->sp_kkt, d->iw);
     nnz_kkt = p->sp_kkt[2+p->nz]; // kkt_colind[nz]
     casadi_copy(d->nz_v, nnz_kkt, d->nz_kkt);
@@ -904,8 +1136,6 @@ int casadi_qp_singular_step(casadi_qp_data<T1>* d) {
 // SYMBOL "qp_calc_step"
 template<typename T1>
 int casadi_qp_calc_step(casadi_qp_data<T1>* d) {
-  // Local variables
-  const casadi_qp_prob<T1>* p = d->prob;
   // Reset returns
   d->r_index = -1;
   d->r_sign = 0;
@@ -914,8 +1144,7 @@ int casadi_qp_calc_step(casadi_qp_data<T1>* d) {
   // Negative KKT residual
   casadi_qp_kkt_residual(d, d->dz);
   // Solve to get step in z[:nx] and lam[nx:]
-  casadi_qr_solve(d->dz, 1, 1, p->sp_v, d->nz_v, p->sp_r, d->nz_r, d->beta,
-                  p->prinv, p->pc, d->w);
+  casadi_qp_solve(d, d->dz, 1);
   // Have step in dz[:nx] and dlam[nx:]. Calculate complete dz and dlam
   casadi_qp_expand_step(d);
   // Successful return
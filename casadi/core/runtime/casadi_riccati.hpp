@@ -0,0 +1,363 @@
+// NOLINT(legal/copyright)
+
+// SYMBOL "riccati_prob"
+template<typename T1>
+struct casadi_riccati_prob {
+  // Horizon
+  casadi_int N;
+  // States, controls and non-dynamic constraints per stage, length N+1 (nu[N]==0)
+  const casadi_int *nx, *nu, *ng;
+  // Sparsity patterns of the QP
+  const casadi_int *sp_a, *sp_h;
+  // Size of the QP
+  casadi_int nxq, naq;
+  // Size of the stagewise storage
+  casadi_int sz_f, sz_e, sz_pm, sz_k, sz_l, sz_pv, sz_kv;
+  // Largest stage
+  casadi_int nv_max, nx_max, ng_max;
+};
+// C-REPLACE "casadi_riccati_prob<T1>" "struct casadi_riccati_prob"
+
+// SYMBOL "riccati_setup"
+template<typename T1>
+void casadi_riccati_setup(casadi_riccati_prob<T1>* p) {
+  // Local variables
+  casadi_int k, nx1, nv;
+  p->naq = p->sp_a[0];
+  p->nxq = p->sp_a[1];
+  p->sz_f = p->sz_e = p->sz_pm = p->sz_k = p->sz_l = p->sz_pv = p->sz_kv = 0;
+  p->nv_max = p->nx_max = p->ng_max = 0;
+  for (k=0; k<=p->N; ++k) {
+    nx1 = k<p->N ? p->nx[k+1] : 0;
+    nv = p->nx[k] + p->nu[k];
+    p->sz_f += nx1*nv;
+    p->sz_e += nx1;
+    p->sz_pm += p->nx[k]*p->nx[k];
+    p->sz_k += p->nu[k]*p->nx[k];
+    p->sz_l += p->nu[k]*p->nu[k];
+    p->sz_pv += p->nx[k];
+    p->sz_kv += p->nu[k];
+    p->nv_max = casadi_max(p->nv_max, nv);
+    p->nx_max = casadi_max(p->nx_max, p->nx[k]);
+    p->ng_max = casadi_max(p->ng_max, p->ng[k]);
+  }
+}
+
+// SYMBOL "riccati_work"
+template<typename T1>
+void casadi_riccati_work(const casadi_riccati_prob<T1>* p, casadi_int* sz_w) {
+  // Persistent work vectors
+  *sz_w = p->sz_f + p->sz_e + p->sz_pm + p->sz_k + p->sz_l + p->sz_pv + p->sz_kv;
+  // Stage Hessian, non-dynamic constraints, P*f
+  *sz_w += p->nv_max*p->nv_max + p->ng_max*p->nv_max + p->nx_max*p->nv_max;
+  // Vectors
+  *sz_w += p->nv_max + 2*p->nx_max;
+}
+
+// SYMBOL "riccati_data"
+template<typename T1>
+struct casadi_riccati_data {
+  // Problem structure
+  const casadi_riccati_prob<T1>* prob;
+  // Per stage: dynamics -inv(E)*[A B], diagonal of E, cost-to-go Hessian, feedback gain,
+  // Cholesky factor of the reduced control Hessian, cost-to-go gradient, feedforward
+  T1 *f, *e, *pm, *k, *l, *pv, *kv;
+  // Work vector
+  T1 *w;
+};
+// C-REPLACE "casadi_riccati_data<T1>" "struct casadi_riccati_data"
+
+// SYMBOL "riccati_init"
+template<typename T1>
+void casadi_riccati_init(casadi_riccati_data<T1>* d, T1** w) {
+  const casadi_riccati_prob<T1>* p = d->prob;
+  d->f = *w; *w += p->sz_f;
+  d->e = *w; *w += p->sz_e;
+  d->pm = *w; *w += p->sz_pm;
+  d->k = *w; *w += p->sz_k;
+  d->l = *w; *w += p->sz_l;
+  d->pv = *w; *w += p->sz_pv;
+  d->kv = *w; *w += p->sz_kv;
+  d->w = *w;
+}
+
+// SYMBOL "riccati_chol"
+template<typename T1>
+int casadi_riccati_chol(T1* a, casadi_int n) {
+  // Local variables
+  casadi_int i, j, k;
+  // In-place lower Cholesky factorization of a dense, column-major matrix
+  for (j=0; j<n; ++j) {
+    for (k=0; k<j; ++k) {
+      for (i=j; i<n; ++i) a[i+j*n] -= a[i+k*n]*a[j+k*n];
+    }
+    // Not positive definite
+    if (!(a[j+j*n] > 0)) return 1;
+    a[j+j*n] = sqrt(a[j+j*n]);
+    for (i=j+1; i<n; ++i) a[i+j*n] /= a[j+j*n];
+  }
+  return 0;
+}
+
+// SYMBOL "riccati_chol_solve"
+template<typename T1>
+void casadi_riccati_chol_solve(const T1* l, casadi_int n, T1* x) {
+  // Local variables
+  casadi_int i, j;
+  // Solve L*y = x
+  for (j=0; j<n; ++j) {
+    x[j] /= l[j+j*n];
+    for (i=j+1; i<n; ++i) x[i] -= l[i+j*n]*x[j];
+  }
+  // Solve L'*x = y
+  for (j=n-1; j>=0; --j) {
+    for (i=j+1; i<n; ++i) x[j] -= l[i+j*n]*x[i];
+    x[j] /= l[j+j*n];
+  }
+}
+
+// SYMBOL "riccati_extract"
+template<typename T1>
+void casadi_riccati_extract(const casadi_riccati_prob<T1>* p, const T1* nz_a, casadi_int k,
+                            casadi_int vo, casadi_int ro, T1* f, T1* gm, T1* e) {
+  // Local variables
+  casadi_int c, el, r, nx1, nv, ng;
+  const casadi_int *a_colind, *a_row;
+  a_row = (a_colind = p->sp_a+2) + p->nxq + 1;
+  nx1 = k<p->N ? p->nx[k+1] : 0;
+  nv = p->nx[k] + p->nu[k];
+  ng = p->ng[k];
+  if (f) casadi_clear(f, nx1*nv);
+  if (gm) casadi_clear(gm, ng*nv);
+  // Dynamics and non-dynamic constraints of the stage, [A B] and [C D]
+  for (c=0; c<nv; ++c) {
+    for (el=a_colind[vo+c]; el<a_colind[vo+c+1]; ++el) {
+      r = a_row[el] - ro;
+      if (r>=0 && r<nx1) {
+        if (f) f[r + c*nx1] = nz_a[el];
+      } else if (r>=nx1 && r<nx1+ng) {
+        if (gm) gm[r-nx1 + c*ng] = nz_a[el];
+      }
+    }
+  }
+  // Diagonal coefficients of the next state in the dynamics
+  if (e) {
+    casadi_clear(e, nx1);
+    for (c=0; c<nx1; ++c) {
+      for (el=a_colind[vo+nv+c]; el<a_colind[vo+nv+c+1]; ++el) {
+        if (a_row[el]==ro+c) e[c] = nz_a[el];
+      }
+    }
+  }
+}
+
+// SYMBOL "riccati_factor"
+template<typename T1>
+int casadi_riccati_factor(casadi_riccati_data<T1>* d, const T1* nz_h, const T1* nz_a,
+                          const T1* sigma) {
+  // Local variables
+  casadi_int k, i, j, c, el, nxk, nuk, nvk, ngk, nx1, vo, ro;
+  T1 *f, *e, *pm, *pm1, *kk, *l, *h, *gm, *pf, s;
+  const casadi_int *h_colind, *h_row;
+  const casadi_riccati_prob<T1>* p = d->prob;
+  h_row = (h_colind = p->sp_h+2) + p->nxq + 1;
+  // Work vectors
+  h = d->w;
+  gm = h + p->nv_max*p->nv_max;
+  pf = gm + p->ng_max*p->nv_max;
+  // Backward recursion, starting after the last stage
+  f = d->f + p->sz_f;
+  e = d->e + p->sz_e;
+  pm = d->pm + p->sz_pm;
+  kk = d->k + p->sz_k;
+  l = d->l + p->sz_l;
+  pm1 = 0;
+  vo = p->nxq;
+  ro = p->naq;
+  for (k=p->N; k>=0; --k) {
+    nxk = p->nx[k];
+    nuk = p->nu[k];
+    nvk = nxk + nuk;
+    ngk = p->ng[k];
+    nx1 = k<p->N ? p->nx[k+1] : 0;
+    vo -= nvk;
+    ro -= nx1 + ngk;
+    f -= nx1*nvk;
+    e -= nx1;
+    pm -= nxk*nxk;
+    kk -= nuk*nxk;
+    l -= nuk*nuk;
+    // Stage Hessian with the eliminated bounds
+    casadi_clear(h, nvk*nvk);
+    for (c=0; c<nvk; ++c) {
+      for (el=h_colind[vo+c]; el<h_colind[vo+c+1]; ++el) {
+        h[h_row[el]-vo + c*nvk] = nz_h[el];
+      }
+      h[c + c*nvk] += sigma[vo+c];
+    }
+    // Eliminated non-dynamic constraints, h += G'*diag(sigma)*G
+    casadi_riccati_extract(p, nz_a, k, vo, ro, f, gm, e);
+    for (i=0; i<ngk; ++i) {
+      s = sigma[p->nxq + ro + nx1 + i];
+      if (s==0) continue;
+      for (c=0; c<nvk; ++c) {
+        for (j=0; j<nvk; ++j) h[j + c*nvk] += s*gm[i + j*ngk]*gm[i + c*ngk];
+      }
+    }
+    // Cost-to-go of the next stage, h += f'*P*f with f = -inv(E)*[A B]
+    if (k<p->N) {
+      for (i=0; i<nx1; ++i) {
+        if (e[i]==0) return 1;
+        for (c=0; c<nvk; ++c) f[i + c*nx1] /= -e[i];
+      }
+      for (c=0; c<nvk; ++c) {
+        for (i=0; i<nx1; ++i) {
+          pf[i + c*nx1] = 0;
+          for (j=0; j<nx1; ++j) pf[i + c*nx1] += pm1[i + j*nx1]*f[j + c*nx1];
+        }
+      }
+      for (c=0; c<nvk; ++c) {
+        for (j=0; j<nvk; ++j) {
+          for (i=0; i<nx1; ++i) h[j + c*nvk] += f[i + j*nx1]*pf[i + c*nx1];
+        }
+      }
+    }
+    // Cholesky factorization of the reduced control Hessian
+    for (c=0; c<nuk; ++c) {
+      for (j=0; j<nuk; ++j) l[j + c*nuk] = h[nxk+j + (nxk+c)*nvk];
+    }
+    if (casadi_riccati_chol(l, nuk)) return 1;
+    // Feedback gain K = -inv(R)*S
+    for (c=0; c<nxk; ++c) {
+      for (j=0; j<nuk; ++j) kk[j + c*nuk] = -h[nxk+j + c*nvk];
+      casadi_riccati_chol_solve(l, nuk, kk + c*nuk);
+    }
+    // Cost-to-go Hessian P = Q + S'*K
+    for (c=0; c<nxk; ++c) {
+      for (j=0; j<=c; ++j) {
+        s = h[j + c*nvk];
+        for (i=0; i<nuk; ++i) s += h[nxk+i + j*nvk]*kk[i + c*nuk];
+        pm[j + c*nxk] = pm[c + j*nxk] = s;
+      }
+    }
+    pm1 = pm;
+  }
+  // Initial state minimizes the cost-to-go
+  return casadi_riccati_chol(d->pm, p->nx[0]);
+}
+
+// SYMBOL "riccati_solve"
+template<typename T1>
+void casadi_riccati_solve(casadi_riccati_data<T1>* d, const T1* nz_a, const T1* sigma,
+                          const T1* rhs, T1* dz, T1* dlam) {
+  // Local variables
+  casadi_int k, i, j, nxk, nuk, nvk, ngk, nx1, vo, ro;
+  T1 *f, *e, *pm, *pm1, *kk, *l, *pv, *pv1, *kv, *gm, *q, *t, *c;
+  const casadi_riccati_prob<T1>* p = d->prob;
+  // Work vectors
+  gm = d->w + p->nv_max*p->nv_max;
+  q = gm + p->ng_max*p->nv_max + p->nx_max*p->nv_max;
+  t = q + p->nv_max;
+  c = t + p->nx_max;
+  // Backward recursion for the cost-to-go gradient
+  f = d->f + p->sz_f;
+  e = d->e + p->sz_e;
+  pm = d->pm + p->sz_pm;
+  kk = d->k + p->sz_k;
+  l = d->l + p->sz_l;
+  pv = d->pv + p->sz_pv;
+  kv = d->kv + p->sz_kv;
+  pm1 = pv1 = 0;
+  vo = p->nxq;
+  ro = p->naq;
+  for (k=p->N; k>=0; --k) {
+    nxk = p->nx[k];
+    nuk = p->nu[k];
+    nvk = nxk + nuk;
+    ngk = p->ng[k];
+    nx1 = k<p->N ? p->nx[k+1] : 0;
+    vo -= nvk;
+    ro -= nx1 + ngk;
+    f -= nx1*nvk;
+    e -= nx1;
+    pm -= nxk*nxk;
+    kk -= nuk*nxk;
+    l -= nuk*nuk;
+    pv -= nxk;
+    kv -= nuk;
+    // Right-hand side with the eliminated non-dynamic constraints
+    casadi_copy(rhs + vo, nvk, q);
+    casadi_riccati_extract(p, nz_a, k, vo, ro, (T1*)0, gm, (T1*)0);
+    for (i=0; i<ngk; ++i) {
+      for (j=0; j<nvk; ++j) {
+        q[j] += gm[i + j*ngk]*sigma[p->nxq + ro + nx1 + i]*rhs[p->nxq + ro + nx1 + i];
+      }
+    }
+    // Cost-to-go of the next stage, q += f'*(p - P*c) with c = inv(E)*b
+    if (k<p->N) {
+      for (i=0; i<nx1; ++i) c[i] = rhs[p->nxq + ro + i]/e[i];
+      for (i=0; i<nx1; ++i) {
+        t[i] = pv1[i];
+        for (j=0; j<nx1; ++j) t[i] -= pm1[i + j*nx1]*c[j];
+      }
+      for (j=0; j<nvk; ++j) {
+        for (i=0; i<nx1; ++i) q[j] += f[i + j*nx1]*t[i];
+      }
+    }
+    // Cost-to-go gradient p = q_x + K'*q_u and feedforward inv(R)*q_u
+    for (j=0; j<nxk; ++j) {
+      pv[j] = q[j];
+      for (i=0; i<nuk; ++i) pv[j] += kk[i + j*nuk]*q[nxk+i];
+    }
+    casadi_copy(q + nxk, nuk, kv);
+    casadi_riccati_chol_solve(l, nuk, kv);
+    pm1 = pm;
+    pv1 = pv;
+  }
+  // Initial state
+  casadi_copy(d->pv, p->nx[0], dz);
+  casadi_riccati_chol_solve(d->pm, p->nx[0], dz);
+  // Forward recursion for the states, controls and dynamics multipliers
+  f = d->f;
+  e = d->e;
+  pm = d->pm;
+  kk = d->k;
+  pv = d->pv;
+  kv = d->kv;
+  vo = ro = 0;
+  for (k=0; k<=p->N; ++k) {
+    nxk = p->nx[k];
+    nuk = p->nu[k];
+    nvk = nxk + nuk;
+    ngk = p->ng[k];
+    nx1 = k<p->N ? p->nx[k+1] : 0;
+    // Controls
+    for (i=0; i<nuk; ++i) {
+      dz[vo+nxk+i] = kv[i];
+      for (j=0; j<nxk; ++j) dz[vo+nxk+i] += kk[i + j*nuk]*dz[vo+j];
+    }
+    if (k<p->N) {
+      // Next state
+      pm1 = pm + nxk*nxk;
+      pv1 = pv + nxk;
+      for (i=0; i<nx1; ++i) {
+        dz[vo+nvk+i] = rhs[p->nxq + ro + i]/e[i];
+        for (j=0; j<nvk; ++j) dz[vo+nvk+i] += f[i + j*nx1]*dz[vo+j];
+      }
+      // Dynamics multipliers from the cost-to-go gradient at the next state
+      for (i=0; i<nx1; ++i) {
+        t[i] = -pv1[i];
+        for (j=0; j<nx1; ++j) t[i] += pm1[i + j*nx1]*dz[vo+nvk+j];
+        dlam[p->nxq + ro + i] = -t[i]/e[i];
+      }
+      pm = pm1;
+      pv = pv1;
+    }
+    vo += nvk;
+    ro += nx1 + ngk;
+    f += nx1*nvk;
+    e += nx1;
+    kk += nuk*nxk;
+    kv += nuk;
+  }
+}
@@ -215,6 +215,21 @@ namespace casadi {
   template<typename T1>
   int casadi_newton(const casadi_newton_mem<T1>* m);
 
+  // Dormand-Prince 5(4) integrator steps
+  template<typename T1>
+  void casadi_dopri_stage(casadi_int n, casadi_int s, T1 h, const T1* x, const T1* k, T1* y);
+  template<typename T1>
+  T1 casadi_dopri_err(casadi_int n, T1 h, const T1* x0, const T1* x1, const T1* k,
+                      T1 abstol, T1 reltol);
+  template<typename T1>
+  void casadi_dopri_cont(casadi_int n, T1 h, const T1* x0, const T1* x1, const T1* k, T1* c);
+  template<typename T1>
+  void casadi_dopri_interp(casadi_int n, T1 theta, const T1* c, T1* y);
+  template<typename T1>
+  T1 casadi_dopri_fac(T1 err, casadi_int reject);
+  template<typename T1>
+  T1 casadi_dopri_h0(casadi_int n, const T1* x, const T1* k, T1 abstol, T1 reltol);
+
   // Dense matrix multiplication
   #define CASADI_GEMM_NT(M, N, K, A, LDA, B, LDB, C, LDC) \
     for (i=0, rr=C; i<M; ++i) \
@@ -265,13 +280,17 @@ namespace casadi {
   #include "casadi_finite_diff.hpp"
   #include "casadi_file_slurp.hpp"
   #include "casadi_ldl.hpp"
+  #include "casadi_ilu.hpp"
   #include "casadi_qr.hpp"
   #include "casadi_qp.hpp"
+  #include "casadi_ipqp.hpp"
+  #include "casadi_riccati.hpp"
   #include "casadi_nlp.hpp"
   #include "casadi_sqpmethod.hpp"
   #include "casadi_bfgs.hpp"
   #include "casadi_regularize.hpp"
   #include "casadi_newton.hpp"
+  #include "casadi_dopri.hpp"
   #include "casadi_bound_consistency.hpp"
   #include "casadi_lsqr.hpp"
   #include "casadi_cache.hpp"
@@ -151,6 +151,25 @@ namespace casadi {
     return ret;
   }
 
+  bool WeakRef::shared_if_alive(SharedObject& shared) const {
+    if (!alive()) return false;
+    SharedObjectInternal* raw = (*this)->raw_;
+#ifdef CASADI_WITH_THREAD
+    // Increase the reference count only if it has not reached zero
+    casadi_int c = raw->count.load();
+    do {
+      if (c==0) return false;
+    } while (!raw->count.compare_exchange_weak(c, c+1));
+#else // CASADI_WITH_THREAD
+    if (raw->count==0) return false;
+    raw->count++;
+#endif // CASADI_WITH_THREAD
+    // Take over the reference counted above
+    shared = SharedObject();
+    shared.assign(raw);
+    return true;
+  }
+
   const WeakRefInternal* WeakRef::operator->() const {
     return static_cast<const WeakRefInternal*>(SharedObject::operator->());
   }
@@ -183,6 +183,15 @@ namespace casadi {
     /** \brief Check if alive */
     bool alive() const;
 
+#ifndef SWIG
+    /** \brief Get a shared (owning) reference, unless the object is being destroyed
+     *
+     * Unlike shared(), this never resurrects an object whose reference count
+     * already dropped to zero on another thread. Returns false on failure.
+     */
+    bool shared_if_alive(SharedObject& shared) const;
+#endif // SWIG
+
     /** \brief  Access functions of the node */
     WeakRefInternal* operator->();
 
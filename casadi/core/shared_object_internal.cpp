@@ -60,6 +60,10 @@ namespace casadi {
     return count;
   }
 
+  void SharedObjectInternal::kill_weak() {
+    if (weak_ref_!=nullptr) weak_ref_->kill();
+  }
+
   WeakRef* SharedObjectInternal::weak() {
     if (weak_ref_==nullptr) {
       weak_ref_ = new WeakRef(this);
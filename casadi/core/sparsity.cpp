@@ -31,6 +31,15 @@
 #include "serializing_stream.hpp"
 #include <climits>
 
+#ifdef CASADI_WITH_THREAD
+#include <atomic>
+#ifdef CASADI_WITH_THREAD_MINGW
+#include <mingw.mutex.h>
+#else // CASADI_WITH_THREAD_MINGW
+#include <mutex>
+#endif // CASADI_WITH_THREAD_MINGW
+#endif // CASADI_WITH_THREAD
+
 #define CASADI_THROW_ERROR(FNAME, WHAT) \
 throw CasadiException("Error in Sparsity::" FNAME " at " + CASADI_WHERE + ":\n"\
   + std::string(WHAT));
@@ -501,9 +510,66 @@ namespace casadi {
     }
   }
 
-  Sparsity::CachingMap& Sparsity::getCache() {
-    static CachingMap ret;
-    return ret;
+  namespace {
+#ifdef CASADI_WITH_THREAD
+    typedef std::atomic<casadi_int> CacheCounter;
+#else // CASADI_WITH_THREAD
+    typedef casadi_int CacheCounter;
+#endif // CASADI_WITH_THREAD
+
+    /// Cached sparsity patterns, split into independently locked shards
+    struct SparsityCache {
+      struct Shard {
+        Sparsity::CachingMap map;
+#ifdef CASADI_WITH_THREAD
+        std::mutex mtx;
+#endif // CASADI_WITH_THREAD
+      };
+
+      static const casadi_int n_shards = 16;
+      Shard shards[n_shards];
+
+      // Statistics
+      CacheCounter n_hit, n_miss, n_collision, n_rehash, n_erased;
+
+      SparsityCache() : n_hit(0), n_miss(0), n_collision(0), n_rehash(0), n_erased(0) {}
+
+      Shard& shard(std::size_t h) { return shards[h % n_shards];}
+    };
+
+    SparsityCache& sparsity_cache() {
+      // Intentionally leaked: patterns may still be destroyed during static destruction
+      static SparsityCache* ret = new SparsityCache();
+      return *ret;
+    }
+  } // namespace
+
+  void Sparsity::uncache(SparsityInternal* node) {
+    SparsityCache::Shard& shard = sparsity_cache().shard(node->hash());
+#ifdef CASADI_WITH_THREAD
+    std::lock_guard<std::mutex> lock(shard.mtx);
+#endif // CASADI_WITH_THREAD
+    node->kill_weak();
+  }
+
+  Dict Sparsity::cache_stats() {
+    SparsityCache& cache = sparsity_cache();
+    casadi_int n_entries = 0;
+    for (auto&& shard : cache.shards) {
+#ifdef CASADI_WITH_THREAD
+      std::lock_guard<std::mutex> lock(shard.mtx);
+#endif // CASADI_WITH_THREAD
+      n_entries += shard.map.size();
+    }
+    Dict stats;
+    stats["n_hit"] = static_cast<casadi_int>(cache.n_hit);
+    stats["n_miss"] = static_cast<casadi_int>(cache.n_miss);
+    stats["n_collision"] = static_cast<casadi_int>(cache.n_collision);
+    stats["n_rehash"] = static_cast<casadi_int>(cache.n_rehash);
+    stats["n_erased"] = static_cast<casadi_int>(cache.n_erased);
+    stats["n_entries"] = n_entries;
+    stats["n_shards"] = SparsityCache::n_shards;
+    return stats;
   }
 
   const Sparsity& Sparsity::getScalar() {
@@ -854,7 +920,19 @@ namespace casadi {
     std::size_t h = hash_sparsity(nrow, ncol, colind, row);
 
     // Get a reference to the cache
-    CachingMap& cache = getCache();
+    SparsityCache& sc = sparsity_cache();
+    SparsityCache::Shard& shard = sc.shard(h);
+
+    // Releasing a pattern may delete it, which uncaches it under its shard lock.
+    // Keep the replaced pattern and all looked up patterns alive until the lock is released
+    SharedObject old_node = *this;
+    std::vector<SharedObject> refs;
+
+    // Lock the shard holding the pattern
+#ifdef CASADI_WITH_THREAD
+    std::lock_guard<std::mutex> lock(shard.mtx);
+#endif // CASADI_WITH_THREAD
+    CachingMap& cache = shard.map;
 
     // Record the current number of buckets (for garbage collection below)
     casadi_int bucket_count_before = cache.bucket_count();
@@ -871,21 +949,22 @@ namespace casadi {
         // Get a weak reference to the cached sparsity pattern
         WeakRef& wref = i->second;
 
-        // Check if the pattern still exists
-        if (wref.alive()) {
-
-          // Get an owning reference to the cached pattern
-          Sparsity ref = shared_cast<Sparsity>(wref.shared());
+        // Get an owning reference to the cached pattern, if it still exists
+        SharedObject ref;
+        if (wref.shared_if_alive(ref)) {
+          refs.push_back(ref);
 
           // Check if the pattern matches
-          if (ref.is_equal(nrow, ncol, colind, row)) {
+          if (shared_cast<Sparsity>(ref).is_equal(nrow, ncol, colind, row)) {
 
             // Found match!
             own(ref.get());
+            sc.n_hit++;
             return;
 
           } else { // There is a hash rowision (unlikely, but possible)
             // Leave the pattern alone, continue to the next matching pattern
+            sc.n_collision++;
             continue;
           }
         } else {
@@ -894,14 +973,13 @@ namespace casadi {
           CachingMap::iterator j=i;
           j++; // Start at the next matching key
           for (; j!=eq.second; ++j) {
-            if (j->second.alive()) {
-
-              // Recover cached sparsity
-              Sparsity ref = shared_cast<Sparsity>(j->second.shared());
-
+            SharedObject ref2;
+            if (j->second.shared_if_alive(ref2)) {
+              refs.push_back(ref2);
               // Match found if sparsity matches
-              if (ref.is_equal(nrow, ncol, colind, row)) {
-                own(ref.get());
+              if (shared_cast<Sparsity>(ref2).is_equal(nrow, ncol, colind, row)) {
+                own(ref2.get());
+                sc.n_hit++;
                 return;
               }
             }
@@ -909,6 +987,7 @@ namespace casadi {
 
           // The cached entry has been deleted, create a new one
           own(new SparsityInternal(nrow, ncol, colind, row));
+          sc.n_miss++;
 
           // Cache this pattern
           wref = *this;
@@ -921,6 +1000,7 @@ namespace casadi {
 
     // No matching sparsity pattern could be found, create a new one
     own(new SparsityInternal(nrow, ncol, colind, row));
+    sc.n_miss++;
 
     // Cache this pattern
     cache.insert(std::pair<std::size_t, WeakRef>(h, *this));
@@ -930,10 +1010,12 @@ namespace casadi {
 
     // We we increased the number of buckets, take time to garbage-collect deleted references
     if (bucket_count_before!=bucket_count_after) {
+      sc.n_rehash++;
       CachingMap::const_iterator i=cache.begin();
       while (i!=cache.end()) {
         if (!i->second.alive()) {
           i = cache.erase(i);
+          sc.n_erased++;
         } else {
           i++;
         }
@@ -341,6 +341,13 @@ namespace casadi {
     /** Obtain information about sparsity */
     Dict info() const;
 
+    /** \brief Statistics of the global cache of sparsity patterns
+     *
+     * Returns the number of cache hits, misses, hash collisions, times the
+     * hash table grew, stale entries erased and the current number of entries.
+     */
+    static Dict cache_stats();
+
     /** Export sparsity pattern to file
     *
     * Supported formats:
@@ -658,8 +665,8 @@ namespace casadi {
 #ifndef SWIG
     typedef std::unordered_multimap<std::size_t, WeakRef> CachingMap;
 
-    /// Cached sparsity patterns
-    static CachingMap& getCache();
+    /// Invalidate the cache entry of a pattern that is being destroyed
+    static void uncache(SparsityInternal* node);
 
     /// (Dense) scalar
     static const Sparsity& getScalar();
@@ -459,6 +459,8 @@ namespace casadi {
   }
 
   SparsityInternal::~SparsityInternal() {
+    // Make sure that no concurrent cache lookup can pick up this pattern
+    if (has_weak()) Sparsity::uncache(this);
     delete btf_;
   }
 
@@ -38,6 +38,11 @@
 #include "casadi_interrupt.hpp"
 #include "serializing_stream.hpp"
 
+// Labels as values, needed for the direct-threaded interpreter
+#if defined(__GNUC__) || defined(__clang__)
+#define CASADI_SX_COMPUTED_GOTO
+#endif
+
 namespace casadi {
 
   using namespace std;
@@ -53,6 +58,7 @@ namespace casadi {
     // Default (persistent) options
     just_in_time_opencl_ = false;
     just_in_time_sparsity_ = false;
+    interpreter_ = "switch";
   }
 
   SXFunction::~SXFunction() {
@@ -71,6 +77,12 @@ namespace casadi {
                    + str(free_vars_) + " are free.");
     }
 
+    // Native machine code
+    if (native_.fcn()) return native_.fcn()(arg, res, iw, w, 0);
+
+    // Direct-threaded interpreter
+    if (!threaded_.empty()) return eval_threaded(arg, res, w);
+
     // NOTE: The implementation of this function is very delicate. Small changes in the
     // class structure can cause large performance losses. For this reason,
     // the preprocessor macros are used below
@@ -90,6 +102,157 @@ namespace casadi {
     return 0;
   }
 
+  // Operations with a handler in the direct-threaded interpreter
+#define CASADI_SX_THREADED_OPS(H) \
+  H(OP_ASSIGN) H(OP_ADD) H(OP_SUB) H(OP_MUL) H(OP_DIV) H(OP_NEG) H(OP_EXP) H(OP_LOG) \
+  H(OP_POW) H(OP_CONSTPOW) H(OP_SQRT) H(OP_SQ) H(OP_TWICE) H(OP_SIN) H(OP_COS) \
+  H(OP_TAN) H(OP_ASIN) H(OP_ACOS) H(OP_ATAN) H(OP_LT) H(OP_LE) H(OP_EQ) H(OP_NE) \
+  H(OP_NOT) H(OP_AND) H(OP_OR) H(OP_IF_ELSE_ZERO) H(OP_FLOOR) H(OP_CEIL) H(OP_FMOD) \
+  H(OP_FABS) H(OP_SIGN) H(OP_COPYSIGN) H(OP_ERF) H(OP_FMIN) H(OP_FMAX) H(OP_INV) \
+  H(OP_SINH) H(OP_COSH) H(OP_TANH) H(OP_ASINH) H(OP_ACOSH) H(OP_ATANH) H(OP_ATAN2) \
+  H(OP_ERFINV) H(OP_LIFT) H(OP_PRINTME)
+
+  int SXFunction::eval_threaded(const double** arg, double** res, double* w,
+      std::vector<const void*>* handlers) const {
+#ifdef CASADI_SX_COMPUTED_GOTO
+    if (handlers) {
+      // Handler for each operation
+      std::vector<const void*> table(NUM_BUILT_IN_OPS, &&unknown);
+#define CASADI_SX_THREADED_ADDR(OP) table[OP] = &&h_##OP;
+      CASADI_SX_THREADED_OPS(CASADI_SX_THREADED_ADDR)
+#undef CASADI_SX_THREADED_ADDR
+      table[OP_CONST] = &&h_OP_CONST;
+      table[OP_INPUT] = &&h_OP_INPUT;
+      table[OP_OUTPUT] = &&h_OP_OUTPUT;
+
+      // Resolve the handler of each instruction, terminated by a sentinel
+      handlers->resize(algorithm_.size() + 1);
+      for (casadi_int k=0; k<algorithm_.size(); ++k) {
+        casadi_int op = algorithm_[k].op;
+        (*handlers)[k] = op>=0 && op<NUM_BUILT_IN_OPS ? table[op] : &&unknown;
+        // Superinstruction: multiplication followed by an addition
+        if (op==OP_MUL && k+1<algorithm_.size() && algorithm_[k+1].op==OP_ADD) {
+          (*handlers)[k] = &&h_muladd;
+          (*handlers)[++k] = table[OP_ADD];
+        }
+      }
+      handlers->back() = &&done;
+      return 0;
+    }
+
+    // NOTE: Each handler ends with its own indirect jump so that the branch predictor
+    // can learn transitions between pairs of operations
+    const AlgEl* a = algorithm_.data();
+    const void* const* h = threaded_.data();
+    casadi_int k = 0;
+    goto *h[0];
+
+#define CASADI_SX_THREADED_HANDLER(OP) \
+  h_##OP: \
+    BinaryOperationSS<OP>::fcn(w[a[k].i1], w[a[k].i2], w[a[k].i0], 1); \
+    goto *h[++k];
+    CASADI_SX_THREADED_OPS(CASADI_SX_THREADED_HANDLER)
+#undef CASADI_SX_THREADED_HANDLER
+
+  h_OP_CONST:
+    w[a[k].i0] = a[k].d;
+    goto *h[++k];
+  h_OP_INPUT:
+    w[a[k].i0] = arg[a[k].i1]==nullptr ? 0 : arg[a[k].i1][a[k].i2];
+    goto *h[++k];
+  h_OP_OUTPUT:
+    if (res[a[k].i0]!=nullptr) res[a[k].i0][a[k].i2] = w[a[k].i1];
+    goto *h[++k];
+  h_muladd:
+    w[a[k].i0] = w[a[k].i1] * w[a[k].i2];
+    w[a[k+1].i0] = w[a[k+1].i1] + w[a[k+1].i2];
+    k += 2;
+    goto *h[k];
+  unknown:
+    casadi_error("Unknown operation" + str(a[k].op));
+  done:
+    return 0;
+#else // CASADI_SX_COMPUTED_GOTO
+    casadi_error("Direct-threaded interpreter requires a compiler with computed goto support");
+    return 1;
+#endif // CASADI_SX_COMPUTED_GOTO
+  }
+
+#undef CASADI_SX_THREADED_OPS
+
+  void SXFunction::init_interpreter() {
+    threaded_.clear();
+    native_.clear();
+    if (interpreter_=="switch") {
+      // Nothing to prepare
+    } else if (interpreter_=="threaded") {
+#ifdef CASADI_SX_COMPUTED_GOTO
+      eval_threaded(nullptr, nullptr, nullptr, &threaded_);
+#else // CASADI_SX_COMPUTED_GOTO
+      casadi_warning("Direct-threaded interpreter not supported by the compiler, "
+                     "falling back to \"switch\"");
+#endif // CASADI_SX_COMPUTED_GOTO
+    } else if (interpreter_=="native") {
+      if (MachineCode::is_supported()) {
+        native_.compile(get_ptr(algorithm_), algorithm_.size(), worksize_);
+        if (verbose_) casadi_message(str(native_.size()) + " bytes of native code");
+      } else {
+        casadi_warning("Native code generation not supported on this platform, "
+                       "falling back to \"switch\"");
+      }
+    } else {
+      casadi_error("Unknown interpreter \"" + interpreter_ + "\", "
+                   "expected \"switch\", \"threaded\" or \"native\"");
+    }
+  }
+
+  bool SXFunction::has_eval_batch() const {
+    return !jit_ && eval_==nullptr && interpreter_=="switch";
+  }
+
+  int SXFunction::eval_batch(const double** arg, double** res,
+      double* w, casadi_int n) const {
+    if (verbose_) casadi_message(name_ + "::eval_batch");
+
+    // Make sure no free parameters
+    if (!free_vars_.empty()) {
+      std::stringstream ss;
+      disp(ss, false);
+      casadi_error("Cannot evaluate \"" + ss.str() + "\" since variables "
+                   + str(free_vars_) + " are free.");
+    }
+
+    // Evaluate the algorithm, element i of the work vector is stored in w[i*n], ..., w[i*n+n-1]
+    for (auto&& e : algorithm_) {
+      switch (e.op) {
+      case OP_CONST:
+        std::fill_n(w + e.i0*n, n, e.d);
+        break;
+      case OP_INPUT:
+        if (arg[e.i1]==nullptr) {
+          std::fill_n(w + e.i0*n, n, 0.);
+        } else {
+          const double* a = arg[e.i1] + e.i2;
+          casadi_int stride = nnz_in(e.i1);
+          double* f = w + e.i0*n;
+          for (casadi_int k=0; k<n; ++k) f[k] = a[k*stride];
+        }
+        break;
+      case OP_OUTPUT:
+        if (res[e.i0]!=nullptr) {
+          double* r = res[e.i0] + e.i2;
+          casadi_int stride = nnz_out(e.i0);
+          const double* x = w + e.i1*n;
+          for (casadi_int k=0; k<n; ++k) r[k*stride] = x[k];
+        }
+        break;
+      default:
+        casadi_math<double>::fun(e.op, w + e.i1*n, w + e.i2*n, w + e.i0*n, n);
+      }
+    }
+    return 0;
+  }
+
   bool SXFunction::is_smooth() const {
     // Go through all nodes and check if any node is non-smooth
     for (auto&& a : algorithm_) {
@@ -148,12 +311,45 @@ namespace casadi {
       casadi_error("Code generation of '" + name_ + "' is not possible since variables "
                    + str(free_vars_) + " are free.");
     }
+
+    // Split a large algorithm into functions that can go to separate translation units
+    casadi_int n_chunks = codegen_chunks(g);
+    if (n_chunks>1) {
+      std::string fname = codegen_name(g, false);
+      for (casadi_int k=0; k<n_chunks; ++k) {
+        g << g.declare_internal(signature(g.shorthand(fname + "_p" + str(k), false))) << " {\n";
+        codegen_alg(g, (k*algorithm_.size())/n_chunks, ((k+1)*algorithm_.size())/n_chunks);
+        g << "return 0;\n";
+        g << "}\n\n";
+        g.split_point();
+      }
+    }
+  }
+
+  casadi_int SXFunction::codegen_chunks(const CodeGenerator& g) const {
+    // Work vector entries are local variables unless avoid_stack
+    if (g.split==0 || !g.avoid_stack_) return 1;
+    return (algorithm_.size() + g.split - 1) / g.split;
   }
 
   void SXFunction::codegen_body(CodeGenerator& g) const {
+    casadi_int n_chunks = codegen_chunks(g);
+    if (n_chunks>1) {
+      // Call the parts in sequence
+      std::string fname = codegen_name(g, false);
+      for (casadi_int k=0; k<n_chunks; ++k) {
+        g << "if (" << g.shorthand(fname + "_p" + str(k)) << "(arg, res, iw, w, mem)) return 1;\n";
+      }
+    } else {
+      codegen_alg(g, 0, algorithm_.size());
+    }
+  }
+
+  void SXFunction::codegen_alg(CodeGenerator& g, casadi_int begin, casadi_int end) const {
 
     // Run the algorithm
-    for (auto&& a : algorithm_) {
+    for (casadi_int k=begin; k<end; ++k) {
+      const ScalarAtomic& a = algorithm_[k];
       if (a.op==OP_OUTPUT) {
         g << "if (res[" << a.i0 << "]!=0) "
           << g.res(a.i0) << "[" << a.i2 << "]=" << g.sx_work(a.i1);
@@ -192,7 +388,19 @@ namespace casadi {
         "Just-in-time compilation for numeric evaluation using OpenCL (experimental)"}},
       {"live_variables",
        {OT_BOOL,
-        "Reuse variables in the work vector"}}
+        "Reuse variables in the work vector"}},
+      {"cse",
+       {OT_BOOL,
+        "Perform common subexpression elimination (default false)"}},
+      {"schedule",
+       {OT_BOOL,
+        "Reorder the instructions to shorten the live ranges of intermediate results, "
+        "reducing the size of the work vector (default false)"}},
+      {"interpreter",
+       {OT_STRING,
+        "Interpreter for numerical evaluation: "
+        "'switch' (default), 'threaded' (direct-threaded, GCC/Clang only) or "
+        "'native' (machine code generated in memory, x86-64 Linux/macOS only)"}}
      }
   };
 
@@ -202,6 +410,7 @@ namespace casadi {
     opts["live_variables"] = live_variables_;
     opts["just_in_time_sparsity"] = just_in_time_sparsity_;
     opts["just_in_time_opencl"] = just_in_time_opencl_;
+    opts["interpreter"] = interpreter_;
     return opts;
   }
 
@@ -212,6 +421,8 @@ namespace casadi {
 
     // Default (temporary) options
     live_variables_ = true;
+    bool cse_opt = false;
+    bool schedule_opt = false;
 
     // Read options
     for (auto&& op : opts) {
@@ -219,6 +430,12 @@ namespace casadi {
         default_in_ = op.second;
       } else if (op.first=="live_variables") {
         live_variables_ = op.second;
+      } else if (op.first=="cse") {
+        cse_opt = op.second;
+      } else if (op.first=="schedule") {
+        schedule_opt = op.second;
+      } else if (op.first=="interpreter") {
+        interpreter_ = op.second.to_string();
       } else if (op.first=="just_in_time_opencl") {
         just_in_time_opencl_ = op.second;
       } else if (op.first=="just_in_time_sparsity") {
@@ -234,12 +451,18 @@ namespace casadi {
                             "Option 'default_in' has incorrect length");
     }
 
+    // Merge structurally equal subexpressions
+    if (cse_opt) out_ = SX::cse(out_);
+
     // Stack used to sort the computational graph
     stack<SXNode*> s;
 
     // All nodes
     vector<SXNode*> nodes;
 
+    // Nodes of the output nonzeros
+    vector<SXNode*> roots;
+
     // Add the list of nodes
     casadi_int ind=0;
     for (auto it = out_.begin(); it != out_.end(); ++it, ++ind) {
@@ -248,6 +471,7 @@ namespace casadi {
         // Add outputs to the list
         s.push(itc->get());
         sort_depth_first(s, nodes);
+        roots.push_back(itc->get());
 
         // A null pointer means an output instruction
         nodes.push_back(static_cast<SXNode*>(nullptr));
@@ -255,6 +479,27 @@ namespace casadi {
     }
 
     casadi_assert(nodes.size() <= std::numeric_limits<int>::max(), "Integer overflow");
+
+    // Reorder to reduce the size of the work vector
+    if (schedule_opt) {
+      for (casadi_int i=0; i<nodes.size(); ++i) {
+        if (nodes[i]) nodes[i]->temp = static_cast<int>(i);
+      }
+      casadi_int size_before = live_size(nodes, roots);
+      vector<SXNode*> scheduled = nodes;
+      schedule(scheduled, roots);
+      for (casadi_int i=0; i<scheduled.size(); ++i) {
+        if (scheduled[i]) scheduled[i]->temp = static_cast<int>(i);
+      }
+      casadi_int size_after = live_size(scheduled, roots);
+      if (verbose_) {
+        casadi_message("Scheduling: live work vector entries " + str(size_before)
+          + " before, " + str(size_after) + " after");
+      }
+      // Keep the original order unless there is an improvement
+      if (size_after < size_before) nodes.swap(scheduled);
+    }
+
     // Set the temporary variables to be the corresponding place in the sorted graph
     for (casadi_int i=0; i<nodes.size(); ++i) {
       if (nodes[i]) {
@@ -470,10 +715,86 @@ namespace casadi {
       casadi_error("OpenCL is not supported in this version of CasADi");
     }
 
+    // Prepare the interpreter for numerical evaluation
+    init_interpreter();
+
     // Print
     if (verbose_) casadi_message(str(algorithm_.size()) + " elementary operations");
   }
 
+  casadi_int SXFunction::live_size(const std::vector<SXNode*>& nodes,
+                                   const std::vector<SXNode*>& roots) {
+    // Remaining number of uses of each node
+    std::vector<casadi_int> uses(nodes.size(), 0);
+    casadi_int k = 0;
+    for (SXNode* n : nodes) {
+      if (n) {
+        for (casadi_int c=0; c<n->n_dep(); ++c) uses[n->dep(c)->temp]++;
+      } else {
+        uses[roots[k++]->temp]++;
+      }
+    }
+
+    // Count live entries, released after the last use
+    casadi_int live = 0, peak = 0;
+    k = 0;
+    for (SXNode* n : nodes) {
+      if (n) {
+        for (casadi_int c=0; c<n->n_dep(); ++c) {
+          if (--uses[n->dep(c)->temp]==0) live--;
+        }
+        peak = std::max(peak, ++live);
+      } else {
+        if (--uses[roots[k++]->temp]==0) live--;
+      }
+    }
+    return peak;
+  }
+
+  void SXFunction::schedule(std::vector<SXNode*>& nodes, const std::vector<SXNode*>& roots) {
+    // Work vector entries needed to evaluate each node (Sethi-Ullman number)
+    std::vector<casadi_int> need(nodes.size(), 0);
+    for (casadi_int i=0; i<nodes.size(); ++i) {
+      SXNode* n = nodes[i];
+      if (n==nullptr) continue;
+      if (n->n_dep()==0) {
+        need[i] = 1;
+      } else if (n->n_dep()==1) {
+        need[i] = need[n->dep(0)->temp];
+      } else {
+        casadi_int n0 = need[n->dep(0)->temp], n1 = need[n->dep(1)->temp];
+        need[i] = n0==n1 ? n0 + 1 : std::max(n0, n1);
+      }
+    }
+
+    // Depth-first search from each output, most demanding operand first
+    std::vector<SXNode*> ret;
+    ret.reserve(nodes.size());
+    std::vector<bool> added(nodes.size(), false);
+    std::vector<std::pair<SXNode*, casadi_int> > s;
+    for (SXNode* r : roots) {
+      s.push_back(std::make_pair(r, 0));
+      while (!s.empty()) {
+        SXNode* t = s.back().first;
+        casadi_int c = s.back().second++;
+        if (added[t->temp]) {
+          s.pop_back();
+        } else if (c < t->n_dep()) {
+          // Visit the operand that needs more entries first
+          if (t->n_dep()==2 && need[t->dep(1)->temp] > need[t->dep(0)->temp]) c = 1 - c;
+          s.push_back(std::make_pair(t->dep(c).get(), 0));
+        } else {
+          ret.push_back(t);
+          added[t->temp] = true;
+          s.pop_back();
+        }
+      }
+      // A null pointer means an output instruction
+      ret.push_back(nullptr);
+    }
+    nodes.swap(ret);
+  }
+
   SX SXFunction::instructions_sx() const {
     std::vector<SXElem> ret(algorithm_.size(), casadi_limits<SXElem>::nan);
 
@@ -830,6 +1151,120 @@ namespace casadi {
     return 0;
   }
 
+  template<casadi_int NW>
+  void SXFunction::sp_forward_lanes(const bvec_t** arg, bvec_t** res, bvec_t* w,
+                                    casadi_int nw) const {
+    const casadi_int n = NW ? NW : nw;
+    for (auto&& e : algorithm_) {
+      switch (e.op) {
+      case OP_CONST:
+      case OP_PARAMETER:
+        {
+          bvec_t* r = w + n*e.i0;
+          for (casadi_int j=0; j<n; ++j) r[j] = 0;
+        }
+        break;
+      case OP_INPUT:
+        {
+          bvec_t* r = w + n*e.i0;
+          const bvec_t* a = arg[e.i1];
+          if (a==nullptr) {
+            for (casadi_int j=0; j<n; ++j) r[j] = 0;
+          } else {
+            for (casadi_int j=0; j<n; ++j) r[j] = a[n*e.i2 + j];
+          }
+        }
+        break;
+      case OP_OUTPUT:
+        if (res[e.i0]!=nullptr) {
+          const bvec_t* x = w + n*e.i1;
+          bvec_t* q = res[e.i0] + n*e.i2;
+          for (casadi_int j=0; j<n; ++j) q[j] = x[j];
+        }
+        break;
+      default: // Unary or binary operation
+        {
+          bvec_t* r = w + n*e.i0;
+          const bvec_t *x = w + n*e.i1, *y = w + n*e.i2;
+          for (casadi_int j=0; j<n; ++j) r[j] = x[j] | y[j];
+        }
+      }
+    }
+  }
+
+  template<casadi_int NW>
+  void SXFunction::sp_reverse_lanes(bvec_t** arg, bvec_t** res, bvec_t* w,
+                                    casadi_int nw) const {
+    const casadi_int n = NW ? NW : nw;
+    fill_n(w, n*sz_w(), 0);
+    for (auto it=algorithm_.rbegin(); it!=algorithm_.rend(); ++it) {
+      switch (it->op) {
+      case OP_CONST:
+      case OP_PARAMETER:
+        {
+          bvec_t* r = w + n*it->i0;
+          for (casadi_int j=0; j<n; ++j) r[j] = 0;
+        }
+        break;
+      case OP_INPUT:
+        {
+          bvec_t* r = w + n*it->i0;
+          bvec_t* a = arg[it->i1];
+          if (a!=nullptr) {
+            for (casadi_int j=0; j<n; ++j) a[n*it->i2 + j] |= r[j];
+          }
+          for (casadi_int j=0; j<n; ++j) r[j] = 0;
+        }
+        break;
+      case OP_OUTPUT:
+        if (res[it->i0]!=nullptr) {
+          bvec_t* x = w + n*it->i1;
+          bvec_t* q = res[it->i0] + n*it->i2;
+          for (casadi_int j=0; j<n; ++j) {
+            x[j] |= q[j];
+            q[j] = 0;
+          }
+        }
+        break;
+      default: // Unary or binary operation
+        {
+          bvec_t *r = w + n*it->i0, *x = w + n*it->i1, *y = w + n*it->i2;
+          for (casadi_int j=0; j<n; ++j) {
+            bvec_t seed = r[j];
+            r[j] = 0;
+            x[j] |= seed;
+            y[j] |= seed;
+          }
+        }
+      }
+    }
+  }
+
+  int SXFunction::sp_forward_wide(const bvec_t** arg, bvec_t** res, casadi_int* iw,
+                                  bvec_t* w, void* mem, casadi_int nw) const {
+    // Fall back when forward mode not allowed
+    if (sp_weight()==1) return FunctionInternal::sp_forward_wide(arg, res, iw, w, mem, nw);
+    // Fixed widths of 256 and 512 bits allow the compiler to vectorize
+    switch (nw) {
+      case 4: sp_forward_lanes<4>(arg, res, w, nw); break;
+      case 8: sp_forward_lanes<8>(arg, res, w, nw); break;
+      default: sp_forward_lanes<0>(arg, res, w, nw);
+    }
+    return 0;
+  }
+
+  int SXFunction::sp_reverse_wide(bvec_t** arg, bvec_t** res, casadi_int* iw,
+                                  bvec_t* w, void* mem, casadi_int nw) const {
+    // Fall back when reverse mode not allowed
+    if (sp_weight()==0) return FunctionInternal::sp_reverse_wide(arg, res, iw, w, mem, nw);
+    switch (nw) {
+      case 4: sp_reverse_lanes<4>(arg, res, w, nw); break;
+      case 8: sp_reverse_lanes<8>(arg, res, w, nw); break;
+      default: sp_reverse_lanes<0>(arg, res, w, nw);
+    }
+    return 0;
+  }
+
   Function SXFunction::get_jacobian(const std::string& name,
                                        const std::vector<std::string>& inames,
                                        const std::vector<std::string>& onames,
@@ -965,7 +1400,7 @@ namespace casadi {
 
   SXFunction::SXFunction(DeserializingStream& s) :
     XFunction<SXFunction, SX, SXNode>(s) {
-    s.version("SXFunction", 1);
+    int version = s.version("SXFunction", 1, 2);
     size_t n_instructions;
     s.unpack("SXFunction::n_instr", n_instructions);
 
@@ -990,12 +1425,19 @@ namespace casadi {
 
     s.unpack("SXFunction::live_variables", live_variables_);
 
+    if (version==1) {
+      interpreter_ = "switch";
+    } else {
+      s.unpack("SXFunction::interpreter", interpreter_);
+    }
+    init_interpreter();
+
     XFunction<SXFunction, SX, SXNode>::delayed_deserialize_members(s);
   }
 
   void SXFunction::serialize_body(SerializingStream &s) const {
     XFunction<SXFunction, SX, SXNode>::serialize_body(s);
-    s.version("SXFunction", 1);
+    s.version("SXFunction", 2);
     s.pack("SXFunction::n_instr", algorithm_.size());
 
     s.pack("SXFunction::worksize", worksize_);
@@ -1013,6 +1455,7 @@ namespace casadi {
     }
 
     s.pack("SXFunction::live_variables", live_variables_);
+    s.pack("SXFunction::interpreter", interpreter_);
 
     XFunction<SXFunction, SX, SXNode>::delayed_serialize_members(s);
   }
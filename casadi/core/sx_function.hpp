@@ -27,6 +27,7 @@
 #define CASADI_SX_FUNCTION_HPP
 
 #include "x_function.hpp"
+#include "machine_code.hpp"
 
 /// \cond INTERNAL
 
@@ -66,6 +67,47 @@ class CASADI_EXPORT SXFunction :
   int eval_sx(const SXElem** arg, SXElem** res,
               casadi_int* iw, SXElem* w, void* mem) const override;
 
+  /** \brief  Evaluate numerically for a batch of n points
+   *
+   * Point k of input (output) i is stored at offset k*nnz_in(i) (k*nnz_out(i)),
+   * as for Map. The work vector, of length sz_w()*n, is used in a
+   * structure-of-arrays layout so that every instruction is applied to
+   * all points with a single dispatch.
+   */
+  int eval_batch(const double** arg, double** res, double* w, casadi_int n) const;
+
+  /** \brief Can eval_batch replace evaluation with eval
+   *
+   * Only when the default interpreter is used and the function is not jit compiled.
+   */
+  bool has_eval_batch() const;
+
+  /** \brief Evaluate numerically with the direct-threaded interpreter
+   *
+   * Each instruction jumps directly to the handler of the next one, using
+   * handler addresses resolved once in advance (computed goto). Pairs of
+   * instructions that occur frequently are fused into superinstructions.
+   * If \a handlers is not null, nothing is evaluated and the handler address
+   * of each instruction is written to it instead.
+   */
+  int eval_threaded(const double** arg, double** res, double* w,
+                    std::vector<const void*>* handlers=nullptr) const;
+
+  /** \brief Prepare the interpreter for numerical evaluation */
+  void init_interpreter();
+
+  /** \brief Work vector size when evaluating the sorted nodes with reuse of entries
+   * Node temporaries must hold their position in the list
+   */
+  static casadi_int live_size(const std::vector<SXNode*>& nodes,
+                              const std::vector<SXNode*>& roots);
+
+  /** \brief Reorder the sorted nodes to shorten live ranges
+   * Depth-first, evaluating the operand that needs the most work vector entries first.
+   * Node temporaries must hold their position in the list
+   */
+  static void schedule(std::vector<SXNode*>& nodes, const std::vector<SXNode*>& roots);
+
   /** Inline calls? */
   bool should_inline(bool always_inline, bool never_inline) const override {
     return true;
@@ -206,6 +248,12 @@ class CASADI_EXPORT SXFunction :
   /** \brief Generate code for the body of the C function */
   void codegen_body(CodeGenerator& g) const override;
 
+  /** \brief Number of functions the generated code is split into */
+  casadi_int codegen_chunks(const CodeGenerator& g) const;
+
+  /** \brief Generate code for a range of instructions */
+  void codegen_alg(CodeGenerator& g, casadi_int begin, casadi_int end) const;
+
   /** \brief  Propagate sparsity forward */
   int sp_forward(const bvec_t** arg, bvec_t** res,
                   casadi_int* iw, bvec_t* w, void* mem) const override;
@@ -213,6 +261,25 @@ class CASADI_EXPORT SXFunction :
   /** \brief  Propagate sparsity backwards */
   int sp_reverse(bvec_t** arg, bvec_t** res, casadi_int* iw, bvec_t* w, void* mem) const override;
 
+  ///@{
+  /** \brief Propagate sparsity in several bit vectors per nonzero at once */
+  int sp_forward_wide(const bvec_t** arg, bvec_t** res, casadi_int* iw, bvec_t* w,
+                      void* mem, casadi_int nw) const override;
+  int sp_reverse_wide(bvec_t** arg, bvec_t** res, casadi_int* iw, bvec_t* w,
+                      void* mem, casadi_int nw) const override;
+  bool has_sp_wide() const override { return true;}
+  ///@}
+
+  ///@{
+  /** \brief Wide sparsity propagation, NW bit vectors per nonzero or nw if NW is zero
+   * The bit vectors of an input, output or work vector entry are stored contiguously
+   */
+  template<casadi_int NW>
+  void sp_forward_lanes(const bvec_t** arg, bvec_t** res, bvec_t* w, casadi_int nw) const;
+  template<casadi_int NW>
+  void sp_reverse_lanes(bvec_t** arg, bvec_t** res, bvec_t* w, casadi_int nw) const;
+  ///@}
+
   /** \brief Return Jacobian of all input elements with respect to all output elements */
   Function get_jacobian(const std::string& name,
                                    const std::vector<std::string>& inames,
@@ -238,6 +305,15 @@ class CASADI_EXPORT SXFunction :
   /// Live variables?
   bool live_variables_;
 
+  /// Interpreter used for numerical evaluation
+  std::string interpreter_;
+
+  /// Handler address for each instruction, empty unless direct-threaded
+  std::vector<const void*> threaded_;
+
+  /// Native machine code, empty unless the interpreter is native
+  MachineCode native_;
+
 protected:
   /** \brief Deserializing constructor */
   explicit SXFunction(DeserializingStream& s);
@@ -27,6 +27,9 @@
 
 #include "sx_function.hpp"
 
+#include <cstring>
+#include <unordered_map>
+
 using namespace std;
 
 namespace casadi {
@@ -861,6 +864,92 @@ namespace casadi {
     copy(vdef.begin(), vdef.end(), vdef_sx.begin());
   }
 
+  template<>
+  vector<SX> CASADI_EXPORT SX::cse(const vector<SX>& e) {
+    // Sort the expression
+    Function f("tmp_cse", vector<SX>(), e);
+    SXFunction *ff = f.get<SXFunction>();
+
+    // Get references to the internal data structures
+    const vector<ScalarAtomic>& algorithm = ff->algorithm_;
+    vector<SXElem> work(f.sz_w());
+
+    // Iterator to the binary operations
+    vector<SXElem>::const_iterator b_it=ff->operations_.begin();
+
+    // Iterator to stack of constants
+    vector<SXElem>::const_iterator c_it = ff->constants_.begin();
+
+    // Iterator to free variables
+    vector<SXElem>::const_iterator p_it = ff->free_vars_.begin();
+
+    // Unique nodes, bucketed by a hash of the operation and its dependencies
+    std::unordered_map<size_t, vector<SXElem> > unique;
+
+    // Return value
+    vector<SX> ret = e;
+
+    // Evaluate the algorithm
+    for (vector<ScalarAtomic>::const_iterator it=algorithm.begin(); it<algorithm.end(); ++it) {
+      switch (it->op) {
+      case OP_OUTPUT: ret.at(it->i0)->at(it->i2) = work[it->i1]; continue;
+      case OP_PARAMETER: work[it->i0] = *p_it++; continue;
+      default: break;
+      }
+
+      // Original node and its hash key
+      SXElem n;
+      size_t key = it->op;
+      if (it->op==OP_CONST) {
+        n = *c_it++;
+        double v = it->d;
+        int64_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        hash_combine(key, bits);
+      } else {
+        const SXElem& orig = *b_it++;
+        const SXElem& x = work[it->i1];
+        if (casadi_math<double>::ndeps(it->op)==2) {
+          const SXElem& y = work[it->i2];
+          // Reuse the original node if the dependencies are unchanged
+          if (SXElem::is_equal(x, orig->dep(0)) && SXElem::is_equal(y, orig->dep(1))) {
+            n = orig;
+          } else {
+            n = SXElem::binary(it->op, x, y);
+          }
+          // Order of arguments irrelevant for commutative operations
+          size_t hx = reinterpret_cast<size_t>(x.get()), hy = reinterpret_cast<size_t>(y.get());
+          if (operation_checker<CommChecker>(it->op) && hy<hx) std::swap(hx, hy);
+          hash_combine(key, hx);
+          hash_combine(key, hy);
+        } else {
+          if (SXElem::is_equal(x, orig->dep(0))) {
+            n = orig;
+          } else {
+            n = SXElem::unary(it->op, x);
+          }
+          hash_combine(key, reinterpret_cast<size_t>(x.get()));
+        }
+      }
+
+      // Look for an equivalent node
+      vector<SXElem>& bucket = unique[key];
+      bool found = false;
+      for (auto&& c : bucket) {
+        if (SXElem::is_equal(c, n, 1)) {
+          work[it->i0] = c;
+          found = true;
+          break;
+        }
+      }
+      if (!found) {
+        bucket.push_back(n);
+        work[it->i0] = n;
+      }
+    }
+    return ret;
+  }
+
   template<>
   SX CASADI_EXPORT SX::poly_coeff(const SX& ex, const SX& x) {
     casadi_assert_dev(ex.is_scalar());
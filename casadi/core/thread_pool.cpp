@@ -0,0 +1,210 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "thread_pool.hpp"
+#include "global_options.hpp"
+#include "exception.hpp"
+
+#if defined(CASADI_WITH_THREAD) && !defined(CASADI_WITH_THREAD_MINGW) && defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#define CASADI_THREAD_AFFINITY
+#endif
+
+using namespace std;
+
+namespace casadi {
+
+  ThreadPool& ThreadPool::instance() {
+    // Intentionally leaked: workers must not be joined during static destruction
+    static ThreadPool* pool = new ThreadPool();
+    return *pool;
+  }
+
+#ifndef CASADI_WITH_THREAD
+
+  ThreadPool::ThreadPool() : n_jobs_(0) {
+  }
+
+  ThreadPool::~ThreadPool() {
+  }
+
+  void ThreadPool::run(casadi_int n, const std::function<void(casadi_int)>& f) {
+    n_jobs_++;
+    for (casadi_int i=0; i<n; ++i) f(i);
+  }
+
+  casadi_int ThreadPool::size() const {
+    return 0;
+  }
+
+#else // CASADI_WITH_THREAD
+
+  ThreadPool::ThreadPool() : n_active_(0), stop_(false), affinity_(false),
+      reconfiguring_(false), n_jobs_(0) {
+  }
+
+  ThreadPool::~ThreadPool() {
+    std::unique_lock<std::mutex> lock(mtx_);
+    stop(lock);
+  }
+
+  casadi_int ThreadPool::size() const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return workers_.size();
+  }
+
+  void ThreadPool::start(casadi_int n_threads, bool affinity) {
+    casadi_assert_dev(workers_.empty());
+    stop_ = false;
+    affinity_ = affinity;
+    workers_.reserve(n_threads);
+    for (casadi_int k=0; k<n_threads; ++k) {
+      workers_.emplace_back([this, k]() { work(k); });
+    }
+  }
+
+  void ThreadPool::stop(std::unique_lock<std::mutex>& lock) {
+    stop_ = true;
+    work_cv_.notify_all();
+    // Join outside the lock, workers need it to exit their loop
+    std::vector<std::thread> workers;
+    workers.swap(workers_);
+    lock.unlock();
+    for (auto&& w : workers) w.join();
+    lock.lock();
+  }
+
+  bool ThreadPool::claim(Job*& job, casadi_int& i) {
+    if (queue_.empty()) return false;
+    job = queue_.front();
+    i = job->next++;
+    // No more tasks to hand out: remove from queue
+    if (job->next>=job->n) queue_.pop_front();
+    return true;
+  }
+
+  void ThreadPool::execute(Job* job, casadi_int i) {
+    try {
+      (*job->f)(i);
+    } catch (std::exception& e) {
+      casadi_warning("Exception raised: " + std::string(e.what()));
+    } catch (...) {
+      casadi_warning("Uncaught exception.");
+    }
+    std::lock_guard<std::mutex> lock(mtx_);
+    // Job may be destroyed by its owner as soon as the lock is released
+    if (++job->done==job->n) done_cv_.notify_all();
+  }
+
+  void ThreadPool::work(casadi_int k) {
+#ifdef CASADI_THREAD_AFFINITY
+    if (affinity_) {
+      casadi_int n_cpu = std::thread::hardware_concurrency();
+      if (n_cpu>0) {
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET((k+1) % n_cpu, &cpuset);
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+      }
+    }
+#endif // CASADI_THREAD_AFFINITY
+    std::unique_lock<std::mutex> lock(mtx_);
+    while (true) {
+      work_cv_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+      if (stop_) return;
+      Job* job;
+      casadi_int i;
+      if (!claim(job, i)) continue;
+      lock.unlock();
+      execute(job, i);
+      lock.lock();
+    }
+  }
+
+  void ThreadPool::run(casadi_int n, const std::function<void(casadi_int)>& f) {
+    if (n<=0) return;
+    std::unique_lock<std::mutex> lock(mtx_);
+    // The lock is released while the workers are replaced, wait for this to complete
+    done_cv_.wait(lock, [this]() { return !reconfiguring_; });
+    n_jobs_++;
+
+    // (Re)create workers when idle and the configuration changed
+    if (n_active_==0) {
+      casadi_int n_threads = GlobalOptions::max_num_threads;
+      if (n_threads<=0) {
+        n_threads = std::thread::hardware_concurrency();
+        if (n_threads<=0) n_threads = 1;
+      }
+      // The calling thread participates
+      n_threads -= 1;
+      bool affinity = GlobalOptions::thread_affinity;
+      if (n_threads!=static_cast<casadi_int>(workers_.size()) || affinity!=affinity_) {
+        reconfiguring_ = true;
+        stop(lock);
+        start(n_threads, affinity);
+        reconfiguring_ = false;
+        done_cv_.notify_all();
+      }
+    }
+
+    // Serial evaluation when there are no workers or a single task
+    if (workers_.empty() || n==1) {
+      lock.unlock();
+      for (casadi_int i=0; i<n; ++i) f(i);
+      return;
+    }
+
+    // Submit job
+    Job job = {&f, n, 0, 0};
+    queue_.push_back(&job);
+    n_active_++;
+    work_cv_.notify_all();
+
+    // Take part in the work until no tasks of this job are left to claim
+    while (job.next<job.n) {
+      casadi_int i = job.next++;
+      if (job.next>=job.n) {
+        // Last task claimed by the owner: remove from queue
+        for (auto it=queue_.begin(); it!=queue_.end(); ++it) {
+          if (*it==&job) {
+            queue_.erase(it);
+            break;
+          }
+        }
+      }
+      lock.unlock();
+      execute(&job, i);
+      lock.lock();
+    }
+
+    // Wait for tasks still being executed by workers
+    done_cv_.wait(lock, [&job]() { return job.done==job.n; });
+    n_active_--;
+  }
+
+#endif // CASADI_WITH_THREAD
+
+} // namespace casadi
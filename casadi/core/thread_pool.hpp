@@ -0,0 +1,146 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_THREAD_POOL_HPP
+#define CASADI_THREAD_POOL_HPP
+
+#include "casadi_common.hpp"
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <vector>
+
+#ifdef CASADI_WITH_THREAD
+#ifdef CASADI_WITH_THREAD_MINGW
+#include <mingw.thread.h>
+#include <mingw.mutex.h>
+#include <mingw.condition_variable.h>
+#else // CASADI_WITH_THREAD_MINGW
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif // CASADI_WITH_THREAD_MINGW
+#endif // CASADI_WITH_THREAD
+
+/// \cond INTERNAL
+
+namespace casadi {
+
+  /** \brief Process-wide pool of persistent worker threads
+
+      Workers are created once and reused for all parallel evaluations.
+      A call to run(n, f) enqueues a job whose n tasks are claimed dynamically
+      by idle workers and by the calling thread itself. Since the caller always
+      takes part in the work, nested calls from within a task cannot deadlock.
+
+      The number of workers and the thread affinity are taken from
+      GlobalOptions::max_num_threads and GlobalOptions::thread_affinity.
+  */
+  class CASADI_EXPORT ThreadPool {
+  public:
+    /// Access the process-wide instance
+    static ThreadPool& instance();
+
+    /// Destructor, stops all workers
+    ~ThreadPool();
+
+    /** \brief Evaluate f(0), ..., f(n-1), possibly in parallel
+     *  Returns once all tasks have completed.
+     */
+    void run(casadi_int n, const std::function<void(casadi_int)>& f);
+
+    /// Number of worker threads (not counting the calling thread)
+    casadi_int size() const;
+
+    /// Number of jobs submitted so far
+    casadi_int n_jobs() const { return n_jobs_;}
+
+  private:
+    /// Use instance() instead
+    ThreadPool();
+
+    /// No copying
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+#ifdef CASADI_WITH_THREAD
+    // A batch of tasks submitted by one call to run
+    struct Job {
+      const std::function<void(casadi_int)>* f;
+      casadi_int n, next, done;
+    };
+
+    // Claim a task, requires lock. Returns false if no work is left.
+    bool claim(Job*& job, casadi_int& i);
+
+    // Execute a claimed task and register its completion
+    void execute(Job* job, casadi_int i);
+
+    // Main loop of a worker
+    void work(casadi_int k);
+
+    // Start workers, requires lock and no running jobs
+    void start(casadi_int n_threads, bool affinity);
+
+    // Stop all workers, requires no running jobs. Releases the lock while joining.
+    void stop(std::unique_lock<std::mutex>& lock);
+
+    // Worker threads
+    std::vector<std::thread> workers_;
+
+    // Jobs with unclaimed tasks
+    std::deque<Job*> queue_;
+
+    // Number of jobs that have not yet completed
+    casadi_int n_active_;
+
+    // Protects all members
+    mutable std::mutex mtx_;
+
+    // Signals new work or shutdown to workers
+    std::condition_variable work_cv_;
+
+    // Signals completion of tasks or of a reconfiguration to waiting callers
+    std::condition_variable done_cv_;
+
+    // Shutdown flag
+    bool stop_;
+
+    // Affinity currently applied to the workers
+    bool affinity_;
+
+    // Workers are being replaced, other callers must wait
+    bool reconfiguring_;
+#endif // CASADI_WITH_THREAD
+
+    // Statistics, may be read without holding the lock
+    std::atomic<casadi_int> n_jobs_;
+  };
+
+} // namespace casadi
+/// \endcond
+
+#endif // CASADI_THREAD_POOL_HPP
@@ -153,6 +153,9 @@ namespace casadi {
     // Set tolerances
     THROWING(CVodeSStolerances, m->mem, reltol_, abstol_);
 
+    // Event functions
+    if (ne_>0) THROWING(CVodeRootInit, m->mem, ne_, rootfn);
+
     // Maximum number of steps
     THROWING(CVodeSetMaxNumSteps, m->mem, max_num_steps_);
 
@@ -236,6 +239,24 @@ namespace casadi {
     }
   }
 
+  int CvodesInterface::rootfn(double t, N_Vector x, double* e, void *user_data) {
+    try {
+      casadi_assert_dev(user_data);
+      auto m = to_mem(user_data);
+      auto& s = m->self;
+      m->arg[0] = NV_DATA_S(x);
+      m->arg[1] = nullptr;
+      m->arg[2] = m->p;
+      m->arg[3] = &t;
+      m->res[0] = e;
+      if (s.calc_function(m, "eventF")) return 1;
+      return 0;
+    } catch(exception& e) { // non-recoverable error
+      uerr() << "rootfn failed: " << e.what() << endl;
+      return -1;
+    }
+  }
+
   void CvodesInterface::reset(IntegratorMemory* mem, double t, const double* x,
                               const double* z, const double* _p) const {
     if (verbose_) casadi_message(name_ + "::reset");
@@ -282,8 +303,19 @@ namespace casadi {
         // ... with taping
         THROWING(CVodeF, m->mem, t, m->xz, &m->t, CV_NORMAL, &m->ncheck);
       } else {
-        // ... without taping
-        THROWING(CVode, m->mem, t, m->xz, &m->t, CV_NORMAL);
+        // ... without taping, stopping at events
+        int flag = CVode(m->mem, t, m->xz, &m->t, CV_NORMAL);
+        cvodes_error("CVode", flag);
+        if (flag==CV_ROOT_RETURN) {
+          THROWING(CVodeGetRootInfo, m->mem, get_ptr(m->rootsfound));
+          for (casadi_int i=0; i<ne_; ++i) {
+            if (m->rootsfound[i]!=0) {
+              m->event_index = i;
+              m->t_event = m->t;
+              break;
+            }
+          }
+        }
       }
 
       // Get quadratures
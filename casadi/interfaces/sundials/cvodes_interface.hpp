@@ -159,6 +159,7 @@ namespace casadi {
 
     // Sundials callback functions
     static int rhs(double t, N_Vector x, N_Vector xdot, void *user_data);
+    static int rootfn(double t, N_Vector x, double* e, void *user_data);
     static void ehfun(int error_code, const char *module, const char *function, char *msg,
                       void *user_data);
     static int rhsQ(double t, N_Vector x, N_Vector qdot, void *user_data);
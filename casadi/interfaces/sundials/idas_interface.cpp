@@ -194,6 +194,24 @@ namespace casadi {
     }
   }
 
+  int IdasInterface::rootfn(double t, N_Vector xz, N_Vector xzdot,
+                            double* e, void *user_data) {
+    try {
+      auto m = to_mem(user_data);
+      auto& s = m->self;
+      m->arg[0] = NV_DATA_S(xz);
+      m->arg[1] = NV_DATA_S(xz)+s.nx_;
+      m->arg[2] = m->p;
+      m->arg[3] = &t;
+      m->res[0] = e;
+      if (s.calc_function(m, "eventF")) return 1;
+      return 0;
+    } catch(exception& e) { // non-recoverable error
+      uerr() << "rootfn failed: " << e.what() << endl;
+      return -1;
+    }
+  }
+
   void IdasInterface::ehfun(int error_code, const char *module, const char *function,
                                    char *msg, void *eh_data) {
     try {
@@ -289,6 +307,9 @@ namespace casadi {
     IDAInit(m->mem, res, t0, m->xz, m->xzdot);
     if (verbose_) casadi_message("IDA initialized");
 
+    // Event functions
+    if (ne_>0) THROWING(IDARootInit, m->mem, ne_, rootfn);
+
     // Include algebraic variables in error testing
     THROWING(IDASetSuppressAlg, m->mem, suppress_algebraic_);
 
@@ -413,14 +434,16 @@ namespace casadi {
     N_VConst(0.0, m->xzdot);
     copy(init_xdot_.begin(), init_xdot_.end(), NV_DATA_S(m->xzdot));
 
-    THROWING(IDAReInit, m->mem, grid_.front(), m->xz, m->xzdot);
+    THROWING(IDAReInit, m->mem, t, m->xz, m->xzdot);
 
     // Re-initialize quadratures
     if (nq_>0) THROWING(IDAQuadReInit, m->mem, m->q);
 
     // Correct initial conditions, if necessary
     if (calc_ic_) {
-      THROWING(IDACalcIC, m->mem, IDA_YA_YDP_INIT , first_time_);
+      // After an event, the first output time may already have passed
+      double tout1 = first_time_>t ? first_time_ : t + (grid_.back()-grid_.front());
+      THROWING(IDACalcIC, m->mem, IDA_YA_YDP_INIT , tout1);
       THROWING(IDAGetConsistentIC, m->mem, m->xz, m->xzdot);
     }
 
@@ -449,8 +472,19 @@ namespace casadi {
       // Integrate forward ...
       if (nrx_>0) { // ... with taping
         THROWING(IDASolveF, m->mem, t, &m->t, m->xz, m->xzdot, IDA_NORMAL, &m->ncheck);
-      } else { // ... without taping
-        THROWING(IDASolve, m->mem, t, &m->t, m->xz, m->xzdot, IDA_NORMAL);
+      } else { // ... without taping, stopping at events
+        int flag = IDASolve(m->mem, t, &m->t, m->xz, m->xzdot, IDA_NORMAL);
+        idas_error("IDASolve", flag);
+        if (flag==IDA_ROOT_RETURN) {
+          THROWING(IDAGetRootInfo, m->mem, get_ptr(m->rootsfound));
+          for (casadi_int i=0; i<ne_; ++i) {
+            if (m->rootsfound[i]!=0) {
+              m->event_index = i;
+              m->t_event = m->t;
+              break;
+            }
+          }
+        }
       }
 
       // Get quadratures
@@ -66,6 +66,17 @@ namespace casadi {
       {"use_preconditioner",
        {OT_BOOL,
         "Precondition the iterative solver [default: true]"}},
+      {"preconditioner",
+       {OT_STRING,
+        "Preconditioner for the iterative schemes: FULL|block_jacobi|ilu. "
+        "'full' factorizes the complete Newton matrix with the linear solver, "
+        "'block_jacobi' only its diagonal blocks from a block triangular "
+        "decomposition, 'ilu' uses an incomplete LU factorization"}},
+      {"preconditioner_options",
+       {OT_DICT,
+        "Options to be passed to the preconditioner. For 'block_jacobi': "
+        "max_block_size [default: 0, unlimited]. For 'ilu': passed to the "
+        "'ilu' linear solver plugin, e.g. fill_level"}},
       {"stop_at_end",
        {OT_BOOL,
         "Stop the integrator at the end of the interval"}},
@@ -122,6 +133,7 @@ namespace casadi {
     max_num_steps_ = 10000;
     stop_at_end_ = true;
     use_precon_ = true;
+    preconditioner_ = "full";
     max_krylov_ = 10;
     linear_solver_ = "qr";
     string newton_scheme = "direct";
@@ -148,6 +160,10 @@ namespace casadi {
         stop_at_end_ = op.second;
       } else if (op.first=="use_preconditioner") {
         use_precon_ = op.second;
+      } else if (op.first=="preconditioner") {
+        preconditioner_ = op.second.to_string();
+      } else if (op.first=="preconditioner_options") {
+        preconditioner_options_ = op.second;
       } else if (op.first=="max_krylov") {
         max_krylov_ = op.second;
       } else if (op.first=="newton_scheme") {
@@ -192,6 +208,26 @@ namespace casadi {
       casadi_error("Unknown Newton scheme: " + newton_scheme);
     }
 
+    // Type of preconditioner
+    casadi_int max_block_size = 0;
+    if (preconditioner_=="full") {
+      // Nothing to do
+    } else if (preconditioner_=="block_jacobi") {
+      for (auto&& op : preconditioner_options_) {
+        if (op.first=="max_block_size") {
+          max_block_size = op.second;
+        } else {
+          casadi_error("No such block_jacobi preconditioner option: " + op.first);
+        }
+      }
+    } else if (preconditioner_=="ilu") {
+      // Options passed to the linear solver plugin
+    } else {
+      casadi_error("Unknown preconditioner: " + preconditioner_);
+    }
+    casadi_assert(preconditioner_=="full" || newton_scheme_!=SD_DIRECT,
+      "Preconditioner '" + preconditioner_ + "' requires an iterative newton_scheme");
+
     // Interpolation_type
     if (interpolation_type=="hermite") {
       interp_ = SD_HERMITE;
@@ -219,6 +255,16 @@ namespace casadi {
           J = d->getJ(backward);
         }
       }
+
+      // Only keep the diagonal blocks for a block-Jacobi preconditioner. With SX, only
+      // the kept entries are evaluated. With MX, the full Jacobian is still evaluated
+      // and then projected, so that only the factorization is restricted.
+      if (preconditioner_=="block_jacobi") {
+        Sparsity sp = block_jacobi_sparsity(J.sparsity_out(0), max_block_size);
+        if (sp!=J.sparsity_out(0)) {
+          J = J.is_a("SXFunction") ? project_jac<SX>(J, sp) : project_jac<MX>(J, sp);
+        }
+      }
       set_function(J, J.name(), true);
       alloc_w(J.nnz_out(0), true);
     }
@@ -229,14 +275,65 @@ namespace casadi {
     alloc_w(2*max(nx_+nz_, nrx_+nrz_), true); // v1, v2
 
     // Allocate linear solvers
-    linsolF_ = Linsol("linsolF", linear_solver_,
-      get_function("jacF").sparsity_out(0), linear_solver_options_);
+    string linear_solver = linear_solver_;
+    Dict linear_solver_options = linear_solver_options_;
+    if (preconditioner_=="ilu") {
+      linear_solver = "ilu";
+      linear_solver_options = preconditioner_options_;
+    }
+    linsolF_ = Linsol("linsolF", linear_solver,
+      get_function("jacF").sparsity_out(0), linear_solver_options);
     if (nrx_>0) {
-      linsolB_ = Linsol("linsolB", linear_solver_,
-        get_function("jacB").sparsity_out(0), linear_solver_options_);
+      linsolB_ = Linsol("linsolB", linear_solver,
+        get_function("jacB").sparsity_out(0), linear_solver_options);
     }
   }
 
+  Sparsity SundialsInterface::block_jacobi_sparsity(const Sparsity& sp,
+      casadi_int max_block_size) {
+    // Block triangular form
+    vector<casadi_int> rowperm, colperm, rowblock, colblock, coarse_rowblock, coarse_colblock;
+    casadi_int nb = sp.btf(rowperm, colperm, rowblock, colblock,
+                           coarse_rowblock, coarse_colblock);
+    // Assign a block index to every row and column, splitting too large blocks
+    vector<casadi_int> rblk(sp.size1(), -1), cblk(sp.size2(), -1);
+    casadi_int ind = 0;
+    for (casadi_int b=0; b<nb; ++b) {
+      casadi_int nr = rowblock[b+1]-rowblock[b], nc = colblock[b+1]-colblock[b];
+      casadi_int bs = max_block_size>0 ? max_block_size : max(max(nr, nc), casadi_int(1));
+      for (casadi_int k=0; k<nr; ++k) rblk[rowperm[rowblock[b]+k]] = ind + k/bs;
+      for (casadi_int k=0; k<nc; ++k) cblk[colperm[colblock[b]+k]] = ind + k/bs;
+      ind += (max(nr, nc)+bs-1)/bs;
+    }
+    // Keep the entries within the blocks
+    const casadi_int *colind = sp.colind(), *row = sp.row();
+    vector<casadi_int> r, c;
+    for (casadi_int cc=0; cc<sp.size2(); ++cc) {
+      for (casadi_int k=colind[cc]; k<colind[cc+1]; ++k) {
+        if (rblk[row[k]]==cblk[cc]) {
+          r.push_back(row[k]);
+          c.push_back(cc);
+        }
+      }
+    }
+    // Include the diagonal, but only where it does not couple different blocks
+    for (casadi_int i=0; i<sp.size1(); ++i) {
+      if (rblk[i]==cblk[i]) {
+        r.push_back(i);
+        c.push_back(i);
+      }
+    }
+    return Sparsity::triplet(sp.size1(), sp.size2(), r, c);
+  }
+
+  template<typename MatType>
+  Function SundialsInterface::project_jac(const Function& J, const Sparsity& sp) {
+    vector<MatType> a = MatType::get_input(J);
+    vector<MatType> r = const_cast<Function&>(J)(a); // NOLINT
+    r.at(0) = project(r.at(0), sp);
+    return Function(J.name(), a, r, J.name_in(), J.name_out());
+  }
+
   int SundialsInterface::init_mem(void* mem) const {
     if (Integrator::init_mem(mem)) return 1;
     auto m = static_cast<SundialsMemory*>(mem);
@@ -247,6 +344,9 @@ namespace casadi {
     m->rxz = N_VNew_Serial(nrx_+nrz_);
     m->rq = N_VNew_Serial(nrq_);
 
+    // Root information for events
+    m->rootsfound.resize(ne_);
+
     m->mem_linsolF = linsolF_.checkout();
     if (!linsolB_.is_null()) m->mem_linsolB = linsolB_.checkout();
 
@@ -76,6 +76,9 @@ namespace casadi {
     /// number of checkpoints stored so far
     int ncheck;
 
+    /// Event functions that crossed zero at the last root return
+    std::vector<int> rootsfound;
+
     /// Linear solver memory objects
     int mem_linsolF, mem_linsolB;
 
@@ -118,12 +121,25 @@ namespace casadi {
     // Get system Jacobian
     virtual Function getJ(bool backward) const = 0;
 
+    /// Block diagonal part of a Jacobian sparsity, for block-Jacobi preconditioning
+    static Sparsity block_jacobi_sparsity(const Sparsity& sp, casadi_int max_block_size);
+
+    /** \brief Restrict the output of a Jacobian function to a sparsity pattern
+
+        The SX version only evaluates the kept entries, the MX version evaluates
+        the full Jacobian and drops the other entries. */
+    template<typename MatType>
+    static Function project_jac(const Function& J, const Sparsity& sp);
+
     /// Get all statistics
     Dict get_stats(void* mem) const override;
 
     /** \brief  Print solver statistics */
     void print_stats(IntegratorMemory* mem) const override;
 
+    /** \brief Events are located by the rootfinding of SUNDIALS */
+    bool has_events() const override { return true;}
+
     /** \brief  Reset the forward problem and bring the time back to t0 */
     void reset(IntegratorMemory* mem, double t, const double* x,
                        const double* z, const double* p) const override;
@@ -152,6 +168,8 @@ namespace casadi {
     Dict linear_solver_options_;
     casadi_int max_krylov_;
     bool use_precon_;
+    std::string preconditioner_;
+    Dict preconditioner_options_;
     bool second_order_correction_;
     double step0_;
     double max_step_size_;
@@ -222,6 +222,28 @@ namespace casadi {
     F_ = Function("dae", F_in, F_out);
     alloc(F_);
 
+    // The collocation equations couple the stages through the derivative coefficients
+    vector<double> M(deg_*deg_);
+    for (casadi_int j=1; j<deg_+1; ++j) {
+      for (casadi_int r=1; r<deg_+1; ++r) M[j-1 + (r-1)*deg_] = C[r][j];
+    }
+
+    // Jacobian of a stage, frozen at the initial state and the first stage algebraic variables
+    MX xs = MX::sym("x", nx_), zs = MX::sym("z", nz_);
+    vector<MX> f_arg(DAE_NUM_IN);
+    f_arg[DAE_T] = t;
+    f_arg[DAE_P] = p;
+    f_arg[DAE_X] = reshape(xs, size_in(INTEGRATOR_X0));
+    f_arg[DAE_Z] = reshape(zs, size_in(INTEGRATOR_Z0));
+    vector<MX> f_res = f_(f_arg);
+    MX K = MX::jacobian(vertcat(h_*vec(f_res[DAE_ODE]), vec(f_res[DAE_ALG])), vertcat(xs, zs));
+    Function stage_jac("stage_jac", {xs, zs, p, t}, {K});
+    K = stage_jac(vector<MX>{vec(x0), vec(z[1]), p, t}).at(0);
+    stage_structure_ = Dict();
+    stage_structure_["stage_matrix"] = M;
+    stage_structure_["stage_differential"] = nx_;
+    stage_structure_["stage_jacobian"] = Function("stage_jac_F", F_in, {K});
+
     // Backwards dynamics
     // NOTE: The following is derived so that it will give the exact adjoint
     // sensitivities whenever g is the reverse mode derivative of f.
@@ -306,18 +328,39 @@ namespace casadi {
       G_out[RDAE_QUAD] = rqf;
       G_ = Function("rdae", G_in, G_out);
       alloc(G_);
-    }
-  }
 
-  void Collocation::reset(IntegratorMemory* mem, double t, const double* x,
-                                const double* z, const double* p) const {
-    auto m = static_cast<FixedStepMemory*>(mem);
+      // Stage coupling, with the collocation equations scaled by the quadrature weights
+      vector<double> MB(deg_*deg_), wB(deg_);
+      for (casadi_int j=1; j<deg_+1; ++j) {
+        wB[j-1] = B[j];
+        for (casadi_int r=1; r<deg_+1; ++r) MB[j-1 + (r-1)*deg_] = B[r]*C[j][r]/B[j];
+      }
 
-    // Reset the base classes
-    ImplicitFixedStepIntegrator::reset(mem, t, x, z, p);
+      // Jacobian of a backward stage, frozen as in the forward problem
+      MX rxs = MX::sym("rx", nrx_), rzs = MX::sym("rz", nrz_);
+      vector<MX> g_arg(RDAE_NUM_IN);
+      g_arg[RDAE_T] = t;
+      g_arg[RDAE_P] = p;
+      g_arg[RDAE_X] = reshape(xs, size_in(INTEGRATOR_X0));
+      g_arg[RDAE_Z] = reshape(zs, size_in(INTEGRATOR_Z0));
+      g_arg[RDAE_RX] = reshape(rxs, this->rx().size());
+      g_arg[RDAE_RZ] = reshape(rzs, this->rz().size());
+      g_arg[RDAE_RP] = rp;
+      vector<MX> g_res = g_(g_arg);
+      MX KB = MX::jacobian(vertcat(h_*vec(g_res[RDAE_ODE]), vec(g_res[RDAE_ALG])),
+                       vertcat(rxs, rzs));
+      Function stage_jacB("stage_jacB", {rxs, rzs, xs, zs, p, rp, t}, {KB});
+      KB = stage_jacB(vector<MX>{vec(rx0), vec(rz[1]), vec(x0), vec(z[1]), p, rp, t}).at(0);
+      stage_structureB_ = Dict();
+      stage_structureB_["stage_matrix"] = MB;
+      stage_structureB_["stage_weights"] = wB;
+      stage_structureB_["stage_differential"] = nrx_;
+      stage_structureB_["stage_jacobian"] = Function("stage_jac_G", G_in, {KB});
+    }
+  }
 
-    // Initial guess for Z
-    double* Z = get_ptr(m->Z);
+  void Collocation::guess_Z(const double* x, const double* z, double* Z) const {
+    // Collocation points start at the initial state
     for (casadi_int d=0; d<deg_; ++d) {
       casadi_copy(x, nx_, Z);
       Z += nx_;
@@ -89,14 +89,18 @@ namespace casadi {
     // Return zero if smaller than machine epsilon
     static double zeroIfSmall(double x);
 
-    /** \brief Reset the forward problem */
-    void reset(IntegratorMemory* mem, double t, const double* x,
-                       const double* z, const double* p) const override;
+    /// Initial guess for the discrete time algebraic variables
+    void guess_Z(const double* x, const double* z, double* Z) const override;
 
     /// Reset the backward problem and take time to tf
     void resetB(IntegratorMemory* mem, double t, const double* rx,
                         const double* rz, const double* rp) const override;
 
+    /// Stage structure of F or G, options for the stage_newton rootfinder
+    Dict stage_structure(bool backward) const override {
+      return backward ? stage_structureB_ : stage_structure_;
+    }
+
     MX algebraic_state_init(const MX& x0, const MX& z0) const override;
     MX algebraic_state_output(const MX& Z) const override;
 
@@ -112,6 +116,9 @@ namespace casadi {
     /// Continuous time dynamics
     Function f_, g_;
 
+    /// Stage structure of F and G, set in setupFG
+    Dict stage_structure_, stage_structureB_;
+
     /** \brief Serialize an object without type information */
     void serialize_body(SerializingStream &s) const override;
 
@@ -0,0 +1,585 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "dormand_prince.hpp"
+
+#include <cmath>
+#include <limits>
+
+using namespace std;
+namespace casadi {
+
+  extern "C"
+  int CASADI_INTEGRATOR_DOPRI_EXPORT
+      casadi_register_integrator_dopri(Integrator::Plugin* plugin) {
+    plugin->creator = DormandPrince::creator;
+    plugin->name = "dopri";
+    plugin->doc = DormandPrince::meta_doc.c_str();
+    plugin->version = CASADI_VERSION;
+    plugin->options = &DormandPrince::options_;
+    plugin->deserialize = &DormandPrince::deserialize;
+    return 0;
+  }
+
+  extern "C"
+  void CASADI_INTEGRATOR_DOPRI_EXPORT casadi_load_integrator_dopri() {
+    Integrator::registerPlugin(casadi_register_integrator_dopri);
+  }
+
+  const double DormandPrince::c_[7] = {0., 1./5, 3./10, 4./5, 8./9, 1., 1.};
+
+  DormandPrince::DormandPrince(const std::string& name, const Function& dae)
+    : Integrator(name, dae) {
+  }
+
+  DormandPrince::~DormandPrince() {
+    clear_mem();
+  }
+
+  const Options DormandPrince::options_
+  = {{&Integrator::options_},
+     {{"abstol",
+       {OT_DOUBLE,
+        "Absolute tolerence for the IVP solution [default: 1e-8]"}},
+      {"reltol",
+       {OT_DOUBLE,
+        "Relative tolerence for the IVP solution [default: 1e-6]"}},
+      {"quad_err_con",
+       {OT_BOOL,
+        "Should the quadratures affect the step size control [default: false]"}},
+      {"max_num_steps",
+       {OT_INT,
+        "Maximum number of steps between two output times [default: 10000]"}},
+      {"step0",
+       {OT_DOUBLE,
+        "Initial step size [default: 0/estimated]"}},
+      {"min_step_size",
+       {OT_DOUBLE,
+        "Min step size [default: 0/0.0]"}},
+      {"max_step_size",
+       {OT_DOUBLE,
+        "Max step size [default: 0/inf]"}}
+     }
+  };
+
+  void DormandPrince::init(const Dict& opts) {
+    // Call the base class init
+    Integrator::init(opts);
+
+    // Default options
+    abstol_ = 1e-8;
+    reltol_ = 1e-6;
+    quad_err_con_ = false;
+    max_num_steps_ = 10000;
+    step0_ = 0;
+    min_step_size_ = 0;
+    max_step_size_ = 0;
+
+    // Read options
+    for (auto&& op : opts) {
+      if (op.first=="abstol") {
+        abstol_ = op.second;
+      } else if (op.first=="reltol") {
+        reltol_ = op.second;
+      } else if (op.first=="quad_err_con") {
+        quad_err_con_ = op.second;
+      } else if (op.first=="max_num_steps") {
+        max_num_steps_ = op.second;
+      } else if (op.first=="step0") {
+        step0_ = op.second;
+      } else if (op.first=="min_step_size") {
+        min_step_size_ = op.second;
+      } else if (op.first=="max_step_size") {
+        max_step_size_ = op.second;
+      }
+    }
+
+    // Algebraic variables not supported
+    casadi_assert(nz_==0 && nrz_==0,
+                  "Explicit Runge-Kutta integrators do not support algebraic variables");
+    casadi_assert(abstol_>0 && reltol_>=0, "Tolerances must be positive");
+
+    // Dynamics, forward and backward problem
+    create_function("dynF", {"x", "p", "t"}, {"ode", "quad"});
+    if (nrx_>0) create_function("dynB", {"rx", "rp", "x", "p", "t"}, {"rode", "rquad"});
+
+    // State, stages and continuous extension in the generated code
+    alloc_w(14*nx_ + 14*nq_ + 1, true);
+  }
+
+  int DormandPrince::init_mem(void* mem) const {
+    if (Integrator::init_mem(mem)) return 1;
+    auto m = static_cast<DormandPrinceMemory*>(mem);
+
+    // Forward problem
+    m->x.resize(nx_);
+    m->q.resize(nq_);
+    m->p.resize(np_);
+    m->x1.resize(nx_);
+    m->q1.resize(nq_);
+    m->k.resize(7*nx_);
+    m->kq.resize(7*nq_);
+    m->c.resize(5*nx_);
+    m->cq.resize(5*nq_);
+
+    // Backward problem
+    m->rx.resize(nrx_);
+    m->rq.resize(nrq_);
+    m->rp.resize(nrp_);
+    m->rx1.resize(nrx_);
+    m->rq1.resize(nrq_);
+    m->rk.resize(7*nrx_);
+    m->rkq.resize(7*nrq_);
+    m->x_interp.resize(nx_);
+
+    // Statistics
+    m->nsteps = m->nfevals = m->netfails = 0;
+    m->nstepsB = m->nfevalsB = m->netfailsB = 0;
+    return 0;
+  }
+
+  void DormandPrince::eval_f(DormandPrinceMemory* m, double t, const double* x,
+                             casadi_int s) const {
+    m->arg[0] = x;
+    m->arg[1] = get_ptr(m->p);
+    m->arg[2] = &t;
+    m->res[0] = get_ptr(m->k) + s*nx_;
+    m->res[1] = get_ptr(m->kq) + s*nq_;
+    casadi_assert(!calc_function(m, "dynF"), "Evaluation of 'dynF' failed at t=" + str(t));
+    m->nfevals++;
+  }
+
+  void DormandPrince::eval_g(DormandPrinceMemory* m, double t, const double* rx,
+                             casadi_int s) const {
+    // Interpolate the forward solution
+    if (m->tape_t.empty()) {
+      casadi_copy(get_ptr(m->x), nx_, get_ptr(m->x_interp));
+    } else {
+      double theta = (t - m->tape_t[m->kB]) / m->tape_h[m->kB];
+      casadi_dopri_interp(nx_, theta, get_ptr(m->tape_c) + 5*nx_*m->kB, get_ptr(m->x_interp));
+    }
+    m->arg[0] = rx;
+    m->arg[1] = get_ptr(m->rp);
+    m->arg[2] = get_ptr(m->x_interp);
+    m->arg[3] = get_ptr(m->p);
+    m->arg[4] = &t;
+    m->res[0] = get_ptr(m->rk) + s*nrx_;
+    m->res[1] = get_ptr(m->rkq) + s*nrq_;
+    casadi_assert(!calc_function(m, "dynB"), "Evaluation of 'dynB' failed at t=" + str(t));
+    m->nfevalsB++;
+  }
+
+  double DormandPrince::step0(double t, double tf, casadi_int n,
+                              const double* x, const double* k) const {
+    double h = step0_>0 ? step0_ : casadi_dopri_h0(n, x, k, abstol_, reltol_);
+    if (max_step_size_>0) h = std::min(h, max_step_size_);
+    return std::min(h, std::fabs(tf - t));
+  }
+
+  void DormandPrince::reset(IntegratorMemory* mem, double t,
+                            const double* x, const double* z, const double* p) const {
+    auto m = static_cast<DormandPrinceMemory*>(mem);
+
+    // Update time
+    m->t = m->t_prev = t;
+    m->h_prev = 0;
+
+    // Set parameters
+    casadi_copy(p, np_, get_ptr(m->p));
+
+    // Update the state
+    casadi_copy(x, nx_, get_ptr(m->x));
+
+    // Reset summation states
+    casadi_clear(get_ptr(m->q), nq_);
+
+    // Clear the tape
+    m->tape_t.clear();
+    m->tape_h.clear();
+    m->tape_c.clear();
+
+    // Reset statistics
+    m->nsteps = m->nfevals = m->netfails = 0;
+
+    // Stage derivative at the initial time, reused at the end of every step
+    eval_f(m, m->t, get_ptr(m->x), 0);
+    m->h = step0(m->t, grid_.back(), nx_, get_ptr(m->x), get_ptr(m->k));
+  }
+
+  void DormandPrince::advance(IntegratorMemory* mem, double t,
+                              double* x, double* z, double* q) const {
+    auto m = static_cast<DormandPrinceMemory*>(mem);
+    double tf = grid_.back();
+    casadi_assert(t<=tf, "Cannot integrate past the end of the time horizon");
+
+    // Take steps until t has been passed
+    bool reject = false;
+    casadi_int nsteps = 0;
+    while (m->t<t) {
+      casadi_assert(nsteps++<max_num_steps_,
+                    "Maximum number of steps reached at t=" + str(m->t));
+
+      // Do not step past the end of the time horizon
+      bool last = m->h>=tf-m->t;
+      double h = last ? tf-m->t : m->h;
+
+      // Stages, the last one is evaluated at the fifth order solution
+      for (casadi_int s=1; s<7; ++s) {
+        casadi_dopri_stage(nx_, s, h, get_ptr(m->x), get_ptr(m->k), get_ptr(m->x1));
+        eval_f(m, m->t + c_[s]*h, get_ptr(m->x1), s);
+      }
+      casadi_dopri_stage(nq_, 6, h, get_ptr(m->q), get_ptr(m->kq), get_ptr(m->q1));
+
+      // Scaled RMS norm of the local error estimate
+      double err = casadi_dopri_err(nx_, h, get_ptr(m->x), get_ptr(m->x1), get_ptr(m->k),
+                                    abstol_, reltol_);
+      casadi_int n_err = nx_;
+      if (quad_err_con_) {
+        err += casadi_dopri_err(nq_, h, get_ptr(m->q), get_ptr(m->q1), get_ptr(m->kq),
+                                abstol_, reltol_);
+        n_err += nq_;
+      }
+      err = std::sqrt(err/static_cast<double>(n_err));
+
+      if (err<=1) {
+        // Continuous extension of the accepted step
+        casadi_dopri_cont(nx_, h, get_ptr(m->x), get_ptr(m->x1), get_ptr(m->k), get_ptr(m->c));
+        casadi_dopri_cont(nq_, h, get_ptr(m->q), get_ptr(m->q1), get_ptr(m->kq),
+                          get_ptr(m->cq));
+
+        // Tape the step for the backward problem
+        if (nrx_>0) {
+          m->tape_t.push_back(m->t);
+          m->tape_h.push_back(h);
+          m->tape_c.insert(m->tape_c.end(), m->c.begin(), m->c.end());
+        }
+
+        // Move to the end of the step, first stage of the next step is the last one
+        casadi_copy(get_ptr(m->x1), nx_, get_ptr(m->x));
+        casadi_copy(get_ptr(m->q1), nq_, get_ptr(m->q));
+        casadi_copy(get_ptr(m->k) + 6*nx_, nx_, get_ptr(m->k));
+        casadi_copy(get_ptr(m->kq) + 6*nq_, nq_, get_ptr(m->kq));
+        m->t_prev = m->t;
+        m->h_prev = h;
+        m->t = last ? tf : m->t + h;
+        m->nsteps++;
+        m->h = h*casadi_dopri_fac(err, casadi_int(reject));
+        reject = false;
+      } else {
+        m->netfails++;
+        m->h = h*casadi_dopri_fac(err, casadi_int(1));
+        reject = true;
+      }
+
+      // Step size limits
+      if (max_step_size_>0) m->h = std::min(m->h, max_step_size_);
+      casadi_assert(m->h>=min_step_size_
+                    && m->h>16*numeric_limits<double>::epsilon()*std::fabs(m->t),
+                    "Step size too small at t=" + str(m->t));
+    }
+
+    // Dense output, unless at the end of the last step
+    if (m->h_prev>0 && t<m->t) {
+      double theta = (t - m->t_prev) / m->h_prev;
+      casadi_dopri_interp(nx_, theta, get_ptr(m->c), x);
+      casadi_dopri_interp(nq_, theta, get_ptr(m->cq), q);
+    } else {
+      casadi_copy(get_ptr(m->x), nx_, x);
+      casadi_copy(get_ptr(m->q), nq_, q);
+    }
+  }
+
+  void DormandPrince::resetB(IntegratorMemory* mem, double t, const double* rx,
+                             const double* rz, const double* rp) const {
+    auto m = static_cast<DormandPrinceMemory*>(mem);
+
+    // Update time, start from the last step on the tape
+    m->tB = t;
+    m->kB = static_cast<casadi_int>(m->tape_t.size()) - 1;
+
+    // Set parameters
+    casadi_copy(rp, nrp_, get_ptr(m->rp));
+
+    // Update the state
+    casadi_copy(rx, nrx_, get_ptr(m->rx));
+
+    // Reset summation states
+    casadi_clear(get_ptr(m->rq), nrq_);
+
+    // Reset statistics
+    m->nstepsB = m->nfevalsB = m->netfailsB = 0;
+
+    // Stage derivative at the final time, reused at the end of every step
+    eval_g(m, m->tB, get_ptr(m->rx), 0);
+    m->hB = step0(m->tB, grid_.front(), nrx_, get_ptr(m->rx), get_ptr(m->rk));
+  }
+
+  void DormandPrince::retreat(IntegratorMemory* mem, double t,
+                              double* rx, double* rz, double* rq) const {
+    auto m = static_cast<DormandPrinceMemory*>(mem);
+
+    // Take steps until t has been reached
+    bool reject = false;
+    casadi_int nsteps = 0;
+    while (m->tB>t) {
+      casadi_assert(nsteps++<max_num_steps_,
+                    "Maximum number of steps reached at t=" + str(m->tB));
+
+      // Stay within one step of the forward solution, where it is smooth
+      double t_lo = std::max(t, m->tape_t.empty() ? t : m->tape_t[m->kB]);
+      bool last = m->hB>=m->tB-t_lo;
+      double h = last ? m->tB-t_lo : m->hB;
+
+      // Stages, the last one is evaluated at the fifth order solution
+      for (casadi_int s=1; s<7; ++s) {
+        casadi_dopri_stage(nrx_, s, h, get_ptr(m->rx), get_ptr(m->rk), get_ptr(m->rx1));
+        eval_g(m, m->tB - c_[s]*h, get_ptr(m->rx1), s);
+      }
+      casadi_dopri_stage(nrq_, 6, h, get_ptr(m->rq), get_ptr(m->rkq), get_ptr(m->rq1));
+
+      // Scaled RMS norm of the local error estimate
+      double err = casadi_dopri_err(nrx_, h, get_ptr(m->rx), get_ptr(m->rx1), get_ptr(m->rk),
+                                    abstol_, reltol_);
+      casadi_int n_err = nrx_;
+      if (quad_err_con_) {
+        err += casadi_dopri_err(nrq_, h, get_ptr(m->rq), get_ptr(m->rq1), get_ptr(m->rkq),
+                                abstol_, reltol_);
+        n_err += nrq_;
+      }
+      err = std::sqrt(err/static_cast<double>(n_err));
+
+      if (err<=1) {
+        // Move to the beginning of the step
+        casadi_copy(get_ptr(m->rx1), nrx_, get_ptr(m->rx));
+        casadi_copy(get_ptr(m->rq1), nrq_, get_ptr(m->rq));
+        casadi_copy(get_ptr(m->rk) + 6*nrx_, nrx_, get_ptr(m->rk));
+        casadi_copy(get_ptr(m->rkq) + 6*nrq_, nrq_, get_ptr(m->rkq));
+        m->tB = last ? t_lo : m->tB - h;
+        if (m->kB>0 && m->tB<=m->tape_t[m->kB]) m->kB--;
+        m->nstepsB++;
+        m->hB = h*casadi_dopri_fac(err, casadi_int(reject));
+        reject = false;
+      } else {
+        m->netfailsB++;
+        m->hB = h*casadi_dopri_fac(err, casadi_int(1));
+        reject = true;
+      }
+
+      // Step size limits
+      if (max_step_size_>0) m->hB = std::min(m->hB, max_step_size_);
+      casadi_assert(m->hB>=min_step_size_
+                    && m->hB>16*numeric_limits<double>::epsilon()*std::fabs(m->tB),
+                    "Step size too small at t=" + str(m->tB));
+    }
+
+    // Return to user
+    casadi_copy(get_ptr(m->rx), nrx_, rx);
+    casadi_copy(get_ptr(m->rq), nrq_, rq);
+  }
+
+  void DormandPrince::print_stats(IntegratorMemory* mem) const {
+    auto m = static_cast<DormandPrinceMemory*>(mem);
+    print("FORWARD INTEGRATION:\n");
+    print("Number of steps taken: %lld\n", static_cast<long long>(m->nsteps));
+    print("Number of calls to the dynamics: %lld\n", static_cast<long long>(m->nfevals));
+    print("Number of error test failures: %lld\n", static_cast<long long>(m->netfails));
+    if (nrx_>0) {
+      print("BACKWARD INTEGRATION:\n");
+      print("Number of steps taken: %lld\n", static_cast<long long>(m->nstepsB));
+      print("Number of calls to the dynamics: %lld\n", static_cast<long long>(m->nfevalsB));
+      print("Number of error test failures: %lld\n", static_cast<long long>(m->netfailsB));
+    }
+  }
+
+  Dict DormandPrince::get_stats(void* mem) const {
+    Dict stats = Integrator::get_stats(mem);
+    auto m = static_cast<DormandPrinceMemory*>(mem);
+    stats["nsteps"] = m->nsteps;
+    stats["nfevals"] = m->nfevals;
+    stats["netfails"] = m->netfails;
+    stats["nstepsB"] = m->nstepsB;
+    stats["nfevalsB"] = m->nfevalsB;
+    stats["netfailsB"] = m->netfailsB;
+    return stats;
+  }
+
+  void DormandPrince::codegen_declarations(CodeGenerator& g) const {
+    g.add_dependency(get_function("dynF"));
+  }
+
+  void DormandPrince::codegen_body(CodeGenerator& g) const {
+    g.add_auxiliary(CodeGenerator::AUX_DOPRI);
+    const Function& f = get_function("dynF");
+
+    // Work vector offsets: state, quadratures, candidates, stages, continuous extension, time
+    casadi_int w_x = 0, w_q = w_x+nx_, w_x1 = w_q+nq_, w_q1 = w_x1+nx_;
+    casadi_int w_k = w_q1+nq_, w_kq = w_k+7*nx_, w_c = w_kq+7*nq_, w_cq = w_c+5*nx_;
+    casadi_int w_t = w_cq+5*nq_, w_f = w_t+1;
+    auto w = [](casadi_int offset) { return "w+" + str(offset);};
+
+    // Tolerances
+    string tol = g.constant(abstol_) + ", " + g.constant(reltol_);
+
+    // Evaluate the dynamics at stage s
+    auto eval_f = [&](const string& x, const string& t, casadi_int s) {
+      g << "w[" << w_t << "] = " << t << ";\n";
+      g << "arg[" << n_in_ << "] = " << x << ";\n";
+      g << "arg[" << n_in_+1 << "] = " << g.arg(INTEGRATOR_P) << ";\n";
+      g << "arg[" << n_in_+2 << "] = " << w(w_t) << ";\n";
+      g << "res[" << n_out_ << "] = " << w(w_k+s*nx_) << ";\n";
+      g << "res[" << n_out_+1 << "] = " << w(w_kq+s*nq_) << ";\n";
+      g << "if (" << g(f, "arg+" + str(n_in_), "res+" + str(n_out_), "iw", w(w_f))
+        << ") return 1;\n";
+    };
+
+    g.local("t", "casadi_real");
+    g.local("tf", "casadi_real");
+    g.local("h", "casadi_real");
+    g.local("t_prev", "casadi_real");
+    g.local("h_prev", "casadi_real");
+    g.local("err", "casadi_real");
+    g.local("theta", "casadi_real");
+    g.local("i", "casadi_int");
+    g.local("nsteps", "casadi_int");
+    g.local("last", "casadi_int");
+    g.local("reject", "casadi_int");
+    g.local("grid", "const casadi_real", "*");
+    g.local("xf", "casadi_real", "*");
+    g.local("qf", "casadi_real", "*");
+
+    g.comment("Initial state");
+    g << "grid = " << g.constant(grid_) << ";\n";
+    g << "t = t_prev = grid[0];\n";
+    g << "tf = grid[" << ngrid_-1 << "];\n";
+    g << "h_prev = 0;\n";
+    g << g.copy(g.arg(INTEGRATOR_X0), nx_, w(w_x)) << "\n";
+    if (nq_>0) g << g.clear(w(w_q), nq_) << "\n";
+    g << "xf = " << g.res(INTEGRATOR_XF) << ";\n";
+    g << "qf = " << g.res(INTEGRATOR_QF) << ";\n";
+
+    g.comment("Stage derivative at the initial time, reused at the end of every step");
+    eval_f(w(w_x), "t", 0);
+    if (step0_>0) {
+      g << "h = " << g.constant(step0_) << ";\n";
+    } else {
+      g << "h = casadi_dopri_h0(" << nx_ << ", " << w(w_x) << ", " << w(w_k) << ", "
+        << tol << ");\n";
+    }
+    if (max_step_size_>0) g << "if (h>" << g.constant(max_step_size_) << ") h = "
+                            << g.constant(max_step_size_) << ";\n";
+    g << "if (h>tf-t) h = tf-t;\n";
+
+    g.comment("Loop over output times");
+    g << "for (i=" << (output_t0_ ? 0 : 1) << "; i<" << ngrid_ << "; ++i) {\n";
+    g << "nsteps = 0;\n";
+    g << "reject = 0;\n";
+    g << "while (t<grid[i]) {\n";
+    g << "if (nsteps++>=" << max_num_steps_ << ") return 1;\n";
+    g << "last = h>=tf-t;\n";
+    g << "if (last) h = tf-t;\n";
+    for (casadi_int s=1; s<7; ++s) {
+      g << "casadi_dopri_stage(" << nx_ << ", " << s << ", h, " << w(w_x) << ", "
+        << w(w_k) << ", " << w(w_x1) << ");\n";
+      eval_f(w(w_x1), "t+" + g.constant(c_[s]) + "*h", s);
+    }
+    if (nq_>0) {
+      g << "casadi_dopri_stage(" << nq_ << ", 6, h, " << w(w_q) << ", " << w(w_kq) << ", "
+        << w(w_q1) << ");\n";
+    }
+    g << "err = casadi_dopri_err(" << nx_ << ", h, " << w(w_x) << ", " << w(w_x1) << ", "
+      << w(w_k) << ", " << tol << ");\n";
+    casadi_int n_err = nx_;
+    if (quad_err_con_ && nq_>0) {
+      g << "err += casadi_dopri_err(" << nq_ << ", h, " << w(w_q) << ", " << w(w_q1) << ", "
+        << w(w_kq) << ", " << tol << ");\n";
+      n_err += nq_;
+    }
+    g << "err = sqrt(err/" << n_err << ");\n";
+    g << "if (err<=1) {\n";
+    g << "casadi_dopri_cont(" << nx_ << ", h, " << w(w_x) << ", " << w(w_x1) << ", "
+      << w(w_k) << ", " << w(w_c) << ");\n";
+    g << g.copy(w(w_x1), nx_, w(w_x)) << "\n";
+    g << g.copy(w(w_k+6*nx_), nx_, w(w_k)) << "\n";
+    if (nq_>0) {
+      g << "casadi_dopri_cont(" << nq_ << ", h, " << w(w_q) << ", " << w(w_q1) << ", "
+        << w(w_kq) << ", " << w(w_cq) << ");\n";
+      g << g.copy(w(w_q1), nq_, w(w_q)) << "\n";
+      g << g.copy(w(w_kq+6*nq_), nq_, w(w_kq)) << "\n";
+    }
+    g << "t_prev = t;\n";
+    g << "h_prev = h;\n";
+    g << "t = last ? tf : t+h;\n";
+    g << "h *= casadi_dopri_fac(err, reject);\n";
+    g << "reject = 0;\n";
+    g << "} else {\n";
+    g << "h *= casadi_dopri_fac(err, 1);\n";
+    g << "reject = 1;\n";
+    g << "}\n";
+    if (max_step_size_>0) g << "if (h>" << g.constant(max_step_size_) << ") h = "
+                            << g.constant(max_step_size_) << ";\n";
+    g << "if (h<" << g.constant(min_step_size_) << " || h<=" << 16*numeric_limits<double>::epsilon()
+      << "*casadi_fabs(t)) return 1;\n";
+    g << "}\n";
+
+    g.comment("Dense output, unless at the end of the last step");
+    g << "if (h_prev>0 && grid[i]<t) {\n";
+    g << "theta = (grid[i]-t_prev)/h_prev;\n";
+    g << "if (xf) casadi_dopri_interp(" << nx_ << ", theta, " << w(w_c) << ", xf);\n";
+    if (nq_>0) {
+      g << "if (qf) casadi_dopri_interp(" << nq_ << ", theta, " << w(w_cq) << ", qf);\n";
+    }
+    g << "} else {\n";
+    g << g.copy(w(w_x), nx_, "xf") << "\n";
+    if (nq_>0) g << g.copy(w(w_q), nq_, "qf") << "\n";
+    g << "}\n";
+    g << "if (xf) xf += " << nx_ << ";\n";
+    if (nq_>0) g << "if (qf) qf += " << nq_ << ";\n";
+    g << "}\n";
+  }
+
+  DormandPrince::DormandPrince(DeserializingStream& s) : Integrator(s) {
+    s.version("DormandPrince", 1);
+    s.unpack("DormandPrince::abstol", abstol_);
+    s.unpack("DormandPrince::reltol", reltol_);
+    s.unpack("DormandPrince::quad_err_con", quad_err_con_);
+    s.unpack("DormandPrince::max_num_steps", max_num_steps_);
+    s.unpack("DormandPrince::step0", step0_);
+    s.unpack("DormandPrince::min_step_size", min_step_size_);
+    s.unpack("DormandPrince::max_step_size", max_step_size_);
+  }
+
+  void DormandPrince::serialize_body(SerializingStream &s) const {
+    Integrator::serialize_body(s);
+    s.version("DormandPrince", 1);
+    s.pack("DormandPrince::abstol", abstol_);
+    s.pack("DormandPrince::reltol", reltol_);
+    s.pack("DormandPrince::quad_err_con", quad_err_con_);
+    s.pack("DormandPrince::max_num_steps", max_num_steps_);
+    s.pack("DormandPrince::step0", step0_);
+    s.pack("DormandPrince::min_step_size", min_step_size_);
+    s.pack("DormandPrince::max_step_size", max_step_size_);
+  }
+
+} // namespace casadi
@@ -0,0 +1,199 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_DORMAND_PRINCE_HPP
+#define CASADI_DORMAND_PRINCE_HPP
+
+#include "casadi/core/integrator_impl.hpp"
+#include <casadi/solvers/casadi_integrator_dopri_export.h>
+
+/** \defgroup plugin_Integrator_dopri
+      Explicit Runge-Kutta integrator for ODEs with adaptive step size,
+      using the embedded Dormand-Prince 5(4) pair.
+
+      The local error of the fifth order solution is estimated with the
+      embedded fourth order solution and the step size is adapted to keep
+      it below abstol + reltol*|x|. Outputs on the time grid are evaluated
+      with the continuous extension of the step that contains the grid point,
+      so the grid does not restrict the step size. The backward problem is
+      integrated with the same method, interpolating the forward solution.
+*/
+/** \pluginsection{Integrator,dopri} */
+
+/// \cond INTERNAL
+namespace casadi {
+
+  /** \brief Integrator memory */
+  struct CASADI_INTEGRATOR_DOPRI_EXPORT DormandPrinceMemory : public IntegratorMemory {
+    // Current time and step size, forward and backward problem
+    double t, h, tB, hB;
+
+    // Time and size of the last accepted step
+    double t_prev, h_prev;
+
+    // Current state
+    std::vector<double> x, q, p, rx, rq, rp;
+
+    // Candidate state at the end of the step
+    std::vector<double> x1, q1, rx1, rq1;
+
+    // Stage derivatives
+    std::vector<double> k, kq, rk, rkq;
+
+    // Continuous extension of the last accepted step
+    std::vector<double> c, cq;
+
+    // Forward solution, for the backward problem
+    std::vector<double> tape_t, tape_h, tape_c;
+
+    // Interpolated forward state
+    std::vector<double> x_interp;
+
+    // Current step on the tape
+    casadi_int kB;
+
+    // Statistics
+    casadi_int nsteps, nfevals, netfails, nstepsB, nfevalsB, netfailsB;
+  };
+
+  /** \brief \pluginbrief{Integrator,dopri}
+
+      @copydoc DAE_doc
+      @copydoc plugin_Integrator_dopri
+
+      \author Joel Andersson
+      \date 2019
+  */
+  class CASADI_INTEGRATOR_DOPRI_EXPORT DormandPrince : public Integrator {
+  public:
+
+    /// Constructor
+    explicit DormandPrince(const std::string& name, const Function& dae);
+
+    /** \brief  Create a new integrator */
+    static Integrator* creator(const std::string& name, const Function& dae) {
+      return new DormandPrince(name, dae);
+    }
+
+    /// Destructor
+    ~DormandPrince() override;
+
+    // Get name of the plugin
+    const char* plugin_name() const override { return "dopri";}
+
+    // Get name of the class
+    std::string class_name() const override { return "DormandPrince";}
+
+    ///@{
+    /** \brief Options */
+    static const Options options_;
+    const Options& get_options() const override { return options_;}
+    ///@}
+
+    /// Initialize stage
+    void init(const Dict& opts) override;
+
+    /** \brief Create memory block */
+    void* alloc_mem() const override { return new DormandPrinceMemory();}
+
+    /** \brief Initalize memory block */
+    int init_mem(void* mem) const override;
+
+    /** \brief Free memory block */
+    void free_mem(void *mem) const override { delete static_cast<DormandPrinceMemory*>(mem);}
+
+    /** \brief Reset the forward problem */
+    void reset(IntegratorMemory* mem, double t,
+               const double* x, const double* z, const double* p) const override;
+
+    /** \brief  Advance solution in time */
+    void advance(IntegratorMemory* mem, double t,
+                 double* x, double* z, double* q) const override;
+
+    /** \brief Reset the backward problem */
+    void resetB(IntegratorMemory* mem, double t,
+                const double* rx, const double* rz, const double* rp) const override;
+
+    /** \brief  Retreat solution in time */
+    void retreat(IntegratorMemory* mem, double t,
+                 double* rx, double* rz, double* rq) const override;
+
+    /** \brief  Print solver statistics */
+    void print_stats(IntegratorMemory* mem) const override;
+
+    /// Get all statistics
+    Dict get_stats(void* mem) const override;
+
+    /** \brief Is codegen supported? */
+    bool has_codegen() const override { return nrx_==0;}
+
+    /** \brief Generate code for the declarations of the C function */
+    void codegen_declarations(CodeGenerator& g) const override;
+
+    /** \brief Generate code for the body of the C function */
+    void codegen_body(CodeGenerator& g) const override;
+
+    /// A documentation string
+    static const std::string meta_doc;
+
+    /// Error tolerances
+    double abstol_, reltol_;
+
+    /// Include the quadratures in the error control
+    bool quad_err_con_;
+
+    /// Maximum number of steps between two output times
+    casadi_int max_num_steps_;
+
+    /// Initial, minimum and maximum step size, zero if not set
+    double step0_, min_step_size_, max_step_size_;
+
+    /** \brief Serialize an object without type information */
+    void serialize_body(SerializingStream &s) const override;
+
+    /** \brief Deserialize into MX */
+    static ProtoFunction* deserialize(DeserializingStream& s) { return new DormandPrince(s); }
+
+  protected:
+    /** \brief Deserializing constructor */
+    explicit DormandPrince(DeserializingStream& s);
+
+    // Evaluate the forward dynamics at stage s
+    void eval_f(DormandPrinceMemory* m, double t, const double* x, casadi_int s) const;
+
+    // Evaluate the backward dynamics at stage s
+    void eval_g(DormandPrinceMemory* m, double t, const double* rx, casadi_int s) const;
+
+    // Initial step size
+    double step0(double t, double tf, casadi_int n, const double* x, const double* k) const;
+
+    // Stage times, as fractions of the step
+    static const double c_[7];
+  };
+
+} // namespace casadi
+
+/// \endcond
+#endif // CASADI_DORMAND_PRINCE_HPP
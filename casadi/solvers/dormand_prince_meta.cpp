@@ -0,0 +1,78 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+      #include "dormand_prince.hpp"
+      #include <string>
+
+      const std::string casadi::DormandPrince::meta_doc=
+      "\n"
+"Explicit Runge-Kutta integrator for ODEs with adaptive step size, using\n"
+"the embedded Dormand-Prince 5(4) pair.\n"
+"\n"
+"The local error of the fifth order solution is estimated with the\n"
+"embedded fourth order solution and the step size is adapted to keep it\n"
+"below abstol + reltol*|x|. Outputs on the time grid are evaluated with\n"
+"the continuous extension of the step that contains the grid point, so\n"
+"the grid does not restrict the step size. The backward problem is\n"
+"integrated with the same method, interpolating the forward solution.\n"
+"\n"
+"\n"
+">List of available options\n"
+"\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"|       Id        |      Type       |     Default     |   Description   |\n"
+"+=================+=================+=================+=================+\n"
+"| abstol          | OT_DOUBLE       | 1e-8            | Absolute        |\n"
+"|                 |                 |                 | tolerence for   |\n"
+"|                 |                 |                 | the IVP         |\n"
+"|                 |                 |                 | solution        |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| max_num_steps   | OT_INT          | 10000           | Maximum number  |\n"
+"|                 |                 |                 | of steps        |\n"
+"|                 |                 |                 | between two     |\n"
+"|                 |                 |                 | output times    |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| max_step_size   | OT_DOUBLE       | 0/inf           | Max step size   |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| min_step_size   | OT_DOUBLE       | 0/0.0           | Min step size   |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| quad_err_con    | OT_BOOL         | false           | Should the      |\n"
+"|                 |                 |                 | quadratures     |\n"
+"|                 |                 |                 | affect the step |\n"
+"|                 |                 |                 | size control    |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| reltol          | OT_DOUBLE       | 1e-6            | Relative        |\n"
+"|                 |                 |                 | tolerence for   |\n"
+"|                 |                 |                 | the IVP         |\n"
+"|                 |                 |                 | solution        |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| step0           | OT_DOUBLE       | 0/estimated     | Initial step    |\n"
+"|                 |                 |                 | size            |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"\n"
+"\n"
+"\n"
+"\n"
+;
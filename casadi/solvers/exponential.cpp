@@ -0,0 +1,214 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "exponential.hpp"
+#include "casadi/core/expm.hpp"
+
+using namespace std;
+namespace casadi {
+
+  extern "C"
+  int CASADI_INTEGRATOR_EXPONENTIAL_EXPORT
+      casadi_register_integrator_exponential(Integrator::Plugin* plugin) {
+    plugin->creator = Exponential::creator;
+    plugin->name = "exponential";
+    plugin->doc = Exponential::meta_doc.c_str();
+    plugin->version = CASADI_VERSION;
+    plugin->options = &Exponential::options_;
+    plugin->deserialize = &Exponential::deserialize;
+    return 0;
+  }
+
+  extern "C"
+  void CASADI_INTEGRATOR_EXPONENTIAL_EXPORT casadi_load_integrator_exponential() {
+    Integrator::registerPlugin(casadi_register_integrator_exponential);
+  }
+
+  Exponential::Exponential(const std::string& name, const Function& dae)
+    : FixedStepIntegrator(name, dae) {
+  }
+
+  Exponential::~Exponential() {
+  }
+
+  const Options Exponential::options_
+  = {{&FixedStepIntegrator::options_},
+     {{"expm",
+       {OT_STRING,
+        "Matrix exponential plugin. Default: slicot, which does not support "
+        "code generation, also not with 'simplify'"}},
+      {"expm_options",
+       {OT_DICT,
+        "Options to be passed to the matrix exponential"}}
+     }
+  };
+
+  void Exponential::init(const Dict& opts) {
+    // Default options
+    expm_ = "slicot";
+
+    // Read options
+    for (auto&& op : opts) {
+      if (op.first=="expm") {
+        expm_ = op.second.to_string();
+      } else if (op.first=="expm_options") {
+        expm_options_ = op.second;
+      }
+    }
+
+    // Call the base class init
+    FixedStepIntegrator::init(opts);
+
+    // Algebraic variables not supported
+    casadi_assert(nz_==0 && nrz_==0,
+                  "Exponential integrators do not support algebraic variables");
+  }
+
+  MX Exponential::phi_step(const MX& A, const MX& u, const MX& w) const {
+    casadi_int n = A.size1();
+    MX E = vertcat(horzcat(A, u, w),
+                   horzcat(MX(1, n+1), MX(1.)),
+                   MX(1, n+2));
+    Function expm = expmsol("expm", expm_, E.sparsity(), expm_options_);
+    MX eE = expm(vector<MX>{E, MX(1.)}).at(0);
+    return eE(Slice(0, n), n+1);
+  }
+
+  void Exponential::setupFG() {
+    f_ = create_function("f", {"x", "z", "p", "t"}, {"ode", "alg", "quad"});
+    g_ = create_function("g", {"rx", "rz", "rp", "x", "z", "p", "t"},
+                              {"rode", "ralg", "rquad"});
+
+    // Symbolic inputs
+    MX x0 = MX::sym("x0", this->x());
+    MX p = MX::sym("p", this->p());
+    MX t = MX::sym("t", this->t());
+
+    // State at the end of the step (does not enter in F_, only in G_)
+    MX v = MX::sym("v", nx_);
+
+    // Forward integration
+    {
+      // Right-hand sides of the state and the quadratures, vectorized
+      MX xs = MX::sym("x", nx_);
+      vector<MX> f_arg(DAE_NUM_IN);
+      f_arg[DAE_X] = reshape(xs, size_in(INTEGRATOR_X0));
+      f_arg[DAE_P] = p;
+      f_arg[DAE_T] = t;
+      vector<MX> f_res = f_(f_arg);
+      MX rhs = vertcat(vec(f_res[DAE_ODE]), vec(f_res[DAE_QUAD]));
+      MX rhs_t = t.is_empty() ? MX(rhs.size1(), 1) : MX::jacobian(rhs, t);
+
+      // Linearization at the start of the step
+      Function lin_f("lin_f", {xs, p, t}, {rhs, MX::jacobian(rhs, xs), rhs_t});
+      vector<MX> lin = lin_f(vector<MX>{vec(x0), p, t});
+
+      // Quadratures do not enter in the right-hand sides
+      MX A = horzcat(h_*lin[1], MX(nx_+nq_, nq_));
+      MX d = phi_step(A, h_*h_*lin[2], h_*lin[0]);
+
+      // Take step
+      MX xf = vec(x0) + d(Slice(0, nx_));
+      MX qf = d(Slice(nx_, nx_+nq_));
+
+      // Define discrete time dynamics
+      vector<MX> F_in(DAE_NUM_IN);
+      F_in[DAE_T] = t;
+      F_in[DAE_X] = x0;
+      F_in[DAE_P] = p;
+      F_in[DAE_Z] = v;
+      vector<MX> F_out(DAE_NUM_OUT);
+      F_out[DAE_ODE] = reshape(xf, size_in(INTEGRATOR_X0));
+      F_out[DAE_ALG] = xf;
+      F_out[DAE_QUAD] = reshape(qf, q().size());
+      F_ = Function("dae", F_in, F_out);
+      alloc(F_);
+    }
+
+    // Backward integration
+    if (!g_.is_null()) {
+      // Symbolic inputs
+      MX rx0 = MX::sym("rx0", this->rx());
+      MX rp = MX::sym("rp", this->rp());
+
+      // Right-hand sides of the backward state and quadratures, vectorized
+      MX rxs = MX::sym("rx", nrx_);
+      MX xs = MX::sym("x", nx_);
+      vector<MX> g_arg(RDAE_NUM_IN);
+      g_arg[RDAE_RX] = reshape(rxs, rx().size());
+      g_arg[RDAE_RP] = rp;
+      g_arg[RDAE_X] = reshape(xs, size_in(INTEGRATOR_X0));
+      g_arg[RDAE_P] = p;
+      g_arg[RDAE_T] = t;
+      vector<MX> g_res = g_(g_arg);
+      MX rhs = vertcat(vec(g_res[RDAE_ODE]), vec(g_res[RDAE_QUAD]));
+      MX rhs_t = t.is_empty() ? MX(rhs.size1(), 1) : MX::jacobian(rhs, t);
+
+      // Linearization at the end of the forward step
+      Function lin_g("lin_g", {rxs, xs, p, rp, t},
+                     {rhs, MX::jacobian(rhs, rxs), MX::jacobian(rhs, xs), rhs_t});
+      vector<MX> lin = lin_g(vector<MX>{vec(rx0), v, p, rp, t + h_});
+
+      // Time derivative along the backward step, with the forward state interpolated linearly
+      MX u = h_*(mtimes(lin[2], vec(x0) - v) - h_*lin[3]);
+      MX A = horzcat(h_*lin[1], MX(nrx_+nrq_, nrq_));
+      MX d = phi_step(A, u, h_*lin[0]);
+
+      // Take step
+      MX rxf = vec(rx0) + d(Slice(0, nrx_));
+      MX rqf = d(Slice(nrx_, nrx_+nrq_));
+
+      // Define discrete time dynamics
+      vector<MX> G_in(RDAE_NUM_IN);
+      G_in[RDAE_T] = t;
+      G_in[RDAE_X] = x0;
+      G_in[RDAE_P] = p;
+      G_in[RDAE_Z] = v;
+      G_in[RDAE_RX] = rx0;
+      G_in[RDAE_RP] = rp;
+      G_in[RDAE_RZ] = MX::sym("rv", 0, 1);
+      vector<MX> G_out(RDAE_NUM_OUT);
+      G_out[RDAE_ODE] = reshape(rxf, rx().size());
+      G_out[RDAE_ALG] = MX(0, 1);
+      G_out[RDAE_QUAD] = reshape(rqf, rq().size());
+      G_ = Function("rdae", G_in, G_out);
+      alloc(G_);
+    }
+  }
+
+  Exponential::Exponential(DeserializingStream& s) : FixedStepIntegrator(s) {
+    s.version("Exponential", 1);
+    s.unpack("Exponential::f", f_);
+    s.unpack("Exponential::g", g_);
+  }
+
+  void Exponential::serialize_body(SerializingStream &s) const {
+    FixedStepIntegrator::serialize_body(s);
+    s.version("Exponential", 1);
+    s.pack("Exponential::f", f_);
+    s.pack("Exponential::g", g_);
+  }
+
+} // namespace casadi
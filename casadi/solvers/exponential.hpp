@@ -0,0 +1,120 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_EXPONENTIAL_HPP
+#define CASADI_EXPONENTIAL_HPP
+
+#include "casadi/core/integrator_impl.hpp"
+#include <casadi/solvers/casadi_integrator_exponential_export.h>
+
+/** \defgroup plugin_Integrator_exponential
+      Fixed-step exponential Rosenbrock-Euler integrator for stiff ODEs
+
+      The ODE is linearized at the start of each step, x' = f0 + J*(x-x0)
+      + ft*(t-t0), and the linearization is integrated exactly with a
+      single matrix exponential of an augmented matrix, evaluated with an
+      Expm plugin. The method is second order and exact for linear ODEs
+      with affine time dependence. Quadratures are integrated together
+      with the state.
+
+      With "simplify", the integrator is an MX Function with one Expm call
+      per step. It can only be code generated if the Expm plugin supports
+      code generation, which the default slicot plugin does not.
+*/
+/** \pluginsection{Integrator,exponential} */
+
+/// \cond INTERNAL
+namespace casadi {
+
+  /** \brief \pluginbrief{Integrator,exponential}
+
+      @copydoc DAE_doc
+      @copydoc plugin_Integrator_exponential
+
+      \author Joel Andersson
+      \date 2019
+  */
+  class CASADI_INTEGRATOR_EXPONENTIAL_EXPORT Exponential : public FixedStepIntegrator {
+  public:
+
+    /// Constructor
+    explicit Exponential(const std::string& name, const Function& dae);
+
+    /** \brief  Create a new integrator */
+    static Integrator* creator(const std::string& name, const Function& dae) {
+      return new Exponential(name, dae);
+    }
+
+    /// Destructor
+    ~Exponential() override;
+
+    // Get name of the plugin
+    const char* plugin_name() const override { return "exponential";}
+
+    // Get name of the class
+    std::string class_name() const override { return "Exponential";}
+
+    ///@{
+    /** \brief Options */
+    static const Options options_;
+    const Options& get_options() const override { return options_;}
+    ///@}
+
+    /// Initialize stage
+    void init(const Dict& opts) override;
+
+    /// Setup F and G
+    void setupFG() override;
+
+    /// A documentation string
+    static const std::string meta_doc;
+
+    /// Continuous time dynamics
+    Function f_, g_;
+
+    /// Matrix exponential
+    std::string expm_;
+    Dict expm_options_;
+
+    /** \brief Serialize an object without type information */
+    void serialize_body(SerializingStream &s) const override;
+
+    /** \brief Deserialize into MX */
+    static ProtoFunction* deserialize(DeserializingStream& s) { return new Exponential(s); }
+  protected:
+    /** \brief Deserializing constructor */
+    explicit Exponential(DeserializingStream& s);
+
+    /** \brief Exact solution of y' = A*y + u*s + w over s in [0, 1], from y = 0
+
+        Evaluated as the last column of the exponential of [A u w; 0 0 1; 0 0 0]
+    */
+    MX phi_step(const MX& A, const MX& u, const MX& w) const;
+  };
+
+} // namespace casadi
+
+/// \endcond
+#endif // CASADI_EXPONENTIAL_HPP
@@ -0,0 +1,63 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+      #include "exponential.hpp"
+      #include <string>
+
+      const std::string casadi::Exponential::meta_doc=
+      "\n"
+"Fixed-step exponential Rosenbrock-Euler integrator for stiff ODEs\n"
+"\n"
+"The ODE is linearized at the start of each step, x' = f0 + J*(x-x0) +\n"
+"ft*(t-t0), and the linearization is integrated exactly with a single\n"
+"matrix exponential of an augmented matrix, evaluated with an Expm\n"
+"plugin. The method is second order and exact for linear ODEs with\n"
+"affine time dependence. Quadratures are integrated together with the\n"
+"state.\n"
+"\n"
+"\n"
+">List of available options\n"
+"\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"|       Id        |      Type       |     Default     |   Description   |\n"
+"+=================+=================+=================+=================+\n"
+"| expm            | OT_STRING       | \"slicot\"        | Matrix          |\n"
+"|                 |                 |                 | exponential     |\n"
+"|                 |                 |                 | plugin          |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| expm_options    | OT_DICT         | GenericType()   | Options to be   |\n"
+"|                 |                 |                 | passed to the   |\n"
+"|                 |                 |                 | matrix          |\n"
+"|                 |                 |                 | exponential     |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| number_of_finit | OT_INT          | 20              | Number of       |\n"
+"| e_elements      |                 |                 | finite elements |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"\n"
+"\n"
+"\n"
+"\n"
+;
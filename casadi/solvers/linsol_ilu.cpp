@@ -0,0 +1,196 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "linsol_ilu.hpp"
+#include "casadi/core/global_options.hpp"
+
+#include <map>
+
+using namespace std;
+namespace casadi {
+
+  extern "C"
+  int CASADI_LINSOL_ILU_EXPORT
+  casadi_register_linsol_ilu(LinsolInternal::Plugin* plugin) {
+    plugin->creator = LinsolIlu::creator;
+    plugin->name = "ilu";
+    plugin->doc = LinsolIlu::meta_doc.c_str();
+    plugin->version = CASADI_VERSION;
+    plugin->options = &LinsolIlu::options_;
+    plugin->deserialize = &LinsolIlu::deserialize;
+    return 0;
+  }
+
+  extern "C"
+  void CASADI_LINSOL_ILU_EXPORT casadi_load_linsol_ilu() {
+    LinsolInternal::registerPlugin(casadi_register_linsol_ilu);
+  }
+
+  LinsolIlu::LinsolIlu(const std::string& name, const Sparsity& sp)
+    : LinsolInternal(name, sp) {
+  }
+
+  LinsolIlu::~LinsolIlu() {
+    clear_mem();
+  }
+
+  const Options LinsolIlu::options_
+  = {{&ProtoFunction::options_},
+     {{"fill_level",
+      {OT_INT,
+       "Level of fill allowed in the factors, ILU(k) [default 0, no fill-in]"}}
+     }
+  };
+
+  void LinsolIlu::init(const Dict& opts) {
+    // Call the init method of the base class
+    LinsolInternal::init(opts);
+
+    // Default options
+    fill_level_ = 0;
+
+    // Read user options
+    for (auto&& op : opts) {
+      if (op.first=="fill_level") {
+        fill_level_ = op.second;
+      }
+    }
+    casadi_assert(fill_level_>=0, "Option 'fill_level' must be nonnegative");
+    casadi_assert(sp_.is_square(), "ILU requires a square matrix");
+
+    // Symbolic factorization: level of fill of each entry, column by column
+    casadi_int n = sp_.size2();
+    const casadi_int *colind = sp_.colind(), *row = sp_.row();
+    vector<casadi_int> l_colind(1, 0), l_row, l_lev, u_colind(1, 0), u_row;
+    for (casadi_int c=0; c<n; ++c) {
+      // Entries of A and the diagonal have level zero
+      map<casadi_int, casadi_int> lev;
+      for (casadi_int k=colind[c]; k<colind[c+1]; ++k) lev[row[k]] = 0;
+      lev[c] = 0;
+      // Fill-in from the elimination, rows added during the loop are visited in turn
+      for (auto it=lev.begin(); it!=lev.end() && it->first<c; ++it) {
+        casadi_int r = it->first;
+        for (casadi_int k=l_colind[r]; k<l_colind[r+1]; ++k) {
+          casadi_int newlev = it->second + l_lev[k] + 1;
+          if (newlev>fill_level_) continue;
+          auto it2 = lev.find(l_row[k]);
+          if (it2==lev.end()) {
+            lev[l_row[k]] = newlev;
+          } else if (newlev<it2->second) {
+            it2->second = newlev;
+          }
+        }
+      }
+      // Split into the upper and the strictly lower part
+      for (auto&& e : lev) {
+        if (e.first<=c) {
+          u_row.push_back(e.first);
+        } else {
+          l_row.push_back(e.first);
+          l_lev.push_back(e.second);
+        }
+      }
+      u_colind.push_back(u_row.size());
+      l_colind.push_back(l_row.size());
+    }
+    sp_l_ = Sparsity(n, n, l_colind, l_row);
+    sp_u_ = Sparsity(n, n, u_colind, u_row);
+  }
+
+  int LinsolIlu::init_mem(void* mem) const {
+    if (LinsolInternal::init_mem(mem)) return 1;
+    auto m = static_cast<LinsolIluMemory*>(mem);
+
+    // Work vectors
+    m->l.resize(sp_l_.nnz());
+    m->u.resize(sp_u_.nnz());
+    m->w.resize(nrow());
+
+    return 0;
+  }
+
+  int LinsolIlu::sfact(void* mem, const double* A) const {
+    return 0;
+  }
+
+  int LinsolIlu::nfact(void* mem, const double* A) const {
+    auto m = static_cast<LinsolIluMemory*>(mem);
+    casadi_ilu(sp_, A, sp_l_, get_ptr(m->l), sp_u_, get_ptr(m->u), get_ptr(m->w));
+    const casadi_int* u_colind = sp_u_.colind();
+    for (casadi_int c=0; c<ncol(); ++c) {
+      if (m->u[u_colind[c+1]-1]==0) {
+        casadi_warning("ILU factorization has a zero pivot");
+        return 1;
+      }
+    }
+    return 0;
+  }
+
+  int LinsolIlu::solve(void* mem, const double* A, double* x, casadi_int nrhs, bool tr) const {
+    auto m = static_cast<LinsolIluMemory*>(mem);
+    casadi_ilu_solve(x, nrhs, tr, sp_l_, get_ptr(m->l), sp_u_, get_ptr(m->u));
+    return 0;
+  }
+
+  void LinsolIlu::generate(CodeGenerator& g, const std::string& A, const std::string& x,
+                          casadi_int nrhs, bool tr) const {
+    // Codegen the integer vectors
+    string sp = g.sparsity(sp_);
+    string sp_l = g.sparsity(sp_l_);
+    string sp_u = g.sparsity(sp_u_);
+
+    // Place in block to avoid conflicts caused by local variables
+    g << "{\n";
+    g.comment("FIXME(@jaeandersson): Memory allocation can be avoided");
+    g << "casadi_real l[" << sp_l_.nnz() << "], "
+         "u[" << sp_u_.nnz() << "], "
+         "w[" << nrow() << "];\n";
+
+    // Factorize
+    g << g.ilu(sp, A, sp_l, "l", sp_u, "u", "w") << "\n";
+
+    // Solve
+    g << g.ilu_solve(x, nrhs, tr, sp_l, "l", sp_u, "u") << "\n";
+
+    // End of block
+    g << "}\n";
+  }
+
+  LinsolIlu::LinsolIlu(DeserializingStream& s) : LinsolInternal(s) {
+    s.version("LinsolIlu", 1);
+    s.unpack("LinsolIlu::fill_level", fill_level_);
+    s.unpack("LinsolIlu::sp_l", sp_l_);
+    s.unpack("LinsolIlu::sp_u", sp_u_);
+  }
+
+  void LinsolIlu::serialize_body(SerializingStream &s) const {
+    LinsolInternal::serialize_body(s);
+    s.version("LinsolIlu", 1);
+    s.pack("LinsolIlu::fill_level", fill_level_);
+    s.pack("LinsolIlu::sp_l", sp_l_);
+    s.pack("LinsolIlu::sp_u", sp_u_);
+  }
+
+} // namespace casadi
@@ -0,0 +1,126 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#ifndef CASADI_LINSOL_ILU_HPP
+#define CASADI_LINSOL_ILU_HPP
+
+/** \defgroup plugin_Linsol_ilu
+  * Linear solver using an incomplete LU factorization with level-of-fill control.
+  * Intended as a preconditioner for iterative methods; with enough fill levels,
+  * the factorization becomes exact.
+*/
+
+/** \pluginsection{Linsol,ilu} */
+
+/// \cond INTERNAL
+#include "casadi/core/linsol_internal.hpp"
+#include <casadi/solvers/casadi_linsol_ilu_export.h>
+
+namespace casadi {
+  struct CASADI_LINSOL_ILU_EXPORT LinsolIluMemory : public LinsolMemory {
+    std::vector<double> l, u, w;
+  };
+
+  /** \brief \pluginbrief{LinsolInternal,ilu}
+   * @copydoc LinsolInternal_doc
+   * @copydoc plugin_LinsolInternal_ilu
+   */
+  class CASADI_LINSOL_ILU_EXPORT LinsolIlu : public LinsolInternal {
+  public:
+
+    // Create a linear solver given a sparsity pattern and a number of right hand sides
+    LinsolIlu(const std::string& name, const Sparsity& sp);
+
+    /** \brief  Create a new LinsolInternal */
+    static LinsolInternal* creator(const std::string& name, const Sparsity& sp) {
+      return new LinsolIlu(name, sp);
+    }
+
+    // Destructor
+    ~LinsolIlu() override;
+
+    ///@{
+    /** \brief Options */
+    static const Options options_;
+    const Options& get_options() const override { return options_;}
+    ///@}
+
+    // Initialize the solver
+    void init(const Dict& opts) override;
+
+    /** \brief Create memory block */
+    void* alloc_mem() const override { return new LinsolIluMemory();}
+
+    /** \brief Initalize memory block */
+    int init_mem(void* mem) const override;
+
+    /** \brief Free memory block */
+    void free_mem(void *mem) const override { delete static_cast<LinsolIluMemory*>(mem);}
+
+    // Symbolic factorization
+    int sfact(void* mem, const double* A) const override;
+
+    // Factorize the linear system
+    int nfact(void* mem, const double* A) const override;
+
+    // Solve the linear system
+    int solve(void* mem, const double* A, double* x, casadi_int nrhs, bool tr) const override;
+
+    /// Generate C code
+    void generate(CodeGenerator& g, const std::string& A, const std::string& x,
+                  casadi_int nrhs, bool tr) const override;
+
+    /// A documentation string
+    static const std::string meta_doc;
+
+    // Get name of the plugin
+    const char* plugin_name() const override { return "ilu";}
+
+    // Get name of the class
+    std::string class_name() const override { return "LinsolIlu";}
+
+    // Sparsity of the factors: strictly lower part of L, upper part of U (diagonal last)
+    Sparsity sp_l_, sp_u_;
+
+    ///@{
+    // Options
+    casadi_int fill_level_;
+    ///@}
+
+    /** \brief Serialize an object without type information */
+    void serialize_body(SerializingStream &s) const override;
+
+    /** \brief Deserialize with type disambiguation */
+    static ProtoFunction* deserialize(DeserializingStream& s) { return new LinsolIlu(s); }
+
+  protected:
+    /** \brief Deserializing constructor */
+    explicit LinsolIlu(DeserializingStream& s);
+  };
+
+} // namespace casadi
+
+/// \endcond
+
+#endif // CASADI_LINSOL_ILU_HPP
@@ -70,7 +70,15 @@ namespace casadi {
         "Print information about each iteration"}},
       {"line_search",
        {OT_BOOL,
-        "Enable line-search (default: true)"}}
+        "Enable line-search (default: true), not used with simplified Newton"}},
+      {"simplified_newton",
+       {OT_BOOL,
+        "Keep the factorized Jacobian across iterations and calls. It is refreshed "
+        "when the residual does not decrease (default: false)"}},
+      {"max_jacobian_age",
+       {OT_INT,
+        "Simplified Newton: refresh the Jacobian after this many calls "
+        "(default: 0, only on convergence failure)"}}
      }
   };
 
@@ -85,6 +93,8 @@ namespace casadi {
     abstolStep_ = 1e-12;
     print_iteration_ = false;
     line_search_ = true;
+    simplified_newton_ = false;
+    max_jacobian_age_ = 0;
 
     // Read options
     for (auto&& op : opts) {
@@ -98,6 +108,10 @@ namespace casadi {
         print_iteration_ = op.second;
       } else if (op.first=="line_search") {
         line_search_ = op.second;
+      } else if (op.first=="simplified_newton") {
+        simplified_newton_ = op.second;
+      } else if (op.first=="max_jacobian_age") {
+        max_jacobian_age_ = op.second;
       }
     }
 
@@ -114,7 +128,6 @@ namespace casadi {
     alloc_w(n_, true); // F
     alloc_w(n_, true); // dx trial
     alloc_w(n_, true); // F trial
-    alloc_w(sp_jac_.nnz(), true); // J
   }
 
  void Newton::set_work(void* mem, const double**& arg, double**& res,
@@ -125,23 +138,39 @@ namespace casadi {
      m->f = w; w += n_;
      m->x_trial = w; w += n_;
      m->f_trial = w; w += n_;
-     m->jac = w; w += sp_jac_.nnz();
   }
 
   int Newton::solve(void* mem) const {
     auto m = static_cast<NewtonMemory*>(mem);
 
-    scoped_checkout<Linsol> mem_linsol(linsol_);
-
     // Get the initial guess
     casadi_copy(m->iarg[iin_], n_, m->x);
 
+    // Refresh the factorization of a previous call if it is too old
+    if (m->is_fact && max_jacobian_age_>0 && ++m->jac_age>=max_jacobian_age_) {
+      m->is_fact = false;
+    }
+
+    // Has the Jacobian been factorized during this call?
+    bool fresh = false;
+    double abstol_prev = numeric_limits<double>::infinity();
+
     // Perform the Newton iterations
     m->iter=0;
     bool success = true;
     while (true) {
       // Break if maximum number of iterations already reached
       if (m->iter >= max_iter_) {
+        if (simplified_newton_ && !fresh) {
+          // Outdated Jacobian, start over
+          if (verbose_) casadi_message("Rejecting the Jacobian of a previous call");
+          m->nreject++;
+          m->is_fact = false;
+          m->iter = 0;
+          casadi_copy(m->iarg[iin_], n_, m->x);
+          abstol_prev = numeric_limits<double>::infinity();
+          continue;
+        }
         if (verbose_) casadi_message("Max iterations reached.");
         m->return_status = "max_iteration_reached";
         m->unified_return_status = SOLVER_RET_LIMITED;
@@ -152,13 +181,21 @@ namespace casadi {
       // Start a new iteration
       m->iter++;
 
-      // Use x to evaluate g and J
+      // Use x to evaluate g and J, with simplified Newton only g
+      bool new_jac = !simplified_newton_ || !m->is_fact;
       copy_n(m->iarg, n_in_, m->arg);
       m->arg[iin_] = m->x;
-      m->res[0] = m->jac;
-      copy_n(m->ires, n_out_, m->res+1);
-      m->res[1+iout_] = m->f;
-      calc_function(m, "jac_f_z");
+      if (!simplified_newton_) {
+        m->res[0] = get_ptr(m->jac);
+        copy_n(m->ires, n_out_, m->res+1);
+        m->res[1+iout_] = m->f;
+        calc_function(m, "jac_f_z");
+        m->njevals++;
+      } else {
+        copy_n(m->ires, n_out_, m->res);
+        m->res[iout_] = m->f;
+        calc_function(m, "g");
+      }
 
       // Check convergence
       double abstol = 0;
@@ -172,9 +209,40 @@ namespace casadi {
         }
       }
 
+      // Simplified Newton: refresh the Jacobian if the residual does not decrease
+      if (!new_jac && abstol_ != numeric_limits<double>::infinity()
+          && !(abstol < abstol_prev)) {
+        m->is_fact = false;
+        if (!fresh) {
+          // Outdated Jacobian, start over
+          if (verbose_) casadi_message("Rejecting the Jacobian of a previous call");
+          m->nreject++;
+          m->iter = 0;
+          casadi_copy(m->iarg[iin_], n_, m->x);
+          abstol_prev = numeric_limits<double>::infinity();
+        }
+        continue;
+      }
+      abstol_prev = abstol;
+
       // Factorize the linear solver with J
-      linsol_.nfact(m->jac, mem_linsol);
-      linsol_.solve(m->jac, m->f, 1, false, mem_linsol);
+      if (new_jac) {
+        if (simplified_newton_) {
+          // Jacobian only needed if not converged
+          copy_n(m->iarg, n_in_, m->arg);
+          m->arg[iin_] = m->x;
+          m->res[0] = get_ptr(m->jac);
+          copy_n(m->ires, n_out_, m->res+1);
+          m->res[1+iout_] = m->f;
+          calc_function(m, "jac_f_z");
+          m->njevals++;
+        }
+        linsol_.nfact(get_ptr(m->jac), m->linsol_mem);
+        m->nfact++;
+        m->is_fact = fresh = true;
+        m->jac_age = 0;
+      }
+      linsol_.solve(get_ptr(m->jac), m->f, 1, false, m->linsol_mem);
 
       // Check convergence again
       double abstolStep=0;
@@ -189,7 +257,7 @@ namespace casadi {
       }
 
       double alpha = 1;
-      if (line_search_) {
+      if (line_search_ && !simplified_newton_) {
         copy_n(m->iarg, n_in_, m->arg);
         m->arg[iin_] = m->x_trial;
         copy_n(m->ires, n_out_, m->res);
@@ -271,9 +339,19 @@ namespace casadi {
     auto m = static_cast<NewtonMemory*>(mem);
     m->return_status = "";
     m->iter = 0;
+    m->jac.resize(sp_jac_.nnz());
+    m->linsol_mem = linsol_.checkout();
+    m->is_fact = false;
+    m->jac_age = 0;
     return 0;
   }
 
+  void Newton::free_mem(void *mem) const {
+    auto m = static_cast<NewtonMemory*>(mem);
+    linsol_.release(m->linsol_mem);
+    delete m;
+  }
+
   Dict Newton::get_stats(void* mem) const {
     Dict stats = Rootfinder::get_stats(mem);
     auto m = static_cast<NewtonMemory*>(mem);
@@ -284,22 +362,31 @@ namespace casadi {
 
 
   Newton::Newton(DeserializingStream& s) : Rootfinder(s) {
-    s.version("Newton", 1);
+    int version = s.version("Newton", 1, 2);
     s.unpack("Newton::max_iter", max_iter_);
     s.unpack("Newton::abstol", abstol_);
     s.unpack("Newton::abstolStep", abstolStep_);
     s.unpack("Newton::print_iteration", print_iteration_);
     s.unpack("Newton::line_search", line_search_);
+    if (version>=2) {
+      s.unpack("Newton::simplified_newton", simplified_newton_);
+      s.unpack("Newton::max_jacobian_age", max_jacobian_age_);
+    } else {
+      simplified_newton_ = false;
+      max_jacobian_age_ = 0;
+    }
   }
 
   void Newton::serialize_body(SerializingStream &s) const {
     Rootfinder::serialize_body(s);
-    s.version("Newton", 1);
+    s.version("Newton", 2);
     s.pack("Newton::max_iter", max_iter_);
     s.pack("Newton::abstol", abstol_);
     s.pack("Newton::abstolStep", abstolStep_);
     s.pack("Newton::print_iteration", print_iteration_);
     s.pack("Newton::line_search", line_search_);
+    s.pack("Newton::simplified_newton", simplified_newton_);
+    s.pack("Newton::max_jacobian_age", max_jacobian_age_);
   }
 
 } // namespace casadi
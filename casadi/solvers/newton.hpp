@@ -49,8 +49,14 @@ namespace casadi {
     double* x_trial;
     // Current residual
     double* f_trial;
-    // Current Jacobian
-    double* jac;
+    // Current Jacobian, kept between calls with simplified Newton
+    std::vector<double> jac;
+    // Linear solver memory
+    casadi_int linsol_mem;
+    // Is the Jacobian factorized?
+    bool is_fact;
+    // Number of calls since the Jacobian was factorized
+    casadi_int jac_age;
     // Return status
     const char* return_status;
     // Number of iterations
@@ -100,7 +106,7 @@ namespace casadi {
     int init_mem(void* mem) const override;
 
     /** \brief Free memory block */
-    void free_mem(void *mem) const override { delete static_cast<NewtonMemory*>(mem);}
+    void free_mem(void *mem) const override;
 
     /** \brief Set the (persistent) work vectors */
     void set_work(void* mem, const double**& arg, double**& res,
@@ -142,6 +148,12 @@ namespace casadi {
 
     bool line_search_;
 
+    /// Keep the factorized Jacobian across iterations and calls
+    bool simplified_newton_;
+
+    /// Number of calls after which the Jacobian is refreshed, 0 if unlimited
+    casadi_int max_jacobian_age_;
+
     /// Print iteration header
     void printIteration(std::ostream &stream) const;
 
@@ -52,11 +52,23 @@
 "|                 |                 |                 | perform before  |\n"
 "|                 |                 |                 | returning.      |\n"
 "+-----------------+-----------------+-----------------+-----------------+\n"
+"| max_jacobian_ag | OT_INT          | 0               | Simplified      |\n"
+"| e               |                 |                 | Newton: refresh |\n"
+"|                 |                 |                 | the Jacobian    |\n"
+"|                 |                 |                 | after this many |\n"
+"|                 |                 |                 | calls           |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
 "| print_iteration | OT_BOOL      | false           | Print           |\n"
 "|                 |                 |                 | information     |\n"
 "|                 |                 |                 | about each      |\n"
 "|                 |                 |                 | iteration       |\n"
 "+-----------------+-----------------+-----------------+-----------------+\n"
+"| simplified_newt | OT_BOOL         | false           | Keep the        |\n"
+"| on              |                 |                 | factorized      |\n"
+"|                 |                 |                 | Jacobian across |\n"
+"|                 |                 |                 | iterations and  |\n"
+"|                 |                 |                 | calls           |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
 "\n"
 "\n"
 ">List of available monitors\n"
@@ -83,6 +95,12 @@
 "+===============+\n"
 "| iter          |\n"
 "+---------------+\n"
+"| nfact         |\n"
+"+---------------+\n"
+"| njevals       |\n"
+"+---------------+\n"
+"| nreject       |\n"
+"+---------------+\n"
 "| return_status |\n"
 "+---------------+\n"
 "\n"
@@ -26,6 +26,8 @@
 #include "qrqp.hpp"
 #include "casadi/core/nlpsol.hpp"
 
+#include <algorithm>
+
 using namespace std;
 namespace casadi {
 
@@ -80,7 +82,16 @@ namespace casadi {
         "Printed numbers are 0-based indices into the vector of [simple bounds;linear bounds]"}},
       {"min_lam",
        {OT_DOUBLE,
-        "Smallest multiplier treated as inactive for the initial active set [0]."}}
+        "Smallest multiplier treated as inactive for the initial active set [0]."}},
+      {"max_update",
+       {OT_INT,
+        "Maximum number of active-set changes handled by a low-rank update of the "
+        "KKT factorization before refactorizing [0]. 0 refactorizes in every iteration."}},
+      {"warm_start",
+       {OT_BOOL,
+        "Keep the working set of the last solution in the memory object and use it when "
+        "no multiplier guess is given [false]. If H and A are unchanged and max_update>0, "
+        "the KKT factorization is also reused and updated. Not available in generated code."}}
      }
   };
 
@@ -105,6 +116,7 @@ namespace casadi {
     print_header_ = true;
     print_info_ = true;
     print_lincomb_ = false;
+    warm_start_ = false;
 
     // Read user options
     for (auto&& op : opts) {
@@ -116,6 +128,8 @@ namespace casadi {
         p_.dual_inf_tol = op.second;
       } else if (op.first=="min_lam") {
         p_.min_lam = op.second;
+      } else if (op.first=="max_update") {
+        p_.max_update = op.second;
       } else if (op.first=="print_iter") {
         print_iter_ = op.second;
       } else if (op.first=="print_header") {
@@ -124,9 +138,13 @@ namespace casadi {
         print_info_ = op.second;
       } else if (op.first=="print_lincomb") {
         print_lincomb_ = op.second;
+      } else if (op.first=="warm_start") {
+        warm_start_ = op.second;
       }
     }
 
+    casadi_assert(p_.max_update>=0, "'max_update' must be nonnegative");
+
     // Allocate memory
     casadi_int sz_w, sz_iw;
     casadi_qp_work(&p_, &sz_iw, &sz_w);
@@ -163,6 +181,11 @@ namespace casadi {
     if (Conic::init_mem(mem)) return 1;
     auto m = static_cast<QrqpMemory*>(mem);
     m->return_status = "";
+    m->iter_count = -1;
+    m->n_fact = m->n_update = 0;
+    m->has_lam = m->has_fact = false;
+    m->n_warm_active = 0;
+    m->fact_reused = false;
     return 0;
   }
 
@@ -188,8 +211,22 @@ namespace casadi {
     casadi_fill(d.z+nx_, na_, nan);
     casadi_copy(arg[CONIC_LAM_X0], nx_, d.lam);
     casadi_copy(arg[CONIC_LAM_A0], na_, d.lam+nx_);
+    // Without a multiplier guess, start from the working set of the last call
+    bool warm = warm_start_ && m->has_lam
+      && std::all_of(d.lam, d.lam+nx_+na_, [](double v) { return v==0.;});
+    if (warm) casadi_copy(get_ptr(m->lam), nx_+na_, d.lam);
     // Reset solver
     if (casadi_qp_reset(&d)) return 1;
+    // Reuse the factorization of the last call if the KKT matrix is unchanged
+    m->fact_reused = warm && m->has_fact
+      && std::equal(m->nz_h.begin(), m->nz_h.end(), d.nz_h)
+      && std::equal(m->nz_a.begin(), m->nz_a.end(), d.nz_a);
+    if (m->fact_reused) {
+      casadi_copy(get_ptr(m->nz_vr), m->nz_vr.size(), d.nz_v);
+      casadi_copy(get_ptr(m->beta), nx_+na_, d.beta);
+      std::copy(m->act_base.begin(), m->act_base.end(), d.act_base);
+      d.n_upd = 0;
+    }
     while (true) {
       // Prepare QP
       int flag = casadi_qp_prepare(&d);
@@ -235,6 +272,30 @@ namespace casadi {
         m->return_status = "Printing error";
         break;
     }
+    m->iter_count = d.iter;
+    m->n_fact = d.n_fact;
+    m->n_update = d.n_update;
+    // Warm-started inequalities that are still active at the solution
+    m->n_warm_active = 0;
+    if (warm) {
+      for (casadi_int i=0; i<nx_+na_; ++i) {
+        if (d.neverzero[i] || m->lam[i]==0 || d.lam[i]==0) continue;
+        if ((m->lam[i]>0)==(d.lam[i]>0)) m->n_warm_active++;
+      }
+    }
+    // Save the working set and factorization for the next call
+    if (warm_start_) {
+      m->has_lam = d.status == QP_SUCCESS;
+      m->has_fact = m->has_lam && d.n_upd >= 0;
+      if (m->has_lam) m->lam.assign(d.lam, d.lam+nx_+na_);
+      if (m->has_fact) {
+        m->nz_vr.assign(d.nz_v, d.nz_v+sp_v_.nnz()+sp_r_.nnz());
+        m->beta.assign(d.beta, d.beta+nx_+na_);
+        m->act_base.assign(d.act_base, d.act_base+nx_+na_);
+        m->nz_h.assign(d.nz_h, d.nz_h+H_.nnz());
+        m->nz_a.assign(d.nz_a, d.nz_a+A_.nnz());
+      }
+    }
     // Get solution
     casadi_copy(&d.f, 1, res[CONIC_COST]);
     casadi_copy(d.z, nx_, res[CONIC_X]);
@@ -269,6 +330,7 @@ namespace casadi {
     // Copy options
     g << "p.max_iter = " << p_.max_iter << ";\n";
     g << "p.min_lam = " << p_.min_lam << ";\n";
+    g << "p.max_update = " << p_.max_update << ";\n";
     g << "p.constr_viol_tol = " << p_.constr_viol_tol << ";\n";
     g << "p.dual_inf_tol = " << p_.dual_inf_tol << ";\n";
 
@@ -327,11 +389,17 @@ namespace casadi {
     Dict stats = Conic::get_stats(mem);
     auto m = static_cast<QrqpMemory*>(mem);
     stats["return_status"] = m->return_status;
+    stats["n_factorization"] = m->n_fact;
+    stats["n_update"] = m->n_update;
+    if (warm_start_) {
+      stats["n_warm_active"] = m->n_warm_active;
+      stats["factorization_reused"] = m->fact_reused;
+    }
     return stats;
   }
 
   Qrqp::Qrqp(DeserializingStream& s) : Conic(s) {
-    s.version("Qrqp", 1);
+    int version = s.version("Qrqp", 1, 3);
     s.unpack("Qrqp::AT", AT_);
     s.unpack("Qrqp::kkt", kkt_);
     s.unpack("Qrqp::sp_v", sp_v_);
@@ -347,12 +415,23 @@ namespace casadi {
     s.unpack("Qrqp::min_lam", p_.min_lam);
     s.unpack("Qrqp::constr_viol_tol", p_.constr_viol_tol);
     s.unpack("Qrqp::dual_inf_tol", p_.dual_inf_tol);
+    if (version>=2) {
+      s.unpack("Qrqp::max_update", p_.max_update);
+    } else {
+      // Work vectors were sized without factorization updates
+      p_.max_update = 0;
+    }
+    if (version>=3) {
+      s.unpack("Qrqp::warm_start", warm_start_);
+    } else {
+      warm_start_ = false;
+    }
   }
 
   void Qrqp::serialize_body(SerializingStream &s) const {
     Conic::serialize_body(s);
 
-    s.version("Qrqp", 1);
+    s.version("Qrqp", 3);
     s.pack("Qrqp::AT", AT_);
     s.pack("Qrqp::kkt", kkt_);
     s.pack("Qrqp::sp_v", sp_v_);
@@ -367,6 +446,8 @@ namespace casadi {
     s.pack("Qrqp::min_lam", p_.min_lam);
     s.pack("Qrqp::constr_viol_tol", p_.constr_viol_tol);
     s.pack("Qrqp::dual_inf_tol", p_.dual_inf_tol);
+    s.pack("Qrqp::max_update", p_.max_update);
+    s.pack("Qrqp::warm_start", warm_start_);
   }
 
 } // namespace casadi
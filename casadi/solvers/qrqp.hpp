@@ -39,6 +39,18 @@
 namespace casadi {
   struct CASADI_CONIC_QRQP_EXPORT QrqpMemory : public ConicMemory {
     const char* return_status;
+    // Number of KKT factorizations, number of active-set changes handled by an update
+    casadi_int n_fact, n_update;
+    // Multipliers at the last solution, defines the working set for a warm start
+    std::vector<double> lam;
+    // QR factorization at the last solution, its active set and the H, A it was formed with
+    std::vector<double> nz_vr, beta, nz_h, nz_a;
+    std::vector<casadi_int> act_base;
+    // Is a working set, factorization available?
+    bool has_lam, has_fact;
+    // Warm start statistics
+    casadi_int n_warm_active;
+    bool fact_reused;
   };
 
   /** \brief \pluginbrief{Conic,qrqp}
@@ -109,6 +121,7 @@ namespace casadi {
     ///@{
     // Options
     bool print_iter_, print_header_, print_info_, print_lincomb_;
+    bool warm_start_;
     ///@}
 
     void serialize_body(SerializingStream &s) const override;
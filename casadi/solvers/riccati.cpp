@@ -0,0 +1,474 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "riccati.hpp"
+
+#include <numeric>
+
+using namespace std;
+namespace casadi {
+
+  extern "C"
+  int CASADI_CONIC_RICCATI_EXPORT
+  casadi_register_conic_riccati(Conic::Plugin* plugin) {
+    plugin->creator = Riccati::creator;
+    plugin->name = "riccati";
+    plugin->doc = Riccati::meta_doc.c_str();
+    plugin->version = CASADI_VERSION;
+    plugin->options = &Riccati::options_;
+    plugin->deserialize = &Riccati::deserialize;
+    return 0;
+  }
+
+  extern "C"
+  void CASADI_CONIC_RICCATI_EXPORT casadi_load_conic_riccati() {
+    Conic::registerPlugin(casadi_register_conic_riccati);
+  }
+
+  Riccati::Riccati(const std::string& name, const std::map<std::string, Sparsity> &st)
+    : Conic(name, st) {
+  }
+
+  Riccati::~Riccati() {
+    clear_mem();
+  }
+
+  const Options Riccati::options_
+  = {{&Conic::options_},
+     {{"N",
+       {OT_INT,
+        "OCP horizon"}},
+      {"nx",
+       {OT_INTVECTOR,
+        "Number of states, length N+1"}},
+      {"nu",
+       {OT_INTVECTOR,
+        "Number of controls, length N"}},
+      {"ng",
+       {OT_INTVECTOR,
+        "Number of non-dynamic constraints, length N+1"}},
+      {"max_iter",
+       {OT_INT,
+        "Maximum number of iterations [100]."}},
+      {"constr_viol_tol",
+       {OT_DOUBLE,
+        "Constraint violation tolerance [1e-8]."}},
+      {"dual_inf_tol",
+       {OT_DOUBLE,
+        "Dual feasibility violation tolerance [1e-8]"}},
+      {"comp_tol",
+       {OT_DOUBLE,
+        "Complementarity tolerance [1e-8]"}},
+      {"print_header",
+       {OT_BOOL,
+        "Print header [true]."}},
+      {"print_iter",
+       {OT_BOOL,
+        "Print iterations [true]."}}
+     }
+  };
+
+  void Riccati::init(const Dict& opts) {
+    // Initialize the base classes
+    Conic::init(opts);
+
+    // Default options
+    print_iter_ = true;
+    print_header_ = true;
+    casadi_int max_iter = 100;
+    double constr_viol_tol = 1e-8, dual_inf_tol = 1e-8, comp_tol = 1e-8;
+    casadi_int struct_cnt = 0;
+
+    // Read user options
+    for (auto&& op : opts) {
+      if (op.first=="N") {
+        N_ = op.second;
+        struct_cnt++;
+      } else if (op.first=="nx") {
+        nx_s_ = op.second;
+        struct_cnt++;
+      } else if (op.first=="nu") {
+        nu_s_ = op.second;
+        struct_cnt++;
+      } else if (op.first=="ng") {
+        ng_s_ = op.second;
+        struct_cnt++;
+      } else if (op.first=="max_iter") {
+        max_iter = op.second;
+      } else if (op.first=="constr_viol_tol") {
+        constr_viol_tol = op.second;
+      } else if (op.first=="dual_inf_tol") {
+        dual_inf_tol = op.second;
+      } else if (op.first=="comp_tol") {
+        comp_tol = op.second;
+      } else if (op.first=="print_iter") {
+        print_iter_ = op.second;
+      } else if (op.first=="print_header") {
+        print_header_ = op.second;
+      }
+    }
+
+    casadi_assert(struct_cnt==0 || struct_cnt==4,
+      "You must either set all of N, nx, nu, ng; "
+      "or set none at all (automatic detection).");
+    if (struct_cnt==0) detect_ocp_structure(N_, nx_s_, nu_s_, ng_s_);
+
+    const std::vector<casadi_int>& nx = nx_s_;
+    const std::vector<casadi_int>& nu = nu_s_;
+    const std::vector<casadi_int>& ng = ng_s_;
+    casadi_assert(nx.size()==N_+1 && nu.size()==N_ && ng.size()==N_+1,
+      "Expected nx, nu, ng of length N+1, N, N+1. "
+      "Structure is: N " + str(N_) + ", nx " + str(nx) + ", "
+      "nu " + str(nu) + ", ng " + str(ng) + ".");
+    casadi_assert(nx_ == std::accumulate(nx.begin(), nx.end(), 0) + // NOLINT
+      std::accumulate(nu.begin(), nu.end(), 0),
+      "sum(nx)+sum(nu) = must equal total size of variables (" + str(nx_) + "). "
+      "Structure is: N " + str(N_) + ", nx " + str(nx) + ", "
+      "nu " + str(nu) + ", ng " + str(ng) + ".");
+    casadi_assert(na_ == std::accumulate(nx.begin()+1, nx.end(), 0) + // NOLINT
+      std::accumulate(ng.begin(), ng.end(), 0),
+      "sum(nx+1)+sum(ng) = must equal total size of constraints (" + str(na_) + "). "
+      "Structure is: N " + str(N_) + ", nx " + str(nx) + ", "
+      "nu " + str(nu) + ", ng " + str(ng) + ".");
+
+    // The last stage has no controls
+    nu_s_.push_back(0);
+
+    // First variable and first constraint of each stage
+    std::vector<casadi_int> vo(N_+2, 0), ro(N_+2, 0);
+    for (casadi_int k=0; k<=N_; ++k) {
+      vo[k+1] = vo[k] + nx[k] + nu[k];
+      ro[k+1] = ro[k] + (k<N_ ? nx[k+1] : 0) + ng[k];
+    }
+
+    // H may only couple variables of the same stage
+    const casadi_int *h_colind = H_.colind(), *h_row = H_.row();
+    for (casadi_int k=0; k<=N_; ++k) {
+      for (casadi_int c=vo[k]; c<vo[k+1]; ++c) {
+        for (casadi_int el=h_colind[c]; el<h_colind[c+1]; ++el) {
+          casadi_assert(h_row[el]>=vo[k] && h_row[el]<vo[k+1],
+            "H must be block diagonal with blocks of size nx+nu, but entry "
+            "(" + str(h_row[el]) + ", " + str(c) + ") couples different stages.");
+        }
+      }
+    }
+
+    // A may only contain the blocks of the stage and the diagonal E of the dynamics
+    const casadi_int *a_colind = A_.colind(), *a_row = A_.row();
+    for (casadi_int k=0; k<=N_; ++k) {
+      for (casadi_int c=vo[k]; c<vo[k+1]; ++c) {
+        bool has_e = false;
+        for (casadi_int el=a_colind[c]; el<a_colind[c+1]; ++el) {
+          casadi_int r = a_row[el];
+          if (r>=ro[k] && r<ro[k+1]) continue;
+          if (k>0 && c-vo[k]<nx[k] && r==ro[k-1]+c-vo[k]) {
+            has_e = true;
+            continue;
+          }
+          casadi_error("A does not have the structure of an optimal control problem: "
+            "entry (" + str(r) + ", " + str(c) + ") is outside of the blocks of stage "
+            + str(k) + ".");
+        }
+        casadi_assert(k==0 || c-vo[k]>=nx[k] || has_e,
+          "A does not have the structure of an optimal control problem: "
+          "state " + str(c) + " is missing in the dynamics of stage " + str(k-1) + ".");
+      }
+    }
+
+    // Only the dynamics are treated as equality constraints
+    ineq_.resize(na_, 1);
+    for (casadi_int k=0; k<N_; ++k) {
+      std::fill(ineq_.begin()+ro[k], ineq_.begin()+ro[k]+nx[k+1], 0);
+    }
+
+    // Setup memory structure
+    set_prob();
+    p_.max_iter = max_iter;
+    p_.constr_viol_tol = constr_viol_tol;
+    p_.dual_inf_tol = dual_inf_tol;
+    p_.comp_tol = comp_tol;
+
+    // Allocate memory
+    casadi_int sz_w, sz_iw, sz_w_riccati;
+    casadi_ipqp_work(&p_, &sz_iw, &sz_w);
+    casadi_riccati_work(&r_, &sz_w_riccati);
+    alloc_iw(sz_iw, true);
+    alloc_w(sz_w + sz_w_riccati, true);
+
+    if (print_header_) {
+      // Print summary
+      print("-------------------------------------------\n");
+      print("This is casadi::Riccati\n");
+      print("Number of variables:                       %9d\n", nx_);
+      print("Number of constraints:                     %9d\n", na_);
+      print("Number of stages:                          %9d\n", N_);
+      print("Number of nonzeros in H:                   %9d\n", H_.nnz());
+      print("Number of nonzeros in A:                   %9d\n", A_.nnz());
+    }
+  }
+
+  void Riccati::set_prob() {
+    p_.sp_a = A_;
+    p_.sp_h = H_;
+    casadi_ipqp_setup(&p_);
+    p_.ineq = get_ptr(ineq_);
+    r_.N = N_;
+    r_.nx = get_ptr(nx_s_);
+    r_.nu = get_ptr(nu_s_);
+    r_.ng = get_ptr(ng_s_);
+    r_.sp_a = A_;
+    r_.sp_h = H_;
+    casadi_riccati_setup(&r_);
+  }
+
+  int Riccati::init_mem(void* mem) const {
+    if (Conic::init_mem(mem)) return 1;
+    auto m = static_cast<RiccatiMemory*>(mem);
+    m->return_status = "";
+    m->iter_count = -1;
+    return 0;
+  }
+
+  int Riccati::
+  solve(const double** arg, double** res, casadi_int* iw, double* w, void* mem) const {
+    auto m = static_cast<RiccatiMemory*>(mem);
+    // Message buffer
+    char buf[121];
+    // Setup data structures
+    casadi_ipqp_data<double> d;
+    d.prob = &p_;
+    d.nz_h = arg[CONIC_H];
+    d.g = arg[CONIC_G];
+    d.nz_a = arg[CONIC_A];
+    casadi_ipqp_init(&d, &iw, &w);
+    casadi_riccati_data<double> r;
+    r.prob = &r_;
+    casadi_riccati_init(&r, &w);
+    // Pass bounds on z
+    casadi_copy(arg[CONIC_LBX], nx_, d.lbz);
+    casadi_copy(arg[CONIC_LBA], na_, d.lbz+nx_);
+    casadi_copy(arg[CONIC_UBX], nx_, d.ubz);
+    casadi_copy(arg[CONIC_UBA], na_, d.ubz+nx_);
+    // Pass initial guess
+    casadi_copy(arg[CONIC_X0], nx_, d.z);
+    casadi_copy(arg[CONIC_LAM_X0], nx_, d.lam);
+    casadi_copy(arg[CONIC_LAM_A0], na_, d.lam+nx_);
+    // Reset solver
+    m->success = false;
+    if (casadi_ipqp_reset(&d)) return 1;
+    // The recursion eliminates the dynamics, which must hence be equalities
+    for (casadi_int i=0; i<na_; ++i) {
+      if (!ineq_[i] && !d.equality[nx_+i]) {
+        m->return_status = "Dynamics constraints must have equal bounds";
+        return 1;
+      }
+    }
+    while (true) {
+      // Prepare QP
+      int flag = casadi_ipqp_prepare(&d);
+      // Print iteration progress
+      if (print_iter_) {
+        if (d.iter % 10 == 0) {
+          // Print header
+          if (casadi_ipqp_print_header(&d, buf, sizeof(buf))) break;
+          uout() << buf << "\n";
+        }
+        // Print iteration
+        if (casadi_ipqp_print_iteration(&d, buf, sizeof(buf))) break;
+        uout() << buf << "\n";
+      }
+      if (flag) break;
+      // Factorize the stagewise KKT system
+      if (casadi_riccati_factor(&r, d.nz_h, d.nz_a, d.sigma)) {
+        d.status = IPQP_NO_SEARCH_DIR;
+        break;
+      }
+      // Predictor step
+      casadi_riccati_solve(&r, d.nz_a, d.sigma, d.rhs, d.dz, d.dlam);
+      casadi_ipqp_predictor(&d);
+      // Corrector step
+      casadi_riccati_solve(&r, d.nz_a, d.sigma, d.rhs, d.dz, d.dlam);
+      casadi_ipqp_corrector(&d);
+
+      // User interrupt
+      InterruptHandler::check();
+    }
+    // Check return flag
+    switch (d.status) {
+      case IPQP_SUCCESS:
+        m->return_status = "success";
+        break;
+      case IPQP_MAX_ITER:
+        m->return_status = "Maximum number of iterations reached";
+        m->unified_return_status = SOLVER_RET_LIMITED;
+        break;
+      case IPQP_NO_SEARCH_DIR:
+        m->return_status = "Failed to calculate search direction";
+        break;
+      case IPQP_PRINTING_ERROR:
+        m->return_status = "Printing error";
+        break;
+    }
+    m->iter_count = d.iter;
+    // Get solution
+    casadi_copy(&d.f, 1, res[CONIC_COST]);
+    casadi_copy(d.z, nx_, res[CONIC_X]);
+    casadi_copy(d.lam, nx_, res[CONIC_LAM_X]);
+    casadi_copy(d.lam+nx_, na_, res[CONIC_LAM_A]);
+    // Return
+    if (verbose_) casadi_warning(m->return_status);
+    m->success = d.status == IPQP_SUCCESS;
+    return 0;
+  }
+
+  void Riccati::codegen_body(CodeGenerator& g) const {
+    g.add_auxiliary(CodeGenerator::AUX_IPQP);
+    g.add_auxiliary(CodeGenerator::AUX_RICCATI);
+    if (print_iter_) g.add_auxiliary(CodeGenerator::AUX_PRINTF);
+    g.local("d", "struct casadi_ipqp_data");
+    g.local("p", "struct casadi_ipqp_prob");
+    g.local("r", "struct casadi_riccati_data");
+    g.local("q", "struct casadi_riccati_prob");
+    g.local("flag", "int");
+    g.local("i", "casadi_int");
+    if (print_iter_) g.local("buf[121]", "char");
+
+    // Setup memory structures
+    g << "p.sp_a = " << g.sparsity(A_) << ";\n";
+    g << "p.sp_h = " << g.sparsity(H_) << ";\n";
+    g << "casadi_ipqp_setup(&p);\n";
+    g << "p.ineq = " << g.constant(ineq_) << ";\n";
+    g << "q.N = " << N_ << ";\n";
+    g << "q.nx = " << g.constant(nx_s_) << ";\n";
+    g << "q.nu = " << g.constant(nu_s_) << ";\n";
+    g << "q.ng = " << g.constant(ng_s_) << ";\n";
+    g << "q.sp_a = " << g.sparsity(A_) << ";\n";
+    g << "q.sp_h = " << g.sparsity(H_) << ";\n";
+    g << "casadi_riccati_setup(&q);\n";
+
+    // Copy options
+    g << "p.max_iter = " << p_.max_iter << ";\n";
+    g << "p.constr_viol_tol = " << p_.constr_viol_tol << ";\n";
+    g << "p.dual_inf_tol = " << p_.dual_inf_tol << ";\n";
+    g << "p.comp_tol = " << p_.comp_tol << ";\n";
+
+    // Setup data structures
+    g << "d.prob = &p;\n";
+    g << "d.nz_h = arg[" << CONIC_H << "];\n";
+    g << "d.g = arg[" << CONIC_G << "];\n";
+    g << "d.nz_a = arg[" << CONIC_A << "];\n";
+    g << "casadi_ipqp_init(&d, &iw, &w);\n";
+    g << "r.prob = &q;\n";
+    g << "casadi_riccati_init(&r, &w);\n";
+
+    g.comment("Pass bounds on z");
+    g.copy_default(g.arg(CONIC_LBX), nx_, "d.lbz", "-casadi_inf", false);
+    g.copy_default(g.arg(CONIC_LBA), na_, "d.lbz+" + str(nx_), "-casadi_inf", false);
+    g.copy_default(g.arg(CONIC_UBX), nx_, "d.ubz", "casadi_inf", false);
+    g.copy_default(g.arg(CONIC_UBA), na_, "d.ubz+" + str(nx_), "casadi_inf", false);
+
+    g.comment("Pass initial guess");
+    g.copy_default(g.arg(CONIC_X0), nx_, "d.z", "0", false);
+    g.copy_default(g.arg(CONIC_LAM_X0), nx_, "d.lam", "0", false);
+    g.copy_default(g.arg(CONIC_LAM_A0), na_, "d.lam+" + str(nx_), "0", false);
+
+    g.comment("Solve QP");
+    g << "if (casadi_ipqp_reset(&d)) return 1;\n";
+    g << "for (i=0; i<" << na_ << "; ++i) {\n";
+    g << "if (!p.ineq[i] && !d.equality[" << nx_ << "+i]) return 1;\n";
+    g << "}\n";
+    g << "while (1) {\n";
+    g << "flag = casadi_ipqp_prepare(&d);\n";
+    if (print_iter_) {
+      // Print header
+      g << "if (d.iter % 10 == 0) {\n";
+      g << "if (casadi_ipqp_print_header(&d, buf, sizeof(buf))) break;\n";
+      g << g.printf("%s\\n", "buf") << "\n";
+      g << "}\n";
+      // Print iteration
+      g << "if (casadi_ipqp_print_iteration(&d, buf, sizeof(buf))) break;\n";
+      g << g.printf("%s\\n", "buf") << "\n";
+    }
+    g << "if (flag) break;\n";
+    g << "if (casadi_riccati_factor(&r, d.nz_h, d.nz_a, d.sigma)) {\n";
+    g << "d.status = IPQP_NO_SEARCH_DIR;\n";
+    g << "break;\n";
+    g << "}\n";
+    g << "casadi_riccati_solve(&r, d.nz_a, d.sigma, d.rhs, d.dz, d.dlam);\n";
+    g << "casadi_ipqp_predictor(&d);\n";
+    g << "casadi_riccati_solve(&r, d.nz_a, d.sigma, d.rhs, d.dz, d.dlam);\n";
+    g << "casadi_ipqp_corrector(&d);\n";
+    g << "}\n";
+
+    g.comment("Get solution");
+    g.copy_check("&d.f", 1, g.res(CONIC_COST), false, true);
+    g.copy_check("d.z", nx_, g.res(CONIC_X), false, true);
+    g.copy_check("d.lam", nx_, g.res(CONIC_LAM_X), false, true);
+    g.copy_check("d.lam+"+str(nx_), na_, g.res(CONIC_LAM_A), false, true);
+
+    g << "return d.status != IPQP_SUCCESS;\n";
+  }
+
+  Dict Riccati::get_stats(void* mem) const {
+    Dict stats = Conic::get_stats(mem);
+    auto m = static_cast<RiccatiMemory*>(mem);
+    stats["return_status"] = m->return_status;
+    return stats;
+  }
+
+  Riccati::Riccati(DeserializingStream& s) : Conic(s) {
+    s.version("Riccati", 1);
+    s.unpack("Riccati::N", N_);
+    s.unpack("Riccati::nx", nx_s_);
+    s.unpack("Riccati::nu", nu_s_);
+    s.unpack("Riccati::ng", ng_s_);
+    s.unpack("Riccati::ineq", ineq_);
+    s.unpack("Riccati::print_iter", print_iter_);
+    s.unpack("Riccati::print_header", print_header_);
+    set_prob();
+    s.unpack("Riccati::max_iter", p_.max_iter);
+    s.unpack("Riccati::constr_viol_tol", p_.constr_viol_tol);
+    s.unpack("Riccati::dual_inf_tol", p_.dual_inf_tol);
+    s.unpack("Riccati::comp_tol", p_.comp_tol);
+  }
+
+  void Riccati::serialize_body(SerializingStream &s) const {
+    Conic::serialize_body(s);
+
+    s.version("Riccati", 1);
+    s.pack("Riccati::N", N_);
+    s.pack("Riccati::nx", nx_s_);
+    s.pack("Riccati::nu", nu_s_);
+    s.pack("Riccati::ng", ng_s_);
+    s.pack("Riccati::ineq", ineq_);
+    s.pack("Riccati::print_iter", print_iter_);
+    s.pack("Riccati::print_header", print_header_);
+    s.pack("Riccati::max_iter", p_.max_iter);
+    s.pack("Riccati::constr_viol_tol", p_.constr_viol_tol);
+    s.pack("Riccati::dual_inf_tol", p_.dual_inf_tol);
+    s.pack("Riccati::comp_tol", p_.comp_tol);
+  }
+
+} // namespace casadi
@@ -0,0 +1,283 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "rosenbrock.hpp"
+
+using namespace std;
+namespace casadi {
+
+  extern "C"
+  int CASADI_INTEGRATOR_ROSENBROCK_EXPORT
+      casadi_register_integrator_rosenbrock(Integrator::Plugin* plugin) {
+    plugin->creator = Rosenbrock::creator;
+    plugin->name = "rosenbrock";
+    plugin->doc = Rosenbrock::meta_doc.c_str();
+    plugin->version = CASADI_VERSION;
+    plugin->options = &Rosenbrock::options_;
+    plugin->deserialize = &Rosenbrock::deserialize;
+    return 0;
+  }
+
+  extern "C"
+  void CASADI_INTEGRATOR_ROSENBROCK_EXPORT casadi_load_integrator_rosenbrock() {
+    Integrator::registerPlugin(casadi_register_integrator_rosenbrock);
+  }
+
+  Rosenbrock::Rosenbrock(const std::string& name, const Function& dae)
+    : FixedStepIntegrator(name, dae) {
+  }
+
+  Rosenbrock::~Rosenbrock() {
+  }
+
+  const Options Rosenbrock::options_
+  = {{&FixedStepIntegrator::options_},
+     {{"linear_solver",
+       {OT_STRING,
+        "Linear solver for the stage equations. Default: qr"}},
+      {"linear_solver_options",
+       {OT_DICT,
+        "Options to be passed to the linear solver"}}
+     }
+  };
+
+  void Rosenbrock::init(const Dict& opts) {
+    // Default options
+    linear_solver_ = "qr";
+
+    // Read options
+    for (auto&& op : opts) {
+      if (op.first=="linear_solver") {
+        linear_solver_ = op.second.to_string();
+      } else if (op.first=="linear_solver_options") {
+        linear_solver_options_ = op.second;
+      }
+    }
+
+    // Call the base class init
+    FixedStepIntegrator::init(opts);
+  }
+
+  MX Rosenbrock::algebraic_state_init(const MX& x0, const MX& z0) const {
+    return vertcat(vec(x0), vec(z0), vec(z0));
+  }
+
+  MX Rosenbrock::algebraic_state_output(const MX& Z) const {
+    return Z(Slice(Z.size1()-nz_, Z.size1()));
+  }
+
+  void Rosenbrock::setupFG() {
+    f_ = create_function("f", {"x", "z", "p", "t"}, {"ode", "alg", "quad"});
+    g_ = create_function("g", {"rx", "rz", "rp", "x", "z", "p", "t"},
+                              {"rode", "ralg", "rquad"});
+
+    // Method parameter of ROS2, chosen for L-stability
+    const double gamma = 1 + 1/sqrt(2.);
+
+    // Symbolic inputs
+    MX x0 = MX::sym("x0", this->x());
+    MX p = MX::sym("p", this->p());
+    MX t = MX::sym("t", this->t());
+
+    // The discrete time algebraic variables hold the state at the end of the step
+    // and the algebraic state at the beginning and at the end of the step
+    MX v = MX::sym("v", nx_ + 2*nz_);
+    MX x1 = v(Slice(0, nx_));
+    MX zb = v(Slice(nx_, nx_+nz_));
+    MX z0 = v(Slice(nx_+nz_, nx_+2*nz_));
+
+    // Mass matrix of the semi-explicit DAE
+    DM mass = diagcat(DM::eye(nx_), DM(nz_, nz_));
+
+    // Evaluate the DAE right-hand sides, vectorized
+    auto eval_f = [&](const MX& x, const MX& z, const MX& tt) {
+      vector<MX> f_arg(DAE_NUM_IN);
+      f_arg[DAE_X] = reshape(x, size_in(INTEGRATOR_X0));
+      f_arg[DAE_Z] = reshape(z, size_in(INTEGRATOR_Z0));
+      f_arg[DAE_P] = p;
+      f_arg[DAE_T] = tt;
+      vector<MX> f_res = f_(f_arg);
+      for (MX& e : f_res) e = vec(e);
+      return f_res;
+    };
+
+    // Forward integration
+    {
+      // Jacobian of the DAE and the quadratures with respect to the states
+      MX xs = MX::sym("x", nx_);
+      MX zs = MX::sym("z", nz_);
+      vector<MX> f_res = eval_f(xs, zs, t);
+      MX y = vertcat(xs, zs);
+      Function jac_f("jac_f", {xs, zs, p, t},
+                     {MX::jacobian(vertcat(f_res[DAE_ODE], f_res[DAE_ALG]), y),
+                      MX::jacobian(f_res[DAE_QUAD], y)});
+      vector<MX> J = jac_f(vector<MX>{vec(x0), z0, p, t});
+
+      // Stage matrix, the same for both stages
+      MX W = MX(mass) - (gamma*h_)*J[0];
+
+      // k1
+      MX y0 = vertcat(vec(x0), z0);
+      f_res = eval_f(vec(x0), z0, t);
+      MX k1 = MX::solve(W, vertcat(f_res[DAE_ODE], f_res[DAE_ALG]),
+                        linear_solver_, linear_solver_options_);
+      MX k1q = f_res[DAE_QUAD] + (gamma*h_)*mtimes(J[1], k1);
+
+      // k2
+      y = y0 + h_*k1;
+      f_res = eval_f(y(Slice(0, nx_)), y(Slice(nx_, nx_+nz_)), t + h_);
+      MX k2 = MX::solve(W, vertcat(f_res[DAE_ODE] - 2*k1(Slice(0, nx_)), f_res[DAE_ALG]),
+                        linear_solver_, linear_solver_options_);
+      MX k2q = f_res[DAE_QUAD] - 2*k1q + (gamma*h_)*mtimes(J[1], k2);
+
+      // Take step
+      MX yf = y0 + (h_/2)*(3*k1 + k2);
+      MX xf = yf(Slice(0, nx_));
+      MX qf = (h_/2)*(3*k1q + k2q);
+
+      // Define discrete time dynamics
+      vector<MX> F_in(DAE_NUM_IN);
+      F_in[DAE_T] = t;
+      F_in[DAE_X] = x0;
+      F_in[DAE_P] = p;
+      F_in[DAE_Z] = v;
+      vector<MX> F_out(DAE_NUM_OUT);
+      F_out[DAE_ODE] = reshape(xf, size_in(INTEGRATOR_X0));
+      F_out[DAE_ALG] = vertcat(xf, z0, yf(Slice(nx_, nx_+nz_)));
+      F_out[DAE_QUAD] = reshape(qf, q().size());
+      F_ = Function("dae", F_in, F_out);
+      alloc(F_);
+    }
+
+    // Backward integration
+    if (!g_.is_null()) {
+      // Symbolic inputs
+      MX rx0 = MX::sym("rx0", this->rx());
+      MX rz0 = MX::sym("rz0", nrz_);
+      MX rp = MX::sym("rp", this->rp());
+
+      // Mass matrix of the backward DAE
+      DM rmass = diagcat(DM::eye(nrx_), DM(nrz_, nrz_));
+
+      // Evaluate the backward DAE right-hand sides, vectorized
+      auto eval_g = [&](const MX& rx, const MX& rz, const MX& x, const MX& z, const MX& tt) {
+        vector<MX> g_arg(RDAE_NUM_IN);
+        g_arg[RDAE_RX] = reshape(rx, this->rx().size());
+        g_arg[RDAE_RZ] = reshape(rz, this->rz().size());
+        g_arg[RDAE_RP] = rp;
+        g_arg[RDAE_X] = reshape(x, size_in(INTEGRATOR_X0));
+        g_arg[RDAE_Z] = reshape(z, size_in(INTEGRATOR_Z0));
+        g_arg[RDAE_P] = p;
+        g_arg[RDAE_T] = tt;
+        vector<MX> g_res = g_(g_arg);
+        for (MX& e : g_res) e = vec(e);
+        return g_res;
+      };
+
+      // Jacobian of the backward DAE and quadratures with respect to the backward states
+      MX rxs = MX::sym("rx", nrx_);
+      MX rzs = MX::sym("rz", nrz_);
+      MX xs = MX::sym("x", nx_);
+      MX zs = MX::sym("z", nz_);
+      vector<MX> g_res = eval_g(rxs, rzs, xs, zs, t);
+      MX ry = vertcat(rxs, rzs);
+      Function jac_g("jac_g", {rxs, rzs, xs, zs, p, rp, t},
+                     {MX::jacobian(vertcat(g_res[RDAE_ODE], g_res[RDAE_ALG]), ry),
+                      MX::jacobian(g_res[RDAE_QUAD], ry)});
+
+      // The backward step starts at the end of the forward step
+      MX z1 = v(Slice(nx_+nz_, nx_+2*nz_));
+      vector<MX> J = jac_g(vector<MX>{vec(rx0), rz0, x1, z1, p, rp, t + h_});
+
+      // Stage matrix
+      MX W = MX(rmass) - (gamma*h_)*J[0];
+
+      // k1
+      MX ry0 = vertcat(vec(rx0), rz0);
+      g_res = eval_g(vec(rx0), rz0, x1, z1, t + h_);
+      MX k1 = MX::solve(W, vertcat(g_res[RDAE_ODE], g_res[RDAE_ALG]),
+                        linear_solver_, linear_solver_options_);
+      MX k1q = g_res[RDAE_QUAD] + (gamma*h_)*mtimes(J[1], k1);
+
+      // k2
+      ry = ry0 + h_*k1;
+      g_res = eval_g(ry(Slice(0, nrx_)), ry(Slice(nrx_, nrx_+nrz_)), vec(x0), zb, t);
+      MX k2 = MX::solve(W, vertcat(g_res[RDAE_ODE] - 2*k1(Slice(0, nrx_)), g_res[RDAE_ALG]),
+                        linear_solver_, linear_solver_options_);
+      MX k2q = g_res[RDAE_QUAD] - 2*k1q + (gamma*h_)*mtimes(J[1], k2);
+
+      // Take step
+      MX ryf = ry0 + (h_/2)*(3*k1 + k2);
+      MX rqf = (h_/2)*(3*k1q + k2q);
+
+      // Define discrete time dynamics
+      vector<MX> G_in(RDAE_NUM_IN);
+      G_in[RDAE_T] = t;
+      G_in[RDAE_X] = x0;
+      G_in[RDAE_P] = p;
+      G_in[RDAE_Z] = v;
+      G_in[RDAE_RX] = rx0;
+      G_in[RDAE_RP] = rp;
+      G_in[RDAE_RZ] = rz0;
+      vector<MX> G_out(RDAE_NUM_OUT);
+      G_out[RDAE_ODE] = reshape(ryf(Slice(0, nrx_)), rx().size());
+      G_out[RDAE_ALG] = ryf(Slice(nrx_, nrx_+nrz_));
+      G_out[RDAE_QUAD] = reshape(rqf, rq().size());
+      G_ = Function("rdae", G_in, G_out);
+      alloc(G_);
+    }
+  }
+
+  void Rosenbrock::guess_Z(const double* x, const double* z, double* Z) const {
+    casadi_copy(x, nx_, Z);
+    casadi_copy(z, nz_, Z + nx_);
+    casadi_copy(z, nz_, Z + nx_ + nz_);
+  }
+
+  void Rosenbrock::resetB(IntegratorMemory* mem, double t, const double* rx,
+                          const double* rz, const double* rp) const {
+    auto m = static_cast<FixedStepMemory*>(mem);
+
+    // Reset the base classes
+    FixedStepIntegrator::resetB(mem, t, rx, rz, rp);
+
+    // The backward algebraic state is carried from step to step
+    casadi_copy(rz, nrz_, get_ptr(m->RZ));
+  }
+
+  Rosenbrock::Rosenbrock(DeserializingStream& s) : FixedStepIntegrator(s) {
+    s.version("Rosenbrock", 1);
+    s.unpack("Rosenbrock::f", f_);
+    s.unpack("Rosenbrock::g", g_);
+  }
+
+  void Rosenbrock::serialize_body(SerializingStream &s) const {
+    FixedStepIntegrator::serialize_body(s);
+    s.version("Rosenbrock", 1);
+    s.pack("Rosenbrock::f", f_);
+    s.pack("Rosenbrock::g", g_);
+  }
+
+} // namespace casadi
@@ -0,0 +1,121 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_ROSENBROCK_HPP
+#define CASADI_ROSENBROCK_HPP
+
+#include "casadi/core/integrator_impl.hpp"
+#include <casadi/solvers/casadi_integrator_rosenbrock_export.h>
+
+/** \defgroup plugin_Integrator_rosenbrock
+      Fixed-step linearly implicit Rosenbrock-W integrator for stiff ODEs
+      and semi-explicit index-1 DAEs
+
+      Implements the two stage, second order, L-stable method ROS2 of
+      Verwer et al. (1999). Each step evaluates the Jacobian once and
+      solves two linear systems with the matrix M - gamma*h*J, there are
+      no Newton iterations. Since the method is a W-method, the order is
+      retained for any approximation of the Jacobian. For DAEs, the initial
+      algebraic state is assumed to be consistent.
+*/
+/** \pluginsection{Integrator,rosenbrock} */
+
+/// \cond INTERNAL
+namespace casadi {
+
+  /** \brief \pluginbrief{Integrator,rosenbrock}
+
+      @copydoc DAE_doc
+      @copydoc plugin_Integrator_rosenbrock
+
+      \author Joel Andersson
+      \date 2019
+  */
+  class CASADI_INTEGRATOR_ROSENBROCK_EXPORT Rosenbrock : public FixedStepIntegrator {
+  public:
+
+    /// Constructor
+    explicit Rosenbrock(const std::string& name, const Function& dae);
+
+    /** \brief  Create a new integrator */
+    static Integrator* creator(const std::string& name, const Function& dae) {
+      return new Rosenbrock(name, dae);
+    }
+
+    /// Destructor
+    ~Rosenbrock() override;
+
+    // Get name of the plugin
+    const char* plugin_name() const override { return "rosenbrock";}
+
+    // Get name of the class
+    std::string class_name() const override { return "Rosenbrock";}
+
+    ///@{
+    /** \brief Options */
+    static const Options options_;
+    const Options& get_options() const override { return options_;}
+    ///@}
+
+    /// Initialize stage
+    void init(const Dict& opts) override;
+
+    /// Setup F and G
+    void setupFG() override;
+
+    /// Initial guess for the discrete time algebraic variables
+    void guess_Z(const double* x, const double* z, double* Z) const override;
+
+    /// Reset the backward problem and take time to tf
+    void resetB(IntegratorMemory* mem, double t, const double* rx,
+                const double* rz, const double* rp) const override;
+
+    MX algebraic_state_init(const MX& x0, const MX& z0) const override;
+    MX algebraic_state_output(const MX& Z) const override;
+
+    /// A documentation string
+    static const std::string meta_doc;
+
+    /// Continuous time dynamics
+    Function f_, g_;
+
+    /// Linear solver for the stage equations
+    std::string linear_solver_;
+    Dict linear_solver_options_;
+
+    /** \brief Serialize an object without type information */
+    void serialize_body(SerializingStream &s) const override;
+
+    /** \brief Deserialize into MX */
+    static ProtoFunction* deserialize(DeserializingStream& s) { return new Rosenbrock(s); }
+  protected:
+    /** \brief Deserializing constructor */
+    explicit Rosenbrock(DeserializingStream& s);
+  };
+
+} // namespace casadi
+
+/// \endcond
+#endif // CASADI_ROSENBROCK_HPP
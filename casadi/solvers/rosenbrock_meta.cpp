@@ -0,0 +1,63 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+      #include "rosenbrock.hpp"
+      #include <string>
+
+      const std::string casadi::Rosenbrock::meta_doc=
+      "\n"
+"Fixed-step linearly implicit Rosenbrock-W integrator for stiff ODEs\n"
+"and semi-explicit index-1 DAEs\n"
+"\n"
+"Implements the two stage, second order, L-stable method ROS2 of Verwer\n"
+"et al. (1999). Each step evaluates the Jacobian once and solves two\n"
+"linear systems with the matrix M - gamma*h*J, there are no Newton\n"
+"iterations. Since the method is a W-method, the order is retained for\n"
+"any approximation of the Jacobian. For DAEs, the initial algebraic\n"
+"state is assumed to be consistent.\n"
+"\n"
+"\n"
+">List of available options\n"
+"\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"|       Id        |      Type       |     Default     |   Description   |\n"
+"+=================+=================+=================+=================+\n"
+"| linear_solver   | OT_STRING       | \"qr\"            | Linear solver   |\n"
+"|                 |                 |                 | for the stage   |\n"
+"|                 |                 |                 | equations       |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| linear_solver_o | OT_DICT         | GenericType()   | Options to be   |\n"
+"| ptions          |                 |                 | passed to the   |\n"
+"|                 |                 |                 | linear solver   |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| number_of_finit | OT_INT          | 20              | Number of       |\n"
+"| e_elements      |                 |                 | finite elements |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"\n"
+"\n"
+"\n"
+"\n"
+;
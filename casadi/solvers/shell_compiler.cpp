@@ -27,6 +27,8 @@
 #include "casadi/core/casadi_misc.hpp"
 #include "casadi/core/casadi_meta.hpp"
 #include "casadi/core/casadi_logger.hpp"
+#include "casadi/core/compile_cache.hpp"
+#include "casadi/core/thread_pool.hpp"
 #include <fstream>
 
 // Set default object file suffix
@@ -58,6 +60,7 @@ namespace casadi {
   ShellCompiler::ShellCompiler(const std::string& name) :
     ImporterInternal(name) {
       handle_ = nullptr;
+      cached_ = false;
   }
 
   ShellCompiler::~ShellCompiler() {
@@ -68,9 +71,11 @@ namespace casadi {
     if (handle_) dlclose(handle_);
 #endif // _WIN32
 
-    if (cleanup_) {
+    // Libraries in the compile cache are owned by the cache
+    if (cleanup_ && !cached_) {
       if (remove(bin_name_.c_str())) casadi_warning("Failed to remove " + bin_name_);
       if (remove(obj_name_.c_str())) casadi_warning("Failed to remove " + obj_name_);
+      for (const std::string& s : extra_obj_names_) remove(s.c_str());
       for (const std::string& s : extra_suffixes_) {
         std::string name = base_name_+s;
         remove(name.c_str());
@@ -78,6 +83,16 @@ namespace casadi {
     }
   }
 
+  void ShellCompiler::cleanup_temp() {
+    remove(bin_name_.c_str());
+    remove(obj_name_.c_str());
+    for (const std::string& s : extra_obj_names_) remove(s.c_str());
+    for (const std::string& s : extra_suffixes_) {
+      std::string name = base_name_+s;
+      remove(name.c_str());
+    }
+  }
+
   const Options ShellCompiler::options_
   = {{&ImporterInternal::options_},
      {{"compiler",
@@ -131,6 +146,26 @@ namespace casadi {
         "This is desired for thread-safety. "
         "This behaviour may defeat caching compiler wrappers. "
         "Default: true"}},
+      {"cache",
+       {OT_BOOL,
+        "Reuse shared libraries built earlier, possibly by other processes, "
+        "from identical source code and compiler commands. Default: false"}},
+      {"cache_dir",
+       {OT_STRING,
+        "Directory of the compile cache. Default: environment variable "
+        "CASADI_CACHE_DIR, or a 'casadi' subfolder of the user cache directory"}},
+      {"cache_size",
+       {OT_INT,
+        "Maximum size in bytes of the compile cache, least recently used "
+        "libraries are removed first. Negative for no limit. Default: 1e9"}},
+      {"extra_sources",
+       {OT_STRINGVECTOR,
+        "Additional source files, compiled separately and linked into the same "
+        "library, e.g. the translation units of CodeGenerator with the 'split' option"}},
+      {"parallel",
+       {OT_BOOL,
+        "Compile the source files concurrently, using the CasADi thread pool. "
+        "Default: true"}}
      }
   };
 
@@ -141,8 +176,14 @@ namespace casadi {
     // Default options
 
     cleanup_ = true;
+    cached_ = false;
     bool temp_suffix = true;
+    bool cache = false;
+    std::string cache_dir = CompileCache::default_dir();
+    casadi_int cache_size = 1000000000;
     std::string bare_name = "tmp_casadi_compiler_shell";
+    std::vector<std::string> extra_sources;
+    bool parallel = true;
 
     vector<string> compiler_flags;
     vector<string> linker_flags;
@@ -191,6 +232,16 @@ namespace casadi {
         bare_name = op.second.to_string();
       } else if (op.first=="temp_suffix") {
         temp_suffix = op.second;
+      } else if (op.first=="cache") {
+        cache = op.second;
+      } else if (op.first=="cache_dir") {
+        cache_dir = op.second.to_string();
+      } else if (op.first=="cache_size") {
+        cache_size = op.second;
+      } else if (op.first=="extra_sources") {
+        extra_sources = op.second;
+      } else if (op.first=="parallel") {
+        parallel = op.second;
       }
     }
 
@@ -202,6 +253,10 @@ namespace casadi {
     }
     base_name_ = std::string(obj_name_.begin(), obj_name_.begin()+obj_name_.size()-suffix.size());
     bin_name_ = base_name_+SHARED_LIBRARY_SUFFIX;
+    extra_obj_names_.clear();
+    for (casadi_int k=0; k<extra_sources.size(); ++k) {
+      extra_obj_names_.push_back(base_name_ + "_" + str(k+1) + suffix);
+    }
 
 #ifndef _WIN32
     // Have relative paths start with ./
@@ -209,6 +264,10 @@ namespace casadi {
       obj_name_ = "./" + obj_name_;
     }
 
+    for (std::string& s : extra_obj_names_) {
+      if (s.at(0)!='/') s = "./" + s;
+    }
+
     if (bin_name_.at(0)!='/') {
       bin_name_ = "./" + bin_name_;
     }
@@ -222,35 +281,86 @@ namespace casadi {
     }
     cccmd << " " << compiler_setup;
 
-    // C/C++ source file
-    cccmd << " " << name_;
+    // Linker flags
+    stringstream ldflags;
+    for (vector<string>::const_iterator i=linker_flags.begin(); i!=linker_flags.end(); ++i) {
+      ldflags << " " << *i;
+    }
+    ldflags << " " << linker_setup;
+
+    // Look for a library built from the same source with the same commands
+    std::string cache_key;
+    if (cache) {
+      std::ifstream src(name_, std::ios::binary);
+      casadi_assert(src.good(), "Cannot read " + name_);
+      stringstream key;
+      key << src.rdbuf() << '\0';
+      for (const std::string& e : extra_sources) {
+        std::ifstream extra_src(e, std::ios::binary);
+        casadi_assert(extra_src.good(), "Cannot read " + e);
+        key << extra_src.rdbuf() << '\0';
+      }
+      key << cccmd.str() << '\0' << linker << ldflags.str() << '\0'
+          << CasadiMeta::version() << SHARED_LIBRARY_SUFFIX;
+      cache_key = CompileCache::hash(key.str());
+      CompileCache c(cache_dir, cache_size);
+      if (c.lookup(cache_key, SHARED_LIBRARY_SUFFIX)) {
+        if (verbose_) casadi_message("found " + c.path(cache_key, SHARED_LIBRARY_SUFFIX));
+        cleanup_temp();
+        bin_name_ = c.path(cache_key, SHARED_LIBRARY_SUFFIX);
+        cached_ = true;
+      }
+    }
+
+    if (!cached_) {
+      // Commands compiling each source file into an object
+      std::vector<std::string> sources = {name_}, objects = {obj_name_};
+      sources.insert(sources.end(), extra_sources.begin(), extra_sources.end());
+      objects.insert(objects.end(), extra_obj_names_.begin(), extra_obj_names_.end());
+      std::vector<std::string> cmds;
+      for (casadi_int k=0; k<sources.size(); ++k) {
+        cmds.push_back(cccmd.str() + " " + sources[k] + " " + compiler_output_flag + objects[k]);
+        if (verbose_) casadi_message("calling \"" + cmds.back() + "\"");
+      }
 
-    // Temporary object file
-    cccmd << " " + compiler_output_flag << obj_name_;
+      // Compile into objects, possibly concurrently
+      std::vector<int> status(cmds.size(), 0);
+      auto compile = [&](casadi_int k) { status[k] = system(cmds[k].c_str());};
+      if (parallel && cmds.size()>1) {
+        ThreadPool::instance().run(cmds.size(), compile);
+      } else {
+        for (casadi_int k=0; k<cmds.size(); ++k) compile(k);
+      }
+      for (casadi_int k=0; k<cmds.size(); ++k) {
+        casadi_assert(status[k]==0, "Compilation failed. Tried \"" + cmds[k] + "\"");
+      }
 
-    // Compile into an object
-    if (verbose_) casadi_message("calling \"" + cccmd.str() + "\"");
-    if (system(cccmd.str().c_str())) {
-      casadi_error("Compilation failed. Tried \"" + cccmd.str() + "\"");
-    }
+      // Link step
+      stringstream ldcmd;
+      ldcmd << linker;
 
-    // Link step
-    stringstream ldcmd;
-    ldcmd << linker;
+      // Temporary files
+      for (const std::string& s : objects) ldcmd << " " << s;
+      ldcmd << " " + linker_output_flag + bin_name_;
 
-    // Temporary file
-    ldcmd << " " << obj_name_ << " " + linker_output_flag + bin_name_;
+      // Add flags
+      ldcmd << ldflags.str();
 
-    // Add flags
-    for (vector<string>::const_iterator i=linker_flags.begin(); i!=linker_flags.end(); ++i) {
-      ldcmd << " " << *i;
-    }
-    ldcmd << " " << linker_setup;
+      // Compile into a shared library
+      if (verbose_) casadi_message("calling \"" + ldcmd.str() + "\"");
+      if (system(ldcmd.str().c_str())) {
+        casadi_error("Linking failed. Tried \"" + ldcmd.str() + "\"");
+      }
 
-    // Compile into a shared library
-    if (verbose_) casadi_message("calling \"" + ldcmd.str() + "\"");
-    if (system(ldcmd.str().c_str())) {
-      casadi_error("Linking failed. Tried \"" + ldcmd.str() + "\"");
+      // Add to the cache and load from there
+      if (cache) {
+        CompileCache c(cache_dir, cache_size);
+        std::string cached_name = c.publish(cache_key, SHARED_LIBRARY_SUFFIX, bin_name_);
+        if (verbose_) casadi_message("added " + cached_name);
+        cleanup_temp();
+        bin_name_ = cached_name;
+        cached_ = true;
+      }
     }
 
 #ifdef _WIN32
@@ -97,9 +97,18 @@ namespace casadi {
     /// Extra files
     std::vector<std::string> extra_suffixes_;
 
+    /// Object files of additional translation units
+    std::vector<std::string> extra_obj_names_;
+
     /// Cleanup temporary files when unloading
     bool cleanup_;
 
+    /// Is the library loaded from the compile cache
+    bool cached_;
+
+    /// Remove temporary files
+    void cleanup_temp();
+
     // Shared library handle
     typedef DL_HANDLE_TYPE handle_t;
     handle_t handle_;
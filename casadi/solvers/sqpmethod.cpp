@@ -103,6 +103,22 @@ namespace casadi {
       {"lbfgs_memory",
        {OT_INT,
         "Size of L-BFGS memory."}},
+      {"lbfgs_qp_form",
+       {OT_STRING,
+        "AUTO|lifted|dense. How the compact L-BFGS Hessian approximation is passed to the "
+        "QP solver: 'dense' expands the approximation into a dense matrix, which costs "
+        "O(nx^2) memory and operations per iteration. 'lifted' adds 2*lbfgs_memory auxiliary "
+        "variables and constraints, keeping the QP Hessian sparse. "
+        "The lifted QP Hessian is indefinite, it is only convex on the subspace of the "
+        "auxiliary constraints, so it requires a QP solver that accepts this, e.g. 'qrqp'. "
+        "'auto' uses the lifted form if qpsol is known to accept an indefinite Hessian, "
+        "and the dense form otherwise."}},
+      {"qp_warm_start",
+       {OT_BOOL,
+        "Keep the working set, and if possible the KKT factorization, of the QP solver "
+        "between calls and use it when no multiplier guess is available, e.g. in the first "
+        "SQP iteration of a receding horizon solve without 'lam_x0', 'lam_g0' [false]. "
+        "Requires qpsol 'qrqp'."}},
       {"print_header",
        {OT_BOOL,
         "Print the header with problem statistics"}},
@@ -151,12 +167,14 @@ namespace casadi {
     tol_pr_ = 1e-6;
     tol_du_ = 1e-6;
     string hessian_approximation = "exact";
+    string lbfgs_qp_form = "auto";
     min_step_size_ = 1e-10;
     string qpsol_plugin = "qpoases";
     Dict qpsol_options;
     print_header_ = true;
     print_iteration_ = true;
     print_status_ = true;
+    qp_warm_start_ = false;
 
     std::string convexify_strategy = "none";
     double convexify_margin = 1e-7;
@@ -178,6 +196,8 @@ namespace casadi {
         merit_memsize_ = op.second;
       } else if (op.first=="lbfgs_memory") {
         lbfgs_memory_ = op.second;
+      } else if (op.first=="lbfgs_qp_form") {
+        lbfgs_qp_form = op.second.to_string();
       } else if (op.first=="tol_pr") {
         tol_pr_ = op.second;
       } else if (op.first=="tol_du") {
@@ -190,6 +210,8 @@ namespace casadi {
         qpsol_plugin = op.second.to_string();
       } else if (op.first=="qpsol_options") {
         qpsol_options = op.second;
+      } else if (op.first=="qp_warm_start") {
+        qp_warm_start_ = op.second;
       } else if (op.first=="print_header") {
         print_header_ = op.second;
       } else if (op.first=="print_iteration") {
@@ -229,6 +251,8 @@ namespace casadi {
                      {"f", "grad:f:x", "g", "jac:g:x"});
     }
     Asp_ = get_function("nlp_jac_fg").sparsity_out(3);
+    Asp_qp_ = Asp_;
+    nlift_ = 0;
 
     if (exact_hessian_) {
       if (!has_function("nlp_hess_l")) {
@@ -247,20 +271,41 @@ namespace casadi {
         Hsp_ = Convexify::setup(convexify_data_, Hsp_, opts);
       }
     } else {
-      Hsp_ = Sparsity::dense(nx_, nx_);
+      casadi_assert(lbfgs_memory_>0, "'lbfgs_memory' must be positive");
+      // Compact L-BFGS, delta*I + W*C*W' with W having 2*lbfgs_memory columns
+      casadi_int nl = 2*lbfgs_memory_;
+      bool lifted;
+      if (lbfgs_qp_form=="lifted") {
+        lifted = true;
+      } else if (lbfgs_qp_form=="dense") {
+        lifted = false;
+      } else if (lbfgs_qp_form=="auto") {
+        // Only QP solvers that accept an H which is indefinite outside the null space of A
+        lifted = qpsol_plugin=="qrqp";
+      } else {
+        casadi_error("Unknown L-BFGS QP form: " + lbfgs_qp_form);
+      }
+      if (lifted) {
+        // QP in (dx, v), with v = W'*dx and Hessian blockdiag(delta*I, C)
+        nlift_ = nl;
+        Hsp_ = diagcat(Sparsity::diag(nx_), Sparsity::dense(nl, nl));
+        Asp_qp_ = blockcat(Asp_, Sparsity(ng_, nl), Sparsity::dense(nl, nx_), Sparsity::diag(nl));
+      } else {
+        Hsp_ = Sparsity::dense(nx_, nx_);
+      }
     }
 
     // Allocate a QP solver
     casadi_assert(!qpsol_plugin.empty(), "'qpsol' option has not been set");
-    qpsol_ = conic("qpsol", qpsol_plugin, {{"h", Hsp_}, {"a", Asp_}},
+    if (qp_warm_start_) {
+      casadi_assert(qpsol_plugin=="qrqp",
+        "'qp_warm_start' requires qpsol 'qrqp', got '" + qpsol_plugin + "'");
+      qpsol_options["warm_start"] = true;
+    }
+    qpsol_ = conic("qpsol", qpsol_plugin, {{"h", Hsp_}, {"a", Asp_qp_}},
                    qpsol_options);
     alloc(qpsol_);
 
-    // BFGS?
-    if (!exact_hessian_) {
-      alloc_w(2*nx_); // casadi_bfgs
-    }
-
     // Header
     if (print_header_) {
       print("-------------------------------------------\n");
@@ -268,7 +313,8 @@ namespace casadi {
       if (exact_hessian_) {
         print("Using exact Hessian\n");
       } else {
-        print("Using limited memory BFGS Hessian approximation\n");
+        print("Using limited memory BFGS Hessian approximation, %s QP form\n",
+              nlift_>0 ? "lifted" : "dense");
       }
       print("Number of variables:                       %9d\n", nx_);
       print("Number of constraints:                     %9d\n", ng_);
@@ -319,9 +365,192 @@ namespace casadi {
     m->add_stat("BFGS");
     m->add_stat("QP");
     m->add_stat("linesearch");
+    m->qp_iter_count = m->qp_n_warm_active = 0;
+    m->qpsol_mem = qpsol_.checkout();
+
+    // L-BFGS memory
+    if (!exact_hessian_) {
+      casadi_int nl = 2*lbfgs_memory_;
+      m->lbfgs_s.resize(nx_*lbfgs_memory_);
+      m->lbfgs_y.resize(nx_*lbfgs_memory_);
+      m->lbfgs_npairs = m->lbfgs_first = 0;
+      m->lbfgs_delta = 1;
+      m->lbfgs_w.resize(nx_*nl);
+      m->lbfgs_c.resize(nl*nl);
+      m->lbfgs_k.resize(nl*nl);
+      m->lbfgs_v.resize(2*nl + nx_);
+      if (nlift_>0) {
+        m->qp_g.resize(nx_ + nlift_);
+        m->qp_a.resize(Asp_qp_.nnz());
+        m->qp_lbz.resize(nx_ + ng_ + 2*nlift_);
+        m->qp_ubz.resize(nx_ + ng_ + 2*nlift_);
+        m->qp_x.resize(nx_ + nlift_);
+        m->qp_lam.resize(nx_ + ng_ + 2*nlift_);
+      }
+    }
     return 0;
   }
 
+  void Sqpmethod::free_mem(void *mem) const {
+    auto m = static_cast<SqpmethodMemory*>(mem);
+    qpsol_.release(m->qpsol_mem);
+    delete m;
+  }
+
+  void Sqpmethod::lbfgs_update(SqpmethodMemory* m) const {
+    auto d = &m->d;
+    // Curvature of the current approximation along the step
+    double* bs = get_ptr(m->lbfgs_v) + 4*lbfgs_memory_;
+    lbfgs_mv(m, d->dx, bs);
+    double sbs = casadi_dot(nx_, d->dx, bs);
+    if (sbs<=0) return;
+    // New pair, replacing the oldest one if the memory is full
+    casadi_int slot;
+    if (m->lbfgs_npairs<lbfgs_memory_) {
+      slot = (m->lbfgs_first + m->lbfgs_npairs++) % lbfgs_memory_;
+    } else {
+      slot = m->lbfgs_first;
+      m->lbfgs_first = (m->lbfgs_first + 1) % lbfgs_memory_;
+    }
+    double* s = get_ptr(m->lbfgs_s) + slot*nx_;
+    double* y = get_ptr(m->lbfgs_y) + slot*nx_;
+    casadi_copy(d->dx, nx_, s);
+    casadi_copy(d->gLag, nx_, y);
+    casadi_axpy(nx_, -1., d->gLag_old, y);
+    // Powell damping, as in casadi_bfgs, keeps the approximation positive definite
+    double sy = casadi_dot(nx_, s, y);
+    if (sy < 0.2*sbs) {
+      double theta = 0.8*sbs/(sbs - sy);
+      casadi_scal(nx_, theta, y);
+      casadi_axpy(nx_, 1-theta, bs, y);
+    }
+    // The update is invariant to scaling the pair, normalize to keep C well-conditioned
+    double ns = casadi_norm_2(nx_, s);
+    casadi_scal(nx_, 1/ns, s);
+    casadi_scal(nx_, 1/ns, y);
+  }
+
+  void Sqpmethod::lbfgs_compact(SqpmethodMemory* m) const {
+    casadi_int nl = 2*lbfgs_memory_, np = m->lbfgs_npairs, r = 2*np;
+    double *w = get_ptr(m->lbfgs_w), *c = get_ptr(m->lbfgs_c), *k = get_ptr(m->lbfgs_k);
+    casadi_clear(w, nx_*nl);
+    casadi_clear(c, nl*nl);
+    m->lbfgs_delta = 1;
+    if (np==0) return;
+    // Pairs in chronological order
+    std::vector<const double*> s(np), y(np);
+    for (casadi_int i=0; i<np; ++i) {
+      casadi_int slot = (m->lbfgs_first + i) % lbfgs_memory_;
+      s[i] = get_ptr(m->lbfgs_s) + slot*nx_;
+      y[i] = get_ptr(m->lbfgs_y) + slot*nx_;
+    }
+    // Scaling of the initial approximation from the latest pair
+    double delta = casadi_dot(nx_, y[np-1], y[np-1])/casadi_dot(nx_, s[np-1], y[np-1]);
+    m->lbfgs_delta = delta;
+    // K = [delta*S'*S, L; L', -D], with L the strictly lower part of S'*Y, D its diagonal
+    for (casadi_int j=0; j<np; ++j) {
+      for (casadi_int i=0; i<np; ++i) {
+        double sy = casadi_dot(nx_, s[i], y[j]);
+        k[i + j*r] = delta*casadi_dot(nx_, s[i], s[j]);
+        k[i + (np+j)*r] = i>j ? sy : 0;
+        k[np+j + i*r] = i>j ? sy : 0;
+        k[np+i + (np+j)*r] = i==j ? -sy : 0;
+      }
+    }
+    // C = -inv(K), Gauss-Jordan elimination with partial pivoting
+    for (casadi_int j=0; j<r; ++j) {
+      for (casadi_int i=0; i<r; ++i) c[i + j*r] = i==j ? -1 : 0;
+    }
+    for (casadi_int p=0; p<r; ++p) {
+      casadi_int ip = p;
+      for (casadi_int i=p+1; i<r; ++i) {
+        if (fabs(k[i + p*r]) > fabs(k[ip + p*r])) ip = i;
+      }
+      if (k[ip + p*r]==0) {
+        // Degenerate pairs, fall back to a scaled identity
+        casadi_clear(c, nl*nl);
+        return;
+      }
+      if (ip!=p) {
+        for (casadi_int j=0; j<r; ++j) {
+          std::swap(k[p + j*r], k[ip + j*r]);
+          std::swap(c[p + j*r], c[ip + j*r]);
+        }
+      }
+      double piv = k[p + p*r];
+      for (casadi_int j=0; j<r; ++j) {
+        k[p + j*r] /= piv;
+        c[p + j*r] /= piv;
+      }
+      for (casadi_int i=0; i<r; ++i) {
+        double f = k[i + p*r];
+        if (i==p || f==0) continue;
+        for (casadi_int j=0; j<r; ++j) {
+          k[i + j*r] -= f*k[p + j*r];
+          c[i + j*r] -= f*c[p + j*r];
+        }
+      }
+    }
+    // Move to the leading dimension of the full memory, last entries first
+    for (casadi_int j=r-1; j>=0; --j) {
+      for (casadi_int i=r-1; i>=0; --i) {
+        double v = c[i + j*r];
+        c[i + j*r] = 0;
+        c[i + j*nl] = v;
+      }
+    }
+    // W = [delta*S, Y]
+    for (casadi_int j=0; j<np; ++j) {
+      casadi_axpy(nx_, delta, s[j], w + j*nx_);
+      casadi_copy(y[j], nx_, w + (np+j)*nx_);
+    }
+  }
+
+  void Sqpmethod::lbfgs_mv(SqpmethodMemory* m, const double* x, double* y) const {
+    casadi_int nl = 2*lbfgs_memory_;
+    const double *w = get_ptr(m->lbfgs_w), *c = get_ptr(m->lbfgs_c);
+    double *v = get_ptr(m->lbfgs_v), *u = v + nl;
+    // v = W'*x, u = C*v
+    for (casadi_int j=0; j<nl; ++j) v[j] = casadi_dot(nx_, w + j*nx_, x);
+    casadi_clear(u, nl);
+    for (casadi_int j=0; j<nl; ++j) casadi_axpy(nl, v[j], c + j*nl, u);
+    // y = delta*x + W*u
+    casadi_copy(x, nx_, y);
+    casadi_scal(nx_, m->lbfgs_delta, y);
+    for (casadi_int j=0; j<nl; ++j) casadi_axpy(nx_, u[j], w + j*nx_, y);
+  }
+
+  void Sqpmethod::lbfgs_qp(SqpmethodMemory* m) const {
+    auto d = &m->d;
+    casadi_int nl = 2*lbfgs_memory_;
+    const double *w = get_ptr(m->lbfgs_w), *c = get_ptr(m->lbfgs_c);
+    if (nlift_>0) {
+      // Hessian blockdiag(delta*I, C)
+      casadi_fill(d->Bk, nx_, m->lbfgs_delta);
+      casadi_copy(c, nl*nl, d->Bk + nx_);
+      // Constraints [J, 0; W', -I]
+      const casadi_int *colind = Asp_.colind();
+      double* a = get_ptr(m->qp_a);
+      for (casadi_int i=0; i<nx_; ++i) {
+        for (casadi_int k=colind[i]; k<colind[i+1]; ++k) *a++ = d->Jk[k];
+        for (casadi_int j=0; j<nl; ++j) *a++ = w[i + j*nx_];
+      }
+      casadi_fill(a, nl, -1.);
+    } else {
+      // Expand into a dense matrix, column by column
+      double *v = get_ptr(m->lbfgs_v), *u = v + nl;
+      for (casadi_int i=0; i<nx_; ++i) {
+        double* bk = d->Bk + i*nx_;
+        for (casadi_int j=0; j<nl; ++j) v[j] = w[i + j*nx_];
+        casadi_clear(u, nl);
+        for (casadi_int j=0; j<nl; ++j) casadi_axpy(nl, v[j], c + j*nl, u);
+        casadi_clear(bk, nx_);
+        for (casadi_int j=0; j<nl; ++j) casadi_axpy(nx_, u[j], w + j*nx_, bk);
+        bk[i] += m->lbfgs_delta;
+      }
+    }
+  }
+
 int Sqpmethod::solve(void* mem) const {
     auto m = static_cast<SqpmethodMemory*>(mem);
     auto d_nlp = &m->d_nlp;
@@ -330,6 +559,9 @@ int Sqpmethod::solve(void* mem) const {
     // Number of SQP iterations
     m->iter_count = 0;
 
+    // QP iterations, warm-started QP constraints still active at the solution
+    m->qp_iter_count = m->qp_n_warm_active = 0;
+
     // Number of line-search iterations
     casadi_int ls_iter = 0;
 
@@ -433,17 +665,17 @@ int Sqpmethod::solve(void* mem) const {
           ScopedTiming tic(m->fstats.at("convexify"));
           if (convexify_eval(&convexify_data_.config, d->Bk, d->Bk, m->iw, m->w)) return 1;
         }
-      } else if (m->iter_count==0) {
-        ScopedTiming tic(m->fstats.at("BFGS"));
-        // Initialize BFGS
-        casadi_fill(d->Bk, Hsp_.nnz(), 1.);
-        casadi_bfgs_reset(Hsp_, d->Bk);
       } else {
         ScopedTiming tic(m->fstats.at("BFGS"));
-        // Update BFGS
-        if (m->iter_count % lbfgs_memory_ == 0) casadi_bfgs_reset(Hsp_, d->Bk);
-        // Update the Hessian approximation
-        casadi_bfgs(Hsp_, d->Bk, d->dx, d->gLag, d->gLag_old, m->w);
+        if (m->iter_count==0) {
+          // Clear the L-BFGS memory
+          m->lbfgs_npairs = m->lbfgs_first = 0;
+        } else {
+          // Add the latest step
+          lbfgs_update(m);
+        }
+        lbfgs_compact(m);
+        lbfgs_qp(m);
       }
 
       // Formulate the QP
@@ -460,11 +692,39 @@ int Sqpmethod::solve(void* mem) const {
       m->iter_count++;
 
       // Solve the QP
-      solve_QP(m, d->Bk, d->gf, d->lbdz, d->ubdz, d->Jk,
-               d->dx, d->dlam);
+      double gain;
+      if (nlift_>0) {
+        // Lifted QP, the auxiliary variables are free, their constraints equalities
+        casadi_int nv = nx_ + nlift_, nc = ng_ + nlift_;
+        casadi_copy(d->gf, nx_, get_ptr(m->qp_g));
+        casadi_clear(get_ptr(m->qp_g) + nx_, nlift_);
+        for (double* lbz : {get_ptr(m->qp_lbz), get_ptr(m->qp_ubz)}) {
+          bool lower = lbz==get_ptr(m->qp_lbz);
+          casadi_copy(lower ? d->lbdz : d->ubdz, nx_, lbz);
+          casadi_fill(lbz + nx_, nlift_, lower ? -inf : inf);
+          casadi_copy((lower ? d->lbdz : d->ubdz) + nx_, ng_, lbz + nv);
+          casadi_clear(lbz + nv + ng_, nlift_);
+        }
+        casadi_clear(get_ptr(m->qp_x), nv);
+        casadi_clear(get_ptr(m->qp_lam), nv + nc);
+        casadi_copy(d->dlam, nx_, get_ptr(m->qp_lam));
+        casadi_copy(d->dlam + nx_, ng_, get_ptr(m->qp_lam) + nv);
+        solve_QP(m, d->Bk, get_ptr(m->qp_g), get_ptr(m->qp_lbz), get_ptr(m->qp_ubz),
+                 get_ptr(m->qp_a), get_ptr(m->qp_x), get_ptr(m->qp_lam));
+        casadi_copy(get_ptr(m->qp_x), nx_, d->dx);
+        casadi_copy(get_ptr(m->qp_lam), nx_, d->dlam);
+        casadi_copy(get_ptr(m->qp_lam) + nv, ng_, d->dlam + nx_);
+        // Curvature along the step
+        double* bdx = get_ptr(m->lbfgs_v) + 4*lbfgs_memory_;
+        lbfgs_mv(m, d->dx, bdx);
+        gain = casadi_dot(nx_, d->dx, bdx);
+      } else {
+        solve_QP(m, d->Bk, d->gf, d->lbdz, d->ubdz, d->Jk,
+                 d->dx, d->dlam);
+        gain = casadi_bilin(d->Bk, Hsp_, d->dx, d->dx);
+      }
 
       // Detecting indefiniteness
-      double gain = casadi_bilin(d->Bk, Hsp_, d->dx, d->dx);
       if (gain < 0) {
         if (print_status_) print("WARNING(sqpmethod): Indefinite Hessian detected\n");
       }
@@ -589,28 +849,38 @@ int Sqpmethod::solve(void* mem) const {
                            const double* lbdz, const double* ubdz, const double* A,
                            double* x_opt, double* dlam) const {
     ScopedTiming tic(m->fstats.at("QP"));
+    // Number of QP variables
+    casadi_int nv = nx_ + nlift_;
+
     // Inputs
     fill_n(m->arg, qpsol_.n_in(), nullptr);
     m->arg[CONIC_H] = H;
     m->arg[CONIC_G] = g;
     m->arg[CONIC_X0] = x_opt;
     m->arg[CONIC_LAM_X0] = dlam;
-    m->arg[CONIC_LAM_A0] = dlam + nx_;
+    m->arg[CONIC_LAM_A0] = dlam + nv;
     m->arg[CONIC_LBX] = lbdz;
     m->arg[CONIC_UBX] = ubdz;
     m->arg[CONIC_A] = A;
-    m->arg[CONIC_LBA] = lbdz+nx_;
-    m->arg[CONIC_UBA] = ubdz+nx_;
+    m->arg[CONIC_LBA] = lbdz+nv;
+    m->arg[CONIC_UBA] = ubdz+nv;
 
     // Outputs
     fill_n(m->res, qpsol_.n_out(), nullptr);
     m->res[CONIC_X] = x_opt;
     m->res[CONIC_LAM_X] = dlam;
-    m->res[CONIC_LAM_A] = dlam + nx_;
+    m->res[CONIC_LAM_A] = dlam + nv;
 
     // Solve the QP
-    qpsol_(m->arg, m->res, m->iw, m->w, 0);
+    qpsol_(m->arg, m->res, m->iw, m->w, m->qpsol_mem);
     if (verbose_) print("QP solved\n");
+
+    // Accumulate warm start statistics
+    if (qp_warm_start_) {
+      Dict qp_stats = qpsol_.stats(m->qpsol_mem);
+      m->qp_iter_count += qp_stats.at("iter_count").to_int();
+      m->qp_n_warm_active += qp_stats.at("n_warm_active").to_int();
+    }
   }
 
 void Sqpmethod::codegen_declarations(CodeGenerator& g) const {
@@ -862,11 +1132,15 @@ void Sqpmethod::codegen_declarations(CodeGenerator& g) const {
     auto m = static_cast<SqpmethodMemory*>(mem);
     stats["return_status"] = m->return_status;
     stats["iter_count"] = m->iter_count;
+    if (qp_warm_start_) {
+      stats["qp_iter_count"] = m->qp_iter_count;
+      stats["qp_n_warm_active"] = m->qp_n_warm_active;
+    }
     return stats;
   }
 
   Sqpmethod::Sqpmethod(DeserializingStream& s) : Nlpsol(s) {
-    int version = s.version("Sqpmethod", 1, 2);
+    int version = s.version("Sqpmethod", 1, 4);
     s.unpack("Sqpmethod::qpsol", qpsol_);
     s.unpack("Sqpmethod::exact_hessian", exact_hessian_);
     s.unpack("Sqpmethod::max_iter", max_iter_);
@@ -915,12 +1189,24 @@ void Sqpmethod::codegen_declarations(CodeGenerator& g) const {
       s.unpack("Sqpmethod::convexify", convexify_);
       if (convexify_) Convexify::deserialize(s, "Sqpmethod::", convexify_data_);
     }
+    if (version>=3) {
+      s.unpack("Sqpmethod::nlift", nlift_);
+      s.unpack("Sqpmethod::Asp_qp", Asp_qp_);
+    } else {
+      nlift_ = 0;
+      Asp_qp_ = Asp_;
+    }
+    if (version>=4) {
+      s.unpack("Sqpmethod::qp_warm_start", qp_warm_start_);
+    } else {
+      qp_warm_start_ = false;
+    }
     set_sqpmethod_prob();
   }
 
   void Sqpmethod::serialize_body(SerializingStream &s) const {
     Nlpsol::serialize_body(s);
-    s.version("Sqpmethod", 2);
+    s.version("Sqpmethod", 4);
     s.pack("Sqpmethod::qpsol", qpsol_);
     s.pack("Sqpmethod::exact_hessian", exact_hessian_);
     s.pack("Sqpmethod::max_iter", max_iter_);
@@ -941,5 +1227,8 @@ void Sqpmethod::codegen_declarations(CodeGenerator& g) const {
     s.pack("Sqpmethod::Asp", Asp_);
     s.pack("Sqpmethod::convexify", convexify_);
     if (convexify_) Convexify::serialize(s, "Sqpmethod::", convexify_data_);
+    s.pack("Sqpmethod::nlift", nlift_);
+    s.pack("Sqpmethod::Asp_qp", Asp_qp_);
+    s.pack("Sqpmethod::qp_warm_start", qp_warm_start_);
   }
 } // namespace casadi
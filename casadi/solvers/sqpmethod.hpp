@@ -53,6 +53,23 @@ namespace casadi {
 
     /// Iteration count
     int iter_count;
+
+    /// L-BFGS pairs, circular buffers of lbfgs_memory columns
+    std::vector<double> lbfgs_s, lbfgs_y;
+    casadi_int lbfgs_npairs, lbfgs_first;
+
+    /// Compact L-BFGS representation: delta*I + W*C*W'
+    double lbfgs_delta;
+    std::vector<double> lbfgs_w, lbfgs_c, lbfgs_k, lbfgs_v;
+
+    /// Lifted QP data
+    std::vector<double> qp_g, qp_a, qp_lbz, qp_ubz, qp_x, qp_lam;
+
+    /// QP iterations, warm-started QP constraints still active at the solution
+    casadi_int qp_iter_count, qp_n_warm_active;
+
+    /// Memory of the QP solver, holds the working set for warm starting
+    int qpsol_mem;
   };
 
   /** \brief  \pluginbrief{Nlpsol,sqpmethod}
@@ -94,7 +111,7 @@ namespace casadi {
     int init_mem(void* mem) const override;
 
     /** \brief Free memory block */
-    void free_mem(void *mem) const override { delete static_cast<SqpmethodMemory*>(mem);}
+    void free_mem(void *mem) const override;
 
     /** \brief Set the (persistent) work vectors */
     void set_work(void* mem, const double**& arg, double**& res,
@@ -121,6 +138,9 @@ namespace casadi {
     /// Memory size of L-BFGS method
     casadi_int lbfgs_memory_;
 
+    /// Number of auxiliary QP variables lifting the L-BFGS Hessian, 0 if expanded
+    casadi_int nlift_;
+
     /// Tolerance of primal and dual infeasibility
     double tol_pr_, tol_du_;
 
@@ -138,12 +158,18 @@ namespace casadi {
     // Print options
     bool print_header_, print_iteration_, print_status_;
 
+    /// Warm start the QP solver from its last working set
+    bool qp_warm_start_;
+
     // Hessian Sparsity
     Sparsity Hsp_;
 
     // Jacobian sparsity
     Sparsity Asp_;
 
+    // Constraint Jacobian sparsity in the QP
+    Sparsity Asp_qp_;
+
     /// Data for convexification
     ConvexifyData convexify_data_;
 
@@ -173,6 +199,18 @@ namespace casadi {
                           double* x_opt, double* dlam) const;
 
 
+    /// Add a (damped) curvature pair to the L-BFGS memory
+    void lbfgs_update(SqpmethodMemory* m) const;
+
+    /// Form the compact L-BFGS representation from the stored pairs
+    void lbfgs_compact(SqpmethodMemory* m) const;
+
+    /// Product with the L-BFGS Hessian approximation, y = B*x
+    void lbfgs_mv(SqpmethodMemory* m, const double* x, double* y) const;
+
+    /// Write the L-BFGS Hessian approximation to the QP Hessian and constraints
+    void lbfgs_qp(SqpmethodMemory* m) const;
+
     // Solve the QP subproblem
     void codegen_qp_solve(CodeGenerator& cg, const std::string& H, const std::string& g,
               const std::string& lbdz, const std::string& ubdz,
@@ -0,0 +1,571 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "stage_newton.hpp"
+#include <complex>
+
+using namespace std;
+namespace casadi {
+
+  extern "C"
+  int CASADI_ROOTFINDER_STAGE_NEWTON_EXPORT
+  casadi_register_rootfinder_stage_newton(Rootfinder::Plugin* plugin) {
+    plugin->creator = StageNewton::creator;
+    plugin->name = "stage_newton";
+    plugin->doc = StageNewton::meta_doc.c_str();
+    plugin->version = CASADI_VERSION;
+    plugin->options = &StageNewton::options_;
+    plugin->deserialize = &StageNewton::deserialize;
+    return 0;
+  }
+
+  extern "C"
+  void CASADI_ROOTFINDER_STAGE_NEWTON_EXPORT casadi_load_rootfinder_stage_newton() {
+    Rootfinder::registerPlugin(casadi_register_rootfinder_stage_newton);
+  }
+
+  // Solve A*x = b in place for a small dense matrix (column-major), partial pivoting
+  template<typename T>
+  static bool dense_solve(casadi_int n, vector<T> A, T* b) {
+    for (casadi_int k=0; k<n; ++k) {
+      // Pivot
+      casadi_int p = k;
+      for (casadi_int i=k+1; i<n; ++i) {
+        if (abs(A[i+k*n]) > abs(A[p+k*n])) p = i;
+      }
+      if (A[p+k*n]==T(0)) return false;
+      if (p!=k) {
+        for (casadi_int j=0; j<n; ++j) swap(A[k+j*n], A[p+j*n]);
+        swap(b[k], b[p]);
+      }
+      // Eliminate
+      for (casadi_int i=k+1; i<n; ++i) {
+        T l = A[i+k*n]/A[k+k*n];
+        for (casadi_int j=k+1; j<n; ++j) A[i+j*n] -= l*A[k+j*n];
+        b[i] -= l*b[k];
+      }
+    }
+    // Back substitution
+    for (casadi_int k=n-1; k>=0; --k) {
+      for (casadi_int j=k+1; j<n; ++j) b[k] -= A[k+j*n]*b[j];
+      b[k] /= A[k+k*n];
+    }
+    return true;
+  }
+
+  // Nonzero indices of the elements (r[k], c[k]), sorted column-wise
+  static vector<casadi_int> nz_index(const Sparsity& sp, const vector<casadi_int>& r,
+                                     const vector<casadi_int>& c) {
+    vector<casadi_int> ind(r.size());
+    for (casadi_int k=0; k<r.size(); ++k) ind[k] = r[k] + c[k]*sp.size1();
+    sp.get_nz(ind);
+    return ind;
+  }
+
+  /* Real block diagonal form M = T*Lambda*inv(T) of a small dense matrix with distinct
+   * eigenvalues. The eigenvalues are the roots of the characteristic polynomial
+   * (Faddeev-LeVerrier, Durand-Kerner), the eigenvectors are found by inverse iteration.
+   * A complex conjugate pair with eigenvector a+ib corresponds to the columns a, b of T
+   * and to the 2-by-2 block [alpha, beta; -beta, alpha] of Lambda.
+   * Only the decoupling depends on the accuracy of the decomposition.
+   */
+  static void stage_decomposition(casadi_int d, const vector<double>& M,
+                                  vector<double>& T, vector<double>& alpha,
+                                  vector<double>& beta) {
+    typedef complex<double> cplx;
+
+    // Characteristic polynomial, c[k] is the coefficient of lambda^k
+    vector<double> c(d+1, 0), Mk(d*d, 0), AMk(d*d);
+    c[d] = 1;
+    for (casadi_int k=1; k<=d; ++k) {
+      // Mk <- M*Mk + c[d-k+1]*I
+      fill(AMk.begin(), AMk.end(), 0.);
+      for (casadi_int j=0; j<d; ++j) {
+        for (casadi_int l=0; l<d; ++l) {
+          for (casadi_int i=0; i<d; ++i) AMk[i+j*d] += M[i+l*d]*Mk[l+j*d];
+        }
+      }
+      for (casadi_int i=0; i<d; ++i) AMk[i+i*d] += c[d-k+1];
+      Mk = AMk;
+      // c[d-k] = -trace(M*Mk)/k
+      double tr = 0;
+      for (casadi_int i=0; i<d; ++i) {
+        for (casadi_int l=0; l<d; ++l) tr += M[i+l*d]*Mk[l+i*d];
+      }
+      c[d-k] = -tr/static_cast<double>(k);
+    }
+
+    // Roots of the characteristic polynomial
+    double r = 0;
+    for (casadi_int k=0; k<d; ++k) r = max(r, fabs(c[k]));
+    r = 1 + r;
+    vector<cplx> lam(d);
+    for (casadi_int i=0; i<d; ++i) lam[i] = r*pow(cplx(0.4, 0.9), static_cast<double>(i));
+    for (casadi_int iter=0; iter<1000; ++iter) {
+      double du = 0;
+      for (casadi_int i=0; i<d; ++i) {
+        cplx num = c[d], den = 1;
+        for (casadi_int k=d-1; k>=0; --k) num = num*lam[i] + c[k];
+        for (casadi_int j=0; j<d; ++j) if (j!=i) den *= lam[i]-lam[j];
+        cplx step = num/den;
+        lam[i] -= step;
+        du = max(du, abs(step)/max(1., abs(lam[i])));
+      }
+      if (du < 1e-15) break;
+    }
+
+    // Eigenvectors and real block diagonal form
+    T.resize(d*d);
+    alpha.resize(d);
+    beta.resize(d);
+    casadi_int col = 0;
+    for (casadi_int i=0; i<d; ++i) {
+      // Real eigenvalue or the first of a complex conjugate pair
+      double im = lam[i].imag();
+      bool is_real = fabs(im) <= 1e-8*max(1., abs(lam[i]));
+      if (!is_real && im<0) continue;
+
+      // Inverse iteration with a slightly perturbed shift
+      cplx mu = is_real ? cplx(lam[i].real()) : lam[i];
+      mu += 1e-10*max(1., abs(mu));
+      vector<cplx> A(d*d);
+      for (casadi_int k=0; k<d*d; ++k) A[k] = M[k];
+      for (casadi_int k=0; k<d; ++k) A[k+k*d] -= mu;
+      vector<cplx> v(d, cplx(1));
+      for (casadi_int iter=0; iter<3; ++iter) {
+        casadi_assert(dense_solve(d, A, get_ptr(v)), "Stage coupling matrix is defective");
+        // Normalize, largest component real and equal to one
+        casadi_int imax = 0;
+        for (casadi_int k=1; k<d; ++k) if (abs(v[k])>abs(v[imax])) imax = k;
+        cplx s = v[imax];
+        for (auto&& e : v) e /= s;
+      }
+
+      casadi_assert(col + (is_real ? 1 : 2) <= d,
+        "Stage coupling matrix has unpaired complex eigenvalues");
+      for (casadi_int k=0; k<d; ++k) T[k+col*d] = v[k].real();
+      alpha[col] = lam[i].real();
+      beta[col] = is_real ? 0 : im;
+      if (!is_real) {
+        for (casadi_int k=0; k<d; ++k) T[k+(col+1)*d] = v[k].imag();
+        alpha[col+1] = lam[i].real();
+        beta[col+1] = -im;
+      }
+      col += is_real ? 1 : 2;
+    }
+    casadi_assert(col==d, "Stage coupling matrix has unpaired complex eigenvalues");
+  }
+
+  StageNewton::StageNewton(const std::string& name, const Function& f)
+    : Rootfinder(name, f) {
+  }
+
+  StageNewton::~StageNewton() {
+    clear_mem();
+  }
+
+  const Options StageNewton::options_
+  = {{&Rootfinder::options_},
+     {{"abstol",
+       {OT_DOUBLE,
+        "Stopping criterion tolerance on max(|F|)"}},
+      {"max_iter",
+       {OT_INT,
+        "Maximum number of Newton iterations with one factorization"}},
+      {"reuse_jacobian",
+       {OT_BOOL,
+        "Keep the factorization between calls, refresh only if the iterations fail "
+        "to converge (default: true)"}},
+      {"max_jacobian_age",
+       {OT_INT,
+        "Refresh the factorization after this many calls "
+        "(default: 0, only on convergence failure)"}},
+      {"stage_matrix",
+       {OT_DOUBLEVECTOR,
+        "Coupling matrix M between the stages, column-major d-by-d"}},
+      {"stage_weights",
+       {OT_DOUBLEVECTOR,
+        "Scaling of the differential residuals of each stage (default: ones)"}},
+      {"stage_differential",
+       {OT_INT,
+        "Number of differential components at the start of each stage "
+        "(default: all)"}},
+      {"stage_jacobian",
+       {OT_FUNCTION,
+        "Function with the same inputs as the residual returning the stage Jacobian K"}}
+     }
+  };
+
+  void StageNewton::init(const Dict& opts) {
+
+    // Call the base class initializer
+    Rootfinder::init(opts);
+
+    // Default options
+    max_iter_ = 50;
+    abstol_ = 1e-12;
+    reuse_jacobian_ = true;
+    max_jacobian_age_ = 0;
+    nd_ = -1;
+    vector<double> stage_matrix;
+    Function stage_jacobian;
+    string linear_solver = "qr";
+    Dict linear_solver_options;
+
+    // Read options
+    for (auto&& op : opts) {
+      if (op.first=="max_iter") {
+        max_iter_ = op.second;
+      } else if (op.first=="abstol") {
+        abstol_ = op.second;
+      } else if (op.first=="reuse_jacobian") {
+        reuse_jacobian_ = op.second;
+      } else if (op.first=="max_jacobian_age") {
+        max_jacobian_age_ = op.second;
+      } else if (op.first=="stage_matrix") {
+        stage_matrix = op.second;
+      } else if (op.first=="stage_weights") {
+        w_ = op.second;
+      } else if (op.first=="stage_differential") {
+        nd_ = op.second;
+      } else if (op.first=="stage_jacobian") {
+        stage_jacobian = op.second;
+      } else if (op.first=="linear_solver") {
+        linear_solver = op.second.to_string();
+      } else if (op.first=="linear_solver_options") {
+        linear_solver_options = op.second;
+      }
+    }
+
+    // Number of stages and stage size
+    d_ = static_cast<casadi_int>(round(sqrt(static_cast<double>(stage_matrix.size()))));
+    casadi_assert(d_>0 && d_*d_==stage_matrix.size(),
+      "StageNewton: 'stage_matrix' must be a nonempty square matrix");
+    casadi_assert(n_ % d_ == 0,
+      "StageNewton: " + str(n_) + " unknowns cannot be divided into " + str(d_) + " stages");
+    ns_ = n_ / d_;
+    if (nd_<0) nd_ = ns_;
+    casadi_assert(nd_<=ns_, "StageNewton: 'stage_differential' exceeds the stage size");
+    if (w_.empty()) w_.resize(d_, 1.);
+    casadi_assert(w_.size()==d_, "StageNewton: 'stage_weights' must have length "
+                  + str(d_));
+    for (double e : w_) casadi_assert(e!=0, "StageNewton: 'stage_weights' must be nonzero");
+
+    // Stage Jacobian
+    casadi_assert(!stage_jacobian.is_null(), "StageNewton: 'stage_jacobian' must be supplied");
+    casadi_assert(stage_jacobian.n_in()==n_in_ && stage_jacobian.n_out()==1,
+      "StageNewton: 'stage_jacobian' must have the inputs of the residual and one output");
+    sp_stage_ = stage_jacobian.sparsity_out(0);
+    casadi_assert(sp_stage_.size1()==ns_ && sp_stage_.size2()==ns_,
+      "StageNewton: 'stage_jacobian' must be " + str(ns_) + "-by-" + str(ns_));
+    set_function(oracle_, "g");
+    set_function(stage_jacobian, "jac_stage");
+
+    // Decouple the stages
+    stage_decomposition(d_, stage_matrix, T_, alpha_, beta_);
+    Tinv_.resize(d_*d_);
+    for (casadi_int j=0; j<d_; ++j) {
+      double* e = get_ptr(Tinv_) + j*d_;
+      casadi_clear(e, d_);
+      e[j] = 1;
+      casadi_assert(dense_solve(d_, T_, e), "StageNewton: Stage coupling matrix is defective");
+    }
+    block_.clear();
+    for (casadi_int k=0; k<d_; k += beta_[k]==0 ? 1 : 2) block_.push_back(k);
+
+    // Sparsity of the decoupled systems
+    vector<casadi_int> ind = range(nd_);
+    Sparsity sp_e = Sparsity::triplet(ns_, ns_, ind, ind);
+    Sparsity sp_r = sp_stage_ + sp_e;
+    vector<casadi_int> row, col;
+    sp_stage_.get_triplet(row, col);
+    map_r_ = nz_index(sp_r, row, col);
+    diag_r_ = nz_index(sp_r, ind, ind);
+    linsol_r_ = Linsol("linsol_r", linear_solver, sp_r, linear_solver_options);
+    if (block_.size()<d_) {
+      Sparsity sp_c = Sparsity::blockcat({{sp_r, sp_e}, {sp_e, sp_r}});
+      sp_r.get_triplet(row, col);
+      map_c11_ = nz_index(sp_c, row, col);
+      for (auto&& e : row) e += ns_;
+      for (auto&& e : col) e += ns_;
+      map_c22_ = nz_index(sp_c, row, col);
+      vector<casadi_int> ind2 = ind;
+      for (auto&& e : ind2) e += ns_;
+      diag_c12_ = nz_index(sp_c, ind, ind2);
+      diag_c21_ = nz_index(sp_c, ind2, ind);
+      linsol_c_ = Linsol("linsol_c", linear_solver, sp_c, linear_solver_options);
+    }
+
+    // Allocate memory
+    alloc_w(n_, true); // x
+    alloc_w(n_, true); // F
+    alloc_w(n_, true); // v
+    alloc_w(sp_stage_.nnz(), true); // jac
+    alloc_w(sp_r.nnz(), true); // jac_r
+  }
+
+  void StageNewton::set_work(void* mem, const double**& arg, double**& res,
+                             casadi_int*& iw, double*& w) const {
+    Rootfinder::set_work(mem, arg, res, iw, w);
+    auto m = static_cast<StageNewtonMemory*>(mem);
+    m->x = w; w += n_;
+    m->f = w; w += n_;
+    m->v = w; w += n_;
+    m->jac = w; w += sp_stage_.nnz();
+    m->jac_r = w; w += linsol_r_.sparsity().nnz();
+  }
+
+  int StageNewton::factorize(StageNewtonMemory* m) const {
+    // Evaluate the stage Jacobian
+    copy_n(m->iarg, n_in_, m->arg);
+    m->arg[iin_] = m->x;
+    m->res[0] = m->jac;
+    if (calc_function(m, "jac_stage")) return 1;
+    m->njevals++;
+
+    // Factorize K - lambda*E for all eigenvalues
+    casadi_int nnz_r = linsol_r_.sparsity().nnz();
+    for (casadi_int b=0; b<block_.size(); ++b) {
+      casadi_int k = block_[b];
+      double* A = get_ptr(m->A[b]);
+      double* jac_r = beta_[k]==0 ? A : m->jac_r;
+      casadi_clear(jac_r, nnz_r);
+      for (casadi_int i=0; i<map_r_.size(); ++i) jac_r[map_r_[i]] += m->jac[i];
+      for (casadi_int i=0; i<nd_; ++i) jac_r[diag_r_[i]] -= alpha_[k];
+      if (beta_[k]==0) {
+        if (linsol_r_.nfact(A, m->linsol_mem[b])) return 1;
+        m->nfact++;
+      } else {
+        // [K - alpha*E, -beta*E; beta*E, K - alpha*E]
+        casadi_clear(A, m->A[b].size());
+        for (casadi_int i=0; i<nnz_r; ++i) {
+          A[map_c11_[i]] = A[map_c22_[i]] = jac_r[i];
+        }
+        for (casadi_int i=0; i<nd_; ++i) {
+          A[diag_c12_[i]] = -beta_[k];
+          A[diag_c21_[i]] = beta_[k];
+        }
+        if (linsol_c_.nfact(A, m->linsol_mem[b])) return 1;
+        m->nfact++;
+      }
+    }
+    m->is_fact = true;
+    m->jac_age = 0;
+    return 0;
+  }
+
+  int StageNewton::solve(void* mem) const {
+    auto m = static_cast<StageNewtonMemory*>(mem);
+
+    // Get the initial guess
+    casadi_copy(m->iarg[iin_], n_, m->x);
+
+    // Factorization from a previous call, if any and not too old
+    if (!reuse_jacobian_) {
+      m->is_fact = false;
+    } else if (m->is_fact && max_jacobian_age_>0 && ++m->jac_age>=max_jacobian_age_) {
+      m->is_fact = false;
+    }
+    bool fresh = false;
+
+    // Perform the simplified Newton iterations
+    m->iter = 0;
+    casadi_int iter_fact = 0;
+    double res_prev = numeric_limits<double>::infinity();
+    bool success = false;
+    while (true) {
+      // Factorize at the current guess
+      if (!m->is_fact) {
+        if (factorize(m)) {
+          m->return_status = "factorization_failed";
+          break;
+        }
+        fresh = true;
+        iter_fact = 0;
+        res_prev = numeric_limits<double>::infinity();
+      }
+
+      // Evaluate the residual and the remaining outputs
+      copy_n(m->iarg, n_in_, m->arg);
+      m->arg[iin_] = m->x;
+      copy_n(m->ires, n_out_, m->res);
+      m->res[iout_] = m->f;
+      if (calc_function(m, "g")) {
+        m->return_status = "residual_evaluation_failed";
+        break;
+      }
+
+      // Check convergence
+      double res = casadi_norm_inf(n_, m->f);
+      if (res <= abstol_) {
+        if (verbose_) casadi_message("Converged to acceptable tolerance: " + str(abstol_));
+        m->return_status = "success";
+        success = true;
+        break;
+      }
+
+      // Too slow or diverging
+      if (iter_fact >= max_iter_ || (!fresh && !(res < res_prev))) {
+        if (fresh) {
+          if (verbose_) casadi_message("Max iterations reached.");
+          m->return_status = "max_iteration_reached";
+          m->unified_return_status = SOLVER_RET_LIMITED;
+          break;
+        }
+        // Outdated factorization, restart from the initial guess
+        if (verbose_) casadi_message("Rejecting the stage Jacobian of a previous call");
+        m->nreject++;
+        casadi_copy(m->iarg[iin_], n_, m->x);
+        m->is_fact = false;
+        continue;
+      }
+      res_prev = res;
+      m->iter++;
+      iter_fact++;
+
+      // Scale the differential residuals
+      for (casadi_int j=0; j<d_; ++j) {
+        for (casadi_int i=0; i<nd_; ++i) m->f[i + j*ns_] /= w_[j];
+      }
+
+      // Transform to decoupled stages, v = (inv(T) kron I)*f
+      casadi_clear(m->v, n_);
+      for (casadi_int j=0; j<d_; ++j) {
+        for (casadi_int k=0; k<d_; ++k) {
+          casadi_axpy(ns_, Tinv_[k + j*d_], m->f + j*ns_, m->v + k*ns_);
+        }
+      }
+
+      // Decoupled linear solves
+      for (casadi_int b=0; b<block_.size(); ++b) {
+        casadi_int k = block_[b];
+        const Linsol& linsol = beta_[k]==0 ? linsol_r_ : linsol_c_;
+        linsol.solve(get_ptr(m->A[b]), m->v + k*ns_, 1, false, m->linsol_mem[b]);
+      }
+
+      // Transform back and take the step, x -= (T kron I)*v
+      for (casadi_int k=0; k<d_; ++k) {
+        for (casadi_int j=0; j<d_; ++j) {
+          casadi_axpy(ns_, -T_[j + k*d_], m->v + k*ns_, m->x + j*ns_);
+        }
+      }
+    }
+
+    // Get the solution
+    casadi_copy(m->x, n_, m->ires[iout_]);
+    if (verbose_) casadi_message("Stage Newton algorithm took " + str(m->iter) + " steps");
+    m->success = success;
+    return 0;
+  }
+
+  int StageNewton::init_mem(void* mem) const {
+    if (Rootfinder::init_mem(mem)) return 1;
+    auto m = static_cast<StageNewtonMemory*>(mem);
+    m->return_status = "";
+    m->iter = m->jac_age = 0;
+    m->is_fact = false;
+
+    // One linear system and linear solver memory per decoupled system
+    m->A.resize(block_.size());
+    m->linsol_mem.resize(block_.size());
+    for (casadi_int b=0; b<block_.size(); ++b) {
+      const Linsol& linsol = beta_[block_[b]]==0 ? linsol_r_ : linsol_c_;
+      m->A[b].resize(linsol.sparsity().nnz());
+      m->linsol_mem[b] = linsol.checkout();
+    }
+    return 0;
+  }
+
+  void StageNewton::free_mem(void *mem) const {
+    auto m = static_cast<StageNewtonMemory*>(mem);
+    for (casadi_int b=0; b<m->linsol_mem.size(); ++b) {
+      const Linsol& linsol = beta_[block_[b]]==0 ? linsol_r_ : linsol_c_;
+      linsol.release(m->linsol_mem[b]);
+    }
+    delete m;
+  }
+
+  Dict StageNewton::get_stats(void* mem) const {
+    Dict stats = Rootfinder::get_stats(mem);
+    auto m = static_cast<StageNewtonMemory*>(mem);
+    stats["return_status"] = m->return_status;
+    stats["iter_count"] = m->iter;
+    return stats;
+  }
+
+  StageNewton::StageNewton(DeserializingStream& s) : Rootfinder(s) {
+    s.version("StageNewton", 1);
+    s.unpack("StageNewton::max_iter", max_iter_);
+    s.unpack("StageNewton::abstol", abstol_);
+    s.unpack("StageNewton::reuse_jacobian", reuse_jacobian_);
+    s.unpack("StageNewton::max_jacobian_age", max_jacobian_age_);
+    s.unpack("StageNewton::d", d_);
+    s.unpack("StageNewton::ns", ns_);
+    s.unpack("StageNewton::nd", nd_);
+    s.unpack("StageNewton::w", w_);
+    s.unpack("StageNewton::T", T_);
+    s.unpack("StageNewton::Tinv", Tinv_);
+    s.unpack("StageNewton::alpha", alpha_);
+    s.unpack("StageNewton::beta", beta_);
+    s.unpack("StageNewton::block", block_);
+    s.unpack("StageNewton::linsol_r", linsol_r_);
+    s.unpack("StageNewton::linsol_c", linsol_c_);
+    s.unpack("StageNewton::sp_stage", sp_stage_);
+    s.unpack("StageNewton::map_r", map_r_);
+    s.unpack("StageNewton::diag_r", diag_r_);
+    s.unpack("StageNewton::map_c11", map_c11_);
+    s.unpack("StageNewton::map_c22", map_c22_);
+    s.unpack("StageNewton::diag_c12", diag_c12_);
+    s.unpack("StageNewton::diag_c21", diag_c21_);
+  }
+
+  void StageNewton::serialize_body(SerializingStream &s) const {
+    Rootfinder::serialize_body(s);
+    s.version("StageNewton", 1);
+    s.pack("StageNewton::max_iter", max_iter_);
+    s.pack("StageNewton::abstol", abstol_);
+    s.pack("StageNewton::reuse_jacobian", reuse_jacobian_);
+    s.pack("StageNewton::max_jacobian_age", max_jacobian_age_);
+    s.pack("StageNewton::d", d_);
+    s.pack("StageNewton::ns", ns_);
+    s.pack("StageNewton::nd", nd_);
+    s.pack("StageNewton::w", w_);
+    s.pack("StageNewton::T", T_);
+    s.pack("StageNewton::Tinv", Tinv_);
+    s.pack("StageNewton::alpha", alpha_);
+    s.pack("StageNewton::beta", beta_);
+    s.pack("StageNewton::block", block_);
+    s.pack("StageNewton::linsol_r", linsol_r_);
+    s.pack("StageNewton::linsol_c", linsol_c_);
+    s.pack("StageNewton::sp_stage", sp_stage_);
+    s.pack("StageNewton::map_r", map_r_);
+    s.pack("StageNewton::diag_r", diag_r_);
+    s.pack("StageNewton::map_c11", map_c11_);
+    s.pack("StageNewton::map_c22", map_c22_);
+    s.pack("StageNewton::diag_c12", diag_c12_);
+    s.pack("StageNewton::diag_c21", diag_c21_);
+  }
+
+} // namespace casadi
@@ -0,0 +1,191 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_STAGE_NEWTON_HPP
+#define CASADI_STAGE_NEWTON_HPP
+
+#include "casadi/core/rootfinder_impl.hpp"
+#include <casadi/solvers/casadi_rootfinder_stage_newton_export.h>
+
+/** \defgroup plugin_Rootfinder_stage_newton
+     Simplified Newton method for the stage equations of an implicit Runge-Kutta
+     (collocation) method.
+
+     The unknowns consist of d stages of equal size. The Jacobian is approximated by
+     I_d (x) K - M (x) E, where K is the stage Jacobian, evaluated at the start of the
+     solve, M is the d-by-d stage coupling matrix and E selects the differential
+     components of a stage. The coupling matrix is brought to real block diagonal
+     form using its eigendecomposition, so that each Newton step reduces to decoupled
+     linear solves of stage size for every real eigenvalue and of twice the stage size
+     for every complex conjugate pair. The factorizations are reused in subsequent
+     calls and only refreshed when the iteration fails to converge.
+*/
+
+/** \pluginsection{Rootfinder,stage_newton} */
+
+/// \cond INTERNAL
+namespace casadi {
+
+  // Memory
+  struct CASADI_ROOTFINDER_STAGE_NEWTON_EXPORT StageNewtonMemory
+    : public RootfinderMemory {
+    // Current guess
+    double* x;
+    // Current residual
+    double* f;
+    // Residual in the decoupled stages
+    double* v;
+    // Stage Jacobian
+    double* jac;
+    // Real block before assembly of a complex block
+    double* jac_r;
+    // Decoupled linear systems, kept between calls
+    std::vector<std::vector<double> > A;
+    // Linear solver memory for each decoupled system
+    std::vector<casadi_int> linsol_mem;
+    // Are the decoupled systems factorized?
+    bool is_fact;
+    // Return status
+    const char* return_status;
+    // Number of iterations
+    casadi_int iter;
+    // Number of calls since the decoupled systems were factorized
+    casadi_int jac_age;
+  };
+
+  /** \brief \pluginbrief{Rootfinder,stage_newton}
+
+      @copydoc Rootfinder_doc
+      @copydoc plugin_Rootfinder_stage_newton
+
+      \author Joel Andersson
+      \date 2019
+  */
+  class CASADI_ROOTFINDER_STAGE_NEWTON_EXPORT StageNewton : public Rootfinder {
+  public:
+    /** \brief  Constructor */
+    explicit StageNewton(const std::string& name, const Function& f);
+
+    /** \brief  Destructor */
+    ~StageNewton() override;
+
+    // Get name of the plugin
+    const char* plugin_name() const override { return "stage_newton";}
+
+    // Name of the class
+    std::string class_name() const override { return "StageNewton";}
+
+    /** \brief  Create a new Rootfinder */
+    static Rootfinder* creator(const std::string& name, const Function& f) {
+      return new StageNewton(name, f);
+    }
+
+    ///@{
+    /** \brief Options */
+    static const Options options_;
+    const Options& get_options() const override { return options_;}
+    ///@}
+
+    /** \brief  Initialize */
+    void init(const Dict& opts) override;
+
+    /** \brief Create memory block */
+    void* alloc_mem() const override { return new StageNewtonMemory();}
+
+    /** \brief Initalize memory block */
+    int init_mem(void* mem) const override;
+
+    /** \brief Free memory block */
+    void free_mem(void *mem) const override;
+
+    /** \brief Set the (persistent) work vectors */
+    void set_work(void* mem, const double**& arg, double**& res,
+                          casadi_int*& iw, double*& w) const override;
+
+    /// Solve the system of equations
+    int solve(void* mem) const override;
+
+    /// A documentation string
+    static const std::string meta_doc;
+
+    /// Get all statistics
+    Dict get_stats(void* mem) const override;
+
+    /** \brief Serialize an object without type information */
+    void serialize_body(SerializingStream &s) const override;
+
+    /** \brief Deserialize into MX */
+    static ProtoFunction* deserialize(DeserializingStream& s) { return new StageNewton(s); }
+
+  protected:
+    /** \brief Deserializing constructor */
+    explicit StageNewton(DeserializingStream& s);
+
+    /// Evaluate the stage Jacobian at the current guess and factorize the decoupled systems
+    int factorize(StageNewtonMemory* m) const;
+
+    /// Maximum number of Newton iterations
+    casadi_int max_iter_;
+
+    /// Absolute tolerance that should be met on residual
+    double abstol_;
+
+    /// Keep the factorization between calls
+    bool reuse_jacobian_;
+
+    /// Number of calls after which the factorization is refreshed, 0 if unlimited
+    casadi_int max_jacobian_age_;
+
+    /// Number of stages, stage size and number of differential components per stage
+    casadi_int d_, ns_, nd_;
+
+    /// Scaling of the differential residuals of each stage
+    std::vector<double> w_;
+
+    /// Eigenvectors of the coupling matrix (real form) and their inverse
+    std::vector<double> T_, Tinv_;
+
+    /// Real part and imaginary part of the eigenvalue for each transformed stage
+    std::vector<double> alpha_, beta_;
+
+    /// First transformed stage of each decoupled system
+    std::vector<casadi_int> block_;
+
+    /// Linear solvers for real and complex conjugate eigenvalues
+    Linsol linsol_r_, linsol_c_;
+
+    /// Sparsity of the stage Jacobian
+    Sparsity sp_stage_;
+
+    /// Nonzero positions in the real system: stage Jacobian, differential diagonal
+    std::vector<casadi_int> map_r_, diag_r_;
+
+    /// Nonzero positions in the complex system: diagonal blocks, coupling blocks
+    std::vector<casadi_int> map_c11_, map_c22_, diag_c12_, diag_c21_;
+  };
+
+} // namespace casadi
+/// \endcond
+#endif // CASADI_STAGE_NEWTON_HPP
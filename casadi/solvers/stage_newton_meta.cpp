@@ -0,0 +1,110 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+      #include "stage_newton.hpp"
+      #include <string>
+
+      const std::string casadi::StageNewton::meta_doc=
+      "\n"
+"Simplified Newton method for the stage equations of an implicit Runge-\n"
+"Kutta (collocation) method.\n"
+"\n"
+"The unknowns consist of d stages of equal size. The Jacobian is\n"
+"approximated by I_d (x) K - M (x) E, where K is the stage Jacobian,\n"
+"evaluated at the start of the solve, M is the d-by-d stage coupling matrix\n"
+"and E selects the differential components of a stage. The coupling matrix\n"
+"is brought to real block diagonal form using its eigendecomposition, so\n"
+"that each Newton step reduces to decoupled linear solves of stage size for\n"
+"every real eigenvalue and of twice the stage size for every complex\n"
+"conjugate pair. The factorizations are reused in subsequent calls and only\n"
+"refreshed when the iteration fails to converge.\n"
+"\n"
+"\n"
+">List of available options\n"
+"\n"
+"+--------------------+-----------------+-----------------+-----------------+\n"
+"|         Id         |      Type       |     Default     |   Description   |\n"
+"+====================+=================+=================+=================+\n"
+"| abstol             | OT_DOUBLE       | 1e-12           | Stopping        |\n"
+"|                    |                 |                 | criterion       |\n"
+"|                    |                 |                 | tolerance on    |\n"
+"|                    |                 |                 | max(|F|)        |\n"
+"+--------------------+-----------------+-----------------+-----------------+\n"
+"| max_iter           | OT_INT          | 50              | Maximum number  |\n"
+"|                    |                 |                 | of Newton       |\n"
+"|                    |                 |                 | iterations with |\n"
+"|                    |                 |                 | one             |\n"
+"|                    |                 |                 | factorization   |\n"
+"+--------------------+-----------------+-----------------+-----------------+\n"
+"| max_jacobian_age   | OT_INT          | 0               | Refresh the     |\n"
+"|                    |                 |                 | factorization   |\n"
+"|                    |                 |                 | after this many |\n"
+"|                    |                 |                 | calls           |\n"
+"+--------------------+-----------------+-----------------+-----------------+\n"
+"| reuse_jacobian     | OT_BOOL         | true            | Keep the        |\n"
+"|                    |                 |                 | factorization   |\n"
+"|                    |                 |                 | between calls   |\n"
+"+--------------------+-----------------+-----------------+-----------------+\n"
+"| stage_differential | OT_INT          | all             | Number of       |\n"
+"|                    |                 |                 | differential    |\n"
+"|                    |                 |                 | components at   |\n"
+"|                    |                 |                 | the start of    |\n"
+"|                    |                 |                 | each stage      |\n"
+"+--------------------+-----------------+-----------------+-----------------+\n"
+"| stage_jacobian     | OT_FUNCTION     |                 | Stage Jacobian  |\n"
+"|                    |                 |                 | K, same inputs  |\n"
+"|                    |                 |                 | as the residual |\n"
+"+--------------------+-----------------+-----------------+-----------------+\n"
+"| stage_matrix       | OT_DOUBLEVECTOR |                 | Coupling matrix |\n"
+"|                    |                 |                 | M, column-major |\n"
+"+--------------------+-----------------+-----------------+-----------------+\n"
+"| stage_weights      | OT_DOUBLEVECTOR | ones            | Scaling of the  |\n"
+"|                    |                 |                 | differential    |\n"
+"|                    |                 |                 | residuals of    |\n"
+"|                    |                 |                 | each stage      |\n"
+"+--------------------+-----------------+-----------------+-----------------+\n"
+"\n"
+"\n"
+">List of available stats\n"
+"\n"
+"+---------------+\n"
+"|      Id       |\n"
+"+===============+\n"
+"| iter_count    |\n"
+"+---------------+\n"
+"| nfact         |\n"
+"+---------------+\n"
+"| njevals       |\n"
+"+---------------+\n"
+"| nreject       |\n"
+"+---------------+\n"
+"| return_status |\n"
+"+---------------+\n"
+"\n"
+"\n"
+"\n"
+"\n"
+;
@@ -206,6 +206,23 @@ class ComplexityTests(casadiTestCase):
     self.complexity(setupfun,fun, 1)
 
 
+  def test_SX_interpreter(self):
+    self.message("SX evaluation of long tapes, switch vs direct-threaded vs native")
+    for interpreter in ["switch","threaded","native"]:
+      self.message(interpreter)
+      def setupfun(self,N):
+        x = SX.sym("x",4)
+        y = x
+        acc = 0
+        for k in range(100*N):
+          acc = 0.5*acc + sin(y[k%4])*0.3 + y[(k+1)%4]*0.4
+          y[k%4] = acc
+        f = Function('f', [x],[acc],{"interpreter":interpreter})
+        return {'f':f}
+      def fun(self,N,setup):
+        setup['f'](DM([0.1,0.2,0.3,0.4]))
+      self.complexity(setupfun,fun, 1)
+
   def test_MX_funprodvec(self):
     self.message("MX prod")
     def setupfun(self,N):
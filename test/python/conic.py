@@ -80,6 +80,7 @@ if has_conic("cbc"):
 
 if has_conic("qrqp"):
   conics.append(("qrqp",{"max_iter":20,"print_header":False,"print_iter":False},{"quadratic": True, "dual": True, "soc": False, "codegen": True, "discrete": False, "sos":False}))
+  conics.append(("qrqp",{"max_iter":20,"max_update":10,"print_header":False,"print_iter":False},{"quadratic": True, "dual": True, "soc": False, "codegen": True, "discrete": False, "sos":False}))
 
 
 print(conics)
@@ -1239,5 +1240,196 @@ class ConicTests(casadiTestCase):
       with self.assertInException("process"):
         solver(x0=0,lbg=0,ubg=0,lbx=[-10,-10],ubx=[10,10])
 
+  @requires_conic("qrqp")
+  def test_qrqp_update(self):
+    N = 30
+    x = SX.sym("x",N)
+    f = 2*sumsqr(x)-dot(x[:-1],x[1:])+4*dot(sin(3*DM(range(N))),x)
+    g = vertcat(sum1(x),x[1:]-x[:-1])
+    qp = {'x':x, 'f':f, 'g':g}
+    solver_in = {"lbx":-0.5,"ubx":0.5,"lbg":vertcat(-1,-0.3*DM.ones(N-1)),"ubg":vertcat(1,0.3*DM.ones(N-1))}
+    # By default the KKT matrix is refactorized in every iteration
+    solver = qpsol("solver","qrqp",qp,{"print_header":False,"print_iter":False})
+    ref = solver(**solver_in)
+    ref_stats = solver.stats()
+    self.assertEqual(ref_stats["n_update"],0)
+    for max_update in [1,3,10]:
+      solver = qpsol("solver","qrqp",qp,{"max_update":max_update,"print_header":False,"print_iter":False})
+      solver_out = solver(**solver_in)
+      stats = solver.stats()
+      self.assertTrue(stats["success"])
+      # Active-set changes are handled by updating the factorization
+      self.assertTrue(stats["n_update"]>0)
+      self.assertTrue(stats["n_factorization"]<ref_stats["n_factorization"])
+      self.checkarray(solver_out["x"],ref["x"],digits=10)
+      self.checkarray(solver_out["lam_x"],ref["lam_x"],digits=8)
+      self.checkarray(solver_out["lam_g"],ref["lam_g"],digits=8)
+      self.check_codegen(solver,solver_in,std="c99")
+      self.check_serialize(solver,solver_in)
+
+  def test_qrqp_warm_start(self):
+    N = 20
+    x = SX.sym("x",N)
+    u = SX.sym("u",N)
+    p = SX.sym("p")
+    qp = {'x':vertcat(x,u), 'p':p, 'f':sumsqr(x)+sumsqr(u), 'g':x-vertcat(p,x[:-1])-u}
+    solver_in = {"lbx":vertcat(-inf*DM.ones(N),-0.3*DM.ones(N)),"ubx":vertcat(inf*DM.ones(N),0.3*DM.ones(N)),"lbg":0,"ubg":0}
+    options = {"max_update":10,"print_header":False,"print_iter":False}
+    cold = qpsol("solver","qrqp",qp,options)
+    options["warm_start"] = True
+    warm = qpsol("solver","qrqp",qp,options)
+    x0 = 3
+    for k in range(5):
+      solver_in["p"] = x0
+      ref = cold(**solver_in)
+      solver_out = warm(**solver_in)
+      stats = warm.stats()
+      self.assertTrue(stats["success"])
+      self.checkarray(solver_out["x"],ref["x"],digits=10)
+      self.checkarray(solver_out["lam_g"],ref["lam_g"],digits=8)
+      if k>0:
+        self.assertTrue(stats["factorization_reused"])
+        self.assertTrue(stats["n_warm_active"]>0)
+        self.assertTrue(stats["iter_count"]<cold.stats()["iter_count"])
+      x0 = float(solver_out["x"][0])
+    self.check_serialize(warm,solver_in)
+
+  def test_riccati(self):
+    inf = 100
+    N = 4
+
+    x = MX.sym('x',2)
+    u = MX.sym('u')
+    xdot = vertcat(0.6*x[0] - 1.11*x[1] + 0.3*u-0.03, 0.7*x[0]+0.01)
+    L = x[0]**2 + 3*x[1]**2 + 7*u**2 -0.4*x[0]*x[1]-0.3*x[0]*u+u -x[0]-2*x[1]
+    F = Function('F', [x, u], [x+xdot, L])
+
+    Xs = SX.sym('X', 2, 1, N+1)
+    Us = SX.sym('U', 1, 1, N)
+    w = []
+    lbw = []
+    ubw = []
+    J = 0
+    g = []
+    lbg = []
+    ubg = []
+    for k in range(N):
+      w += [Xs[k], Us[k]]
+      if k==0:
+        lbw += [-inf, 1]
+        ubw += [inf, 1]
+      elif k==2:
+        lbw += [0, -inf]
+        ubw += [0, inf]
+      else:
+        lbw += [-inf, -inf]
+        ubw += [inf, inf]
+      lbw += [-0.5]
+      ubw += [0.5]
+      xplus, l = F(Xs[k],Us[k])
+      J += l
+      g   += [3*(xplus-Xs[k+1]), 0.1*Xs[k][1]-0.05*Us[k]]
+      lbg += [0, 0, -0.5*k-0.1]
+      ubg += [0, 0, 2]
+    w += [Xs[-1]]
+    lbw += [-inf, -inf]
+    ubw += [inf, inf]
+    g   += [0.1*Xs[-1][1]]
+    lbg += [0.1]
+    ubg += [2]
+    J += mtimes(Xs[-1].T,Xs[-1])
+
+    prob = {'f': J, 'x': vertcat(*w), 'g': vertcat(*g)}
+    solver_in = {"lbx":lbw,"ubx":ubw,"lbg":lbg,"ubg":ubg}
+    options = {"print_header":False,"print_iter":False}
+
+    solver_ref = qpsol('solver', 'qrqp', prob, options)
+    sol_ref = solver_ref(**solver_in)
+
+    structure = {"N":N,"nx":[2]*(N+1),"nu":[1]*N,"ng":[1]*(N+1)}
+    for opts in [options, dict(options,**structure)]:
+      solver = qpsol('solver', 'riccati', prob, opts)
+      sol = solver(**solver_in)
+      self.assertTrue(solver.stats()["success"])
+      self.checkarray(sol_ref["x"], sol["x"],digits=6)
+      self.checkarray(sol_ref["lam_g"], sol["lam_g"],digits=6)
+      self.checkarray(sol_ref["lam_x"], sol["lam_x"],digits=6)
+      self.checkarray(sol_ref["f"], sol["f"],digits=6)
+      self.check_serialize(solver,solver_in)
+      self.check_codegen(solver,solver_in,std="c99")
+
+    solver = nlpsol('solver', 'sqpmethod', prob, {"qpsol": "riccati", "qpsol_options": options})
+    sol = solver(**solver_in)
+    self.checkarray(sol_ref["x"], sol["x"],digits=6)
+    self.checkarray(sol_ref["lam_g"], sol["lam_g"],digits=6)
+
+  def test_riccati_structure(self):
+    # Variables [x0 u0 x1]
+    A = sparsify(DM([[1, 2, -1],[0, 1, 0]]))
+    H = DM.eye(3)
+    solver = conic('solver', 'riccati', {"a": A.sparsity(), "h": H.sparsity()},
+      {"print_header":False,"print_iter":False,"error_on_fail":False,"N":1,"nx":[1,1],"nu":[1],"ng":[1,0]})
+    sol = solver(a=A,h=H,g=DM([1,1,1]),lba=DM([0,-1]),uba=DM([0,1]))
+    self.assertTrue(solver.stats()["success"])
+    # The dynamics must be equalities
+    with self.assertInException("Evaluation failed"):
+      solver(a=A,h=H,g=DM([1,1,1]),lba=DM([-1,-1]),uba=DM([0,1]))
+    self.assertFalse(solver.stats()["success"])
+    # Coupling between stages in H is not supported
+    H = sparsify(DM([[1, 0, 1],[0, 1, 0],[1, 0, 1]]))
+    with self.assertInException("H must be block diagonal"):
+      conic('solver', 'riccati', {"a": A.sparsity(), "h": H.sparsity()},
+        {"print_header":False,"N":1,"nx":[1,1],"nu":[1],"ng":[1,0]})
+
+  def test_ipqp(self):
+    options = {"print_header":False,"print_iter":False}
+    N = 20
+    x = SX.sym("x",N)
+    u = SX.sym("u",N)
+    mpc = {'x':vertcat(x,u), 'f':sumsqr(x)+sumsqr(u), 'g':x-vertcat(3,x[:-1])-u}
+    mpc_in = {"lbx":vertcat(-inf*DM.ones(N),-0.3*DM.ones(N)),"ubx":vertcat(inf*DM.ones(N),0.3*DM.ones(N)),"lbg":0,"ubg":0}
+
+    numpy.random.seed(1)
+    n = 8
+    m = 30
+    Q = DM(numpy.random.rand(n,n))
+    Q = mtimes(Q.T,Q)+0.1*DM.eye(n)
+    G = DM(numpy.random.rand(m,n))-0.5
+    c = DM(numpy.random.rand(n))-0.5
+    x = SX.sym("x",n)
+    dense = {'x':x, 'f':0.5*bilin(Q,x,x)+dot(c,x), 'g':mtimes(G,x)}
+    lbg = -0.1*DM.ones(m)
+    ubg = 0.1*DM.ones(m)
+    # Free row, equality row and fixed variable
+    lbg[0] = -inf
+    ubg[0] = inf
+    lbg[1] = ubg[1] = 0.05
+    lbx = -DM.ones(n)
+    ubx = DM.ones(n)
+    lbx[2] = ubx[2] = 0.02
+    dense_in = {"lbx":lbx,"ubx":ubx,"lbg":lbg,"ubg":ubg}
+
+    x = SX.sym("x",3)
+    lp = {'x':x, 'f':-x[0]-2*x[1]+x[2], 'g':vertcat(x[0]+x[1]+x[2],x[0]-x[1])}
+    lp_in = {"lbx":0,"ubx":10,"lbg":vertcat(-inf,-2),"ubg":vertcat(4,2)}
+
+    for qp, solver_in in [(mpc,mpc_in),(dense,dense_in),(lp,lp_in)]:
+      solver_ref = qpsol("solver","qrqp",qp,options)
+      solver = qpsol("solver","ipqp",qp,options)
+      ref = solver_ref(**solver_in)
+      solver_out = solver(**solver_in)
+      self.assertTrue(solver.stats()["success"])
+      self.checkarray(solver_out["f"],ref["f"],digits=7)
+      self.checkarray(solver_out["x"],ref["x"],digits=7)
+      self.checkarray(solver_out["lam_g"],ref["lam_g"],digits=6)
+      self.checkarray(solver_out["lam_x"],ref["lam_x"],digits=6)
+      self.check_serialize(solver,solver_in)
+      self.check_codegen(solver,solver_in,std="c99")
+
+    solver = qpsol("solver","ipqp",dense,dict(options,max_iter=2,error_on_fail=False))
+    solver(**dense_in)
+    self.assertFalse(solver.stats()["success"])
+    self.assertEqual(solver.stats()["return_status"],"Maximum number of iterations reached")
+
 if __name__ == '__main__':
     unittest.main()
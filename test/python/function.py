@@ -627,6 +627,91 @@ class Functiontests(casadiTestCase):
     self.checkfunction_light(fun.map(4,"thread",2),fun.map(4),inputs=[hcat(X_[:4]),hcat(Y_[:4]),hcat(Z_[:4]),hcat(V_[:4])])
     self.checkfunction_light(fun.map(4,"thread",5),fun.map(4),inputs=[hcat(X_[:4]),hcat(Y_[:4]),hcat(Z_[:4]),hcat(V_[:4])])
 
+  def test_map_sx_batch(self):
+    x = SX.sym("x")
+    y = SX.sym("y",2)
+    z = SX.sym("z",Sparsity.upper(2))
+
+    fun = Function("f",[x,y,z],[sin(y*x)+z[0,1],x**2/(1+z[1,1]),if_else(x>0.5,y,-y)])
+    # Same function without batched evaluation
+    X = [MX.sym("x"),MX.sym("y",2),MX.sym("z",Sparsity.upper(2))]
+    ref = Function("ref",X,fun(*X))
+
+    for n in [1,2,7,200]:
+      inputs = [DM(np.random.random((1,n))),DM(np.random.random((2,n))),DM(repmat(z.sparsity(),1,n),np.random.random(3*n))]
+      self.checkfunction_light(fun.map(n),ref.map(n),inputs=inputs)
+
+  @requiresPlugin(Importer,"shell")
+  def test_map_sx_batch_eval(self):
+    x = SX.sym("x")
+    y = SX.sym("y",2)
+    ref = Function("f",[x,y],[sin(y*x),x**2])
+    # Batched evaluation bypasses the interpreter, only used with default evaluation
+    for opts in [{"interpreter":"threaded"},{"jit":True,"compiler":"shell"}]:
+      fun = Function("f",[x,y],[sin(y*x),x**2],opts)
+      inputs = [DM(np.random.random((1,7))),DM(np.random.random((2,7)))]
+      self.checkfunction_light(fun.map(7),ref.map(7),inputs=inputs)
+
+  def test_sx_interpreter(self):
+    x = SX.sym("x")
+    y = SX.sym("y",2)
+    z = SX.sym("z",Sparsity.upper(2))
+
+    outputs = [sin(y*x)+z[0,1]*y,x**2/(1+z[1,1])+x*y[0]+3,if_else(x>0.5,y,-y),fmin(x,z[0,0])]
+    outputs += [x/y[1]-y[0],sqrt(fabs(x)),1/x,logic_and(x,y[0]),logic_or(x<0,y[1]),atan2(x,y[0])**3]
+    ref = Function("ref",[x,y,z],outputs)
+
+    for interpreter in ["threaded","native"]:
+      fun = Function("f",[x,y,z],outputs,{"interpreter":interpreter})
+
+      for xv in [0.7,0,-1.2]:
+        inputs = [xv,DM([0.3,1.1]),DM(z.sparsity(),[0.2,1.3,0.4])]
+        self.checkfunction_light(fun,ref,inputs=inputs)
+
+      # Serialization preserves the interpreter
+      fun2 = Function.deserialize(fun.serialize())
+      self.checkfunction_light(fun2,ref,inputs=inputs)
+
+    with self.assertInException("Unknown interpreter"):
+      Function("f",[x,y,z],outputs,{"interpreter":"foo"})
+
+  def test_sx_schedule(self):
+    x = SX.sym("x",6)
+    acc = 0
+    for k in range(6):
+      t = x[k]
+      for j in range(5):
+        t = sin(t)*(x[(k+j)%6]+cos(x[j]*t))
+      acc = t+acc
+    e = acc
+    for k in range(4):
+      e = x[k]*(x[k+1]+e)
+
+    ref = Function("ref",[x],[e,acc])
+    f = Function("f",[x],[e,acc],{"schedule":True})
+    self.assertTrue(f.sz_w()<ref.sz_w())
+    self.checkfunction_light(f,ref,inputs=[DM.rand(6)])
+    self.check_codegen(f,inputs=[DM.rand(6)])
+    self.check_codegen(f,inputs=[DM.rand(6)],opts={"codegen_scalars":True})
+
+  def test_map_thread_pool(self):
+    x = SX.sym("x")
+    y = SX.sym("y",2)
+
+    fun = Function("f",[x,y],[sin(y*x),x**2])
+    inputs = [DM(np.random.random((1,6))),DM(np.random.random((2,6)))]
+
+    # Nested thread maps share the persistent worker pool
+    nested = fun.map(3,"thread").map(2,"thread")
+    ref = fun.map(6)
+
+    for n_threads in [0, 1, 2, 5]:
+      GlobalOptions.setMaxNumThreads(n_threads)
+      for i in range(3):
+        self.checkfunction_light(fun.map(6,"thread"),ref,inputs=inputs)
+        self.checkfunction_light(nested,ref,inputs=inputs)
+    GlobalOptions.setMaxNumThreads(0)
+
   @memory_heavy()
   def test_mapsum(self):
     x = SX.sym("x")
@@ -2629,6 +2714,58 @@ class Functiontests(casadiTestCase):
     f = Function("f",[],[c])
     self.check_codegen(f,inputs=[])
 
+  @requiresPlugin(Importer,"shell")
+  def test_jit_cache(self):
+    import shutil
+    cache_dir = "jit_cache_test"
+    shutil.rmtree(cache_dir, ignore_errors=True)
+    x = MX.sym("x",2)
+    opts = {"jit":True, "compiler": "shell", "jit_options": {"verbose":True,"cache":True,"cache_dir":cache_dir}}
+    ref = Function('f',[x],[sin(x)*x[0]])
+
+    # First instance compiles, the second one loads from the cache
+    with self.assertOutput(["calling","added"],["found"]):
+      f = Function('f',[x],[sin(x)*x[0]],opts)
+    self.checkfunction_light(f, ref, inputs=[DM([1.1,2])])
+    with self.assertOutput(["found"],["calling"]):
+      g = Function('f',[x],[sin(x)*x[0]],opts)
+    self.checkfunction_light(g, ref, inputs=[DM([1.1,2])])
+    self.assertEqual(len(os.listdir(cache_dir)),1)
+
+    # Different flags, different entry
+    opts["jit_options"]["compiler_flags"] = ["-O1"]
+    with self.assertOutput(["calling"],["found"]):
+      h = Function('f',[x],[sin(x)*x[0]],opts)
+    self.assertEqual(len(os.listdir(cache_dir)),2)
+
+    # Size limit: only the most recent entry is kept
+    opts["jit_options"]["cache_size"] = 1
+    h = Function('f',[x],[cos(x)],opts)
+    self.assertEqual(len(os.listdir(cache_dir)),1)
+
+    shutil.rmtree(cache_dir, ignore_errors=True)
+
+  def test_codegen_split(self):
+    x = SX.sym("x",3)
+    e = x
+    for i in range(30):
+      e = sin(e)*x[0]+cos(e[2])
+    f = Function('f',[x],[e, dot(e,e)])
+    g = Function('g',[x],[f(2*x)[0]])
+
+    cg = CodeGenerator("codegen_split", {"split": 100, "avoid_stack": True})
+    cg.add(f)
+    cg.add(g)
+    main = cg.generate()
+    units = cg.units()
+    self.assertEqual(units[0], main)
+    self.assertTrue(len(units)>2)
+
+    for parallel in [True, False]:
+      lib = Importer(main, "shell", {"extra_sources": units[1:], "parallel": parallel})
+      for ref in [f, g]:
+        self.checkfunction_light(external(ref.name(), lib), ref, inputs=[DM([1.1,2,0.3])])
+
   def test_jit_serialize(self):
     if not args.run_slow: return
 
@@ -56,10 +56,14 @@ integrators.append(("collocation",["dae","ode"],{"rootfinder":"newton","number_o
 
 integrators.append(("rk",["ode"],{"number_of_finite_elements": 1000}))
 
+integrators.append(("collocation",["dae","ode"],{"rootfinder":"stage_newton","number_of_finite_elements": 18}))
+
 integrators.append(("collocation",["dae","ode"],{"rootfinder":"newton","number_of_finite_elements": 18,"simplify":True,"rootfinder":"fast_newton"}))
 
 integrators.append(("rk",["ode"],{"number_of_finite_elements": 1000,"simplify":True}))
 
+integrators.append(("dopri",["ode"],{"abstol": 1e-12,"reltol":1e-12}))
+
 
 print("Will test these integrators:")
 for cl, t, options in integrators:
@@ -1048,6 +1052,310 @@ class Integrationtests(casadiTestCase):
 
     self.assertTrue(intg.nnz_out("zf")==0)
 
+  def test_parareal(self):
+    x = SX.sym("x",2)
+    t = SX.sym("t")
+    p = SX.sym("p")
+    dae = {"x":x,"p":p,"t":t,"ode":vertcat(x[1],-p*sin(x[0])+0.1*cos(t)),"quad":x[0]**2}
+    for output_t0 in [False,True]:
+      ref = integrator("ref","rk",dae,{"grid":[0,1,2],"number_of_finite_elements":200,"output_t0":output_t0})
+      res_ref = ref(x0=vertcat(1,0),p=2)
+      # As many iterations as windows reproduces the fine solution
+      intg = parareal("intg","rk",dae,{"grid":[0,1,2],"number_of_finite_elements":50,"output_t0":output_t0,
+                                       "parareal_windows":4,"parareal_iterations":4})
+      self.assertFalse(intg.is_a("Integrator"))
+      res = intg(x0=vertcat(1,0),p=2)
+      for k in ["xf","qf"]:
+        self.checkarray(res[k],res_ref[k],digits=10)
+
+  def test_map_lockstep(self):
+    x = SX.sym("x",2)
+    z = SX.sym("z")
+    p = SX.sym("p")
+    ode = vertcat(x[1],-p*sin(x[0]))
+    for Integrator, dae in [("rk",{"x":x,"p":p,"ode":ode,"quad":x[0]**2}),
+                            ("collocation",{"x":x,"z":z,"p":p,"ode":ode,"alg":z-p*x[0],"quad":z**2})]:
+      intg = integrator("intg",Integrator,dae,{"number_of_finite_elements":20,"grid":[0,0.5,1,2]})
+      x0 = DM.rand(2,10)
+      p0 = DM.rand(1,10)
+      for parallelization in ["serial","thread"]:
+        F = intg.map(10,parallelization)
+        res = F(x0=x0,p=p0)
+        nfact = 0
+        for i in range(10):
+          res_ref = intg(x0=x0[:,i],p=p0[i])
+          for k in ["xf","zf","qf"]:
+            self.checkarray(res[k][:,3*i:3*(i+1)],res_ref[k],digits=12)
+          if Integrator=="collocation": nfact += intg.stats()["nfact"]
+        # The statistics count the work of all instances
+        if Integrator=="collocation": self.assertEqual(F.stats()["nfact"],nfact)
+
+  def test_checkpoints(self):
+    x = SX.sym("x",2)
+    rx = SX.sym("rx",2)
+    p = SX.sym("p")
+    ode = vertcat(x[1],-p*sin(x[0]))
+    dae = {"x":x,"p":p,"ode":ode,"rx":rx,"rode":mtimes(jacobian(ode,x).T,rx)}
+    for Integrator in ["rk","collocation"]:
+      ref = integrator("ref",Integrator,dae,{"number_of_finite_elements":100})
+      res_ref = ref(x0=vertcat(1,0),p=2,rx0=vertcat(1,2))
+      for nchk in [1,2,7]:
+        intg = integrator("intg",Integrator,dae,{"number_of_finite_elements":100,"number_of_checkpoints":nchk})
+        res = intg(x0=vertcat(1,0),p=2,rx0=vertcat(1,2))
+        self.checkarray(res["rxf"],res_ref["rxf"],digits=12)
+        stats = intg.stats()
+        self.assertTrue(stats["ncheckpoints"]<=nchk)
+        self.assertTrue(stats["nrecomp"]>=100)
+
+  def test_stage_newton(self):
+    x = SX.sym("x",2)
+    z = SX.sym("z")
+    rx = SX.sym("rx",2)
+    p = SX.sym("p")
+    ode = vertcat(x[1],-p*sin(x[0])-z)
+    alg = z-0.1*x[1]**3
+    dae = {"x":x,"z":z,"p":p,"ode":ode,"alg":alg,"quad":z**2,"rx":rx,"rode":mtimes(jacobian(ode,x).T,rx)}
+    for scheme in ["radau","legendre"]:
+      for order in [1,2,3,4]:
+        opts = {"number_of_finite_elements":20,"grid":[0,0.5,1],"collocation_scheme":scheme,"interpolation_order":order}
+        ref = integrator("ref","collocation",dae,opts)
+        res_ref = ref(x0=vertcat(1,0),p=2,rx0=vertcat(1,2))
+        opts["rootfinder"] = "stage_newton"
+        intg = integrator("intg","collocation",dae,opts)
+        res = intg(x0=vertcat(1,0),p=2,rx0=vertcat(1,2))
+        for k in ["xf","zf","qf","rxf"]:
+          self.checkarray(res[k],res_ref[k],digits=10)
+
+  def test_simplified_newton(self):
+    x = SX.sym("x",2)
+    rx = SX.sym("rx",2)
+    ode = vertcat(x[1],10*(1-x[0]**2)*x[1]-x[0])
+    dae = {"x":x,"ode":ode,"quad":x[0]**2,"rx":rx,"rode":mtimes(jacobian(ode,x).T,rx)}
+    opts = {"tf":10,"number_of_finite_elements":200}
+    ref = integrator("ref","collocation",dae,opts)
+    res_ref = ref(x0=vertcat(2,0),rx0=vertcat(1,0))
+    stats_ref = ref.stats()
+    for rfo in [{"simplified_newton":True},{"simplified_newton":True,"max_jacobian_age":5}]:
+      opts["rootfinder_options"] = rfo
+      intg = integrator("intg","collocation",dae,opts)
+      res = intg(x0=vertcat(2,0),rx0=vertcat(1,0))
+      for k in ["xf","qf","rxf"]:
+        self.checkarray(res[k],res_ref[k],digits=10)
+      stats = intg.stats()
+      # The factorization is kept across steps, refreshed when it fails to converge
+      self.assertTrue(stats["nfact"]<stats_ref["nfact"]/10)
+      self.assertTrue(stats["nfact"]==stats["njevals"])
+      if "max_jacobian_age" in rfo:
+        self.assertTrue(stats["nfact"]>=200/5)
+
+  def test_sensitivity_corrector(self):
+    x = SX.sym("x",2)
+    z = SX.sym("z")
+    p = SX.sym("p",2)
+    dae = {"x":x,"z":z,"p":p,"ode":vertcat(x[1]*z,-p[0]*x[0]+sin(x[1])),
+           "alg":z-1-0.1*x[0]**2-p[1],"quad":x[0]**2+z}
+    args = {"x0":[0.3,0.2],"p":[0.8,0.1],"z0":1}
+    for rf in ["newton","stage_newton"]:
+      J = []
+      for sc in ["simultaneous","staggered"]:
+        opts = {"tf":1,"number_of_finite_elements":20,"rootfinder":rf,
+                "rootfinder_options":{"abstol":1e-14},"sensitivity_corrector":sc}
+        intg = integrator("intg","collocation",dae,opts)
+        J.append(intg.factory("J",["x0","p","z0"],
+                              ["jac:xf:x0","jac:xf:p","jac:qf:p","jac:zf:p","hess:qf:p:p"]))
+      self.checkfunction_light(J[1],J[0],inputs=[args["x0"],args["p"],args["z0"]],digits=9)
+
+  def test_rosenbrock(self):
+    t = SX.sym("t")
+    x = SX.sym("x",2)
+    z = SX.sym("z")
+    p = SX.sym("p")
+    rx = SX.sym("rx",2)
+    rz = SX.sym("rz")
+    ode = vertcat(-p*x[0]+x[1]**2+sin(t),-10*x[1]+x[0])
+    dae = {"t":t,"x":x,"p":p,"ode":ode,"quad":x[0]**2,"rx":rx,
+           "rode":mtimes(jacobian(ode,x).T,rx),"rquad":mtimes(jacobian(ode,p).T,rx)}
+    # Semi-explicit index-1 DAE, started at a consistent algebraic state
+    ode = vertcat(-p*x[0]+z,-x[1]+x[0])
+    dae_z = {"x":x,"z":z,"p":p,"ode":ode,"alg":z-x[1]**2-0.2*z**3,"quad":z,
+             "rx":rx,"rz":rz,"rode":vertcat(-p*rx[0]+rx[1],-rx[1]-2*x[1]*rz),
+             "ralg":rx[0]+rz-0.6*z**2*rz,"rquad":rz}
+    arg = {"x0":vertcat(1,0.5),"p":2,"rx0":vertcat(1,-1)}
+    arg_z = dict(arg, z0=0.25334404)
+
+    for d, a in [(dae, arg), (dae_z, arg_z)]:
+      ref = integrator("ref","collocation",d,{"tf":1,"number_of_finite_elements":100})
+      res_ref = ref(**a)
+      err = []
+      for nk in [100,200]:
+        intg = integrator("intg","rosenbrock",d,{"tf":1,"number_of_finite_elements":nk})
+        res = intg(**a)
+        for k in ["xf","qf","rxf","rqf"]:
+          self.checkarray(res[k],res_ref[k],digits=3)
+        err.append(norm_inf(res["xf"]-res_ref["xf"]))
+      # Second order convergence
+      self.assertTrue(err[0]/err[1]>3)
+
+    # Same result when expanded into an MX Function
+    intg = integrator("intg","rosenbrock",dae_z,{"tf":1,"number_of_finite_elements":20})
+    intg_s = integrator("intg","rosenbrock",dae_z,{"tf":1,"number_of_finite_elements":20,"simplify":True})
+    for k in ["xf","zf","qf"]:
+      self.checkarray(intg(x0=arg["x0"],p=2,z0=arg_z["z0"])[k],intg_s(x0=arg["x0"],p=2,z0=arg_z["z0"])[k])
+
+  @requires_expm("slicot")
+  def test_exponential(self):
+    t = SX.sym("t")
+    x = SX.sym("x",2)
+    A = DM([[-1,2],[0,-300]])
+    # Exact for linear ODEs with affine time dependence
+    dae = {"t":t,"x":x,"ode":mtimes(A,x)+vertcat(t,1),"quad":x[1]}
+    ref = integrator("ref","collocation",dae,{"tf":1,"number_of_finite_elements":400})
+    intg = integrator("intg","exponential",dae,{"tf":1,"number_of_finite_elements":1})
+    for k in ["xf","qf"]:
+      self.checkarray(intg(x0=vertcat(1,1))[k],ref(x0=vertcat(1,1))[k],digits=8)
+
+    # Autonomous ODE, without time as an input
+    dae = {"x":x,"ode":mtimes(A,x)}
+    ref = integrator("ref","collocation",dae,{"tf":1,"number_of_finite_elements":400})
+    intg = integrator("intg","exponential",dae,{"tf":1,"number_of_finite_elements":1,"simplify":True})
+    self.checkarray(intg(x0=vertcat(1,1))["xf"],ref(x0=vertcat(1,1))["xf"],digits=8)
+
+    # Second order convergence for a nonlinear ODE, with the backward problem
+    p = SX.sym("p")
+    rx = SX.sym("rx",2)
+    ode = vertcat(-p*x[0]+x[1]**2+sin(t),-10*x[1]+x[0])
+    dae = {"t":t,"x":x,"p":p,"ode":ode,"quad":x[0]**2,"rx":rx,
+           "rode":mtimes(jacobian(ode,x).T,rx),"rquad":mtimes(jacobian(ode,p).T,rx)}
+    ref = integrator("ref","collocation",dae,{"tf":2,"number_of_finite_elements":100})
+    res_ref = ref(x0=vertcat(1,0.5),p=2,rx0=vertcat(1,-1))
+    err = []
+    for nk in [100,200]:
+      intg = integrator("intg","exponential",dae,{"tf":2,"number_of_finite_elements":nk})
+      res = intg(x0=vertcat(1,0.5),p=2,rx0=vertcat(1,-1))
+      for k in ["xf","qf","rxf","rqf"]:
+        self.checkarray(res[k],res_ref[k],digits=3)
+      err.append(norm_inf(res["xf"]-res_ref["xf"]))
+    self.assertTrue(err[0]/err[1]>3)
+
+  def test_events(self):
+    # Bouncing ball, the velocity is reversed and damped at impact
+    x = SX.sym("x",2)
+    dae = {"x":x,"ode":vertcat(x[1],-9.81),"quad":x[0],"event":x[0]}
+    xs = SX.sym("x",2)
+    tr = Function("tr",[SX.sym("t"),xs,SX.sym("z",0),SX.sym("p",0),SX.sym("index")],
+                  [vertcat(0,-0.8*xs[1])])
+
+    # Analytic solution
+    te = [sqrt(2/9.81)]
+    v = 0.8*9.81*te[0]
+    while te[-1]+2*v/9.81<2:
+      te.append(te[-1]+2*v/9.81)
+      v = 0.8*v
+    dt = 2-te[-1]
+    xf = [v*dt-9.81/2*dt**2,v-9.81*dt]
+
+    for plugin, opts in [("rk",{"number_of_finite_elements":200}),
+                         ("collocation",{"number_of_finite_elements":200}),
+                         ("cvodes",{"abstol":1e-10,"reltol":1e-10,"quad_err_con":True}),
+                         ("idas",{"abstol":1e-10,"reltol":1e-10,"quad_err_con":True})]:
+      if not has_integrator(plugin): continue
+      opts = dict(opts,grid=[0,1,2],event_transition=tr)
+      intg = integrator("intg",plugin,dae,opts)
+      res = intg(x0=vertcat(1,0))
+      stats = intg.stats()
+      self.assertEqual(stats["nevents"],len(te))
+      self.checkarray(DM(stats["event_times"]),DM(te),digits=7)
+      self.checkarray(res["xf"][:,1],DM(xf),digits=6)
+      self.checkarray(res["qf"][:,1],res["qf"][:,0]+0.2476562,digits=5)
+      # Rootfinder work of all steps, also those before the last event
+      if plugin=="collocation": self.assertTrue(stats["nfact"]>=200)
+
+      # No derivatives through the events
+      with self.assertRaises(Exception):
+        intg.jacobian()
+
+    # Several event functions, the index is passed to the transition
+    t = SX.sym("t")
+    x = SX.sym("x")
+    z = SX.sym("z")
+    dae = {"t":t,"x":x,"z":z,"ode":1-z,"alg":z-0.5*x,"event":vertcat(x-0.5,t-0.3)}
+    index = SX.sym("index")
+    xs = SX.sym("x")
+    tr = Function("tr",[SX.sym("t"),xs,SX.sym("z"),SX.sym("p",0),index],
+                  [if_else(index==0,0,xs+1)])
+    xf = 2-(2*exp(-0.15)-1)*exp(-0.85)
+    for plugin in ["collocation","idas"]:
+      if not has_integrator(plugin): continue
+      intg = integrator("intg",plugin,dae,{"tf":2,"event_transition":tr,"max_events":1})
+      self.checkarray(intg(x0=0)["xf"],xf,digits=4)
+      self.assertEqual(intg.stats()["event_indices"],[1])
+      intg = integrator("intg",plugin,dae,{"tf":2,"event_transition":tr,"max_events":0})
+      with self.assertRaises(Exception):
+        intg(x0=0)
+
+    # The algebraic state is solved for again after the state jumps
+    intg = integrator("intg","collocation",dae,{"grid":[0,0.35,2],"event_transition":tr,"max_events":1})
+    res = intg(x0=0)
+    self.checkarray(res["zf"],0.5*res["xf"],digits=3)
+
+  def test_preconditioners(self):
+    # Diffusion-reaction on a grid, pairs of species coupled locally
+    n = 20
+    u = SX.sym("u",n)
+    v = SX.sym("v",n)
+    d = lambda w: vertcat(w[1]-w[0],w[:-2]-2*w[1:-1]+w[2:],w[-2]-w[-1])
+    dae = {"x":vertcat(u,v),"ode":vertcat(10*d(u)-u*v,0.1*d(v)-5*v+u)}
+    x0 = vertcat(DM(range(n))/n,DM.ones(n))
+    ref = integrator("intg","cvodes",dae,{"tf":1,"abstol":1e-10,"reltol":1e-10})(x0=x0)["xf"]
+    for plugin in ["cvodes","idas"]:
+      if not has_integrator(plugin): continue
+      for precon, popts in [("full",{}),("block_jacobi",{}),("block_jacobi",{"max_block_size":4}),
+                            ("ilu",{}),("ilu",{"fill_level":2})]:
+        opts = {"tf":1,"abstol":1e-10,"reltol":1e-10,"newton_scheme":"gmres",
+                "preconditioner":precon,"preconditioner_options":popts}
+        intg = integrator("intg",plugin,dae,opts)
+        self.checkarray(intg(x0=x0)["xf"],ref,digits=6)
+    with self.assertRaises(Exception):
+      integrator("intg","cvodes",dae,{"preconditioner":"ilu"})
+
+  @requires_integrator('idas')
+  def test_block_jacobi_sparsity(self):
+    # Algebraic equations matched off the diagonal
+    x = SX.sym("x",2)
+    z = SX.sym("z",2)
+    dae = {"x":x,"z":z,"ode":vertcat(z[0]-x[0],-2*x[1]),"alg":vertcat(z[1]-x[0],z[0]-x[1])}
+    for popts, bs in [({},1),({"max_block_size":1},1)]:
+      opts = {"tf":1,"newton_scheme":"gmres","preconditioner":"block_jacobi","preconditioner_options":popts}
+      intg = integrator("intg","idas",dae,opts)
+      sp = intg.get_function("jacF").sparsity_out(0)
+      # Connected components of the bipartite row-column graph
+      parent = list(range(sp.size1()+sp.size2()))
+      def find(i):
+        while parent[i]!=i: i = parent[i]
+        return i
+      for r, c in zip(*sp.get_triplet()):
+        parent[find(r)] = find(sp.size1()+c)
+      rows = [find(i) for i in range(sp.size1())]
+      cols = [find(sp.size1()+i) for i in range(sp.size2())]
+      for k in set(rows+cols):
+        self.assertTrue(rows.count(k)<=bs)
+        self.assertTrue(cols.count(k)<=bs)
+      ref = integrator("intg","idas",dae,{"tf":1})(x0=[1,2],z0=[2,1])["xf"]
+      self.checkarray(intg(x0=[1,2],z0=[2,1])["xf"],ref,digits=6)
+
+  def test_dopri_grid(self):
+    x = SX.sym("x")
+    tgrid = numpy.linspace(0, 1, 101)
+    intg = integrator("intg","dopri",{"x":x,"ode":-x},{"grid":tgrid,"abstol":1e-10,"reltol":1e-10})
+    res = intg(x0=1)
+    self.checkarray(res["xf"].T,numpy.exp(-tgrid[1:]),digits=8)
+
+    # The output grid does not restrict the step size
+    stats = intg.stats()
+    self.assertTrue(stats["nsteps"]<100)
+
+    self.check_codegen(intg,inputs={"x0":1})
+
   @requires_integrator('cvodes')
   def test_step_options_cvodes(self):
     x = SX.sym("x")
@@ -429,6 +429,32 @@ class LinearSolverTests(casadiTestCase):
         C = solve(A,b,Solver,options)
         self.checkarray(ref,C)
 
+  def test_ilu(self):
+      # No fill-in for a tridiagonal matrix, ILU(0) is exact
+      n = 6
+      A = DM(Sparsity.band(n,-1)+Sparsity.band(n,0)+Sparsity.band(n,1),
+             [4,-1]+[-1,4,-1]*(n-2)+[-1,4])
+      b = DM(range(1,n+1))
+      self.checkarray(solve(A,b,"ilu"),np.linalg.solve(A,b))
+
+      # Diagonally dominant matrix with fill-in
+      A = DM([[8, 1, 0, 0, 0, 2],
+              [0, 7, 3, 0, 0, 0],
+              [2, 0, 9, 1, 0, 0],
+              [0, 0, 0, 8, 2, 0],
+              [1, 0, 0, 3, 7, 1],
+              [3, 0, 0, 0, 1, 9]])
+      A = A[sparsify(A).sparsity()]
+      for tr in [False, True]:
+        ref = np.linalg.solve(A.T if tr else A,b)
+        # With enough levels of fill, the factorization is complete
+        C = Linsol("S","ilu",A.sparsity(),{"fill_level":n}).solve(A,b,tr)
+        self.checkarray(ref,C)
+        # Without fill-in, only an approximation
+        C = Linsol("S","ilu",A.sparsity()).solve(A,b,tr)
+        self.assertTrue(np.linalg.norm(ref-C)>1e-10)
+        self.assertTrue(np.linalg.norm(ref-C)<0.1*np.linalg.norm(ref))
+
 
   def test_large_sparse2(self):
     numpy.random.seed(1)
@@ -1761,6 +1761,29 @@ class MXtests(casadiTestCase):
     self.checkarray(F_out,9*DM.ones(4,4))
 
 
+  def test_cse(self):
+    x = MX.sym("x",2)
+    y = MX.sym("y",2)
+
+    e = vertcat(sin(x)*y, y*sin(x), cos(sin(x)+3), cos(sin(x)+3))
+    f = Function('f',[x,y],[e])
+
+    r = cse(e)
+    self.assertTrue(n_nodes(r)<n_nodes(e))
+    self.checkfunction(Function('f',[x,y],[r]),f,inputs=[DM([1.1,1.2]),DM([1.3,1.4])])
+
+    fcse = Function('f',[x,y],[e],{"cse":True})
+    self.assertTrue(fcse.n_instructions()<f.n_instructions())
+    self.checkfunction(fcse,f,inputs=[DM([1.1,1.2]),DM([1.3,1.4])])
+
+    # Commutative operations are merged regardless of the order of the arguments
+    r = cse(vertcat(x*y,y*x))
+    self.assertTrue(is_equal(r.dep(0),r.dep(1)))
+
+    # Equal constants are merged
+    [r0,r1] = cse([x+DM([3,4]),x+DM([3,4])])
+    self.assertTrue(is_equal(r0,r1))
+
   def test_matrix_expand(self):
     n = 2
     a = MX.sym("a",n,n)
@@ -1570,6 +1570,55 @@ class NLPtests(casadiTestCase):
     stats_reg = solver.stats()
     self.assertTrue(stats_reg["iter_count"]==9)
 
+  def test_lbfgs_qp_form(self):
+    N = 10
+    x = SX.sym("x",N)
+    f = sum1(100*(x[1:]-x[:-1]**2)**2+(1-x[:-1])**2)
+    g = vertcat(sum1(x),x[0]*x[1])
+    nlp = {"x":x,"f":f,"g":g}
+    sol = {}
+    stats = {}
+    for form in ["lifted","dense","auto",None]:
+      options = {"qpsol":"qrqp","hessian_approximation":"limited-memory","lbfgs_memory":5,"max_iter":200,
+                 "qpsol_options":{"print_iter":False,"print_header":False},"print_iteration":False,"print_header":False}
+      if form is not None: options["lbfgs_qp_form"] = form
+      solver = nlpsol("solver","sqpmethod",nlp,options)
+      sol[form] = solver(x0=0.5,lbg=vertcat(-inf,0.2),ubg=vertcat(3,inf))
+      stats[form] = solver.stats()
+      self.assertTrue(stats[form]["success"])
+    self.checkarray(sol["lifted"]["x"],sol["dense"]["x"],digits=6)
+    self.checkarray(sol["lifted"]["lam_g"],sol["dense"]["lam_g"],digits=5)
+    # By default the QP is lifted when qpsol accepts an indefinite Hessian
+    self.checkarray(sol["auto"]["x"],sol["lifted"]["x"],digits=10)
+    self.checkarray(sol[None]["x"],sol["lifted"]["x"],digits=10)
+    self.assertEqual(stats[None]["iter_count"],stats["lifted"]["iter_count"])
+    with self.assertInException("Unknown L-BFGS QP form"):
+      nlpsol("solver","sqpmethod",nlp,{"qpsol":"qrqp","hessian_approximation":"limited-memory","lbfgs_qp_form":"foo"})
+
+  def test_sqpmethod_qp_warm_start(self):
+    N = 10
+    x = SX.sym("x",N)
+    u = SX.sym("u",N)
+    p = SX.sym("p")
+    nlp = {"x":vertcat(x,u),"p":p,"f":sumsqr(x)+sumsqr(u),"g":x-vertcat(p,x[:-1])-u-0.1*sin(vertcat(p,x[:-1]))}
+    solver_in = {"lbx":vertcat(-inf*DM.ones(N),-0.3*DM.ones(N)),"ubx":vertcat(inf*DM.ones(N),0.3*DM.ones(N)),"lbg":0,"ubg":0}
+    options = {"qpsol":"qrqp","qpsol_options":{"print_iter":False,"print_header":False},"print_iteration":False,"print_header":False}
+    cold = nlpsol("solver","sqpmethod",nlp,options)
+    options["qp_warm_start"] = True
+    warm = nlpsol("solver","sqpmethod",nlp,options)
+    x0 = 3
+    for k in range(4):
+      solver_in["p"] = x0
+      ref = cold(**solver_in)
+      solver_out = warm(**solver_in)
+      stats = warm.stats()
+      self.assertTrue(stats["success"])
+      self.checkarray(solver_out["x"],ref["x"],digits=8)
+      if k>0: self.assertTrue(stats["qp_n_warm_active"]>0)
+      x0 = float(solver_out["x"][0])
+    with self.assertInException("requires qpsol 'qrqp'"):
+      nlpsol("solver","sqpmethod",nlp,{"qpsol":"qpoases","qp_warm_start":True})
+
   @requires_nlpsol("ipopt")
   def test_gauss_newton_ipopt(self):
     x = SX.sym("x",3)
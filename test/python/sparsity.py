@@ -490,6 +490,29 @@ class Sparsitytests(casadiTestCase):
     sp2 = hessian(H,x)[0].sparsity()
     self.assertTrue(sp==sp2)
 
+  def test_jacsparsity_width(self):
+    n = 500
+    x = SX.sym("x",n)
+    e = vertcat(*[sin(x[k])*x[(7*k+3)%n]+(x[(k+n//2)%n] if k%5==0 else 0) for k in range(n)])
+    f = Function("f",[x],[e, gradient(dot(e,e),x)])
+    xm = MX.sym("x",n)
+    fm = Function("fm",[xm],f(2*xm))
+
+    for hier in [False, True]:
+      GlobalOptions.setHierarchicalSparsity(hier)
+      for F in [f, fm]:
+        ref = []
+        for w in [1, 3, 8]:
+          GlobalOptions.setSparsityWidth(w)
+          G = Function.deserialize(F.serialize())
+          sp = [G.sparsity_jac(0, 0), G.sparsity_jac(0, 1, False, True)]
+          if ref:
+            self.assertTrue(sp[0]==ref[0])
+            self.assertTrue(sp[1]==ref[1])
+          else:
+            ref = sp
+    GlobalOptions.setHierarchicalSparsity(True)
+    GlobalOptions.setSparsityWidth(8)
 
   def test_rowcol(self):
     n = 3
@@ -567,6 +590,26 @@ class Sparsitytests(casadiTestCase):
         self.assertTrue(L.is_subset(R))
         self.assertFalse(R.is_subset(L))
 
+  def test_cache_stats(self):
+    s0 = Sparsity.cache_stats()
+    a = Sparsity.lower(17)
+    s1 = Sparsity.cache_stats()
+    b = Sparsity.lower(17)
+    s2 = Sparsity.cache_stats()
+    self.assertTrue(s2["n_hit"]>s1["n_hit"])
+    self.assertTrue(s1["n_hit"]+s1["n_miss"]>s0["n_hit"]+s0["n_miss"])
+    self.assertTrue(s2["n_entries"]>=1)
+    self.assertTrue(a==b)
+
+  def test_cache_sole_owner(self):
+    # Replacing a pattern that is not referenced elsewhere deletes it while
+    # the cache is being updated, this must not deadlock with WITH_THREAD
+    for n in range(20, 60):
+      sp = Sparsity(n, n)
+      for k in range(n):
+        sp.add_nz(k, k)
+      self.assertEqual(sp.nnz(), n)
+
 
 
 if __name__ == '__main__':
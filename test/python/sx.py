@@ -1438,6 +1438,28 @@ class SXtests(casadiTestCase):
   def test_ufunc(self):
     y = np.sin(casadi.SX.sym('x'))
 
+  def test_cse(self):
+    x = SX.sym("x")
+    y = SX.sym("y")
+
+    e = vertcat(sin(x)*y, y*sin(x), cos(sin(x)+3), cos(sin(x)+3))
+    f = Function('f',[x,y],[e])
+
+    r = cse(e)
+    self.assertTrue(n_nodes(r)<n_nodes(e))
+    self.checkfunction(Function('f',[x,y],[r]),f,inputs=[1.1,1.3])
+
+    fcse = Function('f',[x,y],[e],{"cse":True})
+    self.assertTrue(fcse.n_instructions()<f.n_instructions())
+    self.checkfunction(fcse,f,inputs=[1.1,1.3])
+
+    [r0,r1] = cse([sin(x)*y,sin(x)*y])
+    self.assertTrue(is_equal(r0,r1))
+
+    # Commutative operations are merged regardless of the order of the arguments
+    r = cse(x*y+y*x)
+    self.assertTrue(is_equal(r.dep(0),r.dep(1)))
+
 
 
 if __name__ == '__main__':